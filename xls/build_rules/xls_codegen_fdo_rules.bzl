@@ -234,6 +234,7 @@ def xls_ir_verilog_fdo_impl(ctx, src):
         "io_constraints",
         "receives_first_sends_last",
         "mutual_exclusion_z3_rlimit",
+        "mutual_exclusion_time_budget_ms",
         "use_fdo",
         "fdo_iteration_number",
         "fdo_delay_driven_path_number",
@@ -281,6 +281,8 @@ def xls_ir_verilog_impl(ctx, src):
         "gate_recvs",
         "array_index_bounds_checking",
         "inline_procs",
+        "multi_proc",
+        "codegen_worker_count",
     )
 
     SCHEDULING_FLAGS = (
@@ -296,6 +298,7 @@ def xls_ir_verilog_impl(ctx, src):
         "io_constraints",
         "receives_first_sends_last",
         "mutual_exclusion_z3_rlimit",
+        "mutual_exclusion_time_budget_ms",
         "explain_infeasibility",
         "infeasible_per_state_backedge_slack_pool",
         "use_fdo",
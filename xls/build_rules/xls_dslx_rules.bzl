@@ -102,6 +102,9 @@ def _get_dslx_test_cmdline(ctx, src, append_cmd_line_args = True):
         "disable_warnings",
         "max_ticks",
         "format_preference",
+        "worker_count",
+        "run_procs_on_jit",
+        "module_cache_dir",
     )
 
     dslx_test_args = dict(_dslx_test_args)
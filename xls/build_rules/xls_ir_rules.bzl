@@ -127,6 +127,8 @@ def _convert_to_ir(ctx, src):
         "emit_fail_as_assert",
         "warnings_as_errors",
         "disable_warnings",
+        "worker_count",
+        "module_cache_dir",
     )
 
     # With runs outside a monorepo, the execution root for the workspace of
@@ -287,6 +289,9 @@ def get_ir_equivalence_test_cmd(
     ir_equivalence_tool = ctx.executable._xls_ir_equivalence_tool
     IR_EQUIVALENCE_FLAGS = (
         "timeout",
+        "partition_width",
+        "num_threads",
+        "simulation_samples",
     )
 
     ir_equivalence_args = dict(ctx.attr.ir_equivalence_args)
@@ -15,10 +15,19 @@
 #include "xls/codegen/pipeline_generator.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "xls/codegen/block_conversion.h"
 #include "xls/codegen/block_generator.h"
 #include "xls/codegen/codegen_options.h"
@@ -26,12 +35,127 @@
 #include "xls/codegen/codegen_pass_pipeline.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/call_graph.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/package.h"
+#include "xls/ir/source_location.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/scheduling_options.h"
 
 namespace xls {
 namespace verilog {
+namespace {
+
+// Copies `function_base`, the functions it calls and the channels it uses into
+// a new package of the same name. Node names and ids are kept (and new nodes
+// are numbered as they would be in the original package) so the copy converts
+// to the block the original would. Channels which are only sent on (received
+// from) become send-only (receive-only) so that the copy verifies without the
+// procs on their other end. The original package is only read.
+absl::StatusOr<std::unique_ptr<Package>> CopyForCodegen(
+    FunctionBase* function_base) {
+  Package* original = function_base->package();
+  auto package = std::make_unique<Package>(original->name());
+  package->set_next_node_id(original->next_node_id());
+
+  std::vector<FunctionBase*> dependencies =
+      GetDependentFunctions(function_base);
+  for (FunctionBase* f : dependencies) {
+    for (Node* node : f->nodes()) {
+      for (const SourceLocation& loc : node->loc().locations) {
+        if (std::optional<std::string> filename =
+                original->GetFilename(loc.fileno());
+            filename.has_value()) {
+          package->SetFileno(loc.fileno(), filename.value());
+        }
+      }
+    }
+  }
+
+  if (function_base->IsProc()) {
+    absl::flat_hash_set<std::string> sent;
+    absl::flat_hash_set<std::string> received;
+    for (Node* node : function_base->nodes()) {
+      if (node->Is<Send>()) {
+        sent.insert(node->As<Send>()->channel_name());
+      } else if (node->Is<Receive>()) {
+        received.insert(node->As<Receive>()->channel_name());
+      }
+    }
+    for (Channel* channel : original->channels()) {
+      bool is_sent = sent.contains(channel->name());
+      bool is_received = received.contains(channel->name());
+      if (!is_sent && !is_received) {
+        continue;
+      }
+      ChannelOps supported_ops = channel->supported_ops();
+      if (!is_received) {
+        supported_ops = ChannelOps::kSendOnly;
+      } else if (!is_sent) {
+        supported_ops = ChannelOps::kReceiveOnly;
+      }
+      XLS_RETURN_IF_ERROR(
+          package
+              ->CloneChannel(channel, channel->name(),
+                             Package::CloneChannelOverrides()
+                                 .OverrideSupportedOps(supported_ops))
+              .status());
+    }
+  }
+
+  // Callees come first, so every function is parsed after those it calls.
+  for (FunctionBase* f : dependencies) {
+    FunctionBase* copy;
+    if (f->IsFunction()) {
+      XLS_ASSIGN_OR_RETURN(
+          copy, Parser::ParseFunction(f->DumpIr(), package.get(),
+                                      /*verify_function_only=*/true));
+    } else if (f->IsProc()) {
+      XLS_ASSIGN_OR_RETURN(copy, Parser::ParseProc(f->DumpIr(), package.get()));
+    } else {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cannot generate a pipelined module for block %s.", f->name()));
+    }
+    if (std::optional<int64_t> ii = f->GetInitiationInterval();
+        ii.has_value()) {
+      copy->SetInitiationInterval(ii.value());
+    }
+    copy->SetForeignFunctionData(f->ForeignFunctionData());
+  }
+  return package;
+}
+
+// Returns the schedule of `copy` which places each node in the cycle of the
+// node of the same name in `schedule`.
+absl::StatusOr<PipelineSchedule> CopySchedule(const PipelineSchedule& schedule,
+                                              FunctionBase* copy) {
+  absl::flat_hash_map<std::string, int64_t> cycles;
+  for (Node* node : schedule.function_base()->nodes()) {
+    if (schedule.IsScheduled(node)) {
+      cycles[node->GetName()] = schedule.cycle(node);
+    }
+  }
+  ScheduleCycleMap cycle_map;
+  for (Node* node : copy->nodes()) {
+    auto it = cycles.find(node->GetName());
+    XLS_RET_CHECK(it != cycles.end())
+        << "Node " << node->GetName() << " of " << copy->name()
+        << " is not scheduled.";
+    cycle_map[node] = it->second;
+  }
+  return PipelineSchedule(copy, std::move(cycle_map), schedule.length());
+}
+
+}  // namespace
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
@@ -75,5 +199,37 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
                                unit.signature.value()};
 }
 
+absl::StatusOr<std::vector<ModuleGeneratorResult>> ToPipelineModuleTexts(
+    absl::Span<const PipelineSchedule> schedules, int64_t worker_count,
+    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+  if (schedules.size() > 1 && options.module_name().has_value()) {
+    return absl::InvalidArgumentError(
+        "A module name cannot be given when generating more than one module.");
+  }
+
+  std::vector<std::optional<ModuleGeneratorResult>> results(schedules.size());
+  XLS_RETURN_IF_ERROR(ParallelFor(
+      schedules.size(), worker_count, [&](int64_t i) -> absl::Status {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                             CopyForCodegen(schedules[i].function_base()));
+        XLS_ASSIGN_OR_RETURN(FunctionBase * copy,
+                             package->GetFunctionBaseByName(
+                                 schedules[i].function_base()->name()));
+        XLS_ASSIGN_OR_RETURN(PipelineSchedule schedule,
+                             CopySchedule(schedules[i], copy));
+        XLS_ASSIGN_OR_RETURN(results[i],
+                             ToPipelineModuleText(schedule, copy, options,
+                                                  delay_estimator));
+        return absl::OkStatus();
+      }));
+
+  std::vector<ModuleGeneratorResult> module_results;
+  module_results.reserve(results.size());
+  for (std::optional<ModuleGeneratorResult>& result : results) {
+    module_results.push_back(std::move(result).value());
+  }
+  return module_results;
+}
+
 }  // namespace verilog
 }  // namespace xls
@@ -15,9 +15,12 @@
 #ifndef XLS_CODEGEN_PIPELINE_GENERATOR_H_
 #define XLS_CODEGEN_PIPELINE_GENERATOR_H_
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/module_signature.pb.h"
@@ -59,6 +62,28 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const CodegenOptions& options = BuildPipelineOptions(),
     const DelayEstimator* delay_estimator = nullptr);
 
+// Emits a verilog module for the function or proc of each of the given
+// schedules, as ToPipelineModuleText does. Block conversion, the codegen pass
+// pipeline and Verilog generation for each schedule run on up to
+// `worker_count` threads. Results are returned in the order of `schedules`
+// regardless of the order in which they complete.
+//
+// The schedules may share a package, as the procs of a multi-proc design do.
+// Block conversion mutates the package it converts, so each function or proc
+// is first copied (with the functions it calls and the channels it uses) into
+// a package of its own; the given packages are only read and no blocks are
+// added to them. Each module is the one ToPipelineModuleText would produce if
+// its function or proc were converted first. Channels a proc only sends on
+// (receives from) are send-only (receive-only) in its copy, so the signature of
+// the module describes them from the module's side.
+//
+// `options` must not set a module name if there is more than one schedule. The
+// delay estimator, if given, must be safe for concurrent use.
+absl::StatusOr<std::vector<ModuleGeneratorResult>> ToPipelineModuleTexts(
+    absl::Span<const PipelineSchedule> schedules, int64_t worker_count,
+    const CodegenOptions& options = BuildPipelineOptions(),
+    const DelayEstimator* delay_estimator = nullptr);
+
 }  // namespace verilog
 }  // namespace xls
 
@@ -14,12 +14,18 @@
 
 #include "xls/codegen/pipeline_generator.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/substitute.h"
 #include "xls/codegen/module_signature.h"
@@ -42,6 +48,7 @@ namespace verilog {
 namespace {
 
 using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
 using ::testing::ContainsRegex;
 using ::testing::HasSubstr;
 using ::testing::Not;
@@ -1153,6 +1160,157 @@ proc ii_greater_than_one(tkn: token, st: bits[32], init={0}) {
                                  result.verilog_text);
 }
 
+TEST_P(PipelineGeneratorTest, ParallelMultipleModules) {
+  constexpr int64_t kModuleCount = 8;
+  // Builds one package per module.
+  auto make_schedules = [&](std::vector<std::unique_ptr<Package>>& packages)
+      -> absl::StatusOr<std::vector<PipelineSchedule>> {
+    std::vector<PipelineSchedule> schedules;
+    for (int64_t i = 0; i < kModuleCount; ++i) {
+      packages.push_back(
+          std::make_unique<Package>(absl::StrCat(TestBaseName(), i)));
+      Package* package = packages.back().get();
+      FunctionBuilder fb(absl::StrCat("add_negate_", i), package);
+      Type* type = package->GetBitsType(8 + i);
+      fb.Negate(fb.Add(fb.Param("x", type), fb.Param("y", type)));
+      XLS_ASSIGN_OR_RETURN(Function * func, fb.Build());
+      XLS_ASSIGN_OR_RETURN(
+          PipelineSchedule schedule,
+          RunPipelineSchedule(func, TestDelayEstimator(),
+                              SchedulingOptions().pipeline_stages(1 + i % 3)));
+      schedules.push_back(std::move(schedule));
+    }
+    return schedules;
+  };
+  CodegenOptions options =
+      BuildPipelineOptions().use_system_verilog(UseSystemVerilog());
+
+  std::vector<std::unique_ptr<Package>> serial_packages;
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<PipelineSchedule> serial_schedules,
+                           make_schedules(serial_packages));
+  std::vector<std::unique_ptr<Package>> parallel_packages;
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<PipelineSchedule> parallel_schedules,
+                           make_schedules(parallel_packages));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<ModuleGeneratorResult> results,
+      ToPipelineModuleTexts(parallel_schedules, /*worker_count=*/4, options));
+  ASSERT_EQ(results.size(), kModuleCount);
+  for (int64_t i = 0; i < kModuleCount; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ModuleGeneratorResult expected,
+        ToPipelineModuleText(serial_schedules[i],
+                             serial_schedules[i].function_base(), options));
+    EXPECT_EQ(results[i].verilog_text, expected.verilog_text);
+    EXPECT_EQ(results[i].signature.proto().pipeline().latency(),
+              expected.signature.proto().pipeline().latency());
+    EXPECT_EQ(results[i].signature.module_name(),
+              absl::StrCat("add_negate_", i));
+  }
+}
+
+TEST_P(PipelineGeneratorTest, ParallelProcsInOnePackage) {
+  const std::string ir_text = absl::Substitute(R"(package $0
+chan in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=ready_valid, metadata="")
+chan a_to_b(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=ready_valid, metadata="")
+chan b_to_c(bits[32], id=2, kind=streaming, ops=send_receive, flow_control=ready_valid, metadata="")
+chan out(bits[32], id=3, kind=streaming, ops=send_only, flow_control=ready_valid, metadata="")
+
+proc a(tkn: token, st: (), init={()}) {
+  receive.1: (token, bits[32]) = receive(tkn, channel=in, id=1)
+  tuple_index.2: token = tuple_index(receive.1, index=0, id=2)
+  tuple_index.3: bits[32] = tuple_index(receive.1, index=1, id=3)
+  neg.4: bits[32] = neg(tuple_index.3, id=4)
+  send.5: token = send(tuple_index.2, neg.4, channel=a_to_b, id=5)
+  next (send.5, st)
+}
+
+proc b(tkn: token, st: bits[32], init={0}) {
+  receive.6: (token, bits[32]) = receive(tkn, channel=a_to_b, id=6)
+  tuple_index.7: token = tuple_index(receive.6, index=0, id=7)
+  tuple_index.8: bits[32] = tuple_index(receive.6, index=1, id=8)
+  add.9: bits[32] = add(tuple_index.8, st, id=9)
+  send.10: token = send(tuple_index.7, add.9, channel=b_to_c, id=10)
+  next (send.10, add.9)
+}
+
+proc c(tkn: token, st: (), init={()}) {
+  receive.11: (token, bits[32]) = receive(tkn, channel=b_to_c, id=11)
+  tuple_index.12: token = tuple_index(receive.11, index=0, id=12)
+  tuple_index.13: bits[32] = tuple_index(receive.11, index=1, id=13)
+  not.14: bits[32] = not(tuple_index.13, id=14)
+  send.15: token = send(tuple_index.12, not.14, channel=out, id=15)
+  next (send.15, st)
+}
+)",
+                                               TestBaseName());
+  const std::vector<std::string_view> kProcNames = {"a", "b", "c"};
+  CodegenOptions options = BuildPipelineOptions()
+                               .reset("rst", /*asynchronous=*/false,
+                                      /*active_low=*/false,
+                                      /*reset_data_path=*/false)
+                               .use_system_verilog(UseSystemVerilog());
+  auto schedule_proc =
+      [&](Package* package,
+          std::string_view name) -> absl::StatusOr<PipelineSchedule> {
+    XLS_ASSIGN_OR_RETURN(Proc * proc, package->GetProc(name));
+    return RunPipelineSchedule(proc, TestDelayEstimator(),
+                               SchedulingOptions().pipeline_stages(2));
+  };
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+  std::vector<PipelineSchedule> schedules;
+  for (std::string_view name : kProcNames) {
+    XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule,
+                             schedule_proc(package.get(), name));
+    schedules.push_back(std::move(schedule));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<ModuleGeneratorResult> results,
+      ToPipelineModuleTexts(schedules, /*worker_count=*/3, options));
+  ASSERT_EQ(results.size(), kProcNames.size());
+  // The procs are converted in copies; the package itself is left as is.
+  EXPECT_TRUE(package->blocks().empty());
+
+  for (int64_t i = 0; i < kProcNames.size(); ++i) {
+    // Each module matches the one generated by converting its proc alone.
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> expected_package,
+                             Parser::ParsePackage(ir_text));
+    XLS_ASSERT_OK_AND_ASSIGN(
+        PipelineSchedule expected_schedule,
+        schedule_proc(expected_package.get(), kProcNames[i]));
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ModuleGeneratorResult expected,
+        ToPipelineModuleText(expected_schedule,
+                             expected_schedule.function_base(), options));
+    EXPECT_EQ(results[i].verilog_text, expected.verilog_text);
+    EXPECT_EQ(results[i].signature.module_name(), kProcNames[i]);
+    EXPECT_EQ(results[i].signature.proto().pipeline().latency(),
+              expected.signature.proto().pipeline().latency());
+  }
+}
+
+TEST_P(PipelineGeneratorTest, ParallelModulesCannotShareAModuleName) {
+  Package package(TestBaseName());
+  std::vector<PipelineSchedule> schedules;
+  for (std::string_view name : {"a", "b"}) {
+    FunctionBuilder fb(name, &package);
+    fb.Not(fb.Param("x", package.GetBitsType(8)));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+    XLS_ASSERT_OK_AND_ASSIGN(
+        PipelineSchedule schedule,
+        RunPipelineSchedule(func, TestDelayEstimator(),
+                            SchedulingOptions().pipeline_stages(1)));
+    schedules.push_back(std::move(schedule));
+  }
+  EXPECT_THAT(
+      ToPipelineModuleTexts(schedules, /*worker_count=*/2,
+                            BuildPipelineOptions().module_name("foo")),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("module name cannot be given")));
+}
+
 INSTANTIATE_TEST_SUITE_P(PipelineGeneratorTestInstantiation,
                          PipelineGeneratorTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
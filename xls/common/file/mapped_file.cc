@@ -0,0 +1,98 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <filesystem>  // NOLINT
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/error_code_to_status.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<MappedFile> MappedFile::Open(
+    const std::filesystem::path& path) {
+  FileDescriptor fd(open(path.c_str(), O_RDONLY));
+  if (fd.get() == -1) {
+    return ErrnoToStatus(errno) << "Failed to open file: " << path;
+  }
+  struct stat st;
+  if (fstat(fd.get(), &st) == -1) {
+    return ErrnoToStatus(errno) << "Failed to stat file: " << path;
+  }
+
+  MappedFile file;
+  // Empty files cannot be mapped, and only regular files have a meaningful
+  // size; fall back to reading everything else.
+  if (S_ISREG(st.st_mode) && st.st_size > 0) {
+    void* mapping =
+        mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (mapping != MAP_FAILED) {
+      // The file is typically scanned front to back exactly once.
+      madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+      file.mapping_ = mapping;
+      file.mapping_size_ = st.st_size;
+      file.contents_ =
+          std::string_view(static_cast<const char*>(mapping), st.st_size);
+      return file;
+    }
+  }
+  fd.Close();
+  XLS_ASSIGN_OR_RETURN(file.buffer_, GetFileContents(path));
+  file.contents_ = file.buffer_;
+  return file;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+MappedFile::MappedFile(MappedFile&& other) { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  Unmap();
+  mapping_ = other.mapping_;
+  mapping_size_ = other.mapping_size_;
+  // Moving a std::string may or may not move its characters (short strings
+  // are stored inline), so re-derive the view rather than moving it.
+  bool owns_contents = other.mapping_ == nullptr;
+  buffer_ = std::move(other.buffer_);
+  contents_ = owns_contents ? std::string_view(buffer_) : other.contents_;
+  other.mapping_ = nullptr;
+  other.mapping_size_ = 0;
+  other.buffer_.clear();
+  other.contents_ = std::string_view();
+  return *this;
+}
+
+void MappedFile::Unmap() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,61 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_FILE_MAPPED_FILE_H_
+#define XLS_COMMON_FILE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <filesystem>  // NOLINT
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+
+namespace xls {
+
+// Read-only view of a file's contents. Regular files are memory-mapped, so
+// opening even a very large file is cheap and pages are only read as they are
+// touched; other files (pipes, character devices) are read into memory.
+class MappedFile {
+ public:
+  static absl::StatusOr<MappedFile> Open(const std::filesystem::path& path);
+
+  ~MappedFile();
+
+  // MappedFile is movable but not copyable.
+  MappedFile(MappedFile&& other);
+  MappedFile& operator=(MappedFile&& other);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // The contents of the file; valid for the lifetime of this object.
+  std::string_view contents() const { return contents_; }
+
+ private:
+  MappedFile() = default;
+
+  void Unmap();
+
+  // Non-null if the contents are memory-mapped.
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+
+  // Holds the contents if they could not be mapped.
+  std::string buffer_;
+  std::string_view contents_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_FILE_MAPPED_FILE_H_
@@ -0,0 +1,38 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_PARALLEL_FOR_H_
+#define XLS_COMMON_PARALLEL_FOR_H_
+
+#include <cstdint>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+
+namespace xls {
+
+// Invokes `fn(i)` for every `i` in [0, `count`) using up to `worker_count`
+// threads. Indices are handed out to workers in increasing order; if
+// `worker_count` is less than two (or there is at most one item) everything
+// runs on the calling thread.
+//
+// All items are run even if some of them fail. The returned status is the
+// error of the lowest-indexed failing item (so the result does not depend on
+// thread scheduling), or OkStatus if every item succeeded.
+absl::Status ParallelFor(int64_t count, int64_t worker_count,
+                         absl::FunctionRef<absl::Status(int64_t)> fn);
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_PARALLEL_FOR_H_
@@ -0,0 +1,68 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/parallel_for.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::Each;
+using ::testing::Eq;
+
+TEST(ParallelForTest, NoItems) {
+  XLS_EXPECT_OK(ParallelFor(0, 4, [](int64_t) -> absl::Status {
+    return absl::InternalError("should not be called");
+  }));
+}
+
+TEST(ParallelForTest, RunsEveryItemOnce) {
+  for (int64_t worker_count : {0, 1, 2, 7, 100}) {
+    std::vector<std::atomic<int64_t>> counts(1000);
+    XLS_ASSERT_OK(ParallelFor(counts.size(), worker_count, [&](int64_t i) {
+      counts[i].fetch_add(1);
+      return absl::OkStatus();
+    }));
+    for (const std::atomic<int64_t>& count : counts) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+}
+
+TEST(ParallelForTest, ReturnsLowestIndexedError) {
+  std::vector<int64_t> ran(100, 0);
+  absl::Status status = ParallelFor(ran.size(), 8, [&](int64_t i) {
+    ran[i] = 1;
+    if (i % 10 == 3) {
+      return absl::InvalidArgumentError(absl::StrCat("item ", i));
+    }
+    return absl::OkStatus();
+  });
+  EXPECT_THAT(status,
+              StatusIs(absl::StatusCode::kInvalidArgument, Eq("item 3")));
+  EXPECT_THAT(ran, Each(1));
+}
+
+}  // namespace
+}  // namespace xls
@@ -15,6 +15,7 @@
 #include "xls/data_structures/min_cut.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <limits>
 #include <set>
@@ -32,6 +33,17 @@
 
 namespace xls {
 namespace min_cut {
+namespace {
+
+// Returns a + b for non-negative a and b, saturating at the maximum int64_t
+// value.
+int64_t SaturatingAdd(int64_t a, int64_t b) {
+  return a > std::numeric_limits<int64_t>::max() - b
+             ? std::numeric_limits<int64_t>::max()
+             : a + b;
+}
+
+}  // namespace
 
 std::string GraphCut::ToString(const Graph& graph) const {
   std::vector<std::string> lines;
@@ -274,7 +286,8 @@ int64_t AugmentFlow(const Graph& graph, NodeId source, NodeId sink,
 
 }  // namespace
 
-GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
+GraphCut AugmentingPathMinCutBetweenNodes(const Graph& graph, NodeId source,
+                                          NodeId sink) {
   // This loop is the core of the Ford-Fulkerson method. Starting with zero flow
   // on all edges, flow is increased along a path from source to sink with
   // residual capacity (called an augmenting path). When no further augmenting
@@ -324,5 +337,236 @@ GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
   return min_cut;
 }
 
+void MinCutSolver::SetGraph(const Graph& graph) {
+  node_count_ = graph.node_count();
+  int64_t edge_count = graph.edge_count();
+
+  // Count the arcs leaving each node and lay them out contiguously.
+  first_arc_.assign(node_count_ + 1, 0);
+  for (int64_t e = 0; e < edge_count; ++e) {
+    const Edge& edge = graph.edge(EdgeId(e));
+    ++first_arc_[int64_t{edge.from} + 1];
+    ++first_arc_[int64_t{edge.to} + 1];
+  }
+  for (int64_t n = 0; n < node_count_; ++n) {
+    first_arc_[n + 1] += first_arc_[n];
+  }
+  arc_head_.resize(2 * edge_count);
+  arc_reverse_.resize(2 * edge_count);
+  arc_capacity_.resize(2 * edge_count);
+  edge_arc_.resize(edge_count);
+  edge_weight_.resize(edge_count);
+  std::vector<int64_t> next_arc(first_arc_.begin(), first_arc_.end() - 1);
+  for (int64_t e = 0; e < edge_count; ++e) {
+    const Edge& edge = graph.edge(EdgeId(e));
+    int64_t forward = next_arc[int64_t{edge.from}]++;
+    int64_t backward = next_arc[int64_t{edge.to}]++;
+    arc_head_[forward] = int64_t{edge.to};
+    arc_head_[backward] = int64_t{edge.from};
+    arc_reverse_[forward] = backward;
+    arc_reverse_[backward] = forward;
+    edge_arc_[e] = forward;
+    edge_weight_[e] = edge.weight;
+  }
+
+  excess_.resize(node_count_);
+  height_.resize(node_count_);
+  current_arc_.resize(node_count_);
+  height_count_.resize(2 * node_count_ + 2);
+  active_.resize(2 * node_count_ + 2);
+}
+
+void MinCutSolver::SetEdgeWeight(EdgeId edge, int64_t weight) {
+  edge_weight_[int64_t{edge}] = weight;
+}
+
+void MinCutSolver::SetHeight(int64_t node, int64_t height) {
+  --height_count_[height_[node]];
+  height_[node] = height;
+  ++height_count_[height];
+  current_arc_[node] = first_arc_[node];
+}
+
+void MinCutSolver::Activate(int64_t node) {
+  active_[height_[node]].push_back(node);
+  max_active_height_ = std::max(max_active_height_, height_[node]);
+}
+
+void MinCutSolver::Push(int64_t from, int64_t arc) {
+  int64_t amount = std::min(excess_[from], arc_capacity_[arc]);
+  int64_t to = arc_head_[arc];
+  arc_capacity_[arc] -= amount;
+  arc_capacity_[arc_reverse_[arc]] += amount;
+  excess_[from] -= amount;
+  // Excess only accumulates from finite (clamped) capacities, but saturate to
+  // be safe with very large weights.
+  excess_[to] = SaturatingAdd(excess_[to], amount);
+}
+
+GraphCut MinCutSolver::Solve(NodeId source_id, NodeId sink_id) {
+  const int64_t n = node_count_;
+  const int64_t source = int64_t{source_id};
+  const int64_t sink = int64_t{sink_id};
+
+  // Edges with weights at least as large as the sum of all other weights can
+  // never be part of a minimum cut unless every cut includes one, so clamp
+  // them to keep flow arithmetic from overflowing.
+  int64_t total_weight = 0;
+  for (int64_t weight : edge_weight_) {
+    if (weight < std::numeric_limits<int64_t>::max()) {
+      total_weight = std::min(std::numeric_limits<int64_t>::max() / 2,
+                              SaturatingAdd(total_weight, weight));
+    }
+  }
+  const int64_t max_capacity = total_weight + 1;
+  for (int64_t e = 0; e < edge_weight_.size(); ++e) {
+    int64_t arc = edge_arc_[e];
+    arc_capacity_[arc] = std::min(edge_weight_[e], max_capacity);
+    arc_capacity_[arc_reverse_[arc]] = 0;
+  }
+
+  // Initialize heights to the BFS distance to the sink in the residual graph.
+  // Nodes which cannot reach the sink start at n + 1, above the source, so
+  // their excess is returned to the source.
+  std::fill(excess_.begin(), excess_.end(), 0);
+  std::fill(height_.begin(), height_.end(), n + 1);
+  std::fill(height_count_.begin(), height_count_.end(), 0);
+  for (std::vector<int64_t>& bucket : active_) {
+    bucket.clear();
+  }
+  max_active_height_ = -1;
+  height_[sink] = 0;
+  std::deque<int64_t> queue = {sink};
+  while (!queue.empty()) {
+    int64_t node = queue.front();
+    queue.pop_front();
+    for (int64_t arc = first_arc_[node]; arc < first_arc_[node + 1]; ++arc) {
+      // The reverse arc points into `node`; it is residual iff its capacity is
+      // non-zero.
+      int64_t tail = arc_head_[arc];
+      if (tail != source && height_[tail] == n + 1 &&
+          arc_capacity_[arc_reverse_[arc]] > 0) {
+        height_[tail] = height_[node] + 1;
+        queue.push_back(tail);
+      }
+    }
+  }
+  height_[source] = n;
+  for (int64_t node = 0; node < n; ++node) {
+    ++height_count_[height_[node]];
+    current_arc_[node] = first_arc_[node];
+  }
+
+  // Saturate every arc leaving the source.
+  excess_[source] = std::numeric_limits<int64_t>::max();
+  for (int64_t arc = first_arc_[source]; arc < first_arc_[source + 1]; ++arc) {
+    int64_t to = arc_head_[arc];
+    bool was_active = excess_[to] > 0;
+    Push(source, arc);
+    if (!was_active && excess_[to] > 0 && to != sink && to != source) {
+      Activate(to);
+    }
+  }
+
+  // Repeatedly discharge the active node with the largest height.
+  while (max_active_height_ >= 0) {
+    std::vector<int64_t>& bucket = active_[max_active_height_];
+    if (bucket.empty()) {
+      --max_active_height_;
+      continue;
+    }
+    int64_t node = bucket.back();
+    bucket.pop_back();
+    if (height_[node] != max_active_height_ || excess_[node] == 0) {
+      // Stale entry.
+      continue;
+    }
+
+    while (excess_[node] > 0) {
+      if (current_arc_[node] == first_arc_[node + 1]) {
+        // No admissible arcs remain; relabel to one more than the lowest
+        // neighbor reachable through a residual arc.
+        int64_t old_height = height_[node];
+        int64_t new_height = 2 * n;
+        for (int64_t arc = first_arc_[node]; arc < first_arc_[node + 1];
+             ++arc) {
+          if (arc_capacity_[arc] > 0) {
+            new_height = std::min(new_height, height_[arc_head_[arc]] + 1);
+          }
+        }
+        SetHeight(node, new_height);
+        if (old_height < n && height_count_[old_height] == 0) {
+          // Gap heuristic: no node remains at `old_height`, so no node above
+          // it (and below the source) can reach the sink. Lift them all above
+          // the source.
+          for (int64_t other = 0; other < n; ++other) {
+            if (other != source && height_[other] > old_height &&
+                height_[other] < n + 1) {
+              SetHeight(other, n + 1);
+              if (other != node && excess_[other] > 0 && other != sink) {
+                Activate(other);
+              }
+            }
+          }
+        }
+        continue;
+      }
+      int64_t arc = current_arc_[node];
+      int64_t to = arc_head_[arc];
+      if (arc_capacity_[arc] > 0 && height_[node] == height_[to] + 1) {
+        bool was_active = excess_[to] > 0;
+        Push(node, arc);
+        if (!was_active && to != sink && to != source) {
+          Activate(to);
+        }
+      } else {
+        ++current_arc_[node];
+      }
+    }
+  }
+
+  // Walk the residual graph from the source. All reachable nodes form the
+  // source partition.
+  std::vector<bool> reachable_from_source(n, false);
+  reachable_from_source[source] = true;
+  queue = {source};
+  while (!queue.empty()) {
+    int64_t node = queue.front();
+    queue.pop_front();
+    for (int64_t arc = first_arc_[node]; arc < first_arc_[node + 1]; ++arc) {
+      int64_t to = arc_head_[arc];
+      if (arc_capacity_[arc] > 0 && !reachable_from_source[to]) {
+        reachable_from_source[to] = true;
+        queue.push_back(to);
+      }
+    }
+  }
+  XLS_CHECK(!reachable_from_source[sink]);
+
+  GraphCut min_cut;
+  min_cut.weight = 0;
+  for (int64_t node = 0; node < n; ++node) {
+    if (reachable_from_source[node]) {
+      min_cut.source_partition.push_back(NodeId(node));
+    } else {
+      min_cut.sink_partition.push_back(NodeId(node));
+    }
+  }
+  for (int64_t e = 0; e < edge_weight_.size(); ++e) {
+    int64_t forward = edge_arc_[e];
+    if (!reachable_from_source[arc_head_[forward]] &&
+        reachable_from_source[arc_head_[arc_reverse_[forward]]]) {
+      min_cut.weight = SaturatingAdd(min_cut.weight, edge_weight_[e]);
+    }
+  }
+  return min_cut;
+}
+
+GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
+  GraphCut min_cut = MinCutSolver(graph).Solve(source, sink);
+  XLS_VLOG_LINES(4, min_cut.ToString(graph));
+  return min_cut;
+}
+
 }  // namespace min_cut
 }  // namespace xls
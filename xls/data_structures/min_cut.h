@@ -15,6 +15,7 @@
 #ifndef XLS_DATA_STRUCTURES_MIN_CUT_H_
 #define XLS_DATA_STRUCTURES_MIN_CUT_H_
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -95,13 +96,88 @@ struct GraphCut {
   std::string ToString(const Graph& graph) const;
 };
 
+// Computes minimum cuts using the highest-label push-relabel maximum flow
+// algorithm with the gap heuristic, which has a worst case run time of
+// O(V^2 * sqrt(E)).
+//
+// The graph is copied into a compact residual representation in which the arcs
+// leaving each node are stored contiguously (compressed sparse row layout).
+// The solver may be reused: SetGraph rebuilds the representation for a new
+// graph reusing the previously allocated storage, and SetEdgeWeight changes the
+// weight of a single edge. Each call to Solve only resets the residual
+// capacities.
+//
+// The source partition of the returned cut is the set of nodes reachable from
+// the source in the residual graph of the maximum flow. This is the unique
+// minimum cut with the smallest source partition, so the result does not
+// depend on which maximum flow is found.
+class MinCutSolver {
+ public:
+  MinCutSolver() = default;
+  explicit MinCutSolver(const Graph& graph) { SetGraph(graph); }
+
+  // Replaces the graph being solved.
+  void SetGraph(const Graph& graph);
+
+  // Sets the weight of the given edge for subsequent calls to Solve.
+  void SetEdgeWeight(EdgeId edge, int64_t weight);
+
+  // Computes a minimum cut of the graph where source and sink are in different
+  // partitions.
+  GraphCut Solve(NodeId source, NodeId sink);
+
+ private:
+  // Pushes as much of the excess of `from` along `arc` as its residual
+  // capacity allows.
+  void Push(int64_t from, int64_t arc);
+
+  // Sets the height of the given node, maintaining the per-height counts and
+  // resetting the node's current arc.
+  void SetHeight(int64_t node, int64_t height);
+
+  // Makes the node active (if it has excess) at its current height.
+  void Activate(int64_t node);
+
+  int64_t node_count_ = 0;
+
+  // The arcs leaving node `n` are the indices [first_arc_[n],
+  // first_arc_[n + 1]). Each edge of the input graph corresponds to a forward
+  // and a backward arc; arc_reverse_ holds the index of the other arc of the
+  // pair.
+  std::vector<int64_t> first_arc_;
+  std::vector<int64_t> arc_head_;
+  std::vector<int64_t> arc_reverse_;
+  std::vector<int64_t> arc_capacity_;
+
+  // Index of the forward arc and the weight of each edge, indexed by EdgeId.
+  std::vector<int64_t> edge_arc_;
+  std::vector<int64_t> edge_weight_;
+
+  // Per-node state of the push-relabel algorithm.
+  std::vector<int64_t> excess_;
+  std::vector<int64_t> height_;
+  std::vector<int64_t> current_arc_;
+
+  // Number of nodes at each height, and the active nodes at each height.
+  // Buckets may hold stale entries which are skipped when popped.
+  std::vector<int64_t> height_count_;
+  std::vector<std::vector<int64_t>> active_;
+  int64_t max_active_height_ = -1;
+};
+
 // Computes a minimum cut of the given graph where source and sink are in
 // different partitions. The cut is returned as a partitioning of the nodes of
-// the graph into two sets of nodes on either side of the cut. The min cut is
-// found via the Ford-Fulkerson method using Dinic's algorithm. This results in
-// a worst case run time of O(V^2 * E).
+// the graph into two sets of nodes on either side of the cut. Uses
+// MinCutSolver.
 GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink);
 
+// Computes the same cut as MinCutBetweenNodes via the Ford-Fulkerson method,
+// augmenting along a shortest path found by BFS each iteration (Edmonds-Karp).
+// This results in a worst case run time of O(V * E^2). Retained as a reference
+// implementation for testing and benchmarking.
+GraphCut AugmentingPathMinCutBetweenNodes(const Graph& graph, NodeId source,
+                                          NodeId sink);
+
 }  // namespace min_cut
 }  // namespace xls
 
@@ -14,10 +14,12 @@
 
 #include "xls/data_structures/min_cut.h"
 
+#include <cstdint>
 #include <limits>
 #include <random>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
@@ -359,6 +361,127 @@ TEST(MinCutTest, ResidualGraphTraversalTest) {
   EXPECT_EQ(min_cut.weight, 2);
 }
 
+TEST(MinCutTest, MatchesAugmentingPathImplementation) {
+  // The source partition is the unique minimal min cut, so both algorithms
+  // must produce exactly the same cut.
+  for (bool acyclic : {false, true}) {
+    for (int64_t layer_count = 5; layer_count < 20; layer_count += 3) {
+      for (int64_t nodes_in_layer = 5; nodes_in_layer < 20;
+           nodes_in_layer += 3) {
+        NodeId source;
+        NodeId sink;
+        Graph graph = MakeLargeGraph(acyclic, &source, &sink, layer_count,
+                                     nodes_in_layer);
+        GraphCut expected =
+            AugmentingPathMinCutBetweenNodes(graph, source, sink);
+        GraphCut min_cut = MinCutBetweenNodes(graph, source, sink);
+        EXPECT_EQ(min_cut.weight, expected.weight);
+        EXPECT_EQ(min_cut.source_partition, expected.source_partition);
+        EXPECT_EQ(min_cut.sink_partition, expected.sink_partition);
+      }
+    }
+  }
+}
+
+TEST(MinCutTest, SolverReusedAcrossWeightsAndGraphs) {
+  // Same diamond as DiamondGraph above.
+  Graph graph;
+  auto a = graph.AddNode("a");
+  auto b = graph.AddNode("b");
+  auto c = graph.AddNode("c");
+  auto d = graph.AddNode("d");
+  graph.AddEdge(a, b, 100);
+  EdgeId a_c = graph.AddEdge(a, c, 1);
+  EdgeId b_d = graph.AddEdge(b, d, 42);
+  graph.AddEdge(c, d, 1234);
+
+  MinCutSolver solver(graph);
+  GraphCut min_cut = solver.Solve(a, d);
+  EXPECT_EQ(min_cut.weight, 43);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b));
+
+  // Solving again gives the same result.
+  min_cut = solver.Solve(a, d);
+  EXPECT_EQ(min_cut.weight, 43);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b));
+
+  // Make the b->d edge expensive; the cut moves to a->b and c->d.
+  solver.SetEdgeWeight(b_d, 1000);
+  solver.SetEdgeWeight(a_c, 2000);
+  min_cut = solver.Solve(a, d);
+  EXPECT_EQ(min_cut.weight, 1334);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, c));
+  EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(b, d));
+
+  // Load a different graph into the same solver.
+  Graph other;
+  auto s = other.AddNode("s");
+  auto t = other.AddNode("t");
+  other.AddEdge(s, t, 42);
+  solver.SetGraph(other);
+  min_cut = solver.Solve(s, t);
+  EXPECT_EQ(min_cut.weight, 42);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(s));
+  EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(t));
+}
+
+TEST(MinCutTest, HugeWeights) {
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  Graph graph;
+  auto s = graph.AddNode("s");
+  auto a = graph.AddNode("a");
+  auto b = graph.AddNode("b");
+  auto t = graph.AddNode("t");
+  graph.AddEdge(s, a, kMax - 1);
+  graph.AddEdge(a, b, kMax - 2);
+  graph.AddEdge(b, t, 3);
+
+  // The sum of the weights overflows int64_t.
+  GraphCut min_cut = MinCutBetweenNodes(graph, s, t);
+  EXPECT_EQ(min_cut.weight, 3);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(s, a, b));
+  EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(t));
+}
+
+// Layered graphs like those produced when partitioning a pipeline stage.
+template <typename MinCutFn>
+void BM_MinCut(MinCutFn min_cut_fn, benchmark::State& state) {
+  NodeId source;
+  NodeId sink;
+  Graph graph = MakeLargeGraph(/*acyclic=*/true, &source, &sink,
+                               /*layer_count=*/state.range(0),
+                               /*nodes_in_layer=*/state.range(1));
+  for (auto _ : state) {
+    GraphCut min_cut = min_cut_fn(graph, source, sink);
+    benchmark::DoNotOptimize(min_cut);
+  }
+}
+void BM_MinCutPushRelabel(benchmark::State& state) {
+  BM_MinCut(MinCutBetweenNodes, state);
+}
+void BM_MinCutAugmentingPath(benchmark::State& state) {
+  BM_MinCut(AugmentingPathMinCutBetweenNodes, state);
+}
+void BM_MinCutPushRelabelReusedSolver(benchmark::State& state) {
+  MinCutSolver solver;
+  BM_MinCut(
+      [&](const Graph& graph, NodeId source, NodeId sink) {
+        solver.SetGraph(graph);
+        return solver.Solve(source, sink);
+      },
+      state);
+}
+BENCHMARK(BM_MinCutPushRelabel)->ArgPair(10, 10)->ArgPair(50, 50)->ArgPair(
+    100, 100);
+BENCHMARK(BM_MinCutAugmentingPath)
+    ->ArgPair(10, 10)
+    ->ArgPair(50, 50)
+    ->ArgPair(100, 100);
+BENCHMARK(BM_MinCutPushRelabelReusedSolver)
+    ->ArgPair(10, 10)
+    ->ArgPair(50, 50)
+    ->ArgPair(100, 100);
+
 }  // namespace
 }  // namespace min_cut
 }  // namespace xls
@@ -19,19 +19,24 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/op.h"
+#include "xls/ir/type.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/logical_effort.h"
 
@@ -213,6 +218,95 @@ absl::StatusOr<int64_t> CachingDelayEstimator::GetOperationDelayInPs(
   return delay;
 }
 
+namespace {
+
+// Appends a flattened description of the shape of `type` to `key`.
+void AppendTypeToKey(Type* type, std::vector<int64_t>* key) {
+  key->push_back(static_cast<int64_t>(type->kind()));
+  switch (type->kind()) {
+    case TypeKind::kBits:
+      key->push_back(type->AsBitsOrDie()->bit_count());
+      break;
+    case TypeKind::kArray:
+      key->push_back(type->AsArrayOrDie()->size());
+      AppendTypeToKey(type->AsArrayOrDie()->element_type(), key);
+      break;
+    case TypeKind::kTuple:
+      key->push_back(type->AsTupleOrDie()->size());
+      for (Type* element_type : type->AsTupleOrDie()->element_types()) {
+        AppendTypeToKey(element_type, key);
+      }
+      break;
+    case TypeKind::kToken:
+      break;
+  }
+}
+
+}  // namespace
+
+StructuralCachingDelayEstimator::StructuralCachingDelayEstimator(
+    std::string_view name, const DelayEstimator& cached)
+    : DelayEstimator(name), cached_(cached) {}
+
+/* static */ std::optional<StructuralCachingDelayEstimator::Key>
+StructuralCachingDelayEstimator::GetKey(Node* node) {
+  switch (node->op()) {
+    case Op::kCountedFor:
+    case Op::kDynamicCountedFor:
+    case Op::kInvoke:
+    case Op::kMap:
+      return std::nullopt;
+    default:
+      break;
+  }
+  Key key;
+  key.push_back(static_cast<int64_t>(node->op()));
+  AppendTypeToKey(node->GetType(), &key);
+  key.push_back(node->operand_count());
+  for (int64_t i = 0; i < node->operand_count(); ++i) {
+    Node* operand = node->operand(i);
+    // Index of the first operand which is the same node as this one.
+    int64_t alias = 0;
+    while (node->operand(alias) != operand) {
+      ++alias;
+    }
+    key.push_back(alias);
+    key.push_back(operand->Is<Literal>() ? 1 : 0);
+    AppendTypeToKey(operand->GetType(), &key);
+  }
+  return key;
+}
+
+absl::StatusOr<int64_t> StructuralCachingDelayEstimator::GetOperationDelayInPs(
+    Node* node) const {
+  std::optional<Key> key = GetKey(node);
+  if (!key.has_value()) {
+    return cached_.GetOperationDelayInPs(node);
+  }
+  Shard& shard = shards_[absl::HashOf(*key) % kShardCount];
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.delays.find(*key);
+    if (it != shard.delays.end()) {
+      return it->second;
+    }
+  }
+
+  XLS_ASSIGN_OR_RETURN(int64_t delay, cached_.GetOperationDelayInPs(node));
+  absl::WriterMutexLock lock(&shard.mutex);
+  shard.delays.emplace(*std::move(key), delay);
+  return delay;
+}
+
+int64_t StructuralCachingDelayEstimator::size() const {
+  int64_t size = 0;
+  for (const Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    size += shard.delays.size();
+  }
+  return size;
+}
+
 /* static */ absl::StatusOr<int64_t> DelayEstimator::GetLogicalEffortDelayInPs(
     Node* node, int64_t tau_in_ps) {
   XLS_ASSIGN_OR_RETURN(int64_t delay_in_tau, GetLogicalEffortDelayInTau(node));
@@ -15,9 +15,11 @@
 #ifndef XLS_DELAY_MODEL_DELAY_ESTIMATOR_H_
 #define XLS_DELAY_MODEL_DELAY_ESTIMATOR_H_
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -122,6 +124,49 @@ class CachingDelayEstimator : public DelayEstimator {
       ABSL_GUARDED_BY(cache_mutex_);
 };
 
+// Caches the delay of an underlying delay estimator keyed by the structure of
+// the node rather than by its identity. The key consists of the op, the result
+// type, the operand types, which operands alias one another and which operands
+// are literals. Nodes with identical structure in any function or package share
+// one cached delay, and entries do not go stale when nodes are replaced.
+//
+// The underlying estimator must compute delays only from these features, as
+// the generated delay models and logical-effort estimates do. Operations which
+// call other functions (e.g., invoke) depend on the callee and bypass the
+// cache, as do delays which could not be estimated.
+//
+// The cache is split into shards by key hash so that concurrent users rarely
+// contend on the same lock. This class is safe for concurrent access.
+class StructuralCachingDelayEstimator : public DelayEstimator {
+ public:
+  StructuralCachingDelayEstimator(std::string_view name,
+                                  const DelayEstimator& cached);
+
+  ~StructuralCachingDelayEstimator() override = default;
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override;
+
+  // Returns the number of distinct structural keys held in the cache.
+  int64_t size() const;
+
+ private:
+  static constexpr int64_t kShardCount = 16;
+
+  using Key = std::vector<int64_t>;
+
+  struct Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<Key, int64_t> delays ABSL_GUARDED_BY(mutex);
+  };
+
+  // Returns the structural key of `node`, or std::nullopt if the delay of the
+  // node may depend on more than its structure.
+  static std::optional<Key> GetKey(Node* node);
+
+  const DelayEstimator& cached_;
+  mutable std::array<Shard, kShardCount> shards_;
+};
+
 enum class DelayEstimatorPrecedence {
   kLow = 1,
   kMedium = 2,
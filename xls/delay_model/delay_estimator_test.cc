@@ -14,6 +14,7 @@
 
 #include "xls/delay_model/delay_estimator.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string_view>
@@ -150,6 +151,83 @@ TEST_F(DelayEstimatorTest, CachingDelayEstimator) {
   EXPECT_THAT(caching.GetNodeDelay(f->return_value()), 1);
 }
 
+// A test delay estimator that returns the node's bit count and counts how many
+// times it was queried.
+class CountingDelayEstimator : public DelayEstimator {
+ public:
+  CountingDelayEstimator() : DelayEstimator("counting") {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    ++query_count_;
+    return node->GetType()->GetFlatBitCount();
+  }
+
+  int64_t query_count() const { return query_count_; }
+
+ private:
+  mutable std::atomic<int64_t> query_count_ = 0;
+};
+
+TEST_F(DelayEstimatorTest, StructuralCachingDelayEstimator) {
+  CountingDelayEstimator counting;
+  StructuralCachingDelayEstimator caching("caching", counting);
+
+  auto p1 = CreatePackage();
+  FunctionBuilder fb1("f1", p1.get());
+  BValue x1 = fb1.Param("x", p1->GetBitsType(8));
+  BValue y1 = fb1.Param("y", p1->GetBitsType(8));
+  BValue add_xy = fb1.Add(x1, y1);
+  BValue add_xx = fb1.Add(x1, x1);
+  BValue add_lit = fb1.Add(x1, fb1.Literal(UBits(1, 8)));
+  XLS_ASSERT_OK(fb1.Build().status());
+
+  auto p2 = CreatePackage();
+  FunctionBuilder fb2("f2", p2.get());
+  BValue a2 = fb2.Param("a", p2->GetBitsType(8));
+  BValue b2 = fb2.Param("b", p2->GetBitsType(8));
+  BValue c2 = fb2.Param("c", p2->GetBitsType(16));
+  BValue add_ab = fb2.Add(a2, b2);
+  BValue add_cc = fb2.Add(c2, c2);
+  XLS_ASSERT_OK(fb2.Build().status());
+
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_xy.node()), IsOkAndHolds(8));
+  EXPECT_EQ(counting.query_count(), 1);
+
+  // Same structure in a different package hits the cache.
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_ab.node()), IsOkAndHolds(8));
+  EXPECT_EQ(counting.query_count(), 1);
+
+  // Aliased operands, literal operands and different widths are distinct keys.
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_xx.node()), IsOkAndHolds(8));
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_lit.node()), IsOkAndHolds(8));
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_cc.node()), IsOkAndHolds(16));
+  EXPECT_EQ(counting.query_count(), 4);
+  EXPECT_EQ(caching.size(), 4);
+
+  EXPECT_THAT(caching.GetOperationDelayInPs(add_xx.node()), IsOkAndHolds(8));
+  EXPECT_EQ(counting.query_count(), 4);
+}
+
+TEST_F(DelayEstimatorTest, StructuralCachingDelayEstimatorSkipsInvoke) {
+  CountingDelayEstimator counting;
+  StructuralCachingDelayEstimator caching("caching", counting);
+
+  auto p = CreatePackage();
+  FunctionBuilder callee_fb("callee", p.get());
+  callee_fb.Param("x", p->GetBitsType(8));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, callee_fb.Build());
+
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue invoke = fb.Invoke({x}, callee);
+  XLS_ASSERT_OK(fb.Build().status());
+
+  EXPECT_THAT(caching.GetOperationDelayInPs(invoke.node()), IsOkAndHolds(8));
+  EXPECT_THAT(caching.GetOperationDelayInPs(invoke.node()), IsOkAndHolds(8));
+  EXPECT_EQ(counting.query_count(), 2);
+  EXPECT_EQ(caching.size(), 0);
+}
+
 // A Delay Estimator that can only handle one kind of operation.
 class TestNodeMatchEstimator : public DelayEstimator {
  public:
@@ -163,12 +163,16 @@ absl::Status RunBuiltinSlice(const Bytecode& bytecode,
 
 absl::Status RunBuiltinUpdate(const Bytecode& bytecode,
                               InterpreterStack& stack) {
-  return RunTernaryBuiltin(
-      [](const InterpValue& array, const InterpValue& index,
-         const InterpValue& new_value) {
-        return array.Update(index, new_value);
-      },
-      stack);
+  // The array is taken off the stack so that, if nothing else refers to its
+  // elements, they can be updated in place.
+  XLS_RET_CHECK_GE(stack.size(), 3);
+  XLS_ASSIGN_OR_RETURN(InterpValue new_value, stack.Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue index, stack.Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue array, stack.Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue result,
+                       std::move(array).Update(index, new_value));
+  stack.Push(std::move(result));
+  return absl::OkStatus();
 }
 
 absl::Status RunBuiltinBitSlice(const Bytecode& bytecode,
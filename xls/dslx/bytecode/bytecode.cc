@@ -124,6 +124,9 @@ absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s) {
   if (s == "literal") {
     return Bytecode::Op::kLiteral;
   }
+  if (s == "move") {
+    return Bytecode::Op::kMove;
+  }
   if (s == "logical_and") {
     return Bytecode::Op::kLogicalAnd;
   }
@@ -257,6 +260,8 @@ std::string OpToString(Bytecode::Op op) {
       return "le";
     case Bytecode::Op::kLoad:
       return "load";
+    case Bytecode::Op::kMove:
+      return "move";
     case Bytecode::Op::kLt:
       return "lt";
     case Bytecode::Op::kLiteral:
@@ -477,6 +482,10 @@ DEF_UNARY_BUILDER(Swap);
   return Bytecode(std::move(span), Op::kLoad, slot_index);
 }
 
+/* static */ Bytecode Bytecode::MakeMove(Span span, SlotIndex slot_index) {
+  return Bytecode(std::move(span), Op::kMove, slot_index);
+}
+
 /* static */ Bytecode Bytecode::MakeMatchArm(Span span, MatchArmItem item) {
   return Bytecode(std::move(span), Op::kMatchArm, std::move(item));
 }
@@ -726,6 +735,113 @@ absl::StatusOr<std::unique_ptr<BytecodeFunction>> BytecodeFunction::Create(
       new BytecodeFunction(owner, source_fn, type_info, std::move(bytecodes)));
 }
 
+namespace {
+
+bool IsFusibleBinop(Bytecode::Op op) {
+  switch (op) {
+    case Bytecode::Op::kUAdd:
+    case Bytecode::Op::kSAdd:
+    case Bytecode::Op::kUSub:
+    case Bytecode::Op::kSSub:
+    case Bytecode::Op::kAnd:
+    case Bytecode::Op::kOr:
+    case Bytecode::Op::kXor:
+    case Bytecode::Op::kEq:
+    case Bytecode::Op::kNe:
+    case Bytecode::Op::kLt:
+    case Bytecode::Op::kLe:
+    case Bytecode::Op::kGt:
+    case Bytecode::Op::kGe:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsComparison(Bytecode::Op op) {
+  switch (op) {
+    case Bytecode::Op::kEq:
+    case Bytecode::Op::kNe:
+    case Bytecode::Op::kLt:
+    case Bytecode::Op::kLe:
+    case Bytecode::Op::kGt:
+    case Bytecode::Op::kGe:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the operand pushed by `bytecode` if it is a load or a literal.
+std::optional<FusedBinop::Operand> GetFusibleOperand(const Bytecode& bytecode) {
+  if (!bytecode.has_data()) {
+    return std::nullopt;
+  }
+  const Bytecode::Data& data = bytecode.data().value();
+  if (bytecode.op() == Bytecode::Op::kLoad &&
+      std::holds_alternative<Bytecode::SlotIndex>(data)) {
+    return std::get<Bytecode::SlotIndex>(data);
+  }
+  if (bytecode.op() == Bytecode::Op::kLiteral &&
+      std::holds_alternative<InterpValue>(data)) {
+    return &std::get<InterpValue>(data);
+  }
+  return std::nullopt;
+}
+
+// Returns the fused binop beginning at `pc`, if any. None of the bytecodes
+// folded in after the first can be a jump destination (only kJumpDest ops
+// are), so control can never enter the middle of a fused sequence.
+std::optional<FusedBinop> FuseBinopAt(absl::Span<const Bytecode> bytecodes,
+                                      int64_t pc) {
+  FusedBinop fused{.length = 0,
+                   .op = bytecodes[pc].op(),
+                   .op_offset = 0,
+                   .lhs = std::monostate(),
+                   .rhs = std::monostate(),
+                   .sink = FusedBinop::Sink::kPush};
+  int64_t i = pc;
+  if (i + 2 < bytecodes.size() && IsFusibleBinop(bytecodes[i + 2].op())) {
+    std::optional<FusedBinop::Operand> lhs = GetFusibleOperand(bytecodes[i]);
+    std::optional<FusedBinop::Operand> rhs =
+        GetFusibleOperand(bytecodes[i + 1]);
+    if (lhs.has_value() && rhs.has_value()) {
+      fused.lhs = *lhs;
+      fused.rhs = *rhs;
+      i += 2;
+    }
+  }
+  if (!IsFusibleBinop(bytecodes[i].op())) {
+    return std::nullopt;
+  }
+  fused.op = bytecodes[i].op();
+  fused.op_offset = i - pc;
+  ++i;
+
+  if (i < bytecodes.size()) {
+    const Bytecode& next = bytecodes[i];
+    if (next.op() == Bytecode::Op::kStore && next.slot_index().ok()) {
+      fused.sink = FusedBinop::Sink::kStore;
+      fused.store_slot = next.slot_index().value();
+      ++i;
+    } else if (next.op() == Bytecode::Op::kJumpRelIf &&
+               IsComparison(fused.op) && next.jump_target().ok()) {
+      fused.sink = FusedBinop::Sink::kJumpRelIf;
+      fused.jump_pc = i + next.jump_target().value().value();
+      ++i;
+    }
+  }
+
+  // A lone stack-to-stack binop gains nothing from fusion.
+  if (fused.op_offset == 0 && fused.sink == FusedBinop::Sink::kPush) {
+    return std::nullopt;
+  }
+  fused.length = i - pc;
+  return fused;
+}
+
+}  // namespace
+
 BytecodeFunction::BytecodeFunction(const Module* owner,
                                    const Function* source_fn,
                                    const TypeInfo* type_info,
@@ -733,7 +849,12 @@ BytecodeFunction::BytecodeFunction(const Module* owner,
     : owner_(owner),
       source_fn_(source_fn),
       type_info_(type_info),
-      bytecodes_(std::move(bytecodes)) {}
+      bytecodes_(std::move(bytecodes)) {
+  fused_binops_.reserve(bytecodes_.size());
+  for (int64_t pc = 0; pc < bytecodes_.size(); ++pc) {
+    fused_binops_.push_back(FuseBinopAt(bytecodes_, pc));
+  }
+}
 
 std::vector<Bytecode> BytecodeFunction::CloneBytecodes() const {
   // Create a modifiable copy of the bytecodes.
@@ -122,6 +122,9 @@ class Bytecode {
     // equivalent to the MatchArmItem (defined below) held in the optional data
     // member.
     kMatchArm,
+    // Like kLoad, but moves the value out of the slot instead of copying it;
+    // used for the last read of a slot, which then must not be read again.
+    kMove,
     // Multiplies the top two values on the stack.
     kUMul,
     kSMul,
@@ -191,7 +194,7 @@ class Bytecode {
   XLS_DEFINE_STRONG_INT_TYPE(NumElements, int64_t);
 
   // Indicates the index into which to store or from which to load a value. Used
-  // by kLoad and kStore opcodes.
+  // by kLoad, kMove and kStore opcodes.
   XLS_DEFINE_STRONG_INT_TYPE(SlotIndex, int64_t);
 
   // Data needed to resolve a potentially parametric Function invocation to
@@ -342,6 +345,7 @@ class Bytecode {
   static Bytecode MakeLoad(Span span, SlotIndex slot_index);
   static Bytecode MakeLogicalOr(Span span);
   static Bytecode MakeMatchArm(Span span, MatchArmItem item);
+  static Bytecode MakeMove(Span span, SlotIndex slot_index);
   static Bytecode MakePop(Span span);
   static Bytecode MakeRecv(Span span, ChannelData channel_data);
   static Bytecode MakeRecvNonBlocking(Span span, ChannelData channel_data);
@@ -410,6 +414,46 @@ class Bytecode {
 
 std::string OpToString(Bytecode::Op op);
 
+// A binary operation whose operands and result bypass the interpreter stack.
+// These are recognized over short runs of bytecode when a BytecodeFunction is
+// created -- e.g. `load; load; add; store` or `load; literal; lt; jump_rel_if`
+// -- and let the interpreter read operands from frame slots in place and
+// write the result straight to its destination, rather than copying each
+// value onto the stack and back off again.
+struct FusedBinop {
+  // Where an operand comes from: the stack (std::monostate), a frame slot, or
+  // a literal held in the data of the corresponding bytecode. Stack operands
+  // are laid out as for the unfused op (rhs at TOS0, lhs at TOS1).
+  using Operand =
+      std::variant<std::monostate, Bytecode::SlotIndex, const InterpValue*>;
+
+  // Where the result goes: pushed onto the stack, stored to a slot, or
+  // consumed as the condition of a relative jump.
+  enum class Sink {
+    kPush,
+    kStore,
+    kJumpRelIf,
+  };
+
+  // The number of bytecodes covered, starting at the PC of the first one.
+  int64_t length;
+
+  // The binary operation and its offset from the first covered bytecode.
+  Bytecode::Op op;
+  int64_t op_offset;
+
+  Operand lhs;
+  Operand rhs;
+
+  Sink sink;
+
+  // The destination slot, for Sink::kStore.
+  Bytecode::SlotIndex store_slot = Bytecode::SlotIndex(0);
+
+  // The absolute PC to jump to when the result is true, for Sink::kJumpRelIf.
+  int64_t jump_pc = 0;
+};
+
 // Holds all the bytecode implementing a function along with useful metadata.
 class BytecodeFunction {
  public:
@@ -428,6 +472,13 @@ class BytecodeFunction {
   const TypeInfo* type_info() const { return type_info_; }
   const std::vector<Bytecode>& bytecodes() const { return bytecodes_; }
 
+  // Returns the fused binop starting at `pc`, or nullptr if the bytecode at
+  // `pc` does not begin one.
+  const FusedBinop* fused_binop(int64_t pc) const {
+    const std::optional<FusedBinop>& fused = fused_binops_[pc];
+    return fused.has_value() ? &fused.value() : nullptr;
+  }
+
   // Creates and returns a [caller-owned] copy of the internal bytecodes.
   std::vector<Bytecode> CloneBytecodes() const;
 
@@ -439,6 +490,9 @@ class BytecodeFunction {
   const Function* source_fn_;
   const TypeInfo* type_info_;
   std::vector<Bytecode> bytecodes_;
+
+  // Indexed by PC; refers into `bytecodes_` for literal operands.
+  std::vector<std::optional<FusedBinop>> fused_binops_;
 };
 
 // Converts the given sequence of bytecodes to a more human-readable string,
@@ -20,6 +20,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/bytecode/bytecode_emitter.h"
 
 namespace xls::dslx {
@@ -31,6 +32,9 @@ absl::StatusOr<BytecodeFunction*> BytecodeCache::GetOrCreateBytecodeFunction(
     const Function* f, const TypeInfo* type_info,
     const std::optional<ParametricEnv>& caller_bindings) {
   Key key = std::make_tuple(f, type_info, caller_bindings);
+  // Emission does not reenter the cache, so it is done under the lock to avoid
+  // emitting the same function twice.
+  absl::MutexLock lock(&mutex_);
   if (!cache_.contains(key)) {
     XLS_ASSIGN_OR_RETURN(
         std::unique_ptr<BytecodeFunction> bf,
@@ -41,4 +45,13 @@ absl::StatusOr<BytecodeFunction*> BytecodeCache::GetOrCreateBytecodeFunction(
   return cache_.at(key).get();
 }
 
+void BytecodeCache::EraseModule(const Module* module) {
+  absl::MutexLock lock(&mutex_);
+  // Note: the function may belong to a module that has already been destroyed,
+  // so the owning module is determined via the (still live) type information.
+  absl::erase_if(cache_, [module](const auto& item) {
+    return std::get<const TypeInfo*>(item.first)->module() == module;
+  });
+}
+
 }  // namespace xls::dslx
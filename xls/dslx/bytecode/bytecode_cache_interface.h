@@ -36,6 +36,10 @@ class BytecodeCacheInterface {
   virtual absl::StatusOr<BytecodeFunction*> GetOrCreateBytecodeFunction(
       const Function* f, const TypeInfo* type_info,
       const std::optional<ParametricEnv>& caller_bindings) = 0;
+
+  // Drops all bytecode emitted against type information for the given module,
+  // e.g. because the module is being removed from its ImportData.
+  virtual void EraseModule(const Module* module) = 0;
 };
 
 }  // namespace xls::dslx
@@ -26,6 +26,7 @@
 
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -109,6 +110,77 @@ ExprToValueFormatDescriptor(const Expr* expr, const TypeInfo* type_info,
   return MakeValueFormatDescriptor(*maybe_type.value(), field_preference);
 }
 
+// Records, for the names bound by parameters, `let`s and loop headers in a
+// function, the loop depth at which each is bound and the depths at which it is
+// referenced.
+struct NameUses {
+  absl::flat_hash_map<const NameDef*, int64_t> binding_depth;
+  absl::flat_hash_map<const NameDef*, std::vector<int64_t>> ref_depths;
+
+  void Bind(const NameDefTree* tree, int64_t depth) {
+    for (const NameDef* name_def : tree->GetNameDefs()) {
+      binding_depth[name_def] = depth;
+    }
+  }
+
+  void Visit(const AstNode* node, int64_t depth) {
+    // Loop bodies (and the names bound for each trip) are one level deeper than
+    // the loop itself, since they are evaluated more than once.
+    if (auto* for_node = dynamic_cast<const For*>(node)) {
+      Visit(for_node->iterable(), depth);
+      Visit(for_node->init(), depth);
+      Bind(for_node->names(), depth + 1);
+      Visit(for_node->body(), depth + 1);
+      return;
+    }
+    // The splatted struct is emitted once per member it provides, so count it
+    // as referenced more than once.
+    if (auto* splat = dynamic_cast<const SplatStructInstance*>(node)) {
+      Visit(splat->splatted(), depth);
+    }
+    if (auto* let = dynamic_cast<const Let*>(node)) {
+      Bind(let->name_def_tree(), depth);
+    } else if (auto* name_ref = dynamic_cast<const NameRef*>(node);
+               name_ref != nullptr &&
+               std::holds_alternative<const NameDef*>(name_ref->name_def())) {
+      ref_depths[std::get<const NameDef*>(name_ref->name_def())].push_back(
+          depth);
+    }
+    for (const AstNode* child : node->GetChildren(/*want_types=*/true)) {
+      Visit(child, depth);
+    }
+  }
+};
+
+// Returns the aggregate-typed local names in `f` that are read exactly once,
+// from the loop depth at which they are bound. Each value stored in the slot of
+// such a name is read at most once, so that read can move it out of the slot,
+// letting e.g. `update()` on it happen in place.
+absl::flat_hash_set<const NameDef*> GetMovableNames(const Function* f,
+                                                    const TypeInfo* type_info) {
+  NameUses uses;
+  for (const Param* param : f->params()) {
+    uses.binding_depth[param->name_def()] = 0;
+  }
+  uses.Visit(f->body(), /*depth=*/0);
+
+  absl::flat_hash_set<const NameDef*> movable;
+  for (const auto& [name_def, depth] : uses.binding_depth) {
+    auto it = uses.ref_depths.find(name_def);
+    if (it == uses.ref_depths.end() || it->second.size() != 1 ||
+        it->second.front() != depth) {
+      continue;
+    }
+    std::optional<ConcreteType*> type = type_info->GetItem(name_def);
+    if (type.has_value() && (dynamic_cast<ArrayType*>(*type) != nullptr ||
+                             dynamic_cast<TupleType*>(*type) != nullptr ||
+                             dynamic_cast<StructType*>(*type) != nullptr)) {
+      movable.insert(name_def);
+    }
+  }
+  return movable;
+}
+
 }  // namespace
 
 BytecodeEmitter::BytecodeEmitter(
@@ -150,6 +222,7 @@ BytecodeEmitter::EmitProcNext(
     emitter.namedef_to_slot_[name_def] = emitter.next_slotno_++;
   }
   XLS_RETURN_IF_ERROR(emitter.Init(f));
+  emitter.movable_names_ = GetMovableNames(f, type_info);
   XLS_RETURN_IF_ERROR(f->body()->AcceptExpr(&emitter));
 
   return BytecodeFunction::Create(f->owner(), f, type_info,
@@ -1327,6 +1400,10 @@ absl::Status BytecodeEmitter::HandleNameRef(const NameRef* node) {
   XLS_ASSIGN_OR_RETURN(auto result, HandleNameRefInternal(node));
   if (std::holds_alternative<InterpValue>(result)) {
     Add(Bytecode::MakeLiteral(node->span(), std::get<InterpValue>(result)));
+  } else if (movable_names_.contains(
+                 std::get<const NameDef*>(node->name_def()))) {
+    Add(Bytecode::MakeMove(node->span(),
+                           std::get<Bytecode::SlotIndex>(result)));
   } else {
     Add(Bytecode::MakeLoad(node->span(),
                            std::get<Bytecode::SlotIndex>(result)));
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/dslx/bytecode/bytecode.h"
@@ -143,6 +144,9 @@ class BytecodeEmitter : public ExprVisitor {
   std::vector<Bytecode> bytecode_;
   absl::flat_hash_map<const NameDef*, int64_t> namedef_to_slot_;
   int64_t next_slotno_ = 0;
+  // Names whose (only) read moves the value out of its slot; see
+  // GetMovableNames().
+  absl::flat_hash_set<const NameDef*> movable_names_;
 };
 
 }  // namespace xls::dslx
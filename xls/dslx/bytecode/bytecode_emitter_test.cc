@@ -461,10 +461,10 @@ fn index_array() -> u32 {
 store 0 @ test.x:3:7-3:8
 literal [u32:3, u32:4, u32:5] @ test.x:4:23-4:32
 store 1 @ test.x:4:7-4:8
-load 0 @ test.x:6:3-6:4
+move 0 @ test.x:6:3-6:4
 literal u32:0 @ test.x:6:9-6:10
 index @ test.x:6:4-6:11
-load 1 @ test.x:6:14-6:15
+move 1 @ test.x:6:14-6:15
 literal u32:1 @ test.x:6:20-6:21
 index @ test.x:6:15-6:22
 uadd @ test.x:6:12-6:13)";
@@ -840,7 +840,7 @@ fn cast_array_to_bits() -> u32 {
   const std::string_view kWant =
       R"(literal [u8:12, u8:10, u8:15, u8:14] @ test.x:3:17-3:37
 store 0 @ test.x:3:7-3:8
-load 0 @ test.x:4:3-4:4
+move 0 @ test.x:4:3-4:4
 cast uN[32] @ test.x:4:3-4:11)";
   std::string got = absl::StrJoin(bf->bytecodes(), "\n",
                                   [](std::string* out, const Bytecode& b) {
@@ -1117,6 +1117,55 @@ fn main() -> u32 {
   }
 }
 
+// The loop accumulator is read exactly once per trip, so it is moved out of its
+// slot rather than copied, which lets `update()` modify it in place.
+TEST(BytecodeEmitterTest, ForMovesArrayAccumulator) {
+  constexpr std::string_view kProgram = R"(#[test]
+fn main() -> u32[4] {
+  for (i, accum) : (u32, u32[4]) in range(u32:0, u32:4) {
+    update(accum, i, i)
+  }(u32[4]:[0, 0, 0, 0])
+})";
+
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bf,
+                           EmitBytecodes(&import_data, kProgram, "main"));
+
+  EXPECT_EQ(BytecodesToString(bf->bytecodes(), /*source_locs=*/false),
+            R"(000 literal u32:0
+001 literal u32:4
+002 literal builtin:range
+003 call range(u32:0, u32:4) : {}
+004 store 0
+005 literal u32:0
+006 store 1
+007 literal [u32:0, u32:0, u32:0, u32:0]
+008 jump_dest
+009 load 1
+010 literal u32:4
+011 eq
+012 jump_rel_if +19
+013 load 0
+014 load 1
+015 index
+016 swap
+017 create_tuple 2
+018 expand_tuple
+019 store 2
+020 store 3
+021 move 3
+022 load 2
+023 load 2
+024 literal builtin:update
+025 call update(accum, i, i) : {}
+026 load 1
+027 literal u32:1
+028 uadd
+029 store 1
+030 jump_rel -22
+031 jump_dest)");
+}
+
 TEST(BytecodeEmitterTest, ForWithCover) {
   constexpr std::string_view kProgram = R"(
 struct SomeStruct {
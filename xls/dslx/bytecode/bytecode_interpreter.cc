@@ -99,9 +99,9 @@ BytecodeInterpreter::BytecodeInterpreter(
     ImportData* import_data, const BytecodeInterpreterOptions& options)
     : import_data_(import_data), options_(options) {}
 
-absl::Status BytecodeInterpreter::InitFrame(
-    BytecodeFunction* bf, const std::vector<InterpValue>& args,
-    const TypeInfo* type_info) {
+absl::Status BytecodeInterpreter::InitFrame(BytecodeFunction* bf,
+                                            std::vector<InterpValue> args,
+                                            const TypeInfo* type_info) {
   XLS_RET_CHECK(frames_.empty());
 
   // In "mission mode" we expect type_info to be non-null in the frame, but for
@@ -110,7 +110,7 @@ absl::Status BytecodeInterpreter::InitFrame(
     type_info = import_data_->GetRootTypeInfo(bf->owner()).value();
   }
   frames_.push_back(
-      Frame(bf, args, type_info, std::nullopt, /*initial_args=*/{}));
+      Frame(bf, std::move(args), type_info, std::nullopt, /*initial_args=*/{}));
   return absl::OkStatus();
 }
 
@@ -135,13 +135,25 @@ absl::Status BytecodeInterpreter::Run(bool* progress_made) {
       XLS_VLOG(3) << absl::StreamFormat(" - stack depth %d [%s]", stack_.size(),
                                         stack_.ToString());
       int64_t old_pc = frame->pc();
-      XLS_RETURN_IF_ERROR(EvalNextInstruction());
+      int64_t length = 1;
+      const FusedBinop* fused = options_.fuse_bytecodes()
+                                    ? frame->bf()->fused_binop(old_pc)
+                                    : nullptr;
+      bool ran_fused = false;
+      if (fused != nullptr) {
+        XLS_ASSIGN_OR_RETURN(ran_fused, EvalFusedBinop(*fused));
+      }
+      if (ran_fused) {
+        length = fused->length;
+      } else {
+        XLS_RETURN_IF_ERROR(EvalNextInstruction());
+      }
       XLS_VLOG(3) << absl::StreamFormat(" - stack depth %d [%s]", stack_.size(),
                                         stack_.ToString());
 
       if (bytecode.op() == Bytecode::Op::kCall) {
         frame = &frames_.back();
-      } else if (frame->pc() != old_pc + 1) {
+      } else if (frame->pc() != old_pc + length) {
         XLS_RET_CHECK(bytecodes.at(frame->pc()).op() == Bytecode::Op::kJumpDest)
             << "Jumping from PC " << old_pc << " to PC: " << frame->pc()
             << " bytecode: " << bytecodes.at(frame->pc()).ToString()
@@ -316,6 +328,10 @@ absl::Status BytecodeInterpreter::EvalNextInstruction() {
       XLS_RETURN_IF_ERROR(EvalMatchArm(bytecode));
       break;
     }
+    case Bytecode::Op::kMove: {
+      XLS_RETURN_IF_ERROR(EvalMove(bytecode));
+      break;
+    }
     case Bytecode::Op::kSMul: {
       XLS_RETURN_IF_ERROR(EvalMul(bytecode, /*is_signed=*/true));
       break;
@@ -421,6 +437,164 @@ absl::Status BytecodeInterpreter::EvalBinop(
   return absl::OkStatus();
 }
 
+namespace {
+
+// Evaluates a fusible binop (see FusedBinop) with the same semantics as the
+// corresponding Eval* method. Bits values of at most 64 bits are computed with
+// native integer arithmetic.
+absl::StatusOr<InterpValue> EvalFusibleBinop(Bytecode::Op op,
+                                             const InterpValue& lhs,
+                                             const InterpValue& rhs) {
+  if (lhs.IsBits() && lhs.tag() == rhs.tag()) {
+    const Bits& lhs_bits = lhs.GetBitsOrDie();
+    const Bits& rhs_bits = rhs.GetBitsOrDie();
+    const int64_t bit_count = lhs_bits.bit_count();
+    if (bit_count > 0 && bit_count <= 64 &&
+        rhs_bits.bit_count() == bit_count) {
+      const uint64_t mask =
+          bit_count == 64 ? ~uint64_t{0} : (uint64_t{1} << bit_count) - 1;
+      const uint64_t a = lhs_bits.bitmap().GetWord(0);
+      const uint64_t b = rhs_bits.bitmap().GetWord(0);
+      // Sign-extended views of the operands for signed comparisons.
+      const int64_t sa = static_cast<int64_t>(a << (64 - bit_count)) >>
+                         (64 - bit_count);
+      const int64_t sb = static_cast<int64_t>(b << (64 - bit_count)) >>
+                         (64 - bit_count);
+      const bool is_signed = lhs.IsSigned();
+      auto make_bits = [&](uint64_t value) {
+        return InterpValue::MakeBits(is_signed, UBits(value & mask, bit_count));
+      };
+      switch (op) {
+        case Bytecode::Op::kUAdd:
+        case Bytecode::Op::kSAdd:
+          return make_bits(a + b);
+        case Bytecode::Op::kUSub:
+        case Bytecode::Op::kSSub:
+          return make_bits(a - b);
+        case Bytecode::Op::kAnd:
+          return make_bits(a & b);
+        case Bytecode::Op::kOr:
+          return make_bits(a | b);
+        case Bytecode::Op::kXor:
+          return make_bits(a ^ b);
+        case Bytecode::Op::kEq:
+          return InterpValue::MakeBool(a == b);
+        case Bytecode::Op::kNe:
+          return InterpValue::MakeBool(a != b);
+        case Bytecode::Op::kLt:
+          return InterpValue::MakeBool(is_signed ? sa < sb : a < b);
+        case Bytecode::Op::kLe:
+          return InterpValue::MakeBool(is_signed ? sa <= sb : a <= b);
+        case Bytecode::Op::kGt:
+          return InterpValue::MakeBool(is_signed ? sa > sb : a > b);
+        case Bytecode::Op::kGe:
+          return InterpValue::MakeBool(is_signed ? sa >= sb : a >= b);
+        default:
+          break;
+      }
+    }
+  }
+
+  switch (op) {
+    case Bytecode::Op::kUAdd:
+    case Bytecode::Op::kSAdd:
+      return lhs.Add(rhs);
+    case Bytecode::Op::kUSub:
+    case Bytecode::Op::kSSub:
+      return lhs.Sub(rhs);
+    case Bytecode::Op::kAnd:
+      return lhs.BitwiseAnd(rhs);
+    case Bytecode::Op::kOr:
+      return lhs.BitwiseOr(rhs);
+    case Bytecode::Op::kXor:
+      return lhs.BitwiseXor(rhs);
+    case Bytecode::Op::kEq:
+      return InterpValue::MakeBool(lhs.Eq(rhs));
+    case Bytecode::Op::kNe:
+      return InterpValue::MakeBool(lhs.Ne(rhs));
+    case Bytecode::Op::kLt:
+      return lhs.Lt(rhs);
+    case Bytecode::Op::kLe:
+      return lhs.Le(rhs);
+    case Bytecode::Op::kGt:
+      return lhs.Gt(rhs);
+    case Bytecode::Op::kGe:
+      return lhs.Ge(rhs);
+    default:
+      return absl::InternalError(
+          absl::StrCat("Op is not a fusible binop: ", OpToString(op)));
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<bool> BytecodeInterpreter::EvalFusedBinop(
+    const FusedBinop& fused) {
+  Frame* frame = &frames_.back();
+  const std::vector<InterpValue>& slots = frame->slots();
+
+  // Rollover detection lives in EvalAdd/EvalSub.
+  if (options_.rollover_hook() != nullptr &&
+      (fused.op == Bytecode::Op::kUAdd || fused.op == Bytecode::Op::kSAdd ||
+       fused.op == Bytecode::Op::kUSub || fused.op == Bytecode::Op::kSSub)) {
+    return false;
+  }
+
+  // Resolves a slot or literal operand in place; stack operands are resolved
+  // below. Out-of-range slots take the unfused path so that they are reported
+  // by EvalLoad.
+  auto resolve = [&](const FusedBinop::Operand& operand,
+                     const InterpValue** value) {
+    if (const auto* slot = std::get_if<Bytecode::SlotIndex>(&operand)) {
+      if (slot->value() >= slots.size()) {
+        return false;
+      }
+      *value = &slots[slot->value()];
+    } else if (const auto* literal = std::get_if<const InterpValue*>(&operand)) {
+      *value = *literal;
+    }
+    return true;
+  };
+  const InterpValue* lhs = nullptr;
+  const InterpValue* rhs = nullptr;
+  if (!resolve(fused.lhs, &lhs) || !resolve(fused.rhs, &rhs)) {
+    return false;
+  }
+  if (lhs == nullptr && stack_.size() < 2) {
+    return false;
+  }
+
+  absl::StatusOr<InterpValue> result =
+      lhs == nullptr
+          ? EvalFusibleBinop(fused.op, stack_.PeekOrDie(1), stack_.PeekOrDie())
+          : EvalFusibleBinop(fused.op, *lhs, *rhs);
+  if (!result.ok()) {
+    // Report the error exactly as the unfused bytecodes would.
+    return false;
+  }
+  if (lhs == nullptr) {
+    XLS_RETURN_IF_ERROR(stack_.Pop().status());
+    XLS_RETURN_IF_ERROR(stack_.Pop().status());
+  }
+
+  switch (fused.sink) {
+    case FusedBinop::Sink::kPush:
+      stack_.Push(*std::move(result));
+      break;
+    case FusedBinop::Sink::kStore:
+      frame->StoreSlot(fused.store_slot, *std::move(result));
+      break;
+    case FusedBinop::Sink::kJumpRelIf:
+      if (result->IsTrue()) {
+        frame->set_pc(fused.jump_pc);
+        return true;
+      }
+      break;
+  }
+  frame->set_pc(frame->pc() + fused.length);
+  return true;
+}
+
 absl::Status BytecodeInterpreter::EvalAdd(const Bytecode& bytecode,
                                           bool is_signed) {
   return EvalBinop([&](const InterpValue& lhs,
@@ -835,6 +1009,20 @@ absl::Status BytecodeInterpreter::EvalLoad(const Bytecode& bytecode) {
   return absl::OkStatus();
 }
 
+absl::Status BytecodeInterpreter::EvalMove(const Bytecode& bytecode) {
+  XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, bytecode.slot_index());
+  if (frames_.back().slots().size() <= slot.value()) {
+    return absl::InternalError(absl::StrFormat(
+        "Attempted to access local data in slot %d, which is out of range.",
+        slot.value()));
+  }
+  // The slot is dead after this; leave a placeholder behind (as StoreSlot()
+  // does for slots that are never stored) so that it still holds a valid value.
+  stack_.Push(std::exchange(frames_.back().slots().at(slot.value()),
+                            InterpValue::MakeToken()));
+  return absl::OkStatus();
+}
+
 absl::Status BytecodeInterpreter::EvalLogicalAnd(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue rhs, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue lhs, Pop());
@@ -1626,21 +1814,25 @@ absl::StatusOr<ProcRunResult> ProcInstance::Run() {
   absl::Status result_status = interpreter_->Run(&progress_made);
 
   if (result_status.ok()) {
-    InterpValue result_value = interpreter_->stack_.PeekOrDie();
+    XLS_ASSIGN_OR_RETURN(InterpValue result_value, interpreter_->stack_.Pop());
     // If we're starting from next fn top, then set [non-member] args for the
     // next go-around.
     // Don't forget to add the [implicit] token!
     // If we get an empty tuple and the proc has no recurrent state, then don't
     // add it.
-    if (next_args_.size() == proc_->members().size() + 2) {
-      next_args_[proc_->members().size() + 1] = result_value;
+    //
+    // The new state is moved into the next activation's frame rather than
+    // copied so that, e.g., array-typed state can be updated in place.
+    std::vector<InterpValue> args = next_args_;
+    if (args.size() == proc_->members().size() + 2) {
+      args[proc_->members().size() + 1] = std::move(result_value);
     } else {
       XLS_QCHECK(result_value.IsTuple() &&
                  result_value.GetLength().value() == 0);
     }
 
-    XLS_RETURN_IF_ERROR(interpreter_->InitFrame(next_fn_.get(), next_args_,
-                                                type_info_));
+    XLS_RETURN_IF_ERROR(
+        interpreter_->InitFrame(next_fn_.get(), std::move(args), type_info_));
     return ProcRunResult{.execution_state = ProcExecutionState::kCompleted,
                          .blocked_channel_name = std::nullopt,
                          .progress_made = progress_made};
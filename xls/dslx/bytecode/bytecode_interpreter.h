@@ -63,8 +63,7 @@ class BytecodeInterpreter {
 
   virtual ~BytecodeInterpreter() = default;
 
-  absl::Status InitFrame(BytecodeFunction* bf,
-                         const std::vector<InterpValue>& args,
+  absl::Status InitFrame(BytecodeFunction* bf, std::vector<InterpValue> args,
                          const TypeInfo* type_info);
 
   // Helper for converting a trace format string to its result given a stack
@@ -105,6 +104,12 @@ class BytecodeInterpreter {
   // when the PC is already pointing to the end of the bytecode.
   absl::Status EvalNextInstruction();
 
+  // Runs the fused binop starting at the current PC in place of the bytecodes
+  // it covers and advances the PC past them. Returns false, having run
+  // nothing, if the fused form does not apply to the current operands (in
+  // which case the bytecodes should be run one at a time).
+  absl::StatusOr<bool> EvalFusedBinop(const FusedBinop& fused);
+
   absl::Status EvalAdd(const Bytecode& bytecode, bool is_signed);
   absl::Status EvalSub(const Bytecode& bytecode, bool is_signed);
   absl::Status EvalMul(const Bytecode& bytecode, bool is_signed);
@@ -133,6 +138,7 @@ class BytecodeInterpreter {
   absl::Status EvalLogicalOr(const Bytecode& bytecode);
   absl::Status EvalLt(const Bytecode& bytecode);
   absl::Status EvalMatchArm(const Bytecode& bytecode);
+  absl::Status EvalMove(const Bytecode& bytecode);
   absl::Status EvalMod(const Bytecode& bytecode);
   absl::Status EvalNe(const Bytecode& bytecode);
   absl::Status EvalNegate(const Bytecode& bytecode);
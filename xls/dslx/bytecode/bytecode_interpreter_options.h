@@ -87,6 +87,14 @@ class BytecodeInterpreterOptions {
     return validate_final_stack_depth_;
   }
 
+  // Whether to run recognized runs of bytecode (see FusedBinop) as single
+  // fused operations. This only affects performance, not results.
+  BytecodeInterpreterOptions& fuse_bytecodes(bool value) {
+    fuse_bytecodes_ = value;
+    return *this;
+  }
+  bool fuse_bytecodes() const { return fuse_bytecodes_; }
+
   // The format preference to use when one is not otherwise specified. This is
   // used for `{}` in `trace_fmt`, in `assert_eq` messages, with the
   // `trace_channels` options and elsewhere.
@@ -103,6 +111,7 @@ class BytecodeInterpreterOptions {
   bool trace_channels_ = false;
   std::optional<int64_t> max_ticks_;
   bool validate_final_stack_depth_ = true;
+  bool fuse_bytecodes_ = true;
   FormatPreference format_preference_ = FormatPreference::kDefault;
 };
 
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <ios>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -768,6 +769,77 @@ fn do_xor() -> u32 {
   EXPECT_EQ(int_val, 0xffff0000);
 }
 
+TEST(BytecodeInterpreterTest, FusedLoadLoadAddStore) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(1)));
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kUAdd);
+  bytecodes.push_back(Bytecode::MakeStore(kFakeSpan, Bytecode::SlotIndex(2)));
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(2)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto bfunc,
+      BytecodeFunction::Create(/*owner=*/nullptr, /*source_fn=*/nullptr,
+                               /*type_info=*/nullptr, std::move(bytecodes)));
+
+  const FusedBinop* fused = bfunc->fused_binop(0);
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->length, 4);
+  EXPECT_EQ(fused->op, Bytecode::Op::kUAdd);
+  EXPECT_EQ(fused->sink, FusedBinop::Sink::kStore);
+  EXPECT_EQ(bfunc->fused_binop(4), nullptr);
+
+  for (bool fuse : {false, true}) {
+    BytecodeInterpreterOptions options;
+    options.fuse_bytecodes(fuse);
+    EXPECT_THAT(BytecodeInterpreter::Interpret(
+                    /*import_data=*/nullptr, bfunc.get(),
+                    {InterpValue::MakeU32(0xffffffff), InterpValue::MakeU32(3)},
+                    options),
+                IsOkAndHolds(InterpValue::MakeU32(2)));
+  }
+}
+
+TEST(BytecodeInterpreterTest, FusedBinopsMatchUnfused) {
+  constexpr std::string_view kProgram = R"(
+fn main(a: u8, b: s8, c: u64, d: s64, e: u128)
+    -> (u8, s8, u64, s64, u128, bool) {
+  let r0 = for (i, acc): (u8, u8) in range(u8:0, u8:8) {
+    let t = acc + a;
+    if t < (b as u8) { t - i } else { t ^ a }
+  }(u8:0);
+  let r1 = if b < s8:0 { b - s8:1 } else { b + b };
+  let c2 = c + c;
+  let r2 = (c & u64:0xff) | (c ^ c2);
+  let r3 = if d >= s64:-5 { d - s64:7 } else { d + s64:3 };
+  let r4 = if e > u128:1 { e + e - u128:1 } else { e | u128:2 };
+  let r5 = (a == u8:3) || ((c != c2) && (d <= s64:0));
+  (r0, r1, r2, r3, r4, r5)
+})";
+
+  std::vector<std::vector<InterpValue>> arg_sets = {
+      {InterpValue::MakeUBits(8, 0), InterpValue::MakeSBits(8, 0),
+       InterpValue::MakeU64(0), InterpValue::MakeSBits(64, 0),
+       InterpValue::MakeUBits(128, 0)},
+      {InterpValue::MakeUBits(8, 3), InterpValue::MakeSBits(8, -128),
+       InterpValue::MakeU64(0xffffffffffffffff),
+       InterpValue::MakeSBits(64, -5), InterpValue::MakeUBits(128, 1)},
+      {InterpValue::MakeUBits(8, 255), InterpValue::MakeSBits(8, 127),
+       InterpValue::MakeU64(0x8000000000000000),
+       InterpValue::MakeSBits(64, std::numeric_limits<int64_t>::min()),
+       InterpValue::MakeUBits(128, 42)},
+  };
+  for (const std::vector<InterpValue>& args : arg_sets) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        InterpValue unfused,
+        Interpret(kProgram, "main", args,
+                  BytecodeInterpreterOptions().fuse_bytecodes(false)));
+    XLS_ASSERT_OK_AND_ASSIGN(InterpValue fused,
+                             Interpret(kProgram, "main", args));
+    EXPECT_EQ(fused, unfused) << fused.ToString() << " vs "
+                              << unfused.ToString();
+  }
+}
+
 TEST(BytecodeInterpreterTest, Unops) {
   constexpr std::string_view kProgram = R"(
 fn unops() -> s32 {
@@ -1274,6 +1346,23 @@ fn main() -> u32 {
   EXPECT_EQ(int_value, 0xdeadbeef);
 }
 
+// Array accumulators are updated in place once they are moved out of their
+// slot; values that are still referenced elsewhere must be left untouched.
+TEST(BytecodeInterpreterTest, BuiltinUpdateLeavesSharedArraysIntact) {
+  constexpr std::string_view kProgram = R"(
+fn main() -> (u32[4], u32[4]) {
+  let a = u32[4]:[0, 0, 0, 0];
+  let b = for (i, accum) : (u32, u32[4]) in range(u32:0, u32:4) {
+    update(accum, i, i + u32:1)
+  }(a);
+  (a, b)
+})";
+
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue value, Interpret(kProgram, "main"));
+  EXPECT_EQ(value.ToString(),
+            "([u32:0, u32:0, u32:0, u32:0], [u32:1, u32:2, u32:3, u32:4])");
+}
+
 TEST(BytecodeInterpreterTest, BuiltinClz) {
   constexpr std::string_view kProgram = R"(
 fn main() -> u32 {
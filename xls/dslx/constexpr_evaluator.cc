@@ -633,6 +633,16 @@ absl::Status ConstexprEvaluator::InterpretExpr(const Expr* expr) {
       env, MakeConstexprEnv(import_data_, type_info_, warning_collector_, expr,
                             bindings_));
 
+  // The value only depends on the expression and its environment, so reuse
+  // the result of any identical evaluation, e.g. from another instantiation of
+  // the enclosing parametric function or proc.
+  if (std::optional<InterpValue> memoized =
+          type_info_->GetConstExprEvaluation(expr, env);
+      memoized.has_value()) {
+    type_info_->NoteConstExpr(expr, *std::move(memoized));
+    return absl::OkStatus();
+  }
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bf,
                        BytecodeEmitter::EmitExpression(import_data_, type_info_,
                                                        expr, env, bindings_));
@@ -651,6 +661,8 @@ absl::Status ConstexprEvaluator::InterpretExpr(const Expr* expr) {
     }
   }
   type_info_->NoteConstExpr(expr, constexpr_value);
+  type_info_->NoteConstExprEvaluation(expr, std::move(env),
+                                      std::move(constexpr_value));
 
   return absl::OkStatus();
 }
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
@@ -566,5 +567,52 @@ fn main() -> u32 {
   EXPECT_EQ(value.GetBitValueViaSign().value(), 5);
 }
 
+// Evaluations are memoized in the root type info by expression and
+// environment, and reused from any type info derived from it.
+TEST(ConstexprEvaluatorTest, ReusesMemoizedEvaluation) {
+  constexpr std::string_view kProgram = R"(
+fn main() -> u32 {
+  u32:2 * u32:3
+}
+)";
+
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           tm.module->GetMemberOrError<Function>("main"));
+  Expr* expr = GetSingleBodyExpr(f);
+  ASSERT_FALSE(tm.type_info->IsKnownConstExpr(expr));
+
+  // Plant a (deliberately wrong) value for the empty environment; evaluating
+  // in a derived type info must pick it up rather than reinterpret.
+  tm.type_info->NoteConstExprEvaluation(expr, /*env=*/{},
+                                        InterpValue::MakeU32(42));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * derived,
+      import_data.type_info_owner().New(tm.module, tm.type_info));
+  WarningCollector warnings(kAllWarningsSet);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue value,
+      ConstexprEvaluator::EvaluateToValue(&import_data, derived, &warnings,
+                                          ParametricEnv(), expr));
+  EXPECT_EQ(value, InterpValue::MakeU32(42));
+
+  // A different environment is evaluated afresh, and noted for reuse.
+  const absl::flat_hash_map<std::string, InterpValue> env = {
+      {"N", InterpValue::MakeU32(1)}};
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * other_derived,
+      import_data.type_info_owner().New(tm.module, tm.type_info));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      value, ConstexprEvaluator::EvaluateToValue(&import_data, other_derived,
+                                                 &warnings, ParametricEnv(env),
+                                                 expr));
+  EXPECT_EQ(value, InterpValue::MakeU32(6));
+  EXPECT_EQ(tm.type_info->GetConstExprEvaluation(expr, env),
+            InterpValue::MakeU32(6));
+}
+
 }  // namespace
 }  // namespace xls::dslx
@@ -35,6 +35,14 @@ ImportData CreateImportData(
     absl::Span<const std::filesystem::path> additional_search_paths,
     WarningKindSet warnings);
 
+// As above, but heap allocates the result, for clients that keep the
+// ImportData alive across many uses (the bytecode cache refers back to it, so
+// the result must not be moved).
+std::unique_ptr<ImportData> CreateImportDataPtr(
+    const std::filesystem::path& stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths,
+    WarningKindSet warnings);
+
 // Creates an ImportData with reasonable defaults (standard path to the stdlib
 // and no additional search paths).
 ImportData CreateImportDataForTest();
@@ -14,7 +14,11 @@
 
 #include "xls/dslx/frontend/module.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>  // NOLINT
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -47,6 +51,32 @@ Module::Module(std::string name, std::optional<std::filesystem::path> fs_path)
 
 Module::~Module() {
   XLS_VLOG(3) << "Destroying module \"" << name_ << "\" @ " << this;
+  for (AstNode* node : nodes_) {
+    node->~AstNode();
+  }
+}
+
+void* Module::AllocateNode(size_t size, size_t alignment) {
+  // Large enough that even big (e.g. generated) modules only need a modest
+  // number of blocks.
+  constexpr size_t kArenaBlockSize = 64 * 1024;
+  size_t padding = (alignment - reinterpret_cast<uintptr_t>(arena_next_) %
+                                    alignment) %
+                   alignment;
+  if (arena_next_ == nullptr || padding + size > arena_remaining_) {
+    // Blocks come from operator new[] so they are suitably aligned for any
+    // node type.
+    size_t block_size = std::max(kArenaBlockSize, size);
+    arena_blocks_.push_back(
+        std::unique_ptr<std::byte[]>(new std::byte[block_size]));
+    arena_next_ = arena_blocks_.back().get();
+    arena_remaining_ = block_size;
+    padding = 0;
+  }
+  void* result = arena_next_ + padding;
+  arena_next_ += padding + size;
+  arena_remaining_ -= padding + size;
+  return result;
 }
 
 std::string Module::ToString() const {
@@ -70,7 +100,7 @@ const AstNode* Module::FindNode(AstNodeKind kind, const Span& target) const {
   for (const auto& node : nodes_) {
     if (node->kind() == kind && node->GetSpan().has_value() &&
         node->GetSpan().value() == target) {
-      return node.get();
+      return node;
     }
   }
   return nullptr;
@@ -80,7 +110,7 @@ std::vector<const AstNode*> Module::FindIntercepting(const Pos& target) const {
   std::vector<const AstNode*> found;
   for (const auto& node : nodes_) {
     if (node->GetSpan().has_value() && node->GetSpan()->Contains(target)) {
-      found.push_back(node.get());
+      found.push_back(node);
     }
   }
   return found;
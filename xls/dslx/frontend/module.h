@@ -15,9 +15,11 @@
 #ifndef XLS_DSLX_FRONTEND_MODULE_H_
 #define XLS_DSLX_FRONTEND_MODULE_H_
 
+#include <cstddef>
 #include <filesystem>  // NOLINT
 #include <functional>
 #include <memory>
+#include <new>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -138,6 +140,9 @@ class Module : public AstNode {
 
   absl::Span<ModuleMember const> top() const { return top_; }
 
+  // Returns the AST nodes owned by this module, in creation order.
+  absl::Span<AstNode* const> nodes() const { return nodes_; }
+
   // Finds the first top-level member in top() with the given "target" name as
   // an identifier.
   std::optional<ModuleMember*> FindMemberWithName(std::string_view target);
@@ -197,14 +202,17 @@ class Module : public AstNode {
  private:
   template <typename T, typename... Args>
   T* MakeInternal(Args&&... args) {
-    std::unique_ptr<T> node =
-        std::make_unique<T>(this, std::forward<Args>(args)...);
-    T* ptr = node.get();
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    T* ptr = new (AllocateNode(sizeof(T), alignof(T)))
+        T(this, std::forward<Args>(args)...);
     ptr->SetParentage();
-    nodes_.push_back(std::move(node));
+    nodes_.push_back(ptr);
     return ptr;
   }
 
+  // Returns uninitialized storage for a node from the arena blocks below.
+  void* AllocateNode(size_t size, size_t alignment);
+
   // Returns all of the elements of top_ that have the given variant type T.
   template <typename T>
   std::vector<T*> GetTopWithT() const {
@@ -238,7 +246,14 @@ class Module : public AstNode {
   std::optional<std::filesystem::path> fs_path_;
 
   std::vector<ModuleMember> top_;  // Top-level members of this module.
-  std::vector<std::unique_ptr<AstNode>> nodes_;  // Lifetime-owned AST nodes.
+
+  // Lifetime-owned AST nodes, in creation order. They are constructed in place
+  // in `arena_blocks_` (rather than being allocated one by one) and destroyed
+  // by ~Module.
+  std::vector<AstNode*> nodes_;
+  std::vector<std::unique_ptr<std::byte[]>> arena_blocks_;
+  std::byte* arena_next_ = nullptr;
+  size_t arena_remaining_ = 0;
 
   // Map of top-level module member name to the member itself.
   absl::flat_hash_map<std::string, ModuleMember> top_by_name_;
@@ -431,7 +431,7 @@ Parser::ParseAttribute(absl::flat_hash_map<std::string, Function*>* name_to_fn,
   XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kOBrack));
   XLS_ASSIGN_OR_RETURN(Token directive_tok,
                        PopTokenOrError(TokenKind::kIdentifier));
-  const std::string& directive_name = directive_tok.GetStringValue();
+  std::string_view directive_name = directive_tok.GetStringValue();
 
   if (directive_name == "test") {
     XLS_ASSIGN_OR_RETURN(Token cbrack, PopTokenOrError(TokenKind::kCBrack));
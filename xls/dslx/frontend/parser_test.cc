@@ -14,6 +14,7 @@
 
 #include "xls/dslx/frontend/parser.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,7 +29,9 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "benchmark/benchmark.h"
 #include "xls/common/casts.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/command_line_utils.h"
@@ -2013,4 +2016,38 @@ fn will_fail(x:u32) -> u32 {
       << module_or.status();
 }
 
+// Parses a generated, table-driven module (the kind of input produced by e.g.
+// proto_to_dslx) and reports throughput in bytes per second.
+void BM_ParseGeneratedModule(benchmark::State& state) {
+  std::string program;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    absl::StrAppendFormat(&program, R"(
+pub struct Entry%d { key: u32, value: u64, valid: bool }
+pub const TABLE_%d = Entry%d[4]:[
+  Entry%d { key: u32:0x%x, value: u64:%d, valid: true },
+  Entry%d { key: u32:0x%x, value: u64:%d, valid: false },
+  Entry%d { key: u32:0x%x, value: u64:%d, valid: true },
+  Entry%d { key: u32:0x%x, value: u64:%d, valid: false }
+];
+// Looks up `key` in TABLE_%d.
+pub fn lookup_%d(key: u32) -> u64 {
+  for (i, acc): (u32, u64) in u32:0..u32:4 {
+    if TABLE_%d[i].valid && TABLE_%d[i].key == key { TABLE_%d[i].value } else { acc }
+  }(u64:0)
+}
+)",
+                          i, i, i, i, i, i * 4, i, i + 1, i * 4 + 1, i, i + 2,
+                          i * 4 + 2, i, i + 3, i * 4 + 3, i, i, i, i, i);
+  }
+  for (auto _ : state) {
+    Scanner scanner("fake.x", program);
+    Parser parser("fake", &scanner);
+    absl::StatusOr<std::unique_ptr<Module>> module = parser.ParseModule();
+    XLS_ASSERT_OK(module.status());
+    benchmark::DoNotOptimize(module);
+  }
+  state.SetBytesProcessed(state.iterations() * program.size());
+}
+BENCHMARK(BM_ParseGeneratedModule)->Arg(16)->Arg(1024)->Arg(16 * 1024);
+
 }  // namespace xls::dslx
@@ -14,6 +14,7 @@
 
 #include "xls/dslx/frontend/scanner.h"
 
+#include <array>
 #include <cctype>
 #include <cstdint>
 #include <optional>
@@ -40,6 +41,23 @@
 
 namespace xls::dslx {
 
+namespace {
+
+// Returns a view of the one-character string holding `c`, which stays valid
+// for the life of the program.
+std::string_view SingleCharacter(char c) {
+  static const std::array<char, 256>* const kCharacters = [] {
+    auto* characters = new std::array<char, 256>;
+    for (int i = 0; i < 256; ++i) {
+      (*characters)[i] = static_cast<char>(i);
+    }
+    return characters;
+  }();
+  return std::string_view(&(*kCharacters)[static_cast<uint8_t>(c)], 1);
+}
+
+}  // namespace
+
 absl::Status ScanErrorStatus(const Span& span, std::string_view message) {
   return absl::InvalidArgumentError(
       absl::StrFormat("ScanError: %s %s", span.ToString(), message));
@@ -73,24 +91,24 @@ bool Scanner::TryDropChar(char target) {
 }
 
 Token Scanner::PopComment(const Pos& start_pos) {
-  std::string chars;
+  const int64_t start_index = index_;
   while (!AtCharEof()) {
-    char c = PopChar();
-    chars.append(1, c);
-    if (c == '\n') {
+    if (PopChar() == '\n') {
       break;
     }
   }
-  return Token(TokenKind::kComment, Span(start_pos, GetPos()), chars);
+  return Token(TokenKind::kComment, Span(start_pos, GetPos()),
+               TextFrom(start_index));
 }
 
 absl::StatusOr<Token> Scanner::PopWhitespace(const Pos& start_pos) {
   XLS_CHECK(AtWhitespace());
-  std::string chars;
+  const int64_t start_index = index_;
   while (!AtCharEof() && AtWhitespace()) {
-    chars.append(1, PopChar());
+    DropChar();
   }
-  return Token(TokenKind::kWhitespace, Span(start_pos, GetPos()), chars);
+  return Token(TokenKind::kWhitespace, Span(start_pos, GetPos()),
+               TextFrom(start_index));
 }
 
 // This is too simple to need to return absl::Status. Just never call it
@@ -257,6 +275,11 @@ absl::StatusOr<std::string> Scanner::ScanUntilDoubleQuote() {
 
   std::string result;
   while (!AtCharEof() && PeekChar() != '\"') {
+    // Plain characters stand for themselves; only escapes need processing.
+    if (PeekChar() != '\\') {
+      result.push_back(PopChar());
+      continue;
+    }
     XLS_ASSIGN_OR_RETURN(std::string next, ProcessNextStringChar());
     absl::StrAppend(&result, next);
   }
@@ -290,12 +313,12 @@ absl::StatusOr<Token> Scanner::ScanIdentifierOrKeyword(char startc,
     return std::isalpha(c) != 0 || std::isdigit(c) != 0 || c == '_' ||
            c == '!' || c == '\'';
   };
-  std::string s = ScanWhile(startc, is_trailing_identifier_char);
+  std::string_view s = ScanWhile(index_ - 1, is_trailing_identifier_char);
   Span span(start_pos, GetPos());
   if (std::optional<Keyword> keyword = GetKeyword(s)) {
     return Token(span, *keyword);
   }
-  return Token(TokenKind::kIdentifier, span, std::move(s));
+  return Token(TokenKind::kIdentifier, span, s);
 }
 
 std::optional<CommentData> Scanner::TryPopComment() {
@@ -328,35 +351,43 @@ absl::StatusOr<std::optional<Token>> Scanner::TryPopWhitespaceOrComment() {
 
 absl::StatusOr<Token> Scanner::ScanString(const Pos& start_pos) {
   DropChar();
+  const int64_t start_index = index_;
   XLS_ASSIGN_OR_RETURN(std::string value, ScanUntilDoubleQuote());
+  std::string_view raw = TextFrom(start_index);
   if (!TryDropChar('"')) {
     return ScanErrorStatus(
         Span(start_pos, GetPos()),
         "Expected close quote character to terminate open quote character.");
   }
-  return Token(TokenKind::kString, Span(start_pos, GetPos()), value);
+  if (value != raw) {
+    raw = unescaped_values_.emplace_back(std::move(value));
+  }
+  return Token(TokenKind::kString, Span(start_pos, GetPos()), raw);
 }
 
 absl::StatusOr<Token> Scanner::ScanNumber(char startc, const Pos& start_pos) {
+  // The (possibly negative) number is a contiguous run of text that begins
+  // with the already-popped `startc`.
+  const int64_t start_index = index_ - 1;
   bool negative = startc == '-';
   if (negative) {
     startc = PopChar();
   }
 
-  std::string s;
+  std::string_view s;
   if (startc == '0' && TryDropChar('x')) {  // Hex radix.
-    s = ScanWhile("0x", [](char c) {
+    s = ScanWhile(start_index, [](char c) {
       return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f') ||
              ('A' <= c && c <= 'F') || c == '_';
     });
-    if (s == "0x") {
+    if (absl::EndsWith(s, "0x")) {
       return ScanErrorStatus(Span(GetPos(), GetPos()),
                              "Expected hex characters following 0x prefix.");
     }
   } else if (startc == '0' && TryDropChar('b')) {  // Bin prefix.
-    s = ScanWhile("0b",
+    s = ScanWhile(start_index,
                   [](char c) { return ('0' <= c && c <= '1') || c == '_'; });
-    if (s == "0b") {
+    if (absl::EndsWith(s, "0b")) {
       return ScanErrorStatus(Span(GetPos(), GetPos()),
                              "Expected binary characters following 0b prefix");
     }
@@ -366,8 +397,9 @@ absl::StatusOr<Token> Scanner::ScanNumber(char startc, const Pos& start_pos) {
           absl::StrFormat("Invalid digit for binary number: '%c'", PeekChar()));
     }
   } else {
-    s = ScanWhile(startc, [](char c) { return std::isdigit(c) != 0; });
-    if (absl::StartsWith(s, "0") && s.size() != 1) {
+    s = ScanWhile(start_index, [](char c) { return std::isdigit(c) != 0; });
+    std::string_view digits = negative ? s.substr(1) : s;
+    if (absl::StartsWith(digits, "0") && digits.size() != 1) {
       return ScanErrorStatus(
           Span(GetPos(), GetPos()),
           "Invalid radix for number, expect 0b or 0x because of leading 0.");
@@ -375,9 +407,6 @@ absl::StatusOr<Token> Scanner::ScanNumber(char startc, const Pos& start_pos) {
     XLS_CHECK(!s.empty())
         << "Must have seen numerical digits to attempt to scan a number.";
   }
-  if (negative) {
-    s = "-" + s;
-  }
   return Token(TokenKind::kNumber, Span(start_pos, GetPos()), s);
 }
 
@@ -437,7 +466,7 @@ absl::StatusOr<Token> Scanner::ScanChar(const Pos& start_pos) {
     return ScanErrorStatus(Span(GetPos(), GetPos()), msg);
   }
   return Token(TokenKind::kCharacter, Span(start_pos, GetPos()),
-               std::string(1, c));
+               SingleCharacter(c));
 }
 
 absl::StatusOr<Token> Scanner::Pop() {
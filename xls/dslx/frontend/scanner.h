@@ -16,7 +16,7 @@
 #define XLS_DSLX_FRONTEND_CPP_SCANNER_H_
 
 #include <cstdint>
-#include <functional>
+#include <deque>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -57,6 +58,10 @@ class Scanner {
         text_(std::move(text)),
         include_whitespace_and_comments_(include_whitespace_and_comments) {}
 
+  // Tokens refer into the text held by the scanner, so it stays put.
+  Scanner(const Scanner&) = delete;
+  Scanner& operator=(const Scanner&) = delete;
+
   // Gets the current position in the token stream. Note that the position in
   // the token stream can change on a Pop(), because whitespace and comments
   // may be discarded.
@@ -146,19 +151,19 @@ class Scanner {
   absl::StatusOr<Token> ScanChar(const Pos& start_pos);
 
   // Scans from the current position until ftake returns false or EOF is
-  // reached.
-  std::string ScanWhile(std::string s, const std::function<bool(char)>& ftake) {
-    while (!AtCharEof()) {
-      char peek = PeekChar();
-      if (!ftake(peek)) {
-        break;
-      }
-      s.append(1, PopChar());
+  // reached, and returns the text from `start_index` (at or before the current
+  // position, for characters that were already popped) to there.
+  std::string_view ScanWhile(int64_t start_index,
+                             absl::FunctionRef<bool(char)> ftake) {
+    while (!AtCharEof() && ftake(PeekChar())) {
+      DropChar();
     }
-    return s;
+    return TextFrom(start_index);
   }
-  std::string ScanWhile(char c, const std::function<bool(char)>& ftake) {
-    return ScanWhile(std::string(1, c), ftake);
+
+  // Returns the text from `start_index` up to the current position.
+  std::string_view TextFrom(int64_t start_index) const {
+    return std::string_view(text_).substr(start_index, index_ - start_index);
   }
 
   // Scans the identifier-looping entity beginning with startc.
@@ -263,6 +268,9 @@ class Scanner {
 
   std::string filename_;
   std::string text_;
+  // Values of tokens that are not verbatim substrings of `text_` (i.e. string
+  // literals containing escapes). A deque so that the strings never move.
+  std::deque<std::string> unescaped_values_;
   bool include_whitespace_and_comments_;
   int64_t index_ = 0;
   int64_t lineno_ = 0;
@@ -15,6 +15,7 @@
 #include "xls/dslx/frontend/scanner.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
 #include "xls/dslx/error_test_utils.h"
 #include "xls/dslx/frontend/comment_data.h"
 #include "xls/dslx/frontend/pos.h"
@@ -36,15 +38,27 @@ namespace {
 using status_testing::StatusIs;
 using testing::HasSubstr;
 
-absl::StatusOr<std::vector<Token>> ToTokens(std::string text) {
-  Scanner s("fake_file.x", std::move(text));
-  return s.PopAll();
+// The tokens scanned from some text, along with the scanner which holds the
+// text they refer into.
+struct ScannedTokens {
+  std::unique_ptr<Scanner> scanner;
+  std::vector<Token> tokens;
+
+  int64_t size() const { return tokens.size(); }
+  const Token& operator[](int64_t i) const { return tokens[i]; }
+};
+
+absl::StatusOr<ScannedTokens> ToTokens(std::string text) {
+  ScannedTokens result;
+  result.scanner = std::make_unique<Scanner>("fake_file.x", std::move(text));
+  XLS_ASSIGN_OR_RETURN(result.tokens, result.scanner->PopAll());
+  return result;
 }
 
 }  // namespace
 
 TEST(ScannerTest, SimpleTokens) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("+ - ++ << >>"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("+ - ++ << >>"));
   ASSERT_EQ(5, tokens.size());
   EXPECT_EQ(tokens[0].kind(), TokenKind::kPlus);
   EXPECT_EQ(tokens[1].kind(), TokenKind::kMinus);
@@ -54,8 +68,7 @@ TEST(ScannerTest, SimpleTokens) {
 }
 
 TEST(ScannerTest, HexNumbers) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens,
-                           ToTokens("0xf00 0xba5 0xA"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("0xf00 0xba5 0xA"));
   ASSERT_EQ(3, tokens.size());
   EXPECT_TRUE(tokens[0].IsNumber("0xf00"));
   EXPECT_TRUE(tokens[1].IsNumber("0xba5"));
@@ -63,8 +76,7 @@ TEST(ScannerTest, HexNumbers) {
 }
 
 TEST(ScannerTest, BoolKeywords) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens,
-                           ToTokens("true false bool"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("true false bool"));
   ASSERT_EQ(3, tokens.size());
   EXPECT_TRUE(tokens[0].IsKeyword(Keyword::kTrue));
   EXPECT_TRUE(tokens[1].IsKeyword(Keyword::kFalse));
@@ -73,7 +85,7 @@ TEST(ScannerTest, BoolKeywords) {
 }
 
 TEST(ScannerTest, IdentifierWithTick) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens,
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens,
                            ToTokens("state state' state'' s'"));
   ASSERT_EQ(4, tokens.size());
   EXPECT_TRUE(tokens[0].IsIdentifier("state"));
@@ -123,20 +135,19 @@ TEST(ScannerTest, RecognizesEscapes) {
 }
 
 TEST(ScannerTest, ScanJustWhitespace) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens(" "));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens(" "));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_EQ(tokens[0].kind(), TokenKind::kEof);
 }
 
 TEST(ScannerTest, ScanKeyword) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("fn"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("fn"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsKeyword(Keyword::kFn));
 }
 
 TEST(ScannerTest, FunctionDefinition) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens,
-                           ToTokens("fn ident(x) { x }"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("fn ident(x) { x }"));
 
   ASSERT_EQ(tokens.size(), 8);
 
@@ -166,7 +177,7 @@ TEST(ScannerTest, FunctionDefinition) {
 }
 
 TEST(ScannerTest, DoublePlus) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("x++y"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("x++y"));
   ASSERT_EQ(tokens.size(), 3);
   EXPECT_TRUE(tokens[0].IsIdentifier("x"));
   EXPECT_EQ(tokens[1].ToString(), "++");
@@ -174,19 +185,19 @@ TEST(ScannerTest, DoublePlus) {
 }
 
 TEST(ScannerTest, NumberHex) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("0xf00"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("0xf00"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("0xf00"));
 }
 
 TEST(ScannerTest, NegativeNumberHex) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("-0xf00"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("-0xf00"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("-0xf00"));
 }
 
 TEST(ScannerTest, NumberBin) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("0b10"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("0b10"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("0b10"));
 }
@@ -198,19 +209,19 @@ TEST(ScannerTest, NumberBinInvalidDigit) {
 }
 
 TEST(ScannerTest, NegativeNumberBin) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("-0b10"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("-0b10"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("-0b10"));
 }
 
 TEST(ScannerTest, NegativeNumber) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("-42"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("-42"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("-42"));
 }
 
 TEST(ScannerTest, NumberWithUnderscores) {
-  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, ToTokens("0b11_1100"));
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens, ToTokens("0b11_1100"));
   ASSERT_EQ(tokens.size(), 1);
   EXPECT_TRUE(tokens[0].IsNumber("0b11_1100"));
 }
@@ -422,6 +433,17 @@ TEST(ScannerTest, SimpleString) {
   EXPECT_EQ(*t.GetValue(), "hello world!");
 }
 
+TEST(ScannerTest, StringValuesWithAndWithoutEscapes) {
+  XLS_ASSERT_OK_AND_ASSIGN(ScannedTokens tokens,
+                           ToTokens(R"("plain" "a\nb\"c" '\t' 'x')"));
+  ASSERT_EQ(tokens.size(), 5);
+  EXPECT_EQ(tokens[0].GetStringValue(), "plain");
+  EXPECT_EQ(tokens[1].GetStringValue(), "a\nb\"c");
+  EXPECT_EQ(tokens[2].GetStringValue(), "\t");
+  EXPECT_EQ(tokens[3].GetStringValue(), "x");
+  EXPECT_EQ(tokens[4].kind(), TokenKind::kEof);
+}
+
 TEST(ScannerTest, SimpleCommentData) {
   std::string text = R"(// I haz comments!)";
   Scanner s("fake_file.x", text);
@@ -105,10 +105,15 @@ std::optional<Keyword> KeywordFromString(std::string_view s);
 const absl::flat_hash_set<Keyword>& GetTypeKeywords();
 
 // Token yielded by the Scanner below.
+//
+// The value of a token is a view: the Scanner points it into the source text
+// it retains (or, for string literals with escapes, into unescaped storage the
+// Scanner also owns), so tokens must not outlive the Scanner that produced
+// them.
 class Token {
  public:
   Token(TokenKind kind, Span span,
-        std::optional<std::string> value = std::nullopt)
+        std::optional<std::string_view> value = std::nullopt)
       : kind_(kind), span_(std::move(span)), payload_(value) {}
 
   Token(Span span, Keyword keyword)
@@ -121,12 +126,17 @@ class Token {
     if (std::holds_alternative<Keyword>(payload_)) {
       return KeywordToString(GetKeyword());
     }
-    return std::get<std::optional<std::string>>(payload_);
+    const std::optional<std::string_view>& value =
+        std::get<std::optional<std::string_view>>(payload_);
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    return std::string(*value);
   }
 
   // Note: assumes that the payload is not a keyword.
-  const std::string& GetStringValue() const {
-    return *std::get<std::optional<std::string>>(payload_);
+  std::string_view GetStringValue() const {
+    return *std::get<std::optional<std::string_view>>(payload_);
   }
 
   absl::StatusOr<int64_t> GetValueAsInt64() const;
@@ -147,10 +157,10 @@ class Token {
     return kind_ == TokenKind::kKeyword && GetKeyword() == target;
   }
   bool IsIdentifier(std::string_view target) const {
-    return kind_ == TokenKind::kIdentifier && *GetValue() == target;
+    return kind_ == TokenKind::kIdentifier && GetStringValue() == target;
   }
   bool IsNumber(std::string_view target) const {
-    return kind_ == TokenKind::kNumber && *GetValue() == target;
+    return kind_ == TokenKind::kNumber && GetStringValue() == target;
   }
 
   bool IsKindIn(
@@ -186,7 +196,7 @@ class Token {
  private:
   TokenKind kind_;
   Span span_;
-  std::variant<std::optional<std::string>, Keyword> payload_;
+  std::variant<std::optional<std::string_view>, Keyword> payload_;
 };
 
 }  // namespace xls::dslx
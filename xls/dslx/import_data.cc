@@ -63,6 +63,48 @@ absl::StatusOr<ModuleInfo*> ImportData::Put(
   return pmodule_info;
 }
 
+absl::Status ImportData::Evict(const ImportTokens& subject) {
+  auto it = modules_.find(subject);
+  if (it == modules_.end()) {
+    return absl::NotFoundError("Module information was not found for import " +
+                               subject.ToString());
+  }
+  ModuleInfo* module_info = it->second.get();
+  DropModuleState(&module_info->module());
+  auto path_it = path_to_module_info_.find(std::string{module_info->path()});
+  if (path_it != path_to_module_info_.end() &&
+      path_it->second == module_info) {
+    path_to_module_info_.erase(path_it);
+  }
+  modules_.erase(it);
+  return absl::OkStatus();
+}
+
+void ImportData::DropModuleState(const Module* module) {
+  if (bytecode_cache_ != nullptr) {
+    bytecode_cache_->EraseModule(module);
+  }
+  if (module_cache_ != nullptr) {
+    module_cache_->EraseModule(module);
+  }
+  type_info_owner_.Erase(module);
+  // Note: the maps below are keyed on mutable module pointers, but lookups
+  // never dereference the key.
+  Module* key = const_cast<Module*>(module);
+  top_level_bindings_.erase(key);
+  top_level_bindings_done_.erase(key);
+  typecheck_wip_.erase(key);
+}
+
+std::vector<ImportTokens> ImportData::GetSubjects() const {
+  std::vector<ImportTokens> subjects;
+  subjects.reserve(modules_.size());
+  for (const auto& [subject, module_info] : modules_) {
+    subjects.push_back(subject);
+  }
+  return subjects;
+}
+
 absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfoForNode(
     const AstNode* node) {
   XLS_RET_CHECK(node != nullptr);
@@ -108,6 +150,15 @@ BytecodeCacheInterface* ImportData::bytecode_cache() {
   return bytecode_cache_.get();
 }
 
+void ImportData::SetModuleCache(
+    std::unique_ptr<ModuleCacheInterface> module_cache) {
+  module_cache_ = std::move(module_cache);
+}
+
+ModuleCacheInterface* ImportData::module_cache() {
+  return module_cache_.get();
+}
+
 absl::StatusOr<const EnumDef*> ImportData::FindEnumDef(const Span& span) const {
   XLS_ASSIGN_OR_RETURN(const Module* module, FindModule(span));
   const EnumDef* enum_def = module->FindEnumDef(span);
@@ -25,6 +25,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
@@ -33,6 +34,7 @@
 #include "xls/dslx/frontend/module.h"
 #include "xls/dslx/import_record.h"
 #include "xls/dslx/interp_bindings.h"
+#include "xls/dslx/module_cache_interface.h"
 #include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/warning_kind.h"
 
@@ -131,6 +133,22 @@ class ImportData {
   absl::StatusOr<ModuleInfo*> Put(const ImportTokens& subject,
                                   std::unique_ptr<ModuleInfo> module_info);
 
+  // Removes the module imported as "subject", along with its type information
+  // and any interpreter/bytecode state held for it.
+  //
+  // Modules that import "subject" refer into its AST and type information, so
+  // the caller is responsible for evicting those as well.
+  absl::Status Evict(const ImportTokens& subject);
+
+  // Drops the type information and interpreter/bytecode state held for a
+  // module that was never Put() (e.g. because it failed to typecheck) before
+  // it is destroyed, so that a later module allocated at the same address does
+  // not observe it. This only matters for long-lived ImportData objects.
+  void DropModuleState(const Module* module);
+
+  // Returns the subjects of all modules currently held, in no particular order.
+  std::vector<ImportTokens> GetSubjects() const;
+
   TypeInfoOwner& type_info_owner() { return type_info_owner_; }
 
   // Helper that gets the "root" type information for the module of the given
@@ -185,6 +203,12 @@ class ImportData {
   void SetBytecodeCache(std::unique_ptr<BytecodeCacheInterface> bytecode_cache);
   BytecodeCacheInterface* bytecode_cache();
 
+  // Sets a cache that modules imported into this ImportData are loaded from
+  // (and stored to) instead of being typechecked anew; see
+  // ModuleCacheInterface. There is no module cache by default.
+  void SetModuleCache(std::unique_ptr<ModuleCacheInterface> module_cache);
+  ModuleCacheInterface* module_cache();
+
   // Helpers for finding nodes in the cluster of modules managed by this object.
   //
   // These return a NotFound error if _either_ the module (implicitly
@@ -233,6 +257,7 @@ class ImportData {
   absl::Span<const std::filesystem::path> additional_search_paths_;
   WarningKindSet enabled_warnings_;
   std::unique_ptr<BytecodeCacheInterface> bytecode_cache_;
+  std::unique_ptr<ModuleCacheInterface> module_cache_;
 
   // See comment on AddToImporterStack() above.
   std::vector<ImportRecord> importer_stack_;
@@ -20,6 +20,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/cleanup/cleanup.h"
@@ -37,6 +38,8 @@
 #include "xls/dslx/frontend/parser.h"
 #include "xls/dslx/frontend/scanner.h"
 #include "xls/dslx/import_data.h"
+#include "xls/dslx/module_cache_interface.h"
+#include "xls/dslx/warning_collector.h"
 
 namespace xls::dslx {
 
@@ -139,7 +142,8 @@ static absl::StatusOr<std::filesystem::path> FindExistingPath(
 absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
                                      const ImportTokens& subject,
                                      ImportData* import_data,
-                                     const Span& import_span) {
+                                     const Span& import_span,
+                                     WarningCollector* warnings) {
   XLS_RET_CHECK(import_data != nullptr);
   if (import_data->Contains(subject)) {
     XLS_VLOG(3) << "DoImport (cached) subject: " << subject.ToString();
@@ -167,9 +171,33 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
   Scanner scanner(found_path, contents);
   Parser parser(/*module_name=*/fully_qualified_name, &scanner);
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
-  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info, ftypecheck(module.get()));
+
+  absl::StatusOr<TypeInfo*> type_info;
+  if (ModuleCacheInterface* module_cache = import_data->module_cache();
+      module_cache != nullptr) {
+    // The module cache keys the module on the modules it imports, so those are
+    // resolved up front (typechecking the module then finds them imported).
+    for (const ModuleMember& member : module->top()) {
+      if (std::holds_alternative<Import*>(member)) {
+        const Import* import = std::get<Import*>(member);
+        XLS_RETURN_IF_ERROR(DoImport(ftypecheck,
+                                     ImportTokens(import->subject()),
+                                     import_data, import->span(), warnings)
+                                .status());
+      }
+    }
+    type_info = module_cache->LoadOrTypecheck(ftypecheck, module.get(),
+                                              contents, found_path,
+                                              import_data, warnings);
+  } else {
+    type_info = ftypecheck(module.get());
+  }
+  if (!type_info.ok()) {
+    import_data->DropModuleState(module.get());
+    return type_info.status();
+  }
   return import_data->Put(
-      subject, std::make_unique<ModuleInfo>(std::move(module), type_info,
+      subject, std::make_unique<ModuleInfo>(std::move(module), *type_info,
                                             std::move(found_path)));
 }
 
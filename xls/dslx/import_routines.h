@@ -21,6 +21,7 @@
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/type_system/type_info.h"
+#include "xls/dslx/warning_collector.h"
 
 namespace xls::dslx {
 
@@ -41,13 +42,17 @@ using TypecheckModuleFn = std::function<absl::StatusOr<TypeInfo*>(Module*)>;
 //      fully qualified like ('xls', 'lib', 'math').
 //  cache: Cache that we resolve against so we don't waste resources
 //      re-importing things in the import DAG.
+//  warnings: Where warnings for the imported module are reported when it is
+//      loaded from the module cache of 'cache' (if any) instead of being
+//      typechecked via 'ftypecheck'; may be nullptr.
 //
 // Returns:
 //  The imported module information.
 absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
                                      const ImportTokens& subject,
                                      ImportData* import_data,
-                                     const Span& import_span);
+                                     const Span& import_span,
+                                     WarningCollector* warnings);
 
 }  // namespace xls::dslx
 
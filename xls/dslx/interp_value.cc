@@ -362,6 +362,10 @@ absl::StatusOr<std::string> InterpValue::ToFormattedString(
 
 bool InterpValue::Eq(const InterpValue& other) const {
   auto values_equal = [&] {
+    if (std::get<SharedValues>(payload_) ==
+        std::get<SharedValues>(other.payload_)) {
+      return true;
+    }
     const std::vector<InterpValue>& lhs = GetValuesOrDie();
     const std::vector<InterpValue>& rhs = other.GetValuesOrDie();
     if (lhs.size() != rhs.size()) {
@@ -627,8 +631,8 @@ absl::StatusOr<InterpValue> InterpValue::Index(const InterpValue& other) const {
   return (*lhs)[index];
 }
 
-absl::StatusOr<InterpValue> InterpValue::Update(
-    const InterpValue& index, const InterpValue& value) const {
+absl::StatusOr<int64_t> InterpValue::GetUpdateIndex(
+    const InterpValue& index) const {
   XLS_RET_CHECK(index.IsUBits());
   XLS_ASSIGN_OR_RETURN(const std::vector<InterpValue>* lhs, GetValues());
   XLS_ASSIGN_OR_RETURN(Bits index_bits, index.GetBits());
@@ -638,11 +642,28 @@ absl::StatusOr<InterpValue> InterpValue::Update(
         absl::StrFormat("Update index %d is out of bounds; subject size: %d",
                         index_value, lhs->size()));
   }
-  std::vector<InterpValue> copy = *lhs;
+  return index_value;
+}
+
+absl::StatusOr<InterpValue> InterpValue::Update(
+    const InterpValue& index, const InterpValue& value) const& {
+  XLS_ASSIGN_OR_RETURN(int64_t index_value, GetUpdateIndex(index));
+  std::vector<InterpValue> copy = GetValuesOrDie();
   copy[index_value] = value;
   return InterpValue(tag_, std::move(copy));
 }
 
+absl::StatusOr<InterpValue> InterpValue::Update(const InterpValue& index,
+                                                const InterpValue& value) && {
+  XLS_ASSIGN_OR_RETURN(int64_t index_value, GetUpdateIndex(index));
+  SharedValues& elements = std::get<SharedValues>(payload_);
+  if (elements.use_count() != 1) {
+    return std::as_const(*this).Update(index, value);
+  }
+  (*elements)[index_value] = value;
+  return std::move(*this);
+}
+
 absl::StatusOr<InterpValue> InterpValue::ArithmeticNegate() const {
   XLS_ASSIGN_OR_RETURN(Bits arg, GetBits());
   return InterpValue(tag_, bits_ops::Negate(arg));
@@ -128,6 +128,10 @@ struct TokenData {
 };
 
 // A DSLX interpreter value (variant), with InterpValueTag as a discriminator.
+//
+// Bits payloads keep narrow values inline (see InlineBitmap). The elements of
+// tuples and arrays are shared between copies of a value and are only copied
+// when a value that shares them is updated, so copying aggregates is cheap.
 class InterpValue {
  public:
   struct UserFnData {
@@ -313,7 +317,11 @@ class InterpValue {
   absl::StatusOr<InterpValue> Index(const InterpValue& other) const;
   absl::StatusOr<InterpValue> Index(int64_t index) const;
   absl::StatusOr<InterpValue> Update(const InterpValue& index,
-                                     const InterpValue& value) const;
+                                     const InterpValue& value) const&;
+  // As above, but if this value is the only owner of its elements, the element
+  // is replaced in place instead of copying the array.
+  absl::StatusOr<InterpValue> Update(const InterpValue& index,
+                                     const InterpValue& value) &&;
   absl::StatusOr<InterpValue> Slice(const InterpValue& start,
                                     const InterpValue& length) const;
   absl::StatusOr<InterpValue> Flatten() const;
@@ -358,13 +366,13 @@ class InterpValue {
   InterpValueTag tag() const { return tag_; }
 
   absl::StatusOr<const std::vector<InterpValue>*> GetValues() const {
-    if (!std::holds_alternative<std::vector<InterpValue>>(payload_)) {
+    if (!HasValues()) {
       return absl::InvalidArgumentError("Value does not hold element values");
     }
-    return &std::get<std::vector<InterpValue>>(payload_);
+    return &GetValuesOrDie();
   }
   const std::vector<InterpValue>& GetValuesOrDie() const {
-    return std::get<std::vector<InterpValue>>(payload_);
+    return *std::get<SharedValues>(payload_);
   }
   absl::StatusOr<const FnData*> GetFunction() const {
     if (!std::holds_alternative<FnData>(payload_)) {
@@ -406,7 +414,7 @@ class InterpValue {
   }
 
   bool HasValues() const {
-    return std::holds_alternative<std::vector<InterpValue>>(payload_);
+    return std::holds_alternative<SharedValues>(payload_);
   }
 
   bool IsToken() const { return tag_ == InterpValueTag::kToken; }
@@ -459,17 +467,29 @@ class InterpValue {
   absl::StatusOr<std::string> ToEnumString(
       const EnumFormatDescriptor& fmt_desc) const;
 
+  // Elements of a tuple or array, shared copy-on-write between values: they
+  // are never mutated while more than one value refers to them.
+  using SharedValues = std::shared_ptr<std::vector<InterpValue>>;
+
   // Note: currently InterpValues are not scoped to a lifetime, so we use a
   // shared_ptr for referring to token data for identity purposes.
   //
   // TODO(leary): 2020-02-10 When all Python bindings are eliminated we can more
   // easily make an interpreter scoped lifetime that InterpValues can live in.
-  using Payload =
-      std::variant<Bits, EnumData, std::vector<InterpValue>, FnData,
-                   std::shared_ptr<TokenData>, std::shared_ptr<Channel>>;
+  using Payload = std::variant<Bits, EnumData, SharedValues, FnData,
+                               std::shared_ptr<TokenData>,
+                               std::shared_ptr<Channel>>;
 
   InterpValue(InterpValueTag tag, Payload payload)
       : tag_(tag), payload_(std::move(payload)) {}
+  InterpValue(InterpValueTag tag, std::vector<InterpValue> elements)
+      : tag_(tag),
+        payload_(std::make_shared<std::vector<InterpValue>>(
+            std::move(elements))) {}
+
+  // Returns the index of the element of this array that `Update(index, ...)`
+  // replaces, or an error if it is out of bounds.
+  absl::StatusOr<int64_t> GetUpdateIndex(const InterpValue& index) const;
 
   using CompareF = bool (*)(const Bits& lhs, const Bits& rhs);
 
@@ -263,5 +263,36 @@ TEST(InterpValueTest, MakeMaxValue) {
             "s16:32767");
 }
 
+TEST(InterpValueTest, UpdateIsCopyOnWrite) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue original,
+      InterpValue::MakeArray({InterpValue::MakeU32(2), InterpValue::MakeU32(3),
+                              InterpValue::MakeU32(4)}));
+  InterpValue copy = original;
+  EXPECT_EQ(&original.GetValuesOrDie(), &copy.GetValuesOrDie());
+
+  // The elements are shared with `original`, so updating `copy` must not be
+  // visible through `original`.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue updated,
+      std::move(copy).Update(InterpValue::MakeU32(1), InterpValue::MakeU32(7)));
+  EXPECT_EQ(original.ToString(), "[u32:2, u32:3, u32:4]");
+  EXPECT_EQ(updated.ToString(), "[u32:2, u32:7, u32:4]");
+
+  // `updated` is the sole owner of its elements, so it is updated in place.
+  const std::vector<InterpValue>* elements = &updated.GetValuesOrDie();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue updated_again,
+      std::move(updated).Update(InterpValue::MakeU32(0),
+                                InterpValue::MakeU32(5)));
+  EXPECT_EQ(&updated_again.GetValuesOrDie(), elements);
+  EXPECT_EQ(updated_again.ToString(), "[u32:5, u32:7, u32:4]");
+
+  // Out-of-bounds updates are an error, as with the const overload.
+  EXPECT_FALSE(std::move(updated_again)
+                   .Update(InterpValue::MakeU32(3), InterpValue::MakeU32(0))
+                   .ok());
+}
+
 }  // namespace
 }  // namespace xls::dslx
@@ -69,6 +69,15 @@ ABSL_FLAG(bool, trace_channels, false,
 ABSL_FLAG(int64_t, max_ticks, 100000,
           "If non-zero, the maximum number of ticks to execute on any proc. If "
           "exceeded an error is returned.");
+ABSL_FLAG(int64_t, worker_count, 1,
+          "Number of tests and quickchecks to run concurrently. Results are "
+          "printed in declaration order regardless.");
+ABSL_FLAG(bool, run_procs_on_jit, false,
+          "If true, test procs are converted to IR and run on the JIT rather "
+          "than in the DSLX interpreter.");
+ABSL_FLAG(std::string, module_cache_dir, "",
+          "If non-empty, directory of an on-disk cache of typechecked imported "
+          "modules, which may be shared by concurrent and later invocations.");
 // LINT.ThenChange(//xls/build_rules/xls_dslx_rules.bzl)
 
 namespace xls::dslx {
@@ -90,7 +99,8 @@ absl::StatusOr<TestResult> RealMain(std::string_view entry_module_path,
                       FormatPreference format_preference,
                       CompareFlag compare_flag, bool execute,
                       bool warnings_as_errors, std::optional<int64_t> seed,
-                      bool trace_channels, std::optional<int64_t> max_ticks) {
+                      bool trace_channels, std::optional<int64_t> max_ticks,
+                      int64_t worker_count, bool run_procs_on_jit) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet warnings,
       WarningKindSetFromDisabledString(absl::GetFlag(FLAGS_disable_warnings)));
@@ -119,7 +129,12 @@ absl::StatusOr<TestResult> RealMain(std::string_view entry_module_path,
                                  .warnings_as_errors = warnings_as_errors,
                                  .warnings = warnings,
                                  .trace_channels = trace_channels,
-                                 .max_ticks = max_ticks};
+                                 .max_ticks = max_ticks,
+                                 .worker_count = worker_count,
+                                 .run_procs_on_jit = run_procs_on_jit};
+  if (!absl::GetFlag(FLAGS_module_cache_dir).empty()) {
+    options.module_cache_dir = absl::GetFlag(FLAGS_module_cache_dir);
+  }
   XLS_ASSIGN_OR_RETURN(
       TestResult test_result,
       ParseAndTest(program, module_name, entry_module_path, options));
@@ -192,7 +207,9 @@ int main(int argc, char* argv[]) {
 
   absl::StatusOr<xls::dslx::TestResult> test_result = xls::dslx::RealMain(
       args[0], dslx_paths, test_filter, preference, compare_flag, execute,
-      warnings_as_errors, seed, trace_channels, max_ticks);
+      warnings_as_errors, seed, trace_channels, max_ticks,
+      absl::GetFlag(FLAGS_worker_count),
+      absl::GetFlag(FLAGS_run_procs_on_jit));
   if (!test_result.ok()) {
     return xls::ExitStatus(test_result.status());
   }
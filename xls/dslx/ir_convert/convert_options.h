@@ -15,6 +15,10 @@
 #ifndef XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 #define XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
+
 #include "xls/dslx/warning_kind.h"
 
 namespace xls::dslx {
@@ -41,6 +45,19 @@ struct ConvertOptions {
   //
   // Note that this is only used in IR conversion routines that do typechecking.
   WarningKindSet enabled_warnings = kAllWarningsSet;
+
+  // Number of threads used to convert (non-proc) functions to IR. Functions
+  // whose callees have all been converted are built concurrently into staging
+  // packages and then merged into the result in conversion order, so the
+  // functions produced do not depend on this value (only node ids/names do).
+  int64_t worker_count = 1;
+
+  // If set, imported modules are loaded from (and stored to) the on-disk
+  // module cache in this directory rather than always being typechecked; see
+  // ModuleCache.
+  //
+  // Note that this is only used in IR conversion routines that do typechecking.
+  std::optional<std::filesystem::path> module_cache_dir;
 };
 
 }  // namespace xls::dslx
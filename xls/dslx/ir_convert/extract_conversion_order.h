@@ -144,6 +144,7 @@ class ConversionRecord {
   Module* module() const { return module_; }
   TypeInfo* type_info() const { return type_info_; }
   const ParametricEnv& parametric_env() const { return parametric_env_; }
+  const std::vector<Callee>& callees() const { return callees_; }
   std::optional<ProcId> proc_id() const { return proc_id_; }
   bool IsTop() const { return is_top_; }
 
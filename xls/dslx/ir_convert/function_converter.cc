@@ -383,6 +383,19 @@ bool FunctionConverter::GetRequiresImplicitToken(dslx::Function* f) const {
   return xls::dslx::GetRequiresImplicitToken(f, import_data_, options_);
 }
 
+absl::Status FunctionConverter::CheckConstexprIsRecorded(
+    const Expr* expr) const {
+  if (!package_data_.type_info_read_only ||
+      current_type_info_->IsKnownConstExpr(expr) ||
+      current_type_info_->IsKnownNonConstExpr(expr)) {
+    return absl::OkStatus();
+  }
+  return absl::UnavailableError(absl::StrFormat(
+      "Expression @ %s needs constexpr evaluation while type information is "
+      "read-only: `%s`",
+      expr->span().ToString(), expr->ToString()));
+}
+
 void FunctionConverter::SetFunctionBuilder(
     std::unique_ptr<BuilderBase> builder) {
   XLS_CHECK(function_builder_ == nullptr);
@@ -998,6 +1011,8 @@ absl::StatusOr<FunctionConverter::RangeData> FunctionConverter::GetRangeData(
 
   const auto* range_op = dynamic_cast<const Range*>(iterable);
   if (range_op != nullptr) {
+    XLS_RETURN_IF_ERROR(CheckConstexprIsRecorded(range_op->start()));
+    XLS_RETURN_IF_ERROR(CheckConstexprIsRecorded(range_op->end()));
     XLS_ASSIGN_OR_RETURN(
         start_value, ConstexprEvaluator::EvaluateToValue(
                          import_data_, current_type_info_, kNoWarningCollector,
@@ -1027,6 +1042,8 @@ absl::StatusOr<FunctionConverter::RangeData> FunctionConverter::GetRangeData(
     XLS_RET_CHECK_EQ(iterable_call->args().size(), 2);
     Expr* start = iterable_call->args()[0];
     Expr* limit = iterable_call->args()[1];
+    XLS_RETURN_IF_ERROR(CheckConstexprIsRecorded(start));
+    XLS_RETURN_IF_ERROR(CheckConstexprIsRecorded(limit));
 
     XLS_ASSIGN_OR_RETURN(
         start_value, ConstexprEvaluator::EvaluateToValue(
@@ -1627,6 +1644,7 @@ absl::Status FunctionConverter::HandleFailBuiltin(const Invocation* node,
 
     std::optional<std::string> label;
     ParametricEnv bindings(parametric_env_map_);
+    XLS_RETURN_IF_ERROR(CheckConstexprIsRecorded(label_expr));
     XLS_RETURN_IF_ERROR(ConstexprEvaluator::Evaluate(
         import_data_, current_type_info_, kNoWarningCollector, bindings,
         label_expr));
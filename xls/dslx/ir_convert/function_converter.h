@@ -82,6 +82,11 @@ struct PackageData {
   Package* package;
   absl::flat_hash_map<xls::FunctionBase*, dslx::Function*> ir_to_dslx;
   absl::flat_hash_set<xls::Function*> wrappers;
+
+  // When set, conversion is running concurrently with conversions of other
+  // functions that share the same TypeInfo, so it must not evaluate (and thus
+  // record) constexprs that typechecking left unevaluated.
+  bool type_info_read_only = false;
 };
 
 // A function that creates/returns a predicate value -- since this is used
@@ -195,6 +200,11 @@ class FunctionConverter {
   // See `GetRequiresImplicitToken(f, import_data, options)`.
   bool GetRequiresImplicitToken(dslx::Function* f) const;
 
+  // Returns an error if evaluating `expr` as a constexpr would have to note a
+  // new value in the current type information while that is read-only (see
+  // `PackageData::type_info_read_only`).
+  absl::Status CheckConstexprIsRecorded(const Expr* expr) const;
+
   CallingConvention GetCallingConvention(Function* f) const {
     return GetRequiresImplicitToken(f) ? CallingConvention::kImplicitToken
                                        : CallingConvention::kTypical;
@@ -26,14 +26,17 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
@@ -43,6 +46,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/command_line_utils.h"
@@ -58,13 +62,17 @@
 #include "xls/dslx/ir_convert/function_converter.h"
 #include "xls/dslx/ir_convert/ir_conversion_utils.h"
 #include "xls/dslx/ir_convert/proc_config_ir_converter.h"
+#include "xls/dslx/module_cache.h"
 #include "xls/dslx/type_system/parametric_env.h"
 #include "xls/dslx/type_system/typecheck.h"
 #include "xls/dslx/warning_collector.h"
 #include "xls/dslx/warning_kind.h"
+#include "xls/ir/fileno.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_scanner.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value_helpers.h"
 
 namespace xls::dslx {
 namespace {
@@ -224,6 +232,212 @@ absl::Status CreateBoundaryChannels(absl::Span<Param* const> params,
   return absl::OkStatus();
 }
 
+// A function conversion performed on a worker thread into its own package; see
+// ConvertFunctionsInParallel().
+struct StagedConversion {
+  std::unique_ptr<Package> package;
+  PackageData package_data{nullptr};
+  // Functions standing in for the record's callees (with the callees' names and
+  // signatures) so that invocations of them can be built.
+  absl::flat_hash_set<const xls::FunctionBase*> stubs;
+  // The function converted from the record; nullptr if staging did not succeed
+  // and the record is to be converted directly into the target package.
+  xls::Function* function = nullptr;
+};
+
+// Adds a function to `package` with the name and signature of `callee`.
+absl::StatusOr<xls::Function*> AddCalleeStub(const xls::Function* callee,
+                                             Package* package) {
+  FunctionBuilder fb(callee->name(), package);
+  for (const xls::Param* param : callee->params()) {
+    XLS_ASSIGN_OR_RETURN(Type * type,
+                         package->MapTypeFromOtherPackage(param->GetType()));
+    fb.Param(param->GetName(), type);
+  }
+  XLS_ASSIGN_OR_RETURN(Type * return_type,
+                       package->MapTypeFromOtherPackage(
+                           callee->return_value()->GetType()));
+  return fb.BuildWithReturnValue(fb.Literal(ZeroOfType(return_type)));
+}
+
+// Converts `record` into a fresh package, declaring stubs for the (already
+// staged) functions it calls.
+absl::Status StageConversion(const ConversionRecord& record,
+                             std::string_view package_name,
+                             std::optional<Fileno> fileno,
+                             absl::Span<const int64_t> callee_indices,
+                             absl::Span<const ConversionRecord> records,
+                             ImportData* import_data,
+                             const ConvertOptions& options,
+                             std::vector<StagedConversion>& staged,
+                             StagedConversion& result) {
+  result.package = std::make_unique<Package>(package_name);
+  result.package_data.package = result.package.get();
+  result.package_data.type_info_read_only = true;
+  if (fileno.has_value()) {
+    // Use the file number the target package assigned so that source
+    // locations carry over unchanged when merging.
+    result.package->SetFileno(*fileno,
+                              std::string{record.module()->fs_path().value()});
+  }
+  for (int64_t callee_index : callee_indices) {
+    XLS_ASSIGN_OR_RETURN(
+        xls::Function * stub,
+        AddCalleeStub(staged[callee_index].function, result.package.get()));
+    result.stubs.insert(stub);
+    result.package_data.ir_to_dslx[stub] = records[callee_index].f();
+  }
+
+  // Plain functions don't touch proc state, but the converter wants some.
+  ProcConversionData proc_data;
+  XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
+      result.package_data, record, import_data, &proc_data, options));
+  for (const auto& [ir_function, dslx_function] :
+       result.package_data.ir_to_dslx) {
+    if (dslx_function == record.f() && !result.stubs.contains(ir_function)) {
+      result.function = ir_function->AsFunctionOrDie();
+    }
+  }
+  XLS_RET_CHECK(result.function != nullptr) << record.ToString();
+  return absl::OkStatus();
+}
+
+// Moves the functions built by a staged conversion into the target package,
+// pointing calls of the stubs at the real callees.
+absl::Status MergeStagedConversion(const StagedConversion& staged,
+                                   PackageData& package_data) {
+  Package* package = package_data.package;
+  absl::flat_hash_map<const xls::Function*, xls::Function*> call_remapping;
+  for (const std::unique_ptr<xls::Function>& f : staged.package->functions()) {
+    if (staged.stubs.contains(f.get())) {
+      XLS_ASSIGN_OR_RETURN(call_remapping[f.get()],
+                           package->GetFunction(f->name()));
+      continue;
+    }
+    // Helpers such as those built for `map` of builtins are shared by name;
+    // reuse the copy an earlier conversion already placed in the package.
+    if (package->HasFunctionWithName(f->name())) {
+      XLS_ASSIGN_OR_RETURN(call_remapping[f.get()],
+                           package->GetFunction(f->name()));
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(call_remapping[f.get()],
+                         f->Clone(f->name(), package, call_remapping));
+  }
+  for (const auto& [ir_function, dslx_function] :
+       staged.package_data.ir_to_dslx) {
+    if (!staged.stubs.contains(ir_function)) {
+      package_data.ir_to_dslx[call_remapping.at(
+          ir_function->AsFunctionOrDie())] = dslx_function;
+    }
+  }
+  for (xls::Function* wrapper : staged.package_data.wrappers) {
+    package_data.wrappers.insert(call_remapping.at(wrapper));
+  }
+  return absl::OkStatus();
+}
+
+// Converts the leading run of plain (non-proc) functions in `order` using up
+// to `options.worker_count` threads, and returns how many records of `order`
+// were converted.
+//
+// Records are grouped into levels such that every callee of a record is in an
+// earlier level; the records of a level are converted concurrently, each into
+// its own staging package. The results are then merged into the target package
+// in `order`, so functions appear exactly as they would with serial conversion.
+//
+// A record whose staging fails (e.g. it would need to evaluate a constexpr that
+// typechecking didn't, which would write to the shared TypeInfo), along with
+// everything that calls it, is instead converted serially during the merge,
+// which also produces the error if there really is one.
+absl::StatusOr<int64_t> ConvertFunctionsInParallel(
+    absl::Span<const ConversionRecord> order, ImportData* import_data,
+    const ConvertOptions& options, PackageData& package_data,
+    ProcConversionData* proc_data) {
+  int64_t count = 0;
+  while (count < static_cast<int64_t>(order.size()) &&
+         order[count].f()->tag() == Function::Tag::kNormal) {
+    ++count;
+  }
+  absl::Span<const ConversionRecord> records = order.subspan(0, count);
+
+  absl::flat_hash_map<std::pair<const Function*, ParametricEnv>, int64_t>
+      record_index;
+  for (int64_t i = 0; i < count; ++i) {
+    record_index.emplace(
+        std::make_pair(records[i].f(), records[i].parametric_env()), i);
+  }
+
+  std::vector<std::vector<int64_t>> callee_indices(count);
+  std::vector<int64_t> record_level(count);
+  std::vector<std::vector<int64_t>> levels;
+  std::vector<std::optional<Fileno>> filenos(count);
+  for (int64_t i = 0; i < count; ++i) {
+    int64_t level = 0;
+    for (const Callee& callee : records[i].callees()) {
+      auto it = record_index.find(
+          std::make_pair(callee.f(), callee.parametric_env()));
+      if (it == record_index.end() || it->second >= i) {
+        continue;
+      }
+      callee_indices[i].push_back(it->second);
+      level = std::max(level, record_level[it->second] + 1);
+    }
+    std::sort(callee_indices[i].begin(), callee_indices[i].end());
+    callee_indices[i].erase(
+        std::unique(callee_indices[i].begin(), callee_indices[i].end()),
+        callee_indices[i].end());
+    record_level[i] = level;
+    if (static_cast<int64_t>(levels.size()) <= level) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(i);
+
+    // Assign file numbers in conversion order, as serial conversion would.
+    const std::optional<std::filesystem::path>& fs_path =
+        records[i].module()->fs_path();
+    if (fs_path.has_value()) {
+      filenos[i] =
+          package_data.package->GetOrCreateFileno(std::string{*fs_path});
+    }
+  }
+
+  std::vector<StagedConversion> staged(count);
+  for (const std::vector<int64_t>& level : levels) {
+    XLS_RETURN_IF_ERROR(ParallelFor(
+        level.size(), options.worker_count, [&](int64_t j) -> absl::Status {
+          int64_t i = level[j];
+          for (int64_t callee_index : callee_indices[i]) {
+            if (staged[callee_index].function == nullptr) {
+              return absl::OkStatus();
+            }
+          }
+          absl::Status status = StageConversion(
+              records[i], package_data.package->name(), filenos[i],
+              callee_indices[i], records, import_data, options, staged,
+              staged[i]);
+          if (!status.ok()) {
+            XLS_VLOG(3) << "Converting " << records[i].ToString()
+                        << " serially; staging failed: " << status;
+            staged[i].function = nullptr;
+          }
+          return absl::OkStatus();
+        }));
+  }
+
+  for (int64_t i = 0; i < count; ++i) {
+    if (staged[i].function == nullptr) {
+      XLS_VLOG(3) << "Converting to IR: " << records[i].ToString();
+      XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
+          package_data, records[i], import_data, proc_data, options));
+      continue;
+    }
+    XLS_VLOG(3) << "Merging staged IR: " << records[i].ToString();
+    XLS_RETURN_IF_ERROR(MergeStagedConversion(staged[i], package_data));
+  }
+  return count;
+}
+
 // Converts the functions in the call graph in a specified order.
 //
 // Args:
@@ -300,7 +514,14 @@ absl::Status ConvertCallGraph(absl::Span<const ConversionRecord> order,
         first_proc_config->type_info(), package_data, &proc_data));
   }
 
-  for (const ConversionRecord& record : order) {
+  int64_t converted_count = 0;
+  if (options.worker_count > 1) {
+    XLS_ASSIGN_OR_RETURN(converted_count,
+                         ConvertFunctionsInParallel(order, import_data, options,
+                                                    package_data, &proc_data));
+  }
+
+  for (const ConversionRecord& record : order.subspan(converted_count)) {
     XLS_VLOG(3) << "Converting to IR: " << record.ToString();
     XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
         package_data, record, import_data, &proc_data, options));
@@ -381,6 +602,16 @@ absl::Status ConvertOneFunctionIntoPackage(Module* module,
         module, proc_or.value(), import_data, parametric_env, options, package);
   }
 
+  // Test procs are converted like any other proc so they can be run on an IR
+  // proc runtime.
+  absl::StatusOr<TestProc*> test_proc_or =
+      module->GetTestProc(entry_function_name);
+  if (test_proc_or.ok()) {
+    return ConvertOneFunctionIntoPackageInternal(
+        module, test_proc_or.value()->proc(), import_data, parametric_env,
+        options, package);
+  }
+
   return absl::InvalidArgumentError(
       absl::StrFormat("Entry \"%s\" is not present in "
                       "DSLX module %s as a Function or a Proc.",
@@ -422,14 +653,23 @@ absl::Status CheckPackageName(std::string_view name) {
   return absl::OkStatus();
 }
 
+// Converts "module", which has been typechecked against "import_data", into
+// "package": just "entry" and its callees if given, otherwise the whole module.
+absl::Status ConvertTypecheckedModuleIntoPackage(
+    Module* module, std::optional<std::string_view> entry,
+    const ConvertOptions& convert_options, ImportData* import_data,
+    Package* package) {
+  if (entry.has_value()) {
+    return ConvertOneFunctionIntoPackage(
+        module, entry.value(), /*import_data=*/import_data,
+        /*parametric_env=*/nullptr, convert_options, package);
+  }
+  return ConvertModuleIntoPackage(module, import_data, convert_options,
+                                  package);
+}
+
 // Adds IR-converted symbols from the module specified by "path" to the given
 // "package".
-//
-// TODO(leary): 2021-07-21 We should be able to reuse the type checking if
-// there are overlapping nodes in the module DAG between files to process. For
-// now we throw it away for each file and re-derive it (we need to refactor to
-// make the modules outlive any given AddPathToPackage() if we want to
-// appropriately reuse things in ImportData).
 absl::Status AddContentsToPackage(std::string_view file_contents,
                                   std::string_view module_name,
                                   std::optional<std::string_view> path,
@@ -442,6 +682,12 @@ absl::Status AddContentsToPackage(std::string_view file_contents,
       std::unique_ptr<Module> module,
       ParseText(file_contents, module_name, /*print_on_error=*/true,
                 /*filename=*/path.value_or("<UNKNOWN>"), printed_error));
+  // The module is not added to import_data, so drop its type information
+  // (even if typechecking fails part way) before it is destroyed; the import
+  // data may be shared with later conversions.
+  absl::Cleanup drop_module_state = [&] {
+    import_data->DropModuleState(module.get());
+  };
   WarningCollector warnings(import_data->enabled_warnings());
   absl::StatusOr<TypeInfo*> type_info_or =
       CheckModule(module.get(), import_data, &warnings);
@@ -459,15 +705,9 @@ absl::Status AddContentsToPackage(std::string_view file_contents,
         "Warnings encountered and warnings-as-errors set.");
   }
 
-  if (entry.has_value()) {
-    XLS_RETURN_IF_ERROR(ConvertOneFunctionIntoPackage(
-        module.get(), entry.value(), /*import_data=*/import_data,
-        /*parametric_env=*/nullptr, convert_options, package));
-  } else {
-    XLS_RETURN_IF_ERROR(ConvertModuleIntoPackage(module.get(), import_data,
-                                                 convert_options, package));
-  }
-  return absl::OkStatus();
+  return ConvertTypecheckedModuleIntoPackage(module.get(), entry,
+                                             convert_options, import_data,
+                                             package);
 }
 
 }  // namespace
@@ -498,14 +738,45 @@ absl::StatusOr<std::unique_ptr<Package>> ConvertFilesToPackage(
         "Top cannot be supplied with multiple input paths (need a single input "
         "path to know where to resolve the entry function");
   }
+  // A single import data is shared across all of the input paths so that
+  // modules they have in common (e.g. the standard library) are only parsed
+  // and typechecked once per conversion.
+  auto create_import_data = [&] {
+    ImportData import_data = CreateImportData(
+        stdlib_path, dslx_paths, convert_options.enabled_warnings);
+    if (convert_options.module_cache_dir.has_value()) {
+      import_data.SetModuleCache(
+          std::make_unique<ModuleCache>(*convert_options.module_cache_dir));
+    }
+    return import_data;
+  };
+  ImportData import_data = create_import_data();
   for (std::string_view path : paths) {
-    ImportData import_data(CreateImportData(stdlib_path, dslx_paths,
-                                            convert_options.enabled_warnings));
-    XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
     XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(path));
+    XLS_ASSIGN_OR_RETURN(ImportTokens subject,
+                         ImportTokens::FromString(module_name));
+    ImportData* path_import_data = &import_data;
+    std::optional<ImportData> isolated_import_data;
+    if (absl::StatusOr<ModuleInfo*> loaded = import_data.Get(subject);
+        loaded.ok()) {
+      std::error_code ec;
+      if (std::filesystem::equivalent((*loaded)->path(), path, ec)) {
+        // An earlier input path imported this file; convert the module it
+        // loaded rather than typechecking the file again.
+        XLS_RETURN_IF_ERROR(ConvertTypecheckedModuleIntoPackage(
+            &(*loaded)->module(), top, convert_options, &import_data,
+            package.get()));
+        continue;
+      }
+      // A different file of the same module name is loaded; convert this one
+      // against its own import data, as when each path was converted alone.
+      isolated_import_data.emplace(create_import_data());
+      path_import_data = &*isolated_import_data;
+    }
+    XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
     XLS_RETURN_IF_ERROR(AddContentsToPackage(
         text, module_name, /*path=*/path, /*entry=*/top, convert_options,
-        &import_data, package.get(), printed_error));
+        path_import_data, package.get(), printed_error));
   }
 
   return package;
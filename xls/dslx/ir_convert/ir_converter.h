@@ -80,7 +80,9 @@ absl::StatusOr<std::string> ConvertOneFunction(
 // As above, but the package is provided explicitly.
 //
 // Package must outlive this function call -- functions from "module" are placed
-// inside of it, it may not be nullptr.
+// inside of it, it may not be nullptr. "entry_function_name" may also name a
+// test proc, whose terminator channel becomes a send-only channel of the
+// package.
 absl::Status ConvertOneFunctionIntoPackage(Module* module,
                                            std::string_view entry_function_name,
                                            ImportData* import_data,
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>  // NOLINT
 #include <iostream>
@@ -59,6 +60,11 @@ ABSL_FLAG(std::string, disable_warnings, "",
           "recommended, but can be used in exceptional circumstances");
 ABSL_FLAG(bool, warnings_as_errors, true,
           "Whether to fail early, as an error, if warnings are detected");
+ABSL_FLAG(int64_t, worker_count, 1,
+          "Number of threads used to convert independent functions to IR.");
+ABSL_FLAG(std::string, module_cache_dir, "",
+          "If non-empty, directory of an on-disk cache of typechecked imported "
+          "modules, which may be shared by concurrent and later invocations.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
 
 namespace xls::dslx {
@@ -85,17 +91,22 @@ absl::Status RealMain(absl::Span<const std::string_view> paths,
                       const std::string& stdlib_path,
                       absl::Span<const std::filesystem::path> dslx_paths,
                       bool emit_fail_as_assert, bool verify_ir,
-                      bool warnings_as_errors, bool* printed_error) {
+                      bool warnings_as_errors, int64_t worker_count,
+                      bool* printed_error) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet enabled_warnings,
       WarningKindSetFromDisabledString(absl::GetFlag(FLAGS_disable_warnings)));
-  const ConvertOptions convert_options = {
+  ConvertOptions convert_options = {
       .emit_positions = true,
       .emit_fail_as_assert = emit_fail_as_assert,
       .verify_ir = verify_ir,
       .warnings_as_errors = warnings_as_errors,
       .enabled_warnings = enabled_warnings,
+      .worker_count = worker_count,
   };
+  if (!absl::GetFlag(FLAGS_module_cache_dir).empty()) {
+    convert_options.module_cache_dir = absl::GetFlag(FLAGS_module_cache_dir);
+  }
 
   // The following checks are performed inside ConvertFilesToPackage(), but we
   // reproduce them here to give nicer error messages.
@@ -162,10 +173,11 @@ int main(int argc, char* argv[]) {
   bool emit_fail_as_assert = absl::GetFlag(FLAGS_emit_fail_as_assert);
   bool verify_ir = absl::GetFlag(FLAGS_verify);
   bool warnings_as_errors = absl::GetFlag(FLAGS_warnings_as_errors);
+  int64_t worker_count = absl::GetFlag(FLAGS_worker_count);
   bool printed_error = false;
   absl::Status status = xls::dslx::RealMain(
       args, top, package_name, stdlib_path, dslx_paths, emit_fail_as_assert,
-      verify_ir, warnings_as_errors, &printed_error);
+      verify_ir, warnings_as_errors, worker_count, &printed_error);
   if (printed_error) {
     return EXIT_FAILURE;
   }
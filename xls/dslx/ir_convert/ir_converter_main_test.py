@@ -144,6 +144,31 @@ class IrConverterMainTest(test_base.TestCase):
     """),
     )
 
+  def test_multi_file_common_import(self) -> None:
+    result = self._ir_convert(
+        {
+            'common.x': 'pub fn g() -> u32 { u32:7 }',
+            'a.x': 'import common; fn f() -> u32 { common::g() + u32:1 }',
+            'b.x': 'import common; fn f() -> u32 { common::g() + u32:2 }',
+        },
+        package_name='my_entry',
+    )
+    self.assertIn('fn __a__f() -> bits[32]', result.ir)
+    self.assertIn('fn __b__f() -> bits[32]', result.ir)
+    self.assertIn('fn __common__g() -> bits[32]', result.ir)
+
+  def test_multi_file_importer_before_import(self) -> None:
+    result = self._ir_convert(
+        {
+            'a.x': 'import common; fn f() -> u32 { common::g() + u32:1 }',
+            'common.x': 'pub fn g() -> u32 { u32:7 }',
+        },
+        package_name='my_entry',
+    )
+    self.assertIn('fn __a__f() -> bits[32]', result.ir)
+    self.assertIn('fn __common__g() -> bits[32]', result.ir)
+    self.assertEqual(result.ir.count('fn __common__g('), 1)
+
 
 if __name__ == '__main__':
   test_base.main()
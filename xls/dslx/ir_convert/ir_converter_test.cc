@@ -20,6 +20,8 @@
 
 #include "xls/dslx/ir_convert/ir_converter.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -37,6 +39,11 @@
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/ir_convert/convert_options.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
 
 namespace xls::dslx {
 namespace {
@@ -1984,5 +1991,72 @@ fn main(x: u32[4]) -> u32[4] {
   ExpectIr(converted, TestName());
 }
 
+TEST(IrConverterTest, ParallelConversionMatchesSerial) {
+  constexpr std::string_view program =
+      R"(
+fn leaf(x: u32) -> u32 { x + u32:1 }
+
+fn add_n<N: u32>(x: u32) -> u32 { leaf(x) + N }
+
+pub fn checked(x: u32) -> u32 {
+  if x == u32:0 { fail!("zero", u32:0) } else { add_n<u32:3>(x) }
+}
+
+fn clzs(x: u8[2]) -> u8[2] { map(x, clz) }
+
+fn other_clzs(x: u8[2]) -> u8[2] { map(x, clz) }
+
+fn sum(x: u32[4]) -> u32 {
+  for (i, accum): (u32, u32) in u32:0..u32:4 {
+    accum + add_n<u32:5>(x[i])
+  }(u32:0)
+}
+
+fn main(x: u32[4]) -> u32 {
+  let y = clzs(u8[2]:[u8:1, u8:2]);
+  let z = other_clzs(y);
+  sum(x) + leaf(z[0] as u32)
+}
+)";
+
+  auto convert = [&](int64_t worker_count)
+      -> absl::StatusOr<std::unique_ptr<Package>> {
+    auto import_data = CreateImportDataForTest();
+    XLS_ASSIGN_OR_RETURN(TypecheckedModule tm,
+                         ParseAndTypecheck(program, "test_module.x",
+                                           "test_module", &import_data));
+    return ConvertModuleToPackage(
+        tm.module, &import_data,
+        ConvertOptions{.emit_positions = false, .worker_count = worker_count});
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> serial, convert(1));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> parallel, convert(4));
+
+  // Node ids differ between the two, but the functions and their contents must
+  // not.
+  ASSERT_EQ(serial->functions().size(), parallel->functions().size());
+  for (int64_t i = 0; i < parallel->functions().size(); ++i) {
+    xls::Function* want = serial->functions()[i].get();
+    xls::Function* got = parallel->functions()[i].get();
+    EXPECT_EQ(want->name(), got->name());
+    EXPECT_EQ(want->node_count(), got->node_count()) << want->name();
+    EXPECT_EQ(want->GetType()->ToString(), got->GetType()->ToString())
+        << want->name();
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * main,
+                           parallel->GetFunction("__test_module__main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Value result,
+      DropInterpreterEvents(InterpretFunction(
+          main, {Value::UBitsArray({1, 2, 3, 4}, 32).value()})));
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * serial_main,
+                           serial->GetFunction("__test_module__main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Value expected,
+      DropInterpreterEvents(InterpretFunction(
+          serial_main, {Value::UBitsArray({1, 2, 3, 4}, 32).value()})));
+  EXPECT_EQ(result, expected);
+}
+
 }  // namespace
 }  // namespace xls::dslx
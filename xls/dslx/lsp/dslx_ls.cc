@@ -15,21 +15,24 @@
 // Very simple language server for dslx that
 //  - keeps track of open files and updates them whenever they are
 //    changed in the editor (hidden under the hood).
-//  - On every change, attempts to parse and send back diagnostics
-//    on errors/warnings.
+//  - Once a burst of changes has been received, attempts to parse and send
+//    back diagnostics on errors/warnings.
 //
 // Heavily commented below as this serves as a sample.
 
+#include <poll.h>
 #include <unistd.h>
 
 #include <filesystem>  // NOLINT
 #include <iostream>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "external/verible/common/lsp/json-rpc-dispatcher.h"
 #include "external/verible/common/lsp/lsp-protocol.h"
@@ -47,6 +50,9 @@ static constexpr char kDslxPath[] = "DSLX_PATH";
 ABSL_FLAG(std::string, dslx_path,
           getenv(kDslxPath) != nullptr ? getenv(kDslxPath) : "",
           "Additional paths to search for modules (colon delimited).");
+ABSL_FLAG(std::string, module_cache_dir, "",
+          "If non-empty, directory of an on-disk cache of typechecked imported "
+          "modules, which may be shared by concurrent and later invocations.");
 
 namespace xls::dslx {
 namespace {
@@ -82,22 +88,61 @@ InitializeResult InitializeServer(const nlohmann::json& params) {
   };
 }
 
-// On text change: attempt to parse the buffer and emit diagnostics if needed.
-void TextChangeHandler(const std::string& file_uri,
-                       const EditTextBuffer& text_buffer,
-                       verible::lsp::JsonRpcDispatcher& dispatcher,
-                       LanguageServerAdapter& adapter) {
-  text_buffer.RequestContent([&](std::string_view file_content) {
-    // Note: this returns a status, but we don't need to surface it from here.
-    adapter.Update(file_uri, file_content).IgnoreError();
-  });
-  verible::lsp::PublishDiagnosticsParams params{
-      .uri = file_uri,
-      .diagnostics = adapter.GenerateParseDiagnostics(file_uri),
-  };
-  dispatcher.SendNotification("textDocument/publishDiagnostics", params);
+// Returns true if the editor has sent more input that we have not read yet.
+bool InputPending() {
+  pollfd stdin_poll{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+  return poll(&stdin_poll, 1, /*timeout=*/0) > 0;
 }
 
+// Edits are not analyzed as they arrive: we only note the latest contents of
+// each changed buffer, and analyze them once the editor has no further
+// messages queued up (or when a request needs an up-to-date view of the
+// document). A burst of keystrokes thus costs a single analysis rather than
+// one per keystroke.
+class PendingAnalyses {
+ public:
+  PendingAnalyses(JsonRpcDispatcher& dispatcher,
+                  LanguageServerAdapter& adapter)
+      : dispatcher_(dispatcher), adapter_(adapter) {}
+
+  void Note(const std::string& file_uri, const EditTextBuffer& text_buffer) {
+    text_buffer.RequestContent([&](std::string_view file_content) {
+      pending_[file_uri] = std::string{file_content};
+    });
+  }
+
+  // Analyzes the given document if it has pending changes and publishes its
+  // diagnostics.
+  void Flush(const std::string& file_uri) {
+    auto it = pending_.find(file_uri);
+    if (it == pending_.end()) {
+      return;
+    }
+    std::string contents = std::move(it->second);
+    pending_.erase(it);
+    // Note: this returns a status, but we don't need to surface it from here.
+    adapter_.Update(file_uri, contents).IgnoreError();
+    verible::lsp::PublishDiagnosticsParams params{
+        .uri = file_uri,
+        .diagnostics = adapter_.GenerateParseDiagnostics(file_uri),
+    };
+    dispatcher_.SendNotification("textDocument/publishDiagnostics", params);
+  }
+
+  void FlushAll() {
+    while (!pending_.empty()) {
+      // Note: copied since Flush() erases the entry.
+      std::string file_uri = pending_.begin()->first;
+      Flush(file_uri);
+    }
+  }
+
+ private:
+  JsonRpcDispatcher& dispatcher_;
+  LanguageServerAdapter& adapter_;
+  absl::flat_hash_map<std::string, std::string> pending_;
+};
+
 absl::Status RealMain() {
   const std::string stdlib_path = absl::GetFlag(FLAGS_stdlib_path);
   const std::string dslx_path = absl::GetFlag(FLAGS_dslx_path);
@@ -110,7 +155,12 @@ absl::Status RealMain() {
            << "\tcwd=" << fs::current_path().string() << "\n";
 
   // Adapter that interfaces between dslx parsing and LSP
-  LanguageServerAdapter language_server_adapter(stdlib_path, dslx_paths);
+  std::optional<fs::path> module_cache_dir;
+  if (!absl::GetFlag(FLAGS_module_cache_dir).empty()) {
+    module_cache_dir = absl::GetFlag(FLAGS_module_cache_dir);
+  }
+  LanguageServerAdapter language_server_adapter(stdlib_path, dslx_paths,
+                                                module_cache_dir);
 
   // The dispatcher receives json rpc requests
   // (https://www.jsonrpc.org/specification) which are passed in
@@ -155,17 +205,19 @@ absl::Status RealMain() {
   // The text buffer collection can call a callback whenever there is a change.
   // We're using this to hook up our parser that then can send diagnostic
   // messages back.
+  PendingAnalyses pending_analyses(dispatcher, language_server_adapter);
   buffers.SetChangeListener(
       [&](const std::string& uri, const EditTextBuffer* buffer) {
         if (buffer == nullptr) {
           return;  // buffer got deleted. No interest.
         }
-        TextChangeHandler(uri, *buffer, dispatcher, language_server_adapter);
+        pending_analyses.Note(uri, *buffer);
       });
 
   dispatcher.AddRequestHandler(
       "textDocument/documentSymbol",
       [&](const verible::lsp::DocumentSymbolParams& params) {
+        pending_analyses.Flush(params.textDocument.uri);
         return language_server_adapter.GenerateDocumentSymbols(
             params.textDocument.uri);
       });
@@ -173,6 +225,7 @@ absl::Status RealMain() {
   dispatcher.AddRequestHandler(
       "textDocument/definition",
       [&](const verible::lsp::DefinitionParams& params) {
+        pending_analyses.Flush(params.textDocument.uri);
         return language_server_adapter.FindDefinitions(params.textDocument.uri,
                                                        params.position);
       });
@@ -180,6 +233,7 @@ absl::Status RealMain() {
   dispatcher.AddRequestHandler(
       "textDocument/rangeFormatting",
       [&](const verible::lsp::DocumentFormattingParams& params) {
+        pending_analyses.Flush(params.textDocument.uri);
         auto text_edits_or = language_server_adapter.FormatRange(
             params.textDocument.uri, params.range);
         if (text_edits_or.ok()) {
@@ -196,6 +250,9 @@ absl::Status RealMain() {
     status = stream_splitter.PullFrom([](char* buf, int size) -> int {  //
       return static_cast<int>(read(STDIN_FILENO, buf, size));
     });
+    if (!InputPending()) {
+      pending_analyses.FlushAll();
+    }
   }
 
   LspLog() << status << "\n";
@@ -15,16 +15,28 @@
 #include "xls/dslx/lsp/language_server_adapter.h"
 
 #include <cstdint>
+#include <deque>
+#include <filesystem>  // NOLINT
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "external/verible/common/lsp/lsp-protocol.h"
+#include "xls/common/file/filesystem.h"
 #include "xls/common/indent.h"
+#include "xls/common/logging/logging.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/extract_module_name.h"
 #include "xls/dslx/frontend/ast.h"
@@ -34,6 +46,7 @@
 #include "xls/dslx/lsp/document_symbols.h"
 #include "xls/dslx/lsp/find_definition.h"
 #include "xls/dslx/lsp/lsp_type_utils.h"
+#include "xls/dslx/module_cache.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/warning_collector.h"
 #include "xls/dslx/warning_kind.h"
@@ -75,19 +88,20 @@ void AppendDiagnosticFromTypecheck(
 
 LanguageServerAdapter::LanguageServerAdapter(
     std::string_view stdlib,
-    const std::vector<std::filesystem::path>& dslx_paths)
+    const std::vector<std::filesystem::path>& dslx_paths,
+    std::optional<std::filesystem::path> module_cache_dir)
     : stdlib_(stdlib),
       dslx_paths_(dslx_paths),
-      last_parse_data_(absl::FailedPreconditionError(
-          "No DSLX file has been parsed yet by the Language Server.")) {}
+      import_data_(CreateImportDataPtr(stdlib_, dslx_paths_, kAllWarningsSet)) {
+  if (module_cache_dir.has_value()) {
+    import_data_->SetModuleCache(
+        std::make_unique<ModuleCache>(*std::move(module_cache_dir)));
+  }
+}
 
 absl::Status LanguageServerAdapter::Update(std::string_view file_uri,
                                            std::string_view dslx_code) {
-  // TODO(hzeller): remember per file_uri for more sophisticated features.
-  ImportData import_data =
-      CreateImportData(stdlib_, dslx_paths_, kAllWarningsSet);
   const absl::Time start = absl::Now();
-  std::string contents{dslx_code};
 
   absl::StatusOr<std::string> module_name_or = ExtractModuleName(file_uri);
   if (!module_name_or.ok()) {
@@ -96,32 +110,219 @@ absl::Status LanguageServerAdapter::Update(std::string_view file_uri,
     return absl::OkStatus();
   }
 
-  const std::string& module_name = module_name_or.value();
-  absl::StatusOr<TypecheckedModule> typechecked_module_or = ParseAndTypecheck(
-      contents, /*path=*/file_uri, /*module_name=*/module_name, &import_data);
+  const std::string uri{file_uri};
+  DocumentData& document = documents_[uri];
+  document.module_name = std::move(module_name_or).value();
+  document.contents = std::string{dslx_code};
+
+  // Modules that changed on disk since they were imported are dropped along
+  // with everything that depends on them.
+  std::vector<std::string> invalidated;
+  Evict(GetChangedImports(), invalidated);
+
+  // The edited document goes first so that dependents see its new contents.
+  // Analyzing a document can invalidate others (e.g. ones that had imported a
+  // module of the same name from disk); that settles quickly, but each
+  // document is analyzed at most twice per update to be safe.
+  std::deque<std::string> worklist = {uri};
+  absl::flat_hash_set<std::string> queued = {uri};
+  absl::flat_hash_map<std::string, int64_t> analysis_count;
+  auto enqueue = [&](const std::vector<std::string>& uris) {
+    for (const std::string& next : uris) {
+      if (analysis_count[next] < 2 && queued.insert(next).second) {
+        worklist.push_back(next);
+      }
+    }
+  };
+  enqueue(invalidated);
+  while (!worklist.empty()) {
+    std::string next = std::move(worklist.front());
+    worklist.pop_front();
+    queued.erase(next);
+    ++analysis_count[next];
+    invalidated.clear();
+    Analyze(next, invalidated);
+    enqueue(invalidated);
+  }
+
   const absl::Duration duration = absl::Now() - start;
   if (duration > absl::Milliseconds(200)) {
     LspLog() << "Parsing " << file_uri << " took " << duration << "\n";
   }
+  return documents_.at(uri).typechecked_module.status();
+}
 
+void LanguageServerAdapter::Analyze(const std::string& uri,
+                                    std::vector<std::string>& invalidated) {
+  DocumentData& document = documents_.at(uri);
+  // The previous analysis of this document, or a module of the same name that
+  // was imported from disk, has to make way for the new one.
+  std::vector<std::string> evicted_documents;
+  Evict({document.module_name}, evicted_documents);
+  for (std::string& evicted_uri : evicted_documents) {
+    if (evicted_uri != uri) {
+      invalidated.push_back(std::move(evicted_uri));
+    }
+  }
+  absl::StatusOr<TypecheckedModule> typechecked_module_or =
+      ParseAndTypecheck(document.contents, /*path=*/uri,
+                        /*module_name=*/document.module_name,
+                        import_data_.get());
+  document.failed_imports.clear();
   if (typechecked_module_or.ok()) {
-    last_parse_data_.emplace(LastParseData{
-        std::move(import_data), std::move(typechecked_module_or).value(),
-        std::filesystem::path{file_uri}, std::move(contents)});
+    document.typechecked_module.emplace(
+        std::move(typechecked_module_or).value());
   } else {
-    last_parse_data_ = typechecked_module_or.status();
+    document.typechecked_module = typechecked_module_or.status();
+    // Parsing is cheap relative to typechecking, so re-parse to learn which
+    // modules this document depends on.
+    absl::StatusOr<std::unique_ptr<Module>> module =
+        ParseModule(document.contents, uri, document.module_name);
+    if (module.ok()) {
+      for (const auto& [_, import] : (*module)->GetImportByName()) {
+        document.failed_imports.push_back(
+            ImportTokens(import->subject()).ToString());
+      }
+    }
+  }
+  NoteImportHashes();
+}
+
+void LanguageServerAdapter::Evict(
+    const absl::flat_hash_set<std::string>& module_names,
+    std::vector<std::string>& invalidated) {
+  // Reverse import graph over the modules currently held, by module name.
+  absl::flat_hash_map<std::string, std::vector<std::string>> importers;
+  for (const ImportTokens& subject : import_data_->GetSubjects()) {
+    const Module& module = import_data_->Get(subject).value()->module();
+    for (const auto& [_, import] : module.GetImportByName()) {
+      importers[ImportTokens(import->subject()).ToString()].push_back(
+          subject.ToString());
+    }
+  }
+
+  std::vector<std::string> worklist(module_names.begin(), module_names.end());
+  absl::flat_hash_set<std::string> evicted;
+  while (!worklist.empty()) {
+    std::string name = std::move(worklist.back());
+    worklist.pop_back();
+    absl::StatusOr<ImportTokens> subject = ImportTokens::FromString(name);
+    XLS_CHECK_OK(subject.status());
+    if (!import_data_->Contains(*subject) || !evicted.insert(name).second) {
+      continue;
+    }
+    XLS_VLOG(1) << "Evicting module: " << name;
+    XLS_CHECK_OK(import_data_->Evict(*subject));
+    import_hashes_.erase(name);
+    const std::vector<std::string>& dependents = importers[name];
+    worklist.insert(worklist.end(), dependents.begin(), dependents.end());
+  }
+
+  if (evicted.empty()) {
+    return;
+  }
+  for (auto& [uri, document] : documents_) {
+    if (document.typechecked_module.ok()) {
+      if (evicted.contains(document.module_name)) {
+        document.typechecked_module = absl::FailedPreconditionError(
+            "Analysis was invalidated by a change to an imported module.");
+        invalidated.push_back(uri);
+      }
+    } else if (absl::c_any_of(document.failed_imports,
+                              [&](const std::string& name) {
+                                return evicted.contains(name);
+                              })) {
+      invalidated.push_back(uri);
+    }
   }
-  return last_parse_data_.status();
+}
+
+absl::flat_hash_set<std::string> LanguageServerAdapter::GetChangedImports() {
+  absl::flat_hash_set<std::string> changed;
+  for (auto& [name, imported_file] : import_hashes_) {
+    std::error_code ec;
+    std::filesystem::file_time_type mtime =
+        std::filesystem::last_write_time(imported_file.path, ec);
+    std::uintmax_t size =
+        ec ? 0 : std::filesystem::file_size(imported_file.path, ec);
+    if (ec) {
+      changed.insert(name);
+      continue;
+    }
+    if (mtime == imported_file.mtime && size == imported_file.size) {
+      continue;
+    }
+    absl::StatusOr<std::string> contents =
+        GetFileContents(imported_file.path);
+    if (!contents.ok() || absl::HashOf(*contents) != imported_file.hash) {
+      changed.insert(name);
+      continue;
+    }
+    // Touched but unchanged; remember the new stamp to avoid rehashing it on
+    // every update.
+    imported_file.mtime = mtime;
+    imported_file.size = size;
+  }
+  return changed;
+}
+
+void LanguageServerAdapter::NoteImportHashes() {
+  absl::flat_hash_set<std::string> document_modules;
+  for (const auto& [uri, document] : documents_) {
+    if (document.typechecked_module.ok()) {
+      document_modules.insert(document.module_name);
+    }
+  }
+  for (const ImportTokens& subject : import_data_->GetSubjects()) {
+    std::string name = subject.ToString();
+    if (document_modules.contains(name) || import_hashes_.contains(name)) {
+      continue;
+    }
+    const std::filesystem::path& path =
+        import_data_->Get(subject).value()->path();
+    // The stamp is taken before reading so that a write racing with the read
+    // shows up as a change on the next update.
+    std::error_code ec;
+    std::filesystem::file_time_type mtime =
+        std::filesystem::last_write_time(path, ec);
+    std::uintmax_t size = ec ? 0 : std::filesystem::file_size(path, ec);
+    absl::StatusOr<std::string> contents = GetFileContents(path);
+    if (ec || !contents.ok()) {
+      LspLog() << "Could not read imported module " << name << " at " << path
+               << ": "
+               << (ec ? absl::InternalError(ec.message()) : contents.status())
+               << "\n";
+      continue;
+    }
+    import_hashes_.emplace(std::move(name),
+                           ImportedFile{.path = path,
+                                        .hash = absl::HashOf(*contents),
+                                        .mtime = mtime,
+                                        .size = size});
+  }
+}
+
+const LanguageServerAdapter::DocumentData*
+LanguageServerAdapter::FindTypecheckedDocument(std::string_view uri) const {
+  auto it = documents_.find(uri);
+  if (it == documents_.end() || !it->second.typechecked_module.ok()) {
+    return nullptr;
+  }
+  return &it->second;
 }
 
 std::vector<verible::lsp::Diagnostic>
 LanguageServerAdapter::GenerateParseDiagnostics(std::string_view uri) const {
   std::vector<verible::lsp::Diagnostic> result;
-  if (last_parse_data_.ok()) {
-    const TypecheckedModule& tm = last_parse_data_->typechecked_module;
-    AppendDiagnosticFromTypecheck(tm, &result);
+  auto it = documents_.find(uri);
+  if (it == documents_.end()) {
+    return result;
+  }
+  const absl::StatusOr<TypecheckedModule>& tm = it->second.typechecked_module;
+  if (tm.ok()) {
+    AppendDiagnosticFromTypecheck(*tm, &result);
   } else {
-    AppendDiagnosticFromStatus(last_parse_data_.status(), &result);
+    AppendDiagnosticFromStatus(tm.status(), &result);
   }
   return result;
 }
@@ -129,9 +330,8 @@ LanguageServerAdapter::GenerateParseDiagnostics(std::string_view uri) const {
 std::vector<verible::lsp::DocumentSymbol>
 LanguageServerAdapter::GenerateDocumentSymbols(std::string_view uri) const {
   XLS_VLOG(1) << "GenerateDocumentSymbols; uri: " << uri;
-  if (last_parse_data_.ok()) {
-    const Module& module = last_parse_data_->module();
-    return ToDocumentSymbols(module);
+  if (const DocumentData* document = FindTypecheckedDocument(uri)) {
+    return ToDocumentSymbols(document->module());
   }
   return {};
 }
@@ -140,9 +340,8 @@ std::vector<verible::lsp::Location> LanguageServerAdapter::FindDefinitions(
     std::string_view uri, const verible::lsp::Position& position) const {
   const Pos pos = ConvertLspPositionToPos(uri, position);
   XLS_VLOG(1) << "FindDefinition; uri: " << uri << " pos: " << pos;
-  if (last_parse_data_.ok()) {
-    const TypecheckedModule& tm = last_parse_data_->typechecked_module;
-    const Module& m = *tm.module;
+  if (const DocumentData* document = FindTypecheckedDocument(uri)) {
+    const Module& m = document->module();
     std::optional<Span> maybe_definition_span =
         xls::dslx::FindDefinition(m, pos);
     if (maybe_definition_span.has_value()) {
@@ -165,8 +364,8 @@ LanguageServerAdapter::FormatRange(std::string_view uri,
   // `:LspDocumentRangeFormat`, so if you want the last character in a line to
   // be included it's not clear what you can do. This is annoying!
   const Span target = ConvertLspRangeToSpan(uri, range);
-  if (last_parse_data_.ok()) {
-    const Module& module = last_parse_data_->module();
+  if (const DocumentData* document = FindTypecheckedDocument(uri)) {
+    const Module& module = document->module();
     const AstNode* intercepting_block =
         module.FindNode(AstNodeKind::kBlock, target);
     if (intercepting_block == nullptr) {
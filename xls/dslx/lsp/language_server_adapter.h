@@ -15,14 +15,24 @@
 #ifndef XLS_DSLX_LSP_LANGAUGE_SERVER_ADAPTER_H_
 #define XLS_DSLX_LSP_LANGAUGE_SERVER_ADAPTER_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "external/verible/common/lsp/lsp-protocol.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/import_data.h"
 #include "xls/dslx/parse_and_typecheck.h"
 
 namespace xls::dslx {
@@ -35,12 +45,24 @@ inline std::ostream& LspLog() { return std::cerr; }
 // Note: this is a thread-compatible implementation, but not thread safe (e.g.
 // we assume the language server request handler acts as a concurrency
 // serializing entity).
+//
+// The adapter keeps a single long-lived ImportData across updates: modules
+// imported from disk are reused for as long as their contents are unchanged,
+// and an update only re-typechecks the edited document plus the open
+// documents that (transitively) import it.
 class LanguageServerAdapter {
  public:
-  LanguageServerAdapter(std::string_view stdlib,
-                        const std::vector<std::filesystem::path>& dslx_paths);
-
-  // Note: this is parsing is triggered for every keystroke. Fine for now.
+  // If "module_cache_dir" is given, modules imported from disk are loaded from
+  // (and stored to) the on-disk module cache in that directory, so that they
+  // are only typechecked once across language server sessions.
+  LanguageServerAdapter(
+      std::string_view stdlib,
+      const std::vector<std::filesystem::path>& dslx_paths,
+      std::optional<std::filesystem::path> module_cache_dir = std::nullopt);
+
+  // Parses and typechecks the given contents for file_uri, re-analyzing any
+  // open documents that depend on it. Returns the status of analyzing
+  // file_uri itself.
   absl::Status Update(std::string_view file_uri, std::string_view dslx_code);
 
   // Generate LSP diagnostics for the last file update.
@@ -61,19 +83,62 @@ class LanguageServerAdapter {
       std::string_view uri, const verible::lsp::Range& range) const;
 
  private:
+  struct DocumentData {
+    std::string module_name;
+    std::string contents;
+
+    // Result of the last analysis; on success the module is owned by
+    // import_data_.
+    absl::StatusOr<TypecheckedModule> typechecked_module;
+
+    // Names of the modules the document imports, noted when its analysis
+    // fails (so it can be retried when one of them changes).
+    std::vector<std::string> failed_imports;
+
+    const Module& module() const { return *typechecked_module->module; }
+  };
+
+  // Returns the data for the given open document if its last analysis
+  // succeeded, or nullptr otherwise.
+  const DocumentData* FindTypecheckedDocument(std::string_view uri) const;
+
+  // Parses and typechecks the document at "uri" against import_data_, noting
+  // in "invalidated" any open documents whose analysis had to be discarded.
+  void Analyze(const std::string& uri, std::vector<std::string>& invalidated);
+
+  // Evicts the given modules, and every module that transitively imports one
+  // of them, from import_data_. Open documents whose analysis referred to an
+  // evicted module, or that failed to analyze and import one, are noted in
+  // "invalidated".
+  void Evict(const absl::flat_hash_set<std::string>& module_names,
+             std::vector<std::string>& invalidated);
+
+  // Returns the names of modules imported from disk whose file contents have
+  // changed since they were imported. Only files whose modification time or
+  // size changed are re-read and rehashed.
+  absl::flat_hash_set<std::string> GetChangedImports();
+
+  // Notes the content hash of any newly imported modules in import_hashes_.
+  void NoteImportHashes();
+
   const std::string stdlib_;
   const std::vector<std::filesystem::path> dslx_paths_;
+  std::unique_ptr<ImportData> import_data_;
 
-  struct LastParseData {
-    ImportData import_data;
-    TypecheckedModule typechecked_module;
-    std::filesystem::path path;
-    std::string contents;
+  // Open documents, keyed by uri.
+  absl::flat_hash_map<std::string, DocumentData> documents_;
 
-    const Module& module() const { return *typechecked_module.module; }
+  struct ImportedFile {
+    std::filesystem::path path;
+    size_t hash;
+    // Modification time and size of the file when "hash" was last checked.
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
   };
 
-  absl::StatusOr<LastParseData> last_parse_data_;
+  // Hash of the file contents of each module imported from disk (i.e. not an
+  // open document), keyed by module name.
+  absl::flat_hash_map<std::string, ImportedFile> import_hashes_;
 };
 
 }  // namespace xls::dslx
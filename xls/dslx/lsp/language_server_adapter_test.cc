@@ -14,10 +14,15 @@
 
 #include "xls/dslx/lsp/language_server_adapter.h"
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <string_view>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 
@@ -133,5 +138,60 @@ TEST(LanguageServerAdapterTest, TestFormatRange) {
     })");
 }
 
+TEST(LanguageServerAdapterTest, DependentDocumentIsReanalyzed) {
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath, {"."});
+  constexpr std::string_view kImportedUri = "memfile://imported.x";
+  constexpr std::string_view kImporterUri = "memfile://importer.x";
+  XLS_ASSERT_OK(adapter.Update(kImportedUri, "pub fn f() -> u32 { u32:42 }"));
+  XLS_ASSERT_OK(adapter.Update(
+      kImporterUri, "import imported;\nfn g() -> u32 { imported::f() }"));
+  EXPECT_TRUE(adapter.GenerateParseDiagnostics(kImporterUri).empty());
+
+  // Removing `f` from the imported document breaks the (unedited) importer...
+  XLS_ASSERT_OK(adapter.Update(kImportedUri, "pub fn h() -> u32 { u32:42 }"));
+  EXPECT_EQ(adapter.GenerateParseDiagnostics(kImporterUri).size(), 1);
+  EXPECT_TRUE(adapter.GenerateDocumentSymbols(kImporterUri).empty());
+
+  // ...and restoring it fixes the importer again.
+  XLS_ASSERT_OK(adapter.Update(kImportedUri, "pub fn f() -> u32 { u32:64 }"));
+  EXPECT_TRUE(adapter.GenerateParseDiagnostics(kImporterUri).empty());
+  EXPECT_EQ(adapter.GenerateDocumentSymbols(kImporterUri).size(), 1);
+}
+
+TEST(LanguageServerAdapterTest, ReusesImportsAcrossUpdates) {
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath, {"."});
+  constexpr std::string_view kUri = "memfile://test.x";
+  for (int64_t i = 0; i < 3; ++i) {
+    XLS_ASSERT_OK(adapter.Update(
+        kUri, absl::StrCat("import std;\nfn f() -> u32 { std::umax(u32:", i,
+                           ", u32:1) }")));
+    EXPECT_TRUE(adapter.GenerateParseDiagnostics(kUri).empty());
+  }
+  // Imports stay usable after an update that fails to typecheck.
+  ASSERT_FALSE(
+      adapter.Update(kUri, "import std;\nfn f() -> u32 { std::umax() }").ok());
+  XLS_ASSERT_OK(adapter.Update(
+      kUri, "import std;\nfn f() -> u32 { std::popcount(u32:3) }"));
+}
+
+TEST(LanguageServerAdapterTest, ChangedImportOnDiskIsReanalyzed) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  const std::filesystem::path dep_path = temp_dir.path() / "dep.x";
+  XLS_ASSERT_OK(SetFileContents(dep_path, "pub fn f() -> u32 { u32:42 }"));
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath, {temp_dir.path()});
+  constexpr std::string_view kUri = "memfile://test.x";
+  constexpr std::string_view kText =
+      "import dep;\nfn g() -> u32 { dep::f() }";
+  XLS_ASSERT_OK(adapter.Update(kUri, kText));
+
+  // Rewriting the import with the same contents keeps it usable.
+  XLS_ASSERT_OK(SetFileContents(dep_path, "pub fn f() -> u32 { u32:42 }"));
+  XLS_ASSERT_OK(adapter.Update(kUri, kText));
+
+  // Removing `f` from the import breaks the document.
+  XLS_ASSERT_OK(SetFileContents(dep_path, "pub fn h() -> u32 { u32:7 }"));
+  EXPECT_FALSE(adapter.Update(kUri, kText).ok());
+}
+
 }  // namespace
 }  // namespace xls::dslx
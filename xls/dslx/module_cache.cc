@@ -0,0 +1,1449 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/module_cache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>  // NOLINT
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "openssl/sha.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/channel_direction.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/frontend/pos.h"
+#include "xls/dslx/frontend/proc.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/module_cache.pb.h"
+#include "xls/dslx/type_system/concrete_type.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/parametric_expression.h"
+#include "xls/dslx/type_system/type_info.h"
+#include "xls/dslx/type_system/type_info.pb.h"
+#include "xls/dslx/warning_collector.h"
+#include "xls/dslx/warning_kind.h"
+#include "xls/ir/bits.h"
+
+namespace xls::dslx {
+namespace {
+
+// Changed whenever the meaning of ModuleCacheEntryProto changes, which
+// invalidates all existing entries.
+constexpr std::string_view kFormatVersion = "1";
+
+// Identifies the running tool binary -- and so the typechecker that produces
+// entries -- by its size and modification time, as ccache identifies
+// compilers. Empty if the binary cannot be inspected.
+const std::string& GetToolIdentity() {
+  static const std::string* identity = [] {
+    const std::filesystem::path exe = "/proc/self/exe";
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(exe, ec);
+    if (ec) {
+      return new std::string();
+    }
+    std::filesystem::file_time_type mtime =
+        std::filesystem::last_write_time(exe, ec);
+    if (ec) {
+      return new std::string();
+    }
+    return new std::string(
+        absl::StrCat(size, ":", mtime.time_since_epoch().count()));
+  }();
+  return *identity;
+}
+
+// Returns the (hex) SHA-256 digest of the given fields.
+std::string HashFields(absl::Span<const std::string> fields) {
+  std::string data;
+  for (const std::string& field : fields) {
+    absl::StrAppend(&data, field.size(), ":", field, ";");
+  }
+  std::array<uint8_t, SHA256_DIGEST_LENGTH> digest;
+  SHA256(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+         digest.data());
+  return absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+// Returns the number of entries held in the mappings of "type_info" that cache
+// entries record; i.e. everything but memoized results, which are only ever
+// recomputed when absent.
+int64_t CountEntries(const TypeInfo& type_info) {
+  int64_t count = type_info.dict().size() + type_info.const_exprs().size() +
+                  type_info.imports().size() +
+                  type_info.requires_implicit_token().size() +
+                  type_info.top_level_proc_type_infos().size();
+  for (const auto& [invocation, data] : type_info.invocations()) {
+    count += data.parametric_env_map.size() + data.instantiations.size();
+  }
+  for (const auto& [slice, data] : type_info.slices()) {
+    count += data.bindings_to_start_width.size();
+  }
+  return count;
+}
+
+// The keys of the entries in the root type information of an imported module
+// before an importer is typechecked, so that the entries typechecking adds can
+// be told apart.
+struct RootSnapshot {
+  absl::flat_hash_set<const AstNode*> types;
+  absl::flat_hash_set<const AstNode*> const_exprs;
+  absl::flat_hash_set<const Import*> imports;
+  absl::flat_hash_set<std::pair<const Invocation*, ParametricEnv>>
+      invocation_bindings;
+  absl::flat_hash_set<std::pair<const Invocation*, ParametricEnv>>
+      invocation_type_infos;
+  absl::flat_hash_set<std::pair<const Slice*, ParametricEnv>> slices;
+  absl::flat_hash_set<const Function*> requires_implicit_token;
+  absl::flat_hash_set<const Proc*> top_level_procs;
+};
+
+RootSnapshot TakeSnapshot(const TypeInfo& root) {
+  RootSnapshot snapshot;
+  for (const auto& [node, type] : root.dict()) {
+    snapshot.types.insert(node);
+  }
+  for (const auto& [node, value] : root.const_exprs()) {
+    snapshot.const_exprs.insert(node);
+  }
+  for (const auto& [import, info] : root.imports()) {
+    snapshot.imports.insert(import);
+  }
+  for (const auto& [invocation, data] : root.invocations()) {
+    for (const auto& [caller, callee] : data.parametric_env_map) {
+      snapshot.invocation_bindings.insert({invocation, caller});
+    }
+    for (const auto& [caller, type_info] : data.instantiations) {
+      snapshot.invocation_type_infos.insert({invocation, caller});
+    }
+  }
+  for (const auto& [slice, data] : root.slices()) {
+    for (const auto& [env, start_width] : data.bindings_to_start_width) {
+      snapshot.slices.insert({slice, env});
+    }
+  }
+  for (const auto& [f, is_required] : root.requires_implicit_token()) {
+    snapshot.requires_implicit_token.insert(f);
+  }
+  for (const auto& [proc, type_info] : root.top_level_proc_type_infos()) {
+    snapshot.top_level_procs.insert(proc);
+  }
+  return snapshot;
+}
+
+bool IsEmpty(const ModuleCacheTypeInfoProto& proto) {
+  return proto.types().empty() && proto.const_exprs().empty() &&
+         proto.imports().empty() && proto.invocation_bindings().empty() &&
+         proto.invocation_type_infos().empty() && proto.slices().empty() &&
+         proto.requires_implicit_token().empty() &&
+         proto.top_level_procs().empty();
+}
+
+SpanProto SpanToProto(const Span& span) {
+  SpanProto proto;
+  for (auto [pos, pos_proto] : {std::make_pair(&span.start(),
+                                               proto.mutable_start()),
+                                std::make_pair(&span.limit(),
+                                               proto.mutable_limit())}) {
+    pos_proto->set_filename(pos->filename());
+    pos_proto->set_lineno(static_cast<int32_t>(pos->lineno()));
+    pos_proto->set_colno(static_cast<int32_t>(pos->colno()));
+  }
+  return proto;
+}
+
+absl::StatusOr<Span> SpanFromProto(const SpanProto& proto) {
+  if (proto.start().filename() != proto.limit().filename()) {
+    return absl::InvalidArgumentError("Span crosses files: " +
+                                      proto.ShortDebugString());
+  }
+  return Span(Pos(proto.start().filename(), proto.start().lineno(),
+                  proto.start().colno()),
+              Pos(proto.limit().filename(), proto.limit().lineno(),
+                  proto.limit().colno()));
+}
+
+// As in TypeInfoProto, data is stored in big endian format.
+BitsValueProto BitsToProto(const Bits& bits, bool is_signed) {
+  BitsValueProto proto;
+  proto.set_is_signed(is_signed);
+  proto.set_bit_count(static_cast<int32_t>(bits.bit_count()));
+  std::vector<uint8_t> bytes = bits.ToBytes();
+  std::reverse(bytes.begin(), bytes.end());
+  proto.set_data(std::string(bytes.begin(), bytes.end()));
+  return proto;
+}
+
+absl::StatusOr<Bits> BitsFromProto(const BitsValueProto& proto) {
+  if (proto.bit_count() < 0 ||
+      proto.data().size() != CeilOfRatio(int64_t{proto.bit_count()},
+                                         int64_t{8})) {
+    return absl::InvalidArgumentError("Malformed bits value: " +
+                                      proto.ShortDebugString());
+  }
+  std::vector<uint8_t> bytes(proto.data().rbegin(), proto.data().rend());
+  return Bits::FromBytes(bytes, proto.bit_count());
+}
+
+ChannelDirectionProto ChannelDirectionToProto(ChannelDirection direction) {
+  return direction == ChannelDirection::kIn
+             ? ChannelDirectionProto::CHANNEL_DIRECTION_IN
+             : ChannelDirectionProto::CHANNEL_DIRECTION_OUT;
+}
+
+// Converts type information to its cached form, refusing (with an
+// unimplemented error) whatever cannot be reproduced when the entry is loaded.
+class EntryEncoder {
+ public:
+  // "modules" is the module table of the entry and "node_counts" the number of
+  // AST nodes each module had after parsing; "created" is the type information
+  // that typechecking modules[0] created.
+  EntryEncoder(absl::Span<Module* const> modules,
+               absl::Span<const int64_t> node_counts,
+               absl::Span<TypeInfo* const> created)
+      : modules_(modules.begin(), modules.end()),
+        node_counts_(node_counts.begin(), node_counts.end()),
+        node_indices_(modules.size()) {
+    for (int64_t i = 0; i < modules.size(); ++i) {
+      module_indices_[modules[i]] = i;
+    }
+    for (int64_t i = 0; i < created.size(); ++i) {
+      created_indices_[created[i]] = i;
+    }
+  }
+
+  // Encodes the entries of "type_info"; if "before" is given, only those that
+  // are not in it.
+  absl::StatusOr<ModuleCacheTypeInfoProto> EncodeTypeInfo(
+      const TypeInfo& type_info, const RootSnapshot* before) {
+    ModuleCacheTypeInfoProto proto;
+    XLS_ASSIGN_OR_RETURN(int64_t module, EncodeModule(type_info.module()));
+    proto.set_module(module);
+    if (type_info.parent() != nullptr) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_parent(),
+                           EncodeTypeInfoRef(type_info.parent()));
+    }
+    for (const auto& [node, type] : type_info.dict()) {
+      if (before != nullptr && before->types.contains(node)) {
+        continue;
+      }
+      ModuleCacheTypeInfoProto::Type* item = proto.add_types();
+      XLS_ASSIGN_OR_RETURN(*item->mutable_node(), EncodeKey(node, type_info));
+      XLS_ASSIGN_OR_RETURN(*item->mutable_type(), EncodeType(*type));
+    }
+    for (const auto& [node, value] : type_info.const_exprs()) {
+      if (before != nullptr && before->const_exprs.contains(node)) {
+        continue;
+      }
+      if (!value.has_value()) {
+        return absl::UnimplementedError(
+            "Non-constexpr notes are not cached: " + node->ToString());
+      }
+      ModuleCacheTypeInfoProto::ConstExpr* item = proto.add_const_exprs();
+      XLS_ASSIGN_OR_RETURN(*item->mutable_node(), EncodeKey(node, type_info));
+      XLS_ASSIGN_OR_RETURN(*item->mutable_value(), EncodeValue(*value));
+    }
+    for (const auto& [import, info] : type_info.imports()) {
+      if (before != nullptr && before->imports.contains(import)) {
+        continue;
+      }
+      if (info.type_info == nullptr || info.type_info->parent() != nullptr ||
+          info.type_info->module() != info.module) {
+        return absl::UnimplementedError(
+            "Import does not refer to the root type information of the "
+            "imported module: " +
+            import->ToString());
+      }
+      ModuleCacheTypeInfoProto::Import* item = proto.add_imports();
+      XLS_ASSIGN_OR_RETURN(*item->mutable_import(),
+                           EncodeKey(import, type_info));
+      XLS_ASSIGN_OR_RETURN(int64_t imported, EncodeModule(info.module));
+      item->set_module(imported);
+    }
+    for (const auto& [invocation, data] : type_info.invocations()) {
+      for (const auto& [caller, callee] : data.parametric_env_map) {
+        if (before != nullptr &&
+            before->invocation_bindings.contains({invocation, caller})) {
+          continue;
+        }
+        ModuleCacheTypeInfoProto::InvocationBindings* item =
+            proto.add_invocation_bindings();
+        XLS_ASSIGN_OR_RETURN(*item->mutable_invocation(),
+                             EncodeKey(invocation, type_info));
+        XLS_ASSIGN_OR_RETURN(*item->mutable_caller(), EncodeEnv(caller));
+        XLS_ASSIGN_OR_RETURN(*item->mutable_callee(), EncodeEnv(callee));
+      }
+      for (const auto& [caller, callee_type_info] : data.instantiations) {
+        if (before != nullptr &&
+            before->invocation_type_infos.contains({invocation, caller})) {
+          continue;
+        }
+        ModuleCacheTypeInfoProto::InvocationTypeInfo* item =
+            proto.add_invocation_type_infos();
+        XLS_ASSIGN_OR_RETURN(*item->mutable_invocation(),
+                             EncodeKey(invocation, type_info));
+        XLS_ASSIGN_OR_RETURN(*item->mutable_caller(), EncodeEnv(caller));
+        XLS_ASSIGN_OR_RETURN(*item->mutable_type_info(),
+                             EncodeTypeInfoRef(callee_type_info));
+      }
+    }
+    for (const auto& [slice, data] : type_info.slices()) {
+      for (const auto& [env, start_width] : data.bindings_to_start_width) {
+        if (before != nullptr && before->slices.contains({slice, env})) {
+          continue;
+        }
+        ModuleCacheTypeInfoProto::Slice* item = proto.add_slices();
+        XLS_ASSIGN_OR_RETURN(*item->mutable_slice(),
+                             EncodeKey(slice, type_info));
+        XLS_ASSIGN_OR_RETURN(*item->mutable_env(), EncodeEnv(env));
+        item->set_start(start_width.start);
+        item->set_width(start_width.width);
+      }
+    }
+    for (const auto& [f, is_required] : type_info.requires_implicit_token()) {
+      if (before != nullptr && before->requires_implicit_token.contains(f)) {
+        continue;
+      }
+      ModuleCacheTypeInfoProto::RequiresImplicitToken* item =
+          proto.add_requires_implicit_token();
+      XLS_ASSIGN_OR_RETURN(*item->mutable_function(), EncodeKey(f, type_info));
+      item->set_is_required(is_required);
+    }
+    for (const auto& [proc, proc_type_info] :
+         type_info.top_level_proc_type_infos()) {
+      if (before != nullptr && before->top_level_procs.contains(proc)) {
+        continue;
+      }
+      ModuleCacheTypeInfoProto::TopLevelProc* item =
+          proto.add_top_level_procs();
+      XLS_ASSIGN_OR_RETURN(*item->mutable_proc(), EncodeKey(proc, type_info));
+      XLS_ASSIGN_OR_RETURN(*item->mutable_type_info(),
+                           EncodeTypeInfoRef(proc_type_info));
+    }
+    return proto;
+  }
+
+ private:
+  absl::StatusOr<int64_t> EncodeModule(const Module* module) {
+    auto it = module_indices_.find(module);
+    if (it == module_indices_.end()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Refers to module `%s`, which is not imported", module->name()));
+    }
+    return it->second;
+  }
+
+  // Encodes a node keying a mapping of "type_info", which must be for the
+  // module of the node (as loading the entry relies on).
+  absl::StatusOr<ModuleCacheNodeRefProto> EncodeKey(const AstNode* node,
+                                                    const TypeInfo& type_info) {
+    if (node->owner() != type_info.module()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "AST node `%s` keys type information for another module",
+          node->ToString()));
+    }
+    return EncodeNode(node);
+  }
+
+  absl::StatusOr<ModuleCacheNodeRefProto> EncodeNode(const AstNode* node) {
+    XLS_ASSIGN_OR_RETURN(int64_t module, EncodeModule(node->owner()));
+    std::optional<absl::flat_hash_map<const AstNode*, int64_t>>& indices =
+        node_indices_[module];
+    if (!indices.has_value()) {
+      indices.emplace();
+      absl::Span<AstNode* const> nodes = modules_[module]->nodes();
+      for (int64_t i = 0; i < node_counts_[module]; ++i) {
+        indices->emplace(nodes[i], i);
+      }
+    }
+    auto it = indices->find(node);
+    if (it == indices->end()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "AST node `%s` was created by typechecking", node->ToString()));
+    }
+    ModuleCacheNodeRefProto proto;
+    proto.set_module(module);
+    proto.set_node(it->second);
+    return proto;
+  }
+
+  absl::StatusOr<ModuleCacheTypeInfoRefProto> EncodeTypeInfoRef(
+      const TypeInfo* type_info) {
+    ModuleCacheTypeInfoRefProto proto;
+    if (type_info == nullptr) {
+      return proto;
+    }
+    if (auto it = created_indices_.find(type_info);
+        it != created_indices_.end()) {
+      proto.set_created(it->second);
+      return proto;
+    }
+    if (type_info->parent() == nullptr) {
+      XLS_ASSIGN_OR_RETURN(int64_t module, EncodeModule(type_info->module()));
+      proto.set_module_root(module);
+      return proto;
+    }
+    return absl::UnimplementedError(absl::StrFormat(
+        "Refers to type information for module `%s` created by an earlier "
+        "typecheck",
+        type_info->module()->name()));
+  }
+
+  absl::StatusOr<ModuleCacheValueProto> EncodeValue(const InterpValue& value) {
+    ModuleCacheValueProto proto;
+    switch (value.tag()) {
+      case InterpValueTag::kUBits:
+      case InterpValueTag::kSBits:
+        *proto.mutable_bits() =
+            BitsToProto(value.GetBitsOrDie(), value.IsSBits());
+        return proto;
+      case InterpValueTag::kTuple:
+      case InterpValueTag::kArray: {
+        ModuleCacheValuesProto* elements =
+            value.IsTuple() ? proto.mutable_tuple() : proto.mutable_array();
+        for (const InterpValue& element : value.GetValuesOrDie()) {
+          XLS_ASSIGN_OR_RETURN(*elements->add_elements(),
+                               EncodeValue(element));
+        }
+        return proto;
+      }
+      case InterpValueTag::kEnum: {
+        InterpValue::EnumData data = value.GetEnumData().value();
+        ModuleCacheEnumValueProto* enum_value = proto.mutable_enum_value();
+        XLS_ASSIGN_OR_RETURN(*enum_value->mutable_enum_def(),
+                             EncodeNode(data.def));
+        *enum_value->mutable_bits() = BitsToProto(data.value, data.is_signed);
+        return proto;
+      }
+      case InterpValueTag::kFunction: {
+        const InterpValue::FnData& fn_data = value.GetFunctionOrDie();
+        if (std::holds_alternative<Builtin>(fn_data)) {
+          proto.set_builtin_function(
+              BuiltinToString(std::get<Builtin>(fn_data)));
+        } else {
+          XLS_ASSIGN_OR_RETURN(
+              *proto.mutable_user_function(),
+              EncodeNode(std::get<InterpValue::UserFnData>(fn_data).function));
+        }
+        return proto;
+      }
+      case InterpValueTag::kToken:
+        proto.set_token(true);
+        return proto;
+      case InterpValueTag::kChannel:
+        break;
+    }
+    return absl::UnimplementedError("Value is not cached: " +
+                                    value.ToString());
+  }
+
+  absl::StatusOr<ModuleCacheParametricEnvProto> EncodeEnv(
+      const ParametricEnv& env) {
+    ModuleCacheParametricEnvProto proto;
+    for (const ParametricEnvItem& item : env.bindings()) {
+      ModuleCacheParametricEnvProto::Binding* binding = proto.add_bindings();
+      binding->set_identifier(item.identifier);
+      XLS_ASSIGN_OR_RETURN(*binding->mutable_value(), EncodeValue(item.value));
+    }
+    return proto;
+  }
+
+  absl::StatusOr<ModuleCacheParametricExpressionProto> EncodeParametric(
+      const ParametricExpression& e) {
+    ModuleCacheParametricExpressionProto proto;
+    if (const auto* c = dynamic_cast<const ParametricConstant*>(&e)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_constant(), EncodeValue(c->value()));
+      return proto;
+    }
+    if (const auto* s = dynamic_cast<const ParametricSymbol*>(&e)) {
+      proto.mutable_symbol()->set_identifier(s->identifier());
+      *proto.mutable_symbol()->mutable_span() = SpanToProto(s->span());
+    } else if (const auto* add = dynamic_cast<const ParametricAdd*>(&e)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_add()->mutable_lhs(),
+                           EncodeParametric(add->lhs()));
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_add()->mutable_rhs(),
+                           EncodeParametric(add->rhs()));
+    } else if (const auto* mul = dynamic_cast<const ParametricMul*>(&e)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_mul()->mutable_lhs(),
+                           EncodeParametric(mul->lhs()));
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_mul()->mutable_rhs(),
+                           EncodeParametric(mul->rhs()));
+    } else if (const auto* width = dynamic_cast<const ParametricWidth*>(&e)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_width(),
+                           EncodeParametric(width->arg()));
+    } else {
+      return absl::UnimplementedError("Parametric expression is not cached: " +
+                                      e.ToString());
+    }
+    if (std::optional<InterpValue> const_value = e.const_value()) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_const_value(),
+                           EncodeValue(*const_value));
+    }
+    return proto;
+  }
+
+  absl::StatusOr<ModuleCacheTypeDimProto> EncodeDim(
+      const ConcreteTypeDim& dim) {
+    ModuleCacheTypeDimProto proto;
+    if (dim.IsParametric()) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_parametric(),
+                           EncodeParametric(dim.parametric()));
+    } else {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_value(),
+                           EncodeValue(std::get<InterpValue>(dim.value())));
+    }
+    return proto;
+  }
+
+  absl::StatusOr<ModuleCacheTypeProto> EncodeType(const ConcreteType& type) {
+    ModuleCacheTypeProto proto;
+    if (const auto* bits = dynamic_cast<const BitsType*>(&type)) {
+      proto.mutable_bits()->set_is_signed(bits->is_signed());
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_bits()->mutable_size(),
+                           EncodeDim(bits->size()));
+    } else if (const auto* tuple = dynamic_cast<const TupleType*>(&type)) {
+      ModuleCacheTypesProto* members = proto.mutable_tuple();
+      for (const std::unique_ptr<ConcreteType>& member : tuple->members()) {
+        XLS_ASSIGN_OR_RETURN(*members->add_members(), EncodeType(*member));
+      }
+    } else if (const auto* array = dynamic_cast<const ArrayType*>(&type)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_array()->mutable_element_type(),
+                           EncodeType(array->element_type()));
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_array()->mutable_size(),
+                           EncodeDim(array->size()));
+    } else if (const auto* s = dynamic_cast<const StructType*>(&type)) {
+      ModuleCacheStructTypeProto* struct_type = proto.mutable_struct_type();
+      XLS_ASSIGN_OR_RETURN(*struct_type->mutable_struct_def(),
+                           EncodeNode(&s->nominal_type()));
+      for (const std::unique_ptr<ConcreteType>& member : s->members()) {
+        XLS_ASSIGN_OR_RETURN(*struct_type->add_members(), EncodeType(*member));
+      }
+    } else if (const auto* e = dynamic_cast<const EnumType*>(&type)) {
+      ModuleCacheEnumTypeProto* enum_type = proto.mutable_enum_type();
+      XLS_ASSIGN_OR_RETURN(*enum_type->mutable_enum_def(),
+                           EncodeNode(&e->nominal_type()));
+      XLS_ASSIGN_OR_RETURN(*enum_type->mutable_size(), EncodeDim(e->size()));
+      enum_type->set_is_signed(e->is_signed());
+      for (const InterpValue& member : e->members()) {
+        XLS_ASSIGN_OR_RETURN(*enum_type->add_members(), EncodeValue(member));
+      }
+    } else if (const auto* f = dynamic_cast<const FunctionType*>(&type)) {
+      ModuleCacheFunctionTypeProto* function = proto.mutable_function();
+      for (const std::unique_ptr<ConcreteType>& param : f->params()) {
+        XLS_ASSIGN_OR_RETURN(*function->add_params(), EncodeType(*param));
+      }
+      XLS_ASSIGN_OR_RETURN(*function->mutable_return_type(),
+                           EncodeType(f->return_type()));
+    } else if (const auto* c = dynamic_cast<const ChannelType*>(&type)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_channel()->mutable_payload(),
+                           EncodeType(c->payload_type()));
+      proto.mutable_channel()->set_direction(
+          ChannelDirectionToProto(c->direction()));
+    } else if (const auto* meta = dynamic_cast<const MetaType*>(&type)) {
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_meta(), EncodeType(*meta->wrapped()));
+    } else if (dynamic_cast<const TokenType*>(&type) != nullptr) {
+      proto.set_token(true);
+    } else {
+      return absl::UnimplementedError("Type is not cached: " + type.ToString());
+    }
+    return proto;
+  }
+
+  std::vector<Module*> modules_;
+  std::vector<int64_t> node_counts_;
+  absl::flat_hash_map<const Module*, int64_t> module_indices_;
+  // Built on first use, as most entries refer to few of the imported modules.
+  std::vector<std::optional<absl::flat_hash_map<const AstNode*, int64_t>>>
+      node_indices_;
+  absl::flat_hash_map<const TypeInfo*, int64_t> created_indices_;
+};
+
+// Refers to type information while an entry is decoded, before the type
+// information the entry creates exists: "created" indexes the created type
+// information when it is non-negative, otherwise "existing" (which may be
+// nullptr) is referred to.
+struct DecodedTypeInfoRef {
+  int64_t created = -1;
+  TypeInfo* existing = nullptr;
+};
+
+// The entries of a ModuleCacheTypeInfoProto with all references resolved.
+struct DecodedTypeInfo {
+  int64_t module_index;
+  Module* module;
+  std::optional<DecodedTypeInfoRef> parent;
+  std::vector<std::pair<const AstNode*, std::unique_ptr<ConcreteType>>> types;
+  std::vector<std::pair<const AstNode*, InterpValue>> const_exprs;
+  std::vector<std::pair<Import*, Module*>> imports;
+  std::vector<std::tuple<const Invocation*, ParametricEnv, ParametricEnv>>
+      invocation_bindings;
+  std::vector<std::tuple<const Invocation*, ParametricEnv, DecodedTypeInfoRef>>
+      invocation_type_infos;
+  std::vector<std::tuple<Slice*, ParametricEnv, StartAndWidth>> slices;
+  std::vector<std::pair<const Function*, bool>> requires_implicit_token;
+  std::vector<std::pair<const Proc*, DecodedTypeInfoRef>> top_level_procs;
+};
+
+// Converts the cached form of type information back, validating it along the
+// way so that applying the result cannot fail.
+class EntryDecoder {
+ public:
+  // "modules" is the resolved module table of the entry, where modules[0] is
+  // the module being loaded; "node_counts" bounds the AST nodes the entry may
+  // refer to in each, and "roots" holds the root type information of each
+  // module but the first.
+  EntryDecoder(std::vector<Module*> modules, std::vector<int64_t> node_counts,
+               std::vector<TypeInfo*> roots, int64_t created_count)
+      : modules_(std::move(modules)),
+        node_counts_(std::move(node_counts)),
+        roots_(std::move(roots)),
+        created_count_(created_count) {}
+
+  absl::StatusOr<DecodedTypeInfo> DecodeTypeInfo(
+      const ModuleCacheTypeInfoProto& proto) {
+    DecodedTypeInfo result;
+    result.module_index = proto.module();
+    XLS_ASSIGN_OR_RETURN(result.module, DecodeModule(proto.module()));
+    if (proto.has_parent()) {
+      XLS_ASSIGN_OR_RETURN(result.parent, DecodeTypeInfoRef(proto.parent()));
+    }
+    for (const ModuleCacheTypeInfoProto::Type& item : proto.types()) {
+      XLS_ASSIGN_OR_RETURN(AstNode * node,
+                           DecodeKey<AstNode>(item.node(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> type,
+                           DecodeType(item.type()));
+      result.types.push_back({node, std::move(type)});
+    }
+    for (const ModuleCacheTypeInfoProto::ConstExpr& item :
+         proto.const_exprs()) {
+      XLS_ASSIGN_OR_RETURN(AstNode * node,
+                           DecodeKey<AstNode>(item.node(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(item.value()));
+      result.const_exprs.push_back({node, std::move(value)});
+    }
+    for (const ModuleCacheTypeInfoProto::Import& item : proto.imports()) {
+      XLS_ASSIGN_OR_RETURN(Import * import,
+                           DecodeKey<Import>(item.import(), proto.module()));
+      if (item.module() == 0) {
+        return absl::InvalidArgumentError("Module imports itself");
+      }
+      XLS_ASSIGN_OR_RETURN(Module * imported, DecodeModule(item.module()));
+      result.imports.push_back({import, imported});
+    }
+    for (const ModuleCacheTypeInfoProto::InvocationBindings& item :
+         proto.invocation_bindings()) {
+      XLS_ASSIGN_OR_RETURN(
+          Invocation * invocation,
+          DecodeKey<Invocation>(item.invocation(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(ParametricEnv caller, DecodeEnv(item.caller()));
+      XLS_ASSIGN_OR_RETURN(ParametricEnv callee, DecodeEnv(item.callee()));
+      result.invocation_bindings.push_back(
+          {invocation, std::move(caller), std::move(callee)});
+    }
+    for (const ModuleCacheTypeInfoProto::InvocationTypeInfo& item :
+         proto.invocation_type_infos()) {
+      XLS_ASSIGN_OR_RETURN(
+          Invocation * invocation,
+          DecodeKey<Invocation>(item.invocation(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(ParametricEnv caller, DecodeEnv(item.caller()));
+      XLS_ASSIGN_OR_RETURN(DecodedTypeInfoRef type_info,
+                           DecodeTypeInfoRef(item.type_info()));
+      result.invocation_type_infos.push_back(
+          {invocation, std::move(caller), type_info});
+    }
+    for (const ModuleCacheTypeInfoProto::Slice& item : proto.slices()) {
+      XLS_ASSIGN_OR_RETURN(Slice * slice,
+                           DecodeKey<Slice>(item.slice(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(ParametricEnv env, DecodeEnv(item.env()));
+      result.slices.push_back(
+          {slice, std::move(env), StartAndWidth{item.start(), item.width()}});
+    }
+    for (const ModuleCacheTypeInfoProto::RequiresImplicitToken& item :
+         proto.requires_implicit_token()) {
+      XLS_ASSIGN_OR_RETURN(
+          Function * f, DecodeKey<Function>(item.function(), proto.module()));
+      result.requires_implicit_token.push_back({f, item.is_required()});
+    }
+    for (const ModuleCacheTypeInfoProto::TopLevelProc& item :
+         proto.top_level_procs()) {
+      if (proto.has_parent()) {
+        return absl::InvalidArgumentError(
+            "Top-level proc type information noted on a non-root type "
+            "information");
+      }
+      XLS_ASSIGN_OR_RETURN(Proc * proc,
+                           DecodeKey<Proc>(item.proc(), proto.module()));
+      XLS_ASSIGN_OR_RETURN(DecodedTypeInfoRef type_info,
+                           DecodeTypeInfoRef(item.type_info()));
+      result.top_level_procs.push_back({proc, type_info});
+    }
+    return result;
+  }
+
+  absl::StatusOr<WarningCollector::Entry> DecodeWarning(
+      const ModuleCacheWarningProto& proto) {
+    XLS_ASSIGN_OR_RETURN(Span span, SpanFromProto(proto.span()));
+    XLS_ASSIGN_OR_RETURN(WarningKind kind, WarningKindFromString(proto.kind()));
+    return WarningCollector::Entry{std::move(span), kind, proto.message()};
+  }
+
+ private:
+  absl::StatusOr<Module*> DecodeModule(int64_t index) {
+    if (index < 0 || index >= modules_.size()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Module index out of range: ", index));
+    }
+    return modules_[index];
+  }
+
+  template <typename T>
+  absl::StatusOr<T*> DecodeNode(const ModuleCacheNodeRefProto& proto) {
+    XLS_ASSIGN_OR_RETURN(Module * module, DecodeModule(proto.module()));
+    if (proto.node() < 0 || proto.node() >= node_counts_[proto.module()]) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("AST node index out of range: ", proto.node()));
+    }
+    auto* node = dynamic_cast<T*>(module->nodes()[proto.node()]);
+    if (node == nullptr) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("AST node has an unexpected kind: ",
+                       module->nodes()[proto.node()]->ToString()));
+    }
+    return node;
+  }
+
+  // Decodes a node keying a mapping of type information for modules[module],
+  // which it must belong to.
+  template <typename T>
+  absl::StatusOr<T*> DecodeKey(const ModuleCacheNodeRefProto& proto,
+                               int64_t module) {
+    if (proto.module() != module) {
+      return absl::InvalidArgumentError(
+          "AST node keys type information for another module");
+    }
+    return DecodeNode<T>(proto);
+  }
+
+  absl::StatusOr<DecodedTypeInfoRef> DecodeTypeInfoRef(
+      const ModuleCacheTypeInfoRefProto& proto) {
+    DecodedTypeInfoRef result;
+    switch (proto.type_info_oneof_case()) {
+      case ModuleCacheTypeInfoRefProto::kCreated:
+        if (proto.created() < 0 || proto.created() >= created_count_) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              "Type information index out of range: ", proto.created()));
+        }
+        result.created = proto.created();
+        break;
+      case ModuleCacheTypeInfoRefProto::kModuleRoot:
+        if (proto.module_root() <= 0 || proto.module_root() >= roots_.size()) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              "Root module index out of range: ", proto.module_root()));
+        }
+        result.existing = roots_[proto.module_root()];
+        break;
+      case ModuleCacheTypeInfoRefProto::TYPE_INFO_ONEOF_NOT_SET:
+        break;
+    }
+    return result;
+  }
+
+  absl::StatusOr<InterpValue> DecodeValue(const ModuleCacheValueProto& proto) {
+    switch (proto.value_oneof_case()) {
+      case ModuleCacheValueProto::kBits: {
+        XLS_ASSIGN_OR_RETURN(Bits bits, BitsFromProto(proto.bits()));
+        return InterpValue::MakeBits(proto.bits().is_signed(), std::move(bits));
+      }
+      case ModuleCacheValueProto::kTuple:
+      case ModuleCacheValueProto::kArray: {
+        bool is_tuple =
+            proto.value_oneof_case() == ModuleCacheValueProto::kTuple;
+        std::vector<InterpValue> elements;
+        for (const ModuleCacheValueProto& element :
+             is_tuple ? proto.tuple().elements() : proto.array().elements()) {
+          XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(element));
+          elements.push_back(std::move(value));
+        }
+        if (is_tuple) {
+          return InterpValue::MakeTuple(std::move(elements));
+        }
+        return InterpValue::MakeArray(std::move(elements));
+      }
+      case ModuleCacheValueProto::kEnumValue: {
+        const ModuleCacheEnumValueProto& enum_value = proto.enum_value();
+        XLS_ASSIGN_OR_RETURN(EnumDef * def,
+                             DecodeNode<EnumDef>(enum_value.enum_def()));
+        XLS_ASSIGN_OR_RETURN(Bits bits, BitsFromProto(enum_value.bits()));
+        return InterpValue::MakeEnum(std::move(bits),
+                                     enum_value.bits().is_signed(), def);
+      }
+      case ModuleCacheValueProto::kBuiltinFunction: {
+        XLS_ASSIGN_OR_RETURN(Builtin builtin,
+                             BuiltinFromString(proto.builtin_function()));
+        return InterpValue::MakeFunction(builtin);
+      }
+      case ModuleCacheValueProto::kUserFunction: {
+        XLS_ASSIGN_OR_RETURN(Function * f,
+                             DecodeNode<Function>(proto.user_function()));
+        return InterpValue::MakeFunction(
+            InterpValue::UserFnData{f->owner(), f});
+      }
+      case ModuleCacheValueProto::kToken:
+        return InterpValue::MakeToken();
+      case ModuleCacheValueProto::VALUE_ONEOF_NOT_SET:
+        break;
+    }
+    return absl::InvalidArgumentError("Value is not set");
+  }
+
+  absl::StatusOr<ParametricEnv> DecodeEnv(
+      const ModuleCacheParametricEnvProto& proto) {
+    std::vector<std::pair<std::string, InterpValue>> bindings;
+    for (const ModuleCacheParametricEnvProto::Binding& binding :
+         proto.bindings()) {
+      XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(binding.value()));
+      bindings.push_back({binding.identifier(), std::move(value)});
+    }
+    return ParametricEnv(absl::MakeConstSpan(bindings));
+  }
+
+  absl::StatusOr<std::unique_ptr<ParametricExpression>> DecodeParametric(
+      const ModuleCacheParametricExpressionProto& proto) {
+    std::optional<InterpValue> const_value;
+    if (proto.has_const_value()) {
+      XLS_ASSIGN_OR_RETURN(const_value, DecodeValue(proto.const_value()));
+    }
+    switch (proto.expr_oneof_case()) {
+      case ModuleCacheParametricExpressionProto::kSymbol: {
+        XLS_ASSIGN_OR_RETURN(Span span, SpanFromProto(proto.symbol().span()));
+        return std::make_unique<ParametricSymbol>(
+            proto.symbol().identifier(), std::move(span), const_value);
+      }
+      case ModuleCacheParametricExpressionProto::kConstant: {
+        XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(proto.constant()));
+        return std::make_unique<ParametricConstant>(std::move(value));
+      }
+      case ModuleCacheParametricExpressionProto::kAdd:
+      case ModuleCacheParametricExpressionProto::kMul: {
+        bool is_add = proto.has_add();
+        const ModuleCacheParametricBinaryProto& binary =
+            is_add ? proto.add() : proto.mul();
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ParametricExpression> lhs,
+                             DecodeParametric(binary.lhs()));
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ParametricExpression> rhs,
+                             DecodeParametric(binary.rhs()));
+        if (is_add) {
+          return std::make_unique<ParametricAdd>(std::move(lhs), std::move(rhs),
+                                                 const_value);
+        }
+        return std::make_unique<ParametricMul>(std::move(lhs), std::move(rhs),
+                                               const_value);
+      }
+      case ModuleCacheParametricExpressionProto::kWidth: {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ParametricExpression> arg,
+                             DecodeParametric(proto.width()));
+        return std::make_unique<ParametricWidth>(std::move(arg), const_value);
+      }
+      case ModuleCacheParametricExpressionProto::EXPR_ONEOF_NOT_SET:
+        break;
+    }
+    return absl::InvalidArgumentError("Parametric expression is not set");
+  }
+
+  absl::StatusOr<ConcreteTypeDim> DecodeDim(
+      const ModuleCacheTypeDimProto& proto) {
+    switch (proto.dim_oneof_case()) {
+      case ModuleCacheTypeDimProto::kValue: {
+        XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(proto.value()));
+        return ConcreteTypeDim(std::move(value));
+      }
+      case ModuleCacheTypeDimProto::kParametric: {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ParametricExpression> parametric,
+                             DecodeParametric(proto.parametric()));
+        return ConcreteTypeDim(std::move(parametric));
+      }
+      case ModuleCacheTypeDimProto::DIM_ONEOF_NOT_SET:
+        break;
+    }
+    return absl::InvalidArgumentError("Type dimension is not set");
+  }
+
+  // Decodes a type that is held by another type, which cannot be a metatype.
+  absl::StatusOr<std::unique_ptr<ConcreteType>> DecodeMemberType(
+      const ModuleCacheTypeProto& proto) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> type, DecodeType(proto));
+    if (type->IsMeta()) {
+      return absl::InvalidArgumentError("Unexpected metatype: " +
+                                        type->ToString());
+    }
+    return type;
+  }
+
+  absl::StatusOr<std::vector<std::unique_ptr<ConcreteType>>> DecodeMemberTypes(
+      const google::protobuf::RepeatedPtrField<ModuleCacheTypeProto>& protos) {
+    std::vector<std::unique_ptr<ConcreteType>> types;
+    for (const ModuleCacheTypeProto& proto : protos) {
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> type,
+                           DecodeMemberType(proto));
+      types.push_back(std::move(type));
+    }
+    return types;
+  }
+
+  absl::StatusOr<std::unique_ptr<ConcreteType>> DecodeType(
+      const ModuleCacheTypeProto& proto) {
+    switch (proto.type_oneof_case()) {
+      case ModuleCacheTypeProto::kBits: {
+        XLS_ASSIGN_OR_RETURN(ConcreteTypeDim size,
+                             DecodeDim(proto.bits().size()));
+        return std::make_unique<BitsType>(proto.bits().is_signed(),
+                                          std::move(size));
+      }
+      case ModuleCacheTypeProto::kTuple: {
+        XLS_ASSIGN_OR_RETURN(
+            std::vector<std::unique_ptr<ConcreteType>> members,
+            DecodeMemberTypes(proto.tuple().members()));
+        return std::make_unique<TupleType>(std::move(members));
+      }
+      case ModuleCacheTypeProto::kArray: {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> element_type,
+                             DecodeMemberType(proto.array().element_type()));
+        XLS_ASSIGN_OR_RETURN(ConcreteTypeDim size,
+                             DecodeDim(proto.array().size()));
+        return std::make_unique<ArrayType>(std::move(element_type), size);
+      }
+      case ModuleCacheTypeProto::kStructType: {
+        XLS_ASSIGN_OR_RETURN(
+            StructDef * struct_def,
+            DecodeNode<StructDef>(proto.struct_type().struct_def()));
+        XLS_ASSIGN_OR_RETURN(
+            std::vector<std::unique_ptr<ConcreteType>> members,
+            DecodeMemberTypes(proto.struct_type().members()));
+        if (members.size() != struct_def->members().size()) {
+          return absl::InvalidArgumentError(
+              "Struct type does not match its definition: " +
+              struct_def->identifier());
+        }
+        return std::make_unique<StructType>(std::move(members), *struct_def);
+      }
+      case ModuleCacheTypeProto::kEnumType: {
+        const ModuleCacheEnumTypeProto& enum_type = proto.enum_type();
+        XLS_ASSIGN_OR_RETURN(EnumDef * enum_def,
+                             DecodeNode<EnumDef>(enum_type.enum_def()));
+        XLS_ASSIGN_OR_RETURN(ConcreteTypeDim size,
+                             DecodeDim(enum_type.size()));
+        std::vector<InterpValue> members;
+        for (const ModuleCacheValueProto& member : enum_type.members()) {
+          XLS_ASSIGN_OR_RETURN(InterpValue value, DecodeValue(member));
+          members.push_back(std::move(value));
+        }
+        return std::make_unique<EnumType>(*enum_def, std::move(size),
+                                          enum_type.is_signed(), members);
+      }
+      case ModuleCacheTypeProto::kFunction: {
+        XLS_ASSIGN_OR_RETURN(
+            std::vector<std::unique_ptr<ConcreteType>> params,
+            DecodeMemberTypes(proto.function().params()));
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> return_type,
+                             DecodeMemberType(proto.function().return_type()));
+        return std::make_unique<FunctionType>(std::move(params),
+                                              std::move(return_type));
+      }
+      case ModuleCacheTypeProto::kChannel: {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> payload,
+                             DecodeMemberType(proto.channel().payload()));
+        switch (proto.channel().direction()) {
+          case ChannelDirectionProto::CHANNEL_DIRECTION_IN:
+            return std::make_unique<ChannelType>(std::move(payload),
+                                                 ChannelDirection::kIn);
+          case ChannelDirectionProto::CHANNEL_DIRECTION_OUT:
+            return std::make_unique<ChannelType>(std::move(payload),
+                                                 ChannelDirection::kOut);
+          default:
+            return absl::InvalidArgumentError("Invalid channel direction");
+        }
+      }
+      case ModuleCacheTypeProto::kMeta: {
+        XLS_ASSIGN_OR_RETURN(std::unique_ptr<ConcreteType> wrapped,
+                             DecodeType(proto.meta()));
+        return std::make_unique<MetaType>(std::move(wrapped));
+      }
+      case ModuleCacheTypeProto::kToken:
+        return std::make_unique<TokenType>();
+      case ModuleCacheTypeProto::TYPE_ONEOF_NOT_SET:
+        break;
+    }
+    return absl::InvalidArgumentError("Type is not set");
+  }
+
+  std::vector<Module*> modules_;
+  std::vector<int64_t> node_counts_;
+  std::vector<TypeInfo*> roots_;
+  int64_t created_count_;
+};
+
+// Adds the entries of "decoded" to "type_info"; "created" holds the type
+// information created for the entry.
+absl::Status ApplyTypeInfo(const DecodedTypeInfo& decoded, TypeInfo* type_info,
+                           absl::Span<TypeInfo* const> created,
+                           ImportData* import_data) {
+  auto resolve = [&](const DecodedTypeInfoRef& ref) {
+    return ref.created >= 0 ? created[ref.created] : ref.existing;
+  };
+  for (const auto& [node, type] : decoded.types) {
+    type_info->SetItem(node, *type);
+  }
+  for (const auto& [node, value] : decoded.const_exprs) {
+    type_info->NoteConstExpr(node, value);
+  }
+  for (const auto& [import, module] : decoded.imports) {
+    XLS_ASSIGN_OR_RETURN(TypeInfo * imported,
+                         import_data->GetRootTypeInfo(module));
+    type_info->AddImport(import, module, imported);
+  }
+  for (const auto& [invocation, caller, callee] : decoded.invocation_bindings) {
+    type_info->AddInvocationCallBindings(invocation, caller, callee);
+  }
+  for (const auto& [invocation, caller, ref] : decoded.invocation_type_infos) {
+    type_info->SetInvocationTypeInfo(invocation, caller, resolve(ref));
+  }
+  for (const auto& [slice, env, start_width] : decoded.slices) {
+    type_info->AddSliceStartAndWidth(slice, env, start_width);
+  }
+  for (const auto& [f, is_required] : decoded.requires_implicit_token) {
+    type_info->NoteRequiresImplicitToken(f, is_required);
+  }
+  for (const auto& [proc, ref] : decoded.top_level_procs) {
+    XLS_RETURN_IF_ERROR(type_info->SetTopLevelProcTypeInfo(proc, resolve(ref)));
+  }
+  return absl::OkStatus();
+}
+
+// Writes "entry" to "path" via a temporary file, so that concurrent readers
+// never observe a partially written entry.
+absl::Status WriteEntry(const std::filesystem::path& path,
+                        const ModuleCacheEntryProto& entry) {
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(path.parent_path()));
+  absl::BitGen bitgen;
+  std::filesystem::path temp_path = path;
+  temp_path += absl::StrFormat(".%d.%x.tmp", getpid(),
+                               absl::Uniform<uint64_t>(bitgen));
+  XLS_RETURN_IF_ERROR(SetFileContents(temp_path, entry.SerializeAsString()));
+  std::error_code ec;
+  std::filesystem::rename(temp_path, path, ec);
+  if (ec) {
+    std::error_code remove_ec;
+    std::filesystem::remove(temp_path, remove_ec);
+    return absl::InternalError(absl::StrFormat(
+        "Could not rename %s to %s: %s", temp_path, path, ec.message()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<TypeInfo*> ModuleCache::LoadOrTypecheck(
+    const std::function<absl::StatusOr<TypeInfo*>(Module*)>& ftypecheck,
+    Module* module, std::string_view contents,
+    const std::filesystem::path& path, ImportData* import_data,
+    WarningCollector* warnings) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ModuleRecord> record,
+                       MakeRecord(module, contents, path, import_data));
+  if (record == nullptr) {
+    return ftypecheck(module);
+  }
+
+  // Account for entries added to the root type information of the imported
+  // modules since the cache last looked at them.
+  std::vector<TypeInfo*> roots;
+  std::vector<int64_t> entry_counts;
+  bool store = true;
+  for (Module* imported : record->closure) {
+    XLS_ASSIGN_OR_RETURN(TypeInfo * root,
+                         import_data->GetRootTypeInfo(imported));
+    ModuleRecord& imported_record = *records_.at(imported);
+    int64_t entry_count = CountEntries(*root);
+    if (entry_count != imported_record.root_entry_count) {
+      imported_record.has_foreign_writers = true;
+    }
+    store = store && !imported_record.has_foreign_writers &&
+            std::all_of(imported_record.writers.begin(),
+                        imported_record.writers.end(),
+                        [&](const std::string& writer) {
+                          return record->closure_keys.contains(writer);
+                        });
+    roots.push_back(root);
+    entry_counts.push_back(entry_count);
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::optional<TypeInfo*> type_info,
+                       Load(module, *record, import_data, warnings));
+  if (type_info.has_value()) {
+    ++load_count_;
+  } else {
+    XLS_ASSIGN_OR_RETURN(type_info,
+                         TypecheckAndStore(ftypecheck, module, *record, store,
+                                           import_data, warnings));
+  }
+
+  for (int64_t i = 0; i < record->closure.size(); ++i) {
+    int64_t entry_count = CountEntries(*roots[i]);
+    if (entry_count != entry_counts[i]) {
+      ModuleRecord& imported_record = *records_.at(record->closure[i]);
+      imported_record.writers.insert(record->key);
+      imported_record.root_entry_count = entry_count;
+    }
+  }
+  record->root_entry_count = CountEntries(**type_info);
+  records_[module] = std::move(record);
+  return *type_info;
+}
+
+void ModuleCache::EraseModule(const Module* module) { records_.erase(module); }
+
+absl::StatusOr<std::unique_ptr<ModuleCache::ModuleRecord>>
+ModuleCache::MakeRecord(Module* module, std::string_view contents,
+                        const std::filesystem::path& path,
+                        ImportData* import_data) {
+  auto record = std::make_unique<ModuleRecord>();
+  record->node_count = module->nodes().size();
+  std::vector<std::string> fields = {
+      std::string(kFormatVersion),
+      GetToolIdentity(),
+      module->name(),
+      path.string(),
+      std::string(contents),
+      absl::StrCat(import_data->enabled_warnings().value())};
+  absl::flat_hash_set<Module*> closure;
+  auto add_to_closure = [&](Module* imported) -> bool {
+    auto it = records_.find(imported);
+    if (it == records_.end()) {
+      return false;
+    }
+    if (closure.insert(imported).second) {
+      record->closure.push_back(imported);
+      record->closure_keys.insert(it->second->key);
+    }
+    return true;
+  };
+  for (const ModuleMember& member : module->top()) {
+    if (!std::holds_alternative<Import*>(member)) {
+      continue;
+    }
+    const Import* import = std::get<Import*>(member);
+    XLS_ASSIGN_OR_RETURN(ModuleInfo * imported,
+                         import_data->Get(ImportTokens(import->subject())));
+    if (!add_to_closure(&imported->module())) {
+      XLS_VLOG(3) << "Not caching module " << module->name() << ": it imports "
+                  << imported->module().name()
+                  << ", which was not imported through the module cache";
+      return nullptr;
+    }
+    const ModuleRecord& imported_record = *records_.at(&imported->module());
+    fields.push_back(imported_record.key);
+    for (Module* transitive : imported_record.closure) {
+      if (!add_to_closure(transitive)) {
+        return nullptr;
+      }
+    }
+  }
+  record->key = HashFields(fields);
+  return record;
+}
+
+absl::StatusOr<std::optional<TypeInfo*>> ModuleCache::Load(
+    Module* module, const ModuleRecord& record, ImportData* import_data,
+    WarningCollector* warnings) {
+  std::filesystem::path entry_path = GetEntryPath(record.key);
+  absl::StatusOr<std::string> contents = GetFileContents(entry_path);
+  if (!contents.ok()) {
+    XLS_VLOG(3) << "No module cache entry for " << module->name() << ": "
+                << contents.status();
+    return std::nullopt;
+  }
+  ModuleCacheEntryProto entry;
+  if (!entry.ParseFromString(*contents)) {
+    XLS_LOG(WARNING) << "Ignoring malformed module cache entry " << entry_path;
+    return std::nullopt;
+  }
+
+  // Decodes the entry without changing any type information, so that it can
+  // be ignored if it turns out to be unusable.
+  struct DecodedEntry {
+    std::vector<DecodedTypeInfo> created;
+    std::vector<DecodedTypeInfo> imported_root_additions;
+    std::vector<WarningCollector::Entry> warnings;
+  };
+  auto decode = [&]() -> absl::StatusOr<DecodedEntry> {
+    if (entry.modules().empty() || entry.type_infos().empty()) {
+      return absl::InvalidArgumentError("Entry is empty");
+    }
+    std::vector<Module*> modules;
+    std::vector<int64_t> node_counts;
+    std::vector<TypeInfo*> roots;
+    for (const ModuleCacheModuleProto& module_proto : entry.modules()) {
+      if (modules.empty()) {
+        if (module_proto.key() != record.key ||
+            module_proto.node_count() != record.node_count) {
+          return absl::InvalidArgumentError("Entry is for another module");
+        }
+        modules.push_back(module);
+        node_counts.push_back(record.node_count);
+        roots.push_back(nullptr);
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(ImportTokens subject,
+                           ImportTokens::FromString(module_proto.name()));
+      XLS_ASSIGN_OR_RETURN(ModuleInfo * imported, import_data->Get(subject));
+      auto it = records_.find(&imported->module());
+      if (it == records_.end() || it->second->key != module_proto.key() ||
+          it->second->node_count != module_proto.node_count() ||
+          !record.closure_keys.contains(module_proto.key())) {
+        return absl::InvalidArgumentError(
+            "Entry refers to a module that is not imported: " +
+            module_proto.name());
+      }
+      modules.push_back(&imported->module());
+      node_counts.push_back(module_proto.node_count());
+      roots.push_back(imported->type_info());
+    }
+
+    EntryDecoder decoder(std::move(modules), std::move(node_counts), roots,
+                         entry.type_infos_size());
+    DecodedEntry decoded;
+    for (int64_t i = 0; i < entry.type_infos_size(); ++i) {
+      XLS_ASSIGN_OR_RETURN(DecodedTypeInfo type_info,
+                           decoder.DecodeTypeInfo(entry.type_infos(i)));
+      // The first type information created is the root of the module; the
+      // others derive from a root or from type information created before
+      // them, for the same module.
+      if (i == 0) {
+        if (type_info.module_index != 0 || type_info.parent.has_value()) {
+          return absl::InvalidArgumentError("Malformed root type information");
+        }
+      } else {
+        const std::optional<DecodedTypeInfoRef>& parent = type_info.parent;
+        Module* parent_module = nullptr;
+        if (parent.has_value() && parent->created >= 0) {
+          if (parent->created < i) {
+            parent_module = decoded.created[parent->created].module;
+          }
+        } else if (parent.has_value() && parent->existing != nullptr) {
+          parent_module = parent->existing->module();
+        }
+        if (parent_module != type_info.module) {
+          return absl::InvalidArgumentError(
+              "Malformed derived type information");
+        }
+      }
+      decoded.created.push_back(std::move(type_info));
+    }
+    for (const ModuleCacheTypeInfoProto& additions :
+         entry.imported_root_additions()) {
+      XLS_ASSIGN_OR_RETURN(DecodedTypeInfo type_info,
+                           decoder.DecodeTypeInfo(additions));
+      if (type_info.module_index == 0 || type_info.parent.has_value()) {
+        return absl::InvalidArgumentError(
+            "Malformed additions to imported type information");
+      }
+      decoded.imported_root_additions.push_back(std::move(type_info));
+    }
+    for (const ModuleCacheWarningProto& warning : entry.warnings()) {
+      XLS_ASSIGN_OR_RETURN(WarningCollector::Entry decoded_warning,
+                           decoder.DecodeWarning(warning));
+      decoded.warnings.push_back(std::move(decoded_warning));
+    }
+    return decoded;
+  };
+  absl::StatusOr<DecodedEntry> decoded = decode();
+  if (!decoded.ok()) {
+    XLS_LOG(WARNING) << "Ignoring module cache entry " << entry_path << ": "
+                     << decoded.status();
+    return std::nullopt;
+  }
+
+  XLS_VLOG(3) << "Loading module " << module->name()
+              << " from module cache entry " << entry_path;
+  TypeInfoOwner& owner = import_data->type_info_owner();
+  std::vector<TypeInfo*> created;
+  for (const DecodedTypeInfo& type_info : decoded->created) {
+    TypeInfo* parent = nullptr;
+    if (type_info.parent.has_value()) {
+      parent = type_info.parent->created >= 0
+                   ? created[type_info.parent->created]
+                   : type_info.parent->existing;
+    }
+    XLS_ASSIGN_OR_RETURN(TypeInfo * new_type_info,
+                         owner.New(type_info.module, parent));
+    created.push_back(new_type_info);
+  }
+  for (int64_t i = 0; i < created.size(); ++i) {
+    XLS_RETURN_IF_ERROR(ApplyTypeInfo(decoded->created[i], created[i], created,
+                                      import_data));
+  }
+  for (const DecodedTypeInfo& additions : decoded->imported_root_additions) {
+    XLS_ASSIGN_OR_RETURN(TypeInfo * root,
+                         import_data->GetRootTypeInfo(additions.module));
+    XLS_RETURN_IF_ERROR(ApplyTypeInfo(additions, root, created, import_data));
+  }
+  if (warnings != nullptr) {
+    for (WarningCollector::Entry& warning : decoded->warnings) {
+      warnings->Add(std::move(warning.span), warning.kind,
+                    std::move(warning.message));
+    }
+  }
+  return created.front();
+}
+
+absl::StatusOr<TypeInfo*> ModuleCache::TypecheckAndStore(
+    const std::function<absl::StatusOr<TypeInfo*>(Module*)>& ftypecheck,
+    Module* module, const ModuleRecord& record, bool store,
+    ImportData* import_data, WarningCollector* warnings) {
+  if (!store || warnings == nullptr) {
+    XLS_VLOG(3) << "Not caching module " << module->name()
+                << ": imported type information was extended outside of its "
+                   "import closure, or warnings are not collected";
+    return ftypecheck(module);
+  }
+
+  TypeInfoOwner& owner = import_data->type_info_owner();
+  std::vector<TypeInfo*> roots;
+  std::vector<RootSnapshot> snapshots;
+  for (Module* imported : record.closure) {
+    XLS_ASSIGN_OR_RETURN(TypeInfo * root,
+                         import_data->GetRootTypeInfo(imported));
+    roots.push_back(root);
+    snapshots.push_back(TakeSnapshot(*root));
+  }
+  absl::flat_hash_set<const TypeInfo*> existing;
+  int64_t derived_entry_count = 0;
+  for (const std::unique_ptr<TypeInfo>& type_info : owner.type_infos()) {
+    existing.insert(type_info.get());
+    if (type_info->parent() != nullptr) {
+      derived_entry_count += CountEntries(*type_info);
+    }
+  }
+  const int64_t warning_count = warnings->warnings().size();
+
+  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info, ftypecheck(module));
+
+  auto encode = [&]() -> absl::StatusOr<ModuleCacheEntryProto> {
+    std::vector<TypeInfo*> created;
+    int64_t new_derived_entry_count = 0;
+    for (const std::unique_ptr<TypeInfo>& ti : owner.type_infos()) {
+      if (!existing.contains(ti.get())) {
+        created.push_back(ti.get());
+      } else if (ti->parent() != nullptr) {
+        new_derived_entry_count += CountEntries(*ti);
+      }
+    }
+    if (new_derived_entry_count != derived_entry_count) {
+      return absl::UnimplementedError(
+          "Typechecking added to type information created by an earlier "
+          "typecheck");
+    }
+    XLS_RET_CHECK(!created.empty() && created.front() == type_info);
+
+    ModuleCacheEntryProto entry;
+    std::vector<Module*> modules = {module};
+    std::vector<int64_t> node_counts = {record.node_count};
+    ModuleCacheModuleProto* module_proto = entry.add_modules();
+    module_proto->set_name(module->name());
+    module_proto->set_key(record.key);
+    module_proto->set_node_count(record.node_count);
+    for (Module* imported : record.closure) {
+      const ModuleRecord& imported_record = *records_.at(imported);
+      modules.push_back(imported);
+      node_counts.push_back(imported_record.node_count);
+      module_proto = entry.add_modules();
+      module_proto->set_name(imported->name());
+      module_proto->set_key(imported_record.key);
+      module_proto->set_node_count(imported_record.node_count);
+    }
+
+    EntryEncoder encoder(modules, node_counts, created);
+    for (TypeInfo* ti : created) {
+      XLS_ASSIGN_OR_RETURN(*entry.add_type_infos(),
+                           encoder.EncodeTypeInfo(*ti, /*before=*/nullptr));
+    }
+    for (int64_t i = 0; i < roots.size(); ++i) {
+      XLS_ASSIGN_OR_RETURN(ModuleCacheTypeInfoProto additions,
+                           encoder.EncodeTypeInfo(*roots[i], &snapshots[i]));
+      if (!IsEmpty(additions)) {
+        *entry.add_imported_root_additions() = std::move(additions);
+      }
+    }
+    for (int64_t i = warning_count; i < warnings->warnings().size(); ++i) {
+      const WarningCollector::Entry& warning = warnings->warnings()[i];
+      ModuleCacheWarningProto* warning_proto = entry.add_warnings();
+      *warning_proto->mutable_span() = SpanToProto(warning.span);
+      XLS_ASSIGN_OR_RETURN(std::string_view kind,
+                           WarningKindToString(warning.kind));
+      warning_proto->set_kind(std::string(kind));
+      warning_proto->set_message(warning.message);
+    }
+    return entry;
+  };
+  absl::StatusOr<ModuleCacheEntryProto> entry = encode();
+  if (!entry.ok()) {
+    XLS_VLOG(3) << "Not caching module " << module->name() << ": "
+                << entry.status();
+    return type_info;
+  }
+  std::filesystem::path entry_path = GetEntryPath(record.key);
+  if (absl::Status written = WriteEntry(entry_path, *entry); !written.ok()) {
+    XLS_LOG(WARNING) << "Could not write module cache entry " << entry_path
+                     << ": " << written;
+    return type_info;
+  }
+  XLS_VLOG(3) << "Stored module " << module->name()
+              << " to module cache entry " << entry_path;
+  ++store_count_;
+  return type_info;
+}
+
+std::filesystem::path ModuleCache::GetEntryPath(std::string_view key) const {
+  return directory_ / absl::StrCat(key, ".pb");
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,127 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_MODULE_CACHE_H_
+#define XLS_DSLX_MODULE_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/module_cache_interface.h"
+#include "xls/dslx/type_system/type_info.h"
+#include "xls/dslx/warning_collector.h"
+
+namespace xls::dslx {
+
+// Caches typechecked imported modules on disk, so that modules imported by many
+// tool invocations (e.g. the standard library) are only typechecked once.
+//
+// An entry is keyed by a hash of the module's name, path and text, the enabled
+// warnings, the running tool binary, and the keys of the modules it imports --
+// so a change anywhere in its import closure changes the key. The entry holds
+// the type information typechecking the module created (including the
+// instantiations of imported parametric functions, and what it added to the
+// root type information of imported modules) and the warnings it reported. The
+// AST is not stored: parsing is deterministic and cheap next to typechecking,
+// so the module is re-parsed from the text the key was computed from, and the
+// entry refers to AST nodes by their index in creation order.
+//
+// Results that cannot be reproduced that way are not stored; e.g. when
+// typechecking created AST nodes, or when the root type information of an
+// imported module was extended by a module outside of the import closure
+// (typechecking may then have relied on entries the closure alone does not
+// produce).
+class ModuleCache : public ModuleCacheInterface {
+ public:
+  // Entries are files in "directory", which is created when the first entry is
+  // stored. Several processes may share the directory.
+  explicit ModuleCache(std::filesystem::path directory)
+      : directory_(std::move(directory)) {}
+
+  absl::StatusOr<TypeInfo*> LoadOrTypecheck(
+      const std::function<absl::StatusOr<TypeInfo*>(Module*)>& ftypecheck,
+      Module* module, std::string_view contents,
+      const std::filesystem::path& path, ImportData* import_data,
+      WarningCollector* warnings) override;
+
+  void EraseModule(const Module* module) override;
+
+  // Number of modules loaded from / stored to the cache so far.
+  int64_t load_count() const { return load_count_; }
+  int64_t store_count() const { return store_count_; }
+
+ private:
+  // What the cache knows about a module imported through it.
+  struct ModuleRecord {
+    std::string key;
+    // Number of AST nodes after parsing; entries only refer to these.
+    int64_t node_count;
+    // The modules the module (transitively) imports, and their keys.
+    std::vector<Module*> closure;
+    absl::flat_hash_set<std::string> closure_keys;
+    // Keys of the modules whose typechecking added entries to the root type
+    // information of this module.
+    absl::flat_hash_set<std::string> writers;
+    // Number of entries in the root type information as of the last change
+    // the cache accounted for; see CountEntries().
+    int64_t root_entry_count = 0;
+    // Whether entries were added to the root type information other than by
+    // typechecking a module imported through the cache (e.g. by typechecking
+    // the entry module of the tool).
+    bool has_foreign_writers = false;
+  };
+
+  // Returns the record for "module", or nullptr if one of its imports was not
+  // imported through the cache (in which case it is not cached either).
+  absl::StatusOr<std::unique_ptr<ModuleRecord>> MakeRecord(
+      Module* module, std::string_view contents,
+      const std::filesystem::path& path, ImportData* import_data);
+
+  // Loads the entry for the module described by "record" into import_data;
+  // returns std::nullopt if there is no usable entry.
+  absl::StatusOr<std::optional<TypeInfo*>> Load(Module* module,
+                                                const ModuleRecord& record,
+                                                ImportData* import_data,
+                                                WarningCollector* warnings);
+
+  // Typechecks "module" and, if "store" is set, stores the result unless it
+  // cannot be reproduced from an entry.
+  absl::StatusOr<TypeInfo*> TypecheckAndStore(
+      const std::function<absl::StatusOr<TypeInfo*>(Module*)>& ftypecheck,
+      Module* module, const ModuleRecord& record, bool store,
+      ImportData* import_data, WarningCollector* warnings);
+
+  std::filesystem::path GetEntryPath(std::string_view key) const;
+
+  const std::filesystem::path directory_;
+  absl::flat_hash_map<const Module*, std::unique_ptr<ModuleRecord>> records_;
+  int64_t load_count_ = 0;
+  int64_t store_count_ = 0;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_MODULE_CACHE_H_
@@ -0,0 +1,60 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_MODULE_CACHE_INTERFACE_H_
+#define XLS_DSLX_MODULE_CACHE_INTERFACE_H_
+
+#include <filesystem>  // NOLINT
+#include <functional>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/type_system/type_info.h"
+#include "xls/dslx/warning_collector.h"
+
+namespace xls::dslx {
+
+class ImportData;
+
+// Defines the interface a type must provide in order to serve as a cache of
+// typechecked modules across tool invocations. As with the bytecode cache, this
+// type exists to avoid attaching too many concrete dependencies onto
+// ImportData, which is the cache owner.
+class ModuleCacheInterface {
+ public:
+  virtual ~ModuleCacheInterface() = default;
+
+  // Returns the type information for the imported "module" -- parsed from
+  // "contents", which were read from "path" -- either by loading it from the
+  // cache or by typechecking the module via "ftypecheck" (and storing the
+  // result, when possible). Warnings for the module are added to "warnings",
+  // which may be nullptr.
+  //
+  // The modules imported by "module" must already be present in
+  // "import_data".
+  virtual absl::StatusOr<TypeInfo*> LoadOrTypecheck(
+      const std::function<absl::StatusOr<TypeInfo*>(Module*)>& ftypecheck,
+      Module* module, std::string_view contents,
+      const std::filesystem::path& path, ImportData* import_data,
+      WarningCollector* warnings) = 0;
+
+  // Drops all state held for the given module, e.g. because the module is
+  // being removed from its ImportData. "module" is not dereferenced.
+  virtual void EraseModule(const Module* module) = 0;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_MODULE_CACHE_INTERFACE_H_
@@ -0,0 +1,143 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/module_cache.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_system/concrete_type.h"
+#include "xls/dslx/warning_collector.h"
+#include "xls/dslx/warning_kind.h"
+
+namespace xls::dslx {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr std::string_view kLibrary = R"(import std
+
+pub fn clog2_plus<N: u32>(x: uN[N]) -> uN[N] {
+  std::clog2(x) + x
+}
+
+pub fn add_one(x: u32) -> u32 {
+  let unused = x;
+  x + u32:1
+}
+)";
+
+constexpr std::string_view kProgram = R"(import lib
+
+fn main(x: u8, y: u32) -> (u8, u32) {
+  (lib::clog2_plus(x), lib::add_one(y))
+}
+)";
+
+// The observable results of typechecking kProgram in a fresh ImportData, as a
+// tool invocation does.
+struct Result {
+  std::string main_type;
+  std::vector<std::string> warnings;
+  int64_t load_count;
+  int64_t store_count;
+};
+
+absl::StatusOr<Result> TypecheckProgram(
+    const std::filesystem::path& search_path,
+    const std::filesystem::path& cache_dir) {
+  ImportData import_data =
+      CreateImportData(kDefaultDslxStdlibPath, {search_path}, kAllWarningsSet);
+  auto module_cache = std::make_unique<ModuleCache>(cache_dir);
+  ModuleCache* cache = module_cache.get();
+  import_data.SetModuleCache(std::move(module_cache));
+  XLS_ASSIGN_OR_RETURN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "main.x", "main", &import_data));
+  XLS_ASSIGN_OR_RETURN(Function * main,
+                       tm.module->GetMemberOrError<Function>("main"));
+  XLS_ASSIGN_OR_RETURN(ConcreteType * main_type,
+                       tm.type_info->GetItemOrError(main));
+  Result result{main_type->ToString(), {}, cache->load_count(),
+                cache->store_count()};
+  for (const WarningCollector::Entry& warning : tm.warnings.warnings()) {
+    result.warnings.push_back(warning.message);
+  }
+  return result;
+}
+
+constexpr std::string_view kMainType = "(uN[8], uN[32]) -> (uN[8], uN[32])";
+constexpr std::string_view kLibraryWarning =
+    "Definition of `unused` (type `uN[32]`) is not used in function `add_one`";
+
+TEST(ModuleCacheTest, ImportsAreLoadedByLaterTypechecks) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "lib.x", kLibrary));
+  const std::filesystem::path cache_dir = temp_dir.path() / "cache";
+
+  // lib and std are typechecked and stored.
+  XLS_ASSERT_OK_AND_ASSIGN(Result first,
+                           TypecheckProgram(temp_dir.path(), cache_dir));
+  EXPECT_EQ(first.main_type, kMainType);
+  EXPECT_THAT(first.warnings, ElementsAre(kLibraryWarning));
+  EXPECT_EQ(first.load_count, 0);
+  EXPECT_EQ(first.store_count, 2);
+
+  // ... and then loaded, along with the warning for lib.
+  XLS_ASSERT_OK_AND_ASSIGN(Result second,
+                           TypecheckProgram(temp_dir.path(), cache_dir));
+  EXPECT_EQ(second.main_type, kMainType);
+  EXPECT_THAT(second.warnings, ElementsAre(kLibraryWarning));
+  EXPECT_EQ(second.load_count, 2);
+  EXPECT_EQ(second.store_count, 0);
+}
+
+TEST(ModuleCacheTest, ChangedImportIsTypecheckedAgain) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  const std::filesystem::path lib_path = temp_dir.path() / "lib.x";
+  XLS_ASSERT_OK(SetFileContents(lib_path, kLibrary));
+  const std::filesystem::path cache_dir = temp_dir.path() / "cache";
+  XLS_ASSERT_OK(TypecheckProgram(temp_dir.path(), cache_dir).status());
+
+  // Changing the text of lib changes its key; std is still loaded.
+  XLS_ASSERT_OK(SetFileContents(
+      lib_path, absl::StrCat(kLibrary, "\nfn unrelated() -> u32 { u32:0 }\n")));
+  XLS_ASSERT_OK_AND_ASSIGN(Result result,
+                           TypecheckProgram(temp_dir.path(), cache_dir));
+  EXPECT_EQ(result.main_type, kMainType);
+  EXPECT_THAT(result.warnings, ElementsAre(kLibraryWarning));
+  EXPECT_EQ(result.load_count, 1);
+  EXPECT_EQ(result.store_count, 1);
+}
+
+}  // namespace
+}  // namespace xls::dslx
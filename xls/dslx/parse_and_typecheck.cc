@@ -83,16 +83,25 @@ absl::StatusOr<TypecheckedModule> TypecheckModule(
   std::string_view module_name = module->name();
 
   WarningCollector warnings(import_data->enabled_warnings());
-  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
-                       CheckModule(module.get(), import_data, &warnings));
+  absl::StatusOr<TypeInfo*> type_info_or =
+      CheckModule(module.get(), import_data, &warnings);
+  if (!type_info_or.ok()) {
+    import_data->DropModuleState(module.get());
+    return type_info_or.status();
+  }
+  TypeInfo* type_info = type_info_or.value();
   TypecheckedModule result{module.get(), type_info, std::move(warnings)};
   XLS_ASSIGN_OR_RETURN(ImportTokens subject,
                        ImportTokens::FromString(module_name));
-  XLS_RETURN_IF_ERROR(import_data
-                          ->Put(subject, std::make_unique<ModuleInfo>(
-                                             std::move(module), type_info,
-                                             std::filesystem::path(path)))
-                          .status());
+  absl::StatusOr<ModuleInfo*> module_info = import_data->Put(
+      subject, std::make_unique<ModuleInfo>(std::move(module), type_info,
+                                            std::filesystem::path(path)));
+  if (!module_info.ok()) {
+    // The module was destroyed along with the rejected ModuleInfo; its state
+    // is keyed by (but never dereferences) the module pointer.
+    import_data->DropModuleState(result.module);
+    return module_info.status();
+  }
   return result;
 }
 
@@ -16,6 +16,7 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <ctime>
 #include <functional>
@@ -29,12 +30,18 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/bytecode/bytecode_cache.h"
 #include "xls/dslx/bytecode/bytecode_emitter.h"
@@ -45,17 +52,24 @@
 #include "xls/dslx/errors.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/bindings.h"
+#include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/interp_value_helpers.h"
 #include "xls/dslx/ir_convert/ir_converter.h"
 #include "xls/dslx/mangle.h"
+#include "xls/dslx/module_cache.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/type_system/concrete_type.h"
 #include "xls/dslx/type_system/type_info.h"
+#include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/random_value.h"
+#include "xls/interpreter/serial_proc_runtime.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/events.h"
 #include "xls/ir/package.h"
+#include "xls/ir/proc.h"
 #include "xls/ir/value.h"
+#include "xls/jit/jit_proc_runtime.h"
 
 namespace xls::dslx {
 namespace {
@@ -67,8 +81,6 @@ constexpr int kQuickcheckSpaces = 15;
 absl::Status RunTestFunction(ImportData* import_data, TypeInfo* type_info,
                              Module* module, TestFunction* tf,
                              const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<BytecodeFunction> bf,
       BytecodeEmitter::Emit(
@@ -83,9 +95,6 @@ absl::Status RunTestFunction(ImportData* import_data, TypeInfo* type_info,
 absl::Status RunTestProc(ImportData* import_data, TypeInfo* type_info,
                          Module* module, TestProc* tp,
                          const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
-
   XLS_ASSIGN_OR_RETURN(TypeInfo * ti,
                        type_info->GetTopLevelProcTypeInfo(tp->proc()));
 
@@ -134,6 +143,160 @@ absl::Status RunTestProc(ImportData* import_data, TypeInfo* type_info,
   return absl::OkStatus();
 }
 
+// Converts an assertion failure raised while running converted IR back into a
+// positional error. IR conversion of `fail!` embeds the DSLX span of the
+// failure at the end of the assertion message; if none can be recovered the
+// error is reported at `fallback_span`.
+absl::Status AssertionMessageToStatus(std::string_view message,
+                                      const Span& fallback_span) {
+  size_t at = message.rfind(" @ ");
+  if (at != std::string_view::npos) {
+    absl::StatusOr<Span> span = Span::FromString(message.substr(at + 3));
+    if (span.ok()) {
+      return FailureErrorStatus(*span, message);
+    }
+  }
+  return FailureErrorStatus(fallback_span, message);
+}
+
+// As RunTestProc(), but runs the IR conversion of the test proc network (in
+// `package`) on the JIT proc runtime.
+//
+// Only the trace hook and tick limit of `options` are honored; channel traffic
+// is not traced.
+absl::Status RunTestProcOnJit(Package* package, TestProc* tp,
+                              const BytecodeInterpreterOptions& options) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<SerialProcRuntime> runtime,
+                       CreateJitSerialProcRuntime(package));
+
+  // IR conversion turns the test proc's terminator into a boundary channel of
+  // the package.
+  std::string terminator_name =
+      absl::StrCat(package->name(), "__",
+                   tp->proc()->config()->params()[0]->identifier());
+  XLS_ASSIGN_OR_RETURN(
+      ChannelQueue * term_queue,
+      runtime->queue_manager().GetQueueByName(terminator_name));
+
+  int64_t tick_count = 0;
+  while (term_queue->IsEmpty()) {
+    if (options.max_ticks().has_value() &&
+        tick_count > options.max_ticks().value()) {
+      return absl::DeadlineExceededError(
+          absl::StrFormat("Exceeded limit of %d proc ticks before terminating",
+                          options.max_ticks().value()));
+    }
+
+    XLS_RETURN_IF_ERROR(runtime->Tick());
+    for (const std::unique_ptr<xls::Proc>& proc : package->procs()) {
+      const InterpreterEvents& events =
+          runtime->GetInterpreterEvents(proc.get());
+      if (options.trace_hook() != nullptr) {
+        for (const std::string& msg : events.trace_msgs) {
+          options.trace_hook()(msg);
+        }
+      }
+      if (!events.assert_msgs.empty()) {
+        return AssertionMessageToStatus(events.assert_msgs.front(),
+                                        tp->proc()->span());
+      }
+    }
+    runtime->ClearInterpreterEvents();
+    ++tick_count;
+  }
+
+  std::optional<Value> ret_val = term_queue->Read();
+  XLS_RET_CHECK(ret_val.has_value());
+  XLS_RET_CHECK(ret_val->IsBits() && ret_val->bits().bit_count() == 1);
+  if (!ret_val->bits().IsOne()) {
+    return FailureErrorStatus(
+        tp->proc()->span(), "Proc reported failure upon exit.");
+  }
+  return absl::OkStatus();
+}
+
+// Hands out run comparators to concurrently running tests, so that each
+// comparator (and e.g. its JIT cache) is only used by one test at a time. The
+// base comparator is handed out first and further ones are created with
+// AbstractRunComparator::CloneForWorker as needed.
+class RunComparatorPool {
+ public:
+  explicit RunComparatorPool(AbstractRunComparator* base) : base_(base) {
+    if (base_ != nullptr) {
+      available_.push_back(base_);
+    }
+  }
+
+  bool has_base() const { return base_ != nullptr; }
+
+  // Returns nullptr if there is no base comparator.
+  AbstractRunComparator* Acquire() {
+    if (base_ == nullptr) {
+      return nullptr;
+    }
+    absl::MutexLock lock(&mutex_);
+    if (available_.empty()) {
+      owned_.push_back(base_->CloneForWorker());
+      XLS_CHECK(owned_.back() != nullptr);
+      return owned_.back().get();
+    }
+    AbstractRunComparator* comparator = available_.back();
+    available_.pop_back();
+    return comparator;
+  }
+
+  void Release(AbstractRunComparator* comparator) {
+    if (comparator == nullptr) {
+      return;
+    }
+    absl::MutexLock lock(&mutex_);
+    available_.push_back(comparator);
+  }
+
+ private:
+  AbstractRunComparator* base_;
+  absl::Mutex mutex_;
+  std::vector<AbstractRunComparator*> available_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<AbstractRunComparator>> owned_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Runs `run(i)` for each i in [0, count) using up to `worker_count` threads.
+// Results are presented in index order regardless of completion order:
+// `announce(i)` followed by `report(i, status)` is invoked for each item once
+// all earlier items have been reported, and these calls are serialized. When
+// running on a single worker each item is announced before it runs, so output
+// streams just as it would from a plain loop.
+absl::Status RunInOrder(
+    int64_t count, int64_t worker_count,
+    absl::FunctionRef<void(int64_t)> announce,
+    absl::FunctionRef<absl::Status(int64_t)> run,
+    absl::FunctionRef<void(int64_t, const absl::Status&)> report) {
+  if (worker_count <= 1) {
+    for (int64_t i = 0; i < count; ++i) {
+      announce(i);
+      report(i, run(i));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Mutex mutex;
+  std::vector<std::optional<absl::Status>> results(count);
+  int64_t next_to_report = 0;
+  return ParallelFor(count, worker_count, [&](int64_t i) -> absl::Status {
+    absl::Status status = run(i);
+    absl::MutexLock lock(&mutex);
+    results[i] = std::move(status);
+    while (next_to_report < count && results[next_to_report].has_value()) {
+      announce(next_to_report);
+      report(next_to_report, *results[next_to_report]);
+      results[next_to_report].reset();
+      ++next_to_report;
+    }
+    return absl::OkStatus();
+  });
+}
+
 }  // namespace
 
 static bool TestMatchesFilter(std::string_view test_name,
@@ -222,9 +385,10 @@ using HandleError = const std::function<void(
 
 static absl::Status RunQuickChecksIfJitEnabled(
     Module* entry_module, TypeInfo* type_info,
-    AbstractRunComparator* run_comparator, Package* ir_package,
-    std::optional<int64_t> seed, const HandleError& handle_error) {
-  if (run_comparator == nullptr) {
+    RunComparatorPool& run_comparators, Package* ir_package,
+    std::optional<int64_t> seed, int64_t worker_count,
+    const HandleError& handle_error) {
+  if (!run_comparators.has_base()) {
     std::cerr << "[ SKIPPING QUICKCHECKS  ] (JIT is disabled)"
               << "\n";
     return absl::OkStatus();
@@ -237,18 +401,33 @@ static absl::Status RunQuickChecksIfJitEnabled(
   }
   std::cerr << absl::StreamFormat("[ SEED %*d ]", kQuickcheckSpaces + 1, *seed)
             << "\n";
-  for (QuickCheck* quickcheck : entry_module->GetQuickChecks()) {
-    const std::string& test_name = quickcheck->identifier();
-    std::cerr << "[ RUN QUICKCHECK        ] " << test_name
-              << " count: " << quickcheck->GetTestCountOrDefault() << "\n";
-    absl::Status status =
-        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed);
-    if (!status.ok()) {
-      handle_error(status, test_name, /*is_quickcheck=*/true);
-    } else {
-      std::cerr << "[                    OK ] " << test_name << "\n";
-    }
-  }
+  std::vector<QuickCheck*> quickchecks = entry_module->GetQuickChecks();
+  XLS_RETURN_IF_ERROR(RunInOrder(
+      quickchecks.size(), worker_count,
+      /*announce=*/
+      [&](int64_t i) {
+        std::cerr << "[ RUN QUICKCHECK        ] "
+                  << quickchecks[i]->identifier()
+                  << " count: " << quickchecks[i]->GetTestCountOrDefault()
+                  << "\n";
+      },
+      /*run=*/
+      [&](int64_t i) {
+        AbstractRunComparator* run_comparator = run_comparators.Acquire();
+        absl::Status status = RunQuickCheck(run_comparator, ir_package,
+                                            quickchecks[i], type_info, *seed);
+        run_comparators.Release(run_comparator);
+        return status;
+      },
+      /*report=*/
+      [&](int64_t i, const absl::Status& status) {
+        const std::string& test_name = quickchecks[i]->identifier();
+        if (!status.ok()) {
+          handle_error(status, test_name, /*is_quickcheck=*/true);
+        } else {
+          std::cerr << "[                    OK ] " << test_name << "\n";
+        }
+      }));
   std::cerr << absl::StreamFormat(
                    "[=======================] %d quickcheck(s) ran.",
                    entry_module->GetQuickChecks().size())
@@ -291,6 +470,10 @@ absl::StatusOr<TestResult> ParseAndTest(std::string_view program,
 
   auto import_data = CreateImportData(options.stdlib_path, options.dslx_paths,
                                       options.warnings);
+  if (options.module_cache_dir.has_value()) {
+    import_data.SetModuleCache(
+        std::make_unique<ModuleCache>(*options.module_cache_dir));
+  }
 
   absl::StatusOr<TypecheckedModule> tm_or =
       ParseAndTypecheck(program, filename, module_name, &import_data);
@@ -320,10 +503,22 @@ absl::StatusOr<TestResult> ParseAndTest(std::string_view program,
 
   Module* entry_module = tm_or.value().module;
 
+  // Tests running on different workers each get their own interpreter (and,
+  // via the pool, run comparator) but share the typechecked module, the
+  // bytecode cache and the IR package, none of which are mutated by running.
+  import_data.SetBytecodeCache(std::make_unique<BytecodeCache>(&import_data));
+  int64_t worker_count = std::max<int64_t>(options.worker_count, 1);
+  if (worker_count > 1 && options.run_comparator != nullptr &&
+      options.run_comparator->CloneForWorker() == nullptr) {
+    XLS_VLOG(1) << "Run comparator does not support concurrent workers; "
+                   "running tests sequentially.";
+    worker_count = 1;
+  }
+  RunComparatorPool run_comparators(options.run_comparator);
+
   // If JIT comparisons are "on", we register a post-evaluation hook to compare
   // with the interpreter.
   std::unique_ptr<Package> ir_package;
-  PostFnEvalHook post_fn_eval_hook;
   if (options.run_comparator != nullptr) {
     absl::StatusOr<std::unique_ptr<Package>> ir_package_or =
         ConvertModuleToPackage(entry_module, &import_data,
@@ -335,55 +530,116 @@ absl::StatusOr<TestResult> ParseAndTest(std::string_view program,
       return ir_package_or.status();
     }
     ir_package = std::move(ir_package_or).value();
-    post_fn_eval_hook = [&ir_package, &import_data, &options](
-                            const Function* f,
-                            absl::Span<const InterpValue> args,
-                            const ParametricEnv* parametric_env,
-                            const InterpValue& got) -> absl::Status {
+  }
+  auto make_post_fn_eval_hook =
+      [&](AbstractRunComparator* run_comparator) -> PostFnEvalHook {
+    if (run_comparator == nullptr) {
+      return nullptr;
+    }
+    return [&ir_package, &import_data, run_comparator](
+               const Function* f, absl::Span<const InterpValue> args,
+               const ParametricEnv* parametric_env,
+               const InterpValue& got) -> absl::Status {
       std::optional<bool> requires_implicit_token =
           import_data.GetRootTypeInfoForNode(f)
               .value()
               ->GetRequiresImplicitToken(f);
       XLS_RET_CHECK(requires_implicit_token.has_value());
-      return options.run_comparator->RunComparison(ir_package.get(),
-                                                   *requires_implicit_token, f,
-                                                   args, parametric_env, got);
+      return run_comparator->RunComparison(ir_package.get(),
+                                           *requires_implicit_token, f, args,
+                                           parametric_env, got);
     };
-  }
+  };
 
   // Run unit tests.
+  std::vector<std::string> test_names;
   for (const std::string& test_name : entry_module->GetTestNames()) {
     if (!TestMatchesFilter(test_name, options.test_filter)) {
       skipped += 1;
       continue;
     }
+    test_names.push_back(test_name);
+  }
+  ran = test_names.size();
+
+  // Test procs to be run on the JIT are converted to IR up front (conversion
+  // is not safe to run concurrently). A test proc that cannot be converted
+  // fails with the conversion error rather than quietly running in the
+  // bytecode interpreter.
+  absl::flat_hash_map<std::string, absl::StatusOr<std::unique_ptr<Package>>>
+      test_proc_packages;
+  if (options.run_procs_on_jit) {
+    for (const std::string& test_name : test_names) {
+      if (!entry_module->GetTestProc(test_name).ok()) {
+        continue;
+      }
+      auto package = std::make_unique<Package>(entry_module->name());
+      absl::Status status = ConvertOneFunctionIntoPackage(
+          entry_module, test_name, &import_data, /*parametric_env=*/nullptr,
+          options.convert_options, package.get());
+      if (status.ok()) {
+        test_proc_packages.emplace(test_name, std::move(package));
+      } else {
+        test_proc_packages.emplace(test_name, status);
+      }
+    }
+  }
 
-    ran += 1;
-    std::cerr << "[ RUN UNITTEST  ] " << test_name << std::endl;
-    absl::Status status;
-    ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
+  auto run_test = [&](int64_t i) -> absl::Status {
+    const std::string& test_name = test_names[i];
+    AbstractRunComparator* run_comparator = run_comparators.Acquire();
     BytecodeInterpreterOptions interpreter_options;
-    interpreter_options.post_fn_eval_hook(post_fn_eval_hook)
+    interpreter_options.post_fn_eval_hook(make_post_fn_eval_hook(run_comparator))
         .trace_hook(InfoLoggingTraceHook)
         .trace_channels(options.trace_channels)
         .max_ticks(options.max_ticks)
         .format_preference(options.format_preference);
+    absl::Status status;
+    ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
     if (std::holds_alternative<TestFunction*>(*member)) {
-      XLS_ASSIGN_OR_RETURN(TestFunction * tf, entry_module->GetTest(test_name));
-      status = RunTestFunction(&import_data, tm_or.value().type_info,
-                               entry_module, tf, interpreter_options);
+      absl::StatusOr<TestFunction*> tf = entry_module->GetTest(test_name);
+      status = tf.ok() ? RunTestFunction(&import_data, tm_or.value().type_info,
+                                         entry_module, *tf, interpreter_options)
+                       : tf.status();
     } else {
-      XLS_ASSIGN_OR_RETURN(TestProc * tp, entry_module->GetTestProc(test_name));
-      status = RunTestProc(&import_data, tm_or.value().type_info, entry_module,
-                           tp, interpreter_options);
+      absl::StatusOr<TestProc*> tp = entry_module->GetTestProc(test_name);
+      if (!tp.ok()) {
+        status = tp.status();
+      } else if (options.run_procs_on_jit) {
+        const absl::StatusOr<std::unique_ptr<Package>>& package =
+            test_proc_packages.at(test_name);
+        if (!package.ok()) {
+          status = package.status();
+        } else {
+          if (options.jit_test_proc_hook != nullptr) {
+            options.jit_test_proc_hook(test_name);
+          }
+          status = RunTestProcOnJit(package->get(), *tp, interpreter_options);
+        }
+      } else {
+        status = RunTestProc(&import_data, tm_or.value().type_info,
+                             entry_module, *tp, interpreter_options);
+      }
     }
+    run_comparators.Release(run_comparator);
+    return status;
+  };
 
-    if (status.ok()) {
-      std::cerr << "[            OK ]" << std::endl;
-    } else {
-      handle_error(status, test_name, /*is_quickcheck=*/false);
-    }
-  }
+  XLS_RETURN_IF_ERROR(RunInOrder(
+      test_names.size(), worker_count,
+      /*announce=*/
+      [&](int64_t i) {
+        std::cerr << "[ RUN UNITTEST  ] " << test_names[i] << std::endl;
+      },
+      run_test,
+      /*report=*/
+      [&](int64_t i, const absl::Status& status) {
+        if (status.ok()) {
+          std::cerr << "[            OK ]" << std::endl;
+        } else {
+          handle_error(status, test_names[i], /*is_quickcheck=*/false);
+        }
+      }));
 
   std::cerr << absl::StreamFormat(
                    "[===============] %d test(s) ran; %d failed; %d skipped.",
@@ -393,8 +649,8 @@ absl::StatusOr<TestResult> ParseAndTest(std::string_view program,
   // Run quickchecks, but only if the JIT is enabled.
   if (!entry_module->GetQuickChecks().empty()) {
     XLS_RETURN_IF_ERROR(RunQuickChecksIfJitEnabled(
-        entry_module, tm_or.value().type_info, options.run_comparator,
-        ir_package.get(), options.seed, handle_error));
+        entry_module, tm_or.value().type_info, run_comparators,
+        ir_package.get(), options.seed, worker_count, handle_error));
   }
 
   return failed == 0 ? TestResult::kAllPassed : TestResult::kSomeFailed;
@@ -20,6 +20,8 @@
 
 #include <cstdint>
 #include <filesystem>  // NOLINT
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -67,6 +69,13 @@ class AbstractRunComparator {
   virtual absl::StatusOr<InterpreterResult<xls::Value>> RunIrFunction(
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) = 0;
+
+  // Returns a new comparator with the same configuration but independent state
+  // (e.g. its own JIT cache), for use by a concurrently running test. Returns
+  // nullptr if this is not supported, in which case tests run sequentially.
+  virtual std::unique_ptr<AbstractRunComparator> CloneForWorker() const {
+    return nullptr;
+  }
 };
 
 // Optional arguments to ParseAndTest (that have sensible defaults).
@@ -82,6 +91,8 @@ class AbstractRunComparator {
 //   warnings_as_errors: Whether warnings should be reported as errors (i.e.
 //    cause the run routine to report failure when a warning is encountered).
 //   warnings: Set of warnings to enable for reporting.
+//   worker_count: Number of tests (and quickchecks) to run concurrently.
+//    Results are printed in declaration order regardless.
 struct ParseAndTestOptions {
   std::string stdlib_path = xls::kDefaultDslxStdlibPath;
   absl::Span<const std::filesystem::path> dslx_paths = {};
@@ -95,6 +106,17 @@ struct ParseAndTestOptions {
   WarningKindSet warnings = kAllWarningsSet;
   bool trace_channels = false;
   std::optional<int64_t> max_ticks;
+  int64_t worker_count = 1;
+  // Whether to run test procs by converting them to IR and ticking them on the
+  // JIT proc runtime rather than in the bytecode interpreter. A test proc that
+  // cannot be converted to IR fails with the conversion error.
+  bool run_procs_on_jit = false;
+  // If set, called with the name of each test proc about to be run on the JIT
+  // proc runtime. May be called concurrently when worker_count > 1.
+  std::function<void(std::string_view)> jit_test_proc_hook;
+  // If set, imported modules are loaded from (and stored to) the on-disk
+  // module cache in this directory; see ModuleCache.
+  std::optional<std::filesystem::path> module_cache_dir;
 };
 
 enum class TestResult : uint8_t {
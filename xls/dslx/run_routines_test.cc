@@ -114,6 +114,60 @@ fn trivial(x: u5) -> bool { false }
   EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kSomeFailed));
 }
 
+TEST(RunRoutinesTest, ParallelTestsAndQuickChecks) {
+  constexpr const char* kProgram = R"(
+fn add_one(x: u32) -> u32 { x + u32:1 }
+
+#[test]
+fn test_a() { assert_eq(add_one(u32:1), u32:2) }
+
+#[test]
+fn test_b() { assert_eq(add_one(u32:41), u32:42) }
+
+#[test]
+fn test_c() { assert_eq(add_one(u32:0xffffffff), u32:0) }
+
+#[quickcheck(test_count=100)]
+fn increments(x: u8) -> bool { (x as u32) + u32:1 == add_one(x as u32) }
+
+#[quickcheck(test_count=100)]
+fn xor_self_is_zero(x: u16) -> bool { x ^ x == u16:0 }
+)";
+  constexpr const char* kModuleName = "test";
+  constexpr const char* kFilename = "test.x";
+  RunComparator jit_comparator(CompareMode::kJit);
+  ParseAndTestOptions options;
+  options.run_comparator = &jit_comparator;
+  options.seed = int64_t{42};
+  options.worker_count = 4;
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, kModuleName, kFilename, options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kAllPassed));
+}
+
+TEST(RunRoutinesTest, ParallelFailingTest) {
+  constexpr const char* kProgram = R"(
+#[test]
+fn test_passes() { assert_eq(u32:1, u32:1) }
+
+#[test]
+fn test_fails() { assert_eq(u32:1, u32:2) }
+
+#[test]
+fn test_also_passes() { assert_eq(u32:2, u32:2) }
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto temp_file,
+                           TempFile::CreateWithContent(kProgram, "_test.x"));
+  constexpr const char* kModuleName = "test";
+  RunComparator jit_comparator(CompareMode::kJit);
+  ParseAndTestOptions options;
+  options.run_comparator = &jit_comparator;
+  options.worker_count = 3;
+  absl::StatusOr<TestResult> result = ParseAndTest(
+      kProgram, kModuleName, std::string(temp_file.path()), options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kSomeFailed));
+}
+
 TEST(RunRoutinesTest, FailingProc) {
   constexpr std::string_view kProgram = R"(
 #[test_proc()]
@@ -356,4 +410,119 @@ proc tester_proc {
       << result.status();
 }
 
+TEST(RunRoutinesTest, TestProcOnJit) {
+  constexpr std::string_view kProgram = R"(
+proc incrementer {
+  in_ch: chan<u32> in;
+  out_ch: chan<u32> out;
+
+  init { () }
+
+  config(in_ch: chan<u32> in,
+         out_ch: chan<u32> out) {
+    (in_ch, out_ch)
+  }
+  next(tok: token, _: ()) {
+    let (tok, i) = recv(tok, in_ch);
+    let tok = send(tok, out_ch, i + u32:1);
+  }
+}
+
+#[test_proc]
+proc tester_proc {
+  data_out: chan<u32> out;
+  data_in: chan<u32> in;
+  terminator: chan<bool> out;
+
+  init { u32:0 }
+
+  config(terminator: chan<bool> out) {
+    let (input_out, input_in) = chan<u32>;
+    let (output_out, output_in) = chan<u32>;
+    spawn incrementer(input_in, output_out);
+    (input_out, output_in, terminator)
+  }
+
+  next(tok: token, count: u32) {
+    let tok = send(tok, data_out, count);
+    let (tok, result) = recv(tok, data_in);
+    let tok = send_if(tok, terminator, count == u32:1000,
+                      result == count + u32:1);
+    count + u32:1
+ }
+})";
+  std::vector<std::string> jit_test_procs;
+  ParseAndTestOptions options;
+  options.run_procs_on_jit = true;
+  options.jit_test_proc_hook = [&](std::string_view test_name) {
+    jit_test_procs.push_back(std::string(test_name));
+  };
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, "test_module", "test.x", options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kAllPassed))
+      << result.status();
+  EXPECT_THAT(jit_test_procs, testing::ElementsAre("tester_proc"));
+}
+
+TEST(RunRoutinesTest, FailingTestProcOnJit) {
+  constexpr std::string_view kProgram = R"(
+#[test_proc]
+proc tester_proc {
+  terminator: chan<bool> out;
+
+  init { u32:0 }
+
+  config(terminator: chan<bool> out) {
+    (terminator,)
+  }
+
+  next(tok: token, count: u32) {
+    let count = if count == u32:10 { fail!("too_many", count) } else { count };
+    let tok = send_if(tok, terminator, count == u32:20, true);
+    count + u32:1
+ }
+})";
+  std::vector<std::string> jit_test_procs;
+  ParseAndTestOptions options;
+  options.run_procs_on_jit = true;
+  options.jit_test_proc_hook = [&](std::string_view test_name) {
+    jit_test_procs.push_back(std::string(test_name));
+  };
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, "test_module", "test.x", options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kSomeFailed))
+      << result.status();
+  EXPECT_THAT(jit_test_procs, testing::ElementsAre("tester_proc"));
+}
+
+TEST(RunRoutinesTest, TooManyTicksOnJit) {
+  constexpr std::string_view kProgram = R"(
+#[test_proc]
+proc tester_proc {
+  terminator: chan<bool> out;
+
+  init { () }
+
+  config(terminator: chan<bool> out) {
+    (terminator,)
+  }
+
+  next(tok: token, state: ()) {
+    let tok = send_if(tok, terminator, false, true);
+ }
+})";
+  std::vector<std::string> jit_test_procs;
+  ParseAndTestOptions options;
+  options.run_procs_on_jit = true;
+  options.jit_test_proc_hook = [&](std::string_view test_name) {
+    jit_test_procs.push_back(std::string(test_name));
+  };
+  options.max_ticks = 100;
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, "test_module", "test.x", options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kSomeFailed))
+      << result.status();
+  EXPECT_THAT(jit_test_procs, testing::ElementsAre("tester_proc"));
+}
+
 }  // namespace xls::dslx
@@ -14,9 +14,11 @@
 
 #include "xls/dslx/type_system/type_info.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -78,12 +80,47 @@ absl::StatusOr<TypeInfo*> TypeInfoOwner::GetRootTypeInfo(const Module* module) {
   return it->second;
 }
 
+void TypeInfoOwner::Erase(const Module* module) {
+  module_to_root_.erase(module);
+  type_infos_.erase(
+      std::remove_if(type_infos_.begin(), type_infos_.end(),
+                     [module](const std::unique_ptr<TypeInfo>& type_info) {
+                       return type_info->module() == module;
+                     }),
+      type_infos_.end());
+}
+
 // -- class TypeInfo
 
 void TypeInfo::NoteConstExpr(const AstNode* const_expr, InterpValue value) {
   const_exprs_.insert({const_expr, value});
 }
 
+void TypeInfo::NoteConstExprEvaluation(
+    const Expr* expr, absl::flat_hash_map<std::string, InterpValue> env,
+    InterpValue value) {
+  XLS_CHECK_EQ(expr->owner(), module_);
+  GetRoot()->const_expr_evaluations_[expr].push_back(
+      ConstExprEvaluation{std::move(env), std::move(value)});
+}
+
+std::optional<InterpValue> TypeInfo::GetConstExprEvaluation(
+    const Expr* expr,
+    const absl::flat_hash_map<std::string, InterpValue>& env) const {
+  XLS_CHECK_EQ(expr->owner(), module_);
+  const TypeInfo* root = GetRoot();
+  auto it = root->const_expr_evaluations_.find(expr);
+  if (it == root->const_expr_evaluations_.end()) {
+    return std::nullopt;
+  }
+  for (const ConstExprEvaluation& evaluation : it->second) {
+    if (evaluation.env == env) {
+      return evaluation.value;
+    }
+  }
+  return std::nullopt;
+}
+
 absl::StatusOr<InterpValue> TypeInfo::GetConstExpr(
     const AstNode* const_expr) const {
   XLS_CHECK_EQ(const_expr->owner(), module_)
@@ -272,6 +309,25 @@ absl::StatusOr<TypeInfo*> TypeInfo::GetInvocationTypeInfoOrError(
                    caller.ToString()));
 }
 
+void TypeInfo::NoteInstantiationTypeInfo(const Function* f,
+                                         const ParametricEnv& env,
+                                         TypeInfo* type_info) {
+  XLS_CHECK_EQ(f->owner(), module_);
+  XLS_CHECK_EQ(type_info->parent(), this);
+  GetRoot()->instantiations_[std::make_tuple(f, env, this)] = type_info;
+}
+
+std::optional<TypeInfo*> TypeInfo::GetInstantiationTypeInfo(
+    const Function* f, const ParametricEnv& env) const {
+  XLS_CHECK_EQ(f->owner(), module_);
+  const TypeInfo* root = GetRoot();
+  auto it = root->instantiations_.find(std::make_tuple(f, env, this));
+  if (it == root->instantiations_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 void TypeInfo::SetInvocationTypeInfo(const Invocation* invocation,
                                      ParametricEnv caller,
                                      TypeInfo* type_info) {
@@ -21,6 +21,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -90,6 +91,17 @@ class TypeInfoOwner {
   // status error if it is not present.
   absl::StatusOr<TypeInfo*> GetRootTypeInfo(const Module* module);
 
+  // Destroys all type information (root and derived) whose module is "module".
+  // Used when a module is dropped from a long-lived ImportData; "module" is not
+  // dereferenced, so it may already have been destroyed.
+  void Erase(const Module* module);
+
+  // Returns all owned type information, in creation order (so parents precede
+  // their children).
+  const std::vector<std::unique_ptr<TypeInfo>>& type_infos() const {
+    return type_infos_;
+  }
+
  private:
   // Mapping from module to the "root" (or "parentmost") type info -- these have
   // nullptr as their parent. There should only be one of these for any given
@@ -157,6 +169,19 @@ class TypeInfo {
   absl::StatusOr<TypeInfo*> GetInvocationTypeInfoOrError(
       const Invocation* invocation, const ParametricEnv& caller) const;
 
+  // Notes that the body of parametric function "f" has been typechecked, with
+  // the given callee parametric env, into "type_info" -- a type information
+  // derived from this one. Identical instantiations (same function, env and
+  // enclosing type information) can then share it instead of re-deducing the
+  // body; see GetInstantiationTypeInfo().
+  void NoteInstantiationTypeInfo(const Function* f, const ParametricEnv& env,
+                                 TypeInfo* type_info);
+
+  // Retrieves the type information noted above for an instantiation of "f"
+  // with "env" derived from this type information, if there is one.
+  std::optional<TypeInfo*> GetInstantiationTypeInfo(
+      const Function* f, const ParametricEnv& env) const;
+
   // Sets the type info for the given proc when typechecked at top-level (i.e.,
   // not via an instantiation). Can only be called on the module root TypeInfo.
   absl::Status SetTopLevelProcTypeInfo(const Proc* p, TypeInfo* ti);
@@ -241,6 +266,22 @@ class TypeInfo {
   std::optional<InterpValue> GetConstExprOption(
       const AstNode* const_expr) const;
 
+  // Memoizes the constexpr evaluation of "expr" within the environment "env"
+  // it was evaluated in (its parametric bindings and the values of its
+  // constexpr free variables). The memo lives in the root TypeInfo, so an
+  // identical evaluation from any instantiation -- e.g. a second instantiation
+  // of a proc, or of a parametric function from another caller -- can reuse
+  // the value instead of running the interpreter again.
+  void NoteConstExprEvaluation(
+      const Expr* expr, absl::flat_hash_map<std::string, InterpValue> env,
+      InterpValue value);
+
+  // Retrieves a value noted above for "expr" in an environment equal to
+  // "env", if there is one.
+  std::optional<InterpValue> GetConstExprEvaluation(
+      const Expr* expr,
+      const absl::flat_hash_map<std::string, InterpValue>& env) const;
+
   // Retrieves a string that shows the module associated with this type info and
   // which imported modules are present, suitable for debugging.
   std::string GetImportsDebugString() const;
@@ -257,6 +298,24 @@ class TypeInfo {
     return dict_;
   }
 
+  // Accessors for the remaining underlying mappings; most of these are only
+  // populated in the root (see GetRoot()).
+  const absl::flat_hash_map<Slice*, SliceData>& slices() const {
+    return slices_;
+  }
+  const absl::flat_hash_map<const AstNode*, std::optional<InterpValue>>&
+  const_exprs() const {
+    return const_exprs_;
+  }
+  const absl::flat_hash_map<const Function*, bool>& requires_implicit_token()
+      const {
+    return requires_implicit_token_;
+  }
+  const absl::flat_hash_map<const Proc*, TypeInfo*>& top_level_proc_type_infos()
+      const {
+    return top_level_proc_type_info_;
+  }
+
  private:
   friend class TypeInfoOwner;
 
@@ -268,6 +327,13 @@ class TypeInfo {
   //    then performed in the parent, and so on transitively).
   explicit TypeInfo(Module* module, TypeInfo* parent = nullptr);
 
+  // An environment a constexpr was evaluated in, and the resulting value; see
+  // NoteConstExprEvaluation().
+  struct ConstExprEvaluation {
+    absl::flat_hash_map<std::string, InterpValue> env;
+    InterpValue value;
+  };
+
   // Traverses to the 'root' (AKA 'most parent') TypeInfo. This is a place to
   // stash context-free information (e.g. that is found in a parametric
   // instantiation context, but that we want to be accessible to other
@@ -287,8 +353,17 @@ class TypeInfo {
   absl::flat_hash_map<const AstNode*, std::unique_ptr<ConcreteType>> dict_;
   absl::flat_hash_map<Import*, ImportedInfo> imports_;
   absl::flat_hash_map<const Invocation*, InvocationData> invocations_;
+  // Keyed on (function, callee env, parent type info); see
+  // NoteInstantiationTypeInfo().
+  absl::flat_hash_map<
+      std::tuple<const Function*, ParametricEnv, const TypeInfo*>, TypeInfo*>
+      instantiations_;
   absl::flat_hash_map<Slice*, SliceData> slices_;
   absl::flat_hash_map<const AstNode*, std::optional<InterpValue>> const_exprs_;
+  // Only populated in the root; a handful of environments (one per distinct
+  // instantiation) is expected per expression, so they are searched linearly.
+  absl::flat_hash_map<const Expr*, std::vector<ConstExprEvaluation>>
+      const_expr_evaluations_;
   absl::flat_hash_map<const Function*, bool> requires_implicit_token_;
 
   // Maps a Proc to the TypeInfo used for its top-level typechecking.
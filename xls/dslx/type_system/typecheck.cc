@@ -470,7 +470,7 @@ absl::Status CheckModuleMember(const ModuleMember& member, Module* module,
     XLS_ASSIGN_OR_RETURN(
         ModuleInfo * imported,
         DoImport(ctx->typecheck_module(), ImportTokens(import->subject()),
-                 import_data, import->span()));
+                 import_data, import->span(), ctx->warnings()));
     ctx->type_info()->AddImport(import, &imported->module(),
                                 imported->type_info());
   } else if (std::holds_alternative<ConstantDef*>(member) ||
@@ -914,6 +914,28 @@ absl::StatusOr<TypeAndParametricEnv> CheckInvocation(
   parent_ctx->type_info()->SetItem(invocation->callee(), instantiated_ft);
   ctx->type_info()->SetItem(callee_fn->name_def(), instantiated_ft);
 
+  // If this exact instantiation (same callee and parametric env, derived from
+  // the same type information) has been typechecked before, share its type
+  // information (including its constexpr values) rather than re-deducing the
+  // body -- e.g. floating point code instantiates the same apfloat parametrics
+  // many times over. Procs get distinct constexpr data per instantiation (see
+  // above), so they're always checked anew.
+  const bool shareable_instantiation =
+      !callee_fn->proc().has_value() && constexpr_env.empty();
+  if (shareable_instantiation) {
+    if (std::optional<TypeInfo*> instantiation_ti =
+            ctx->type_info()->GetInstantiationTypeInfo(
+                callee_fn, callee_tab.parametric_env);
+        instantiation_ti.has_value()) {
+      XLS_VLOG(5) << "Reusing type info for instantiation of "
+                  << callee_fn->identifier() << " with "
+                  << callee_tab.parametric_env;
+      parent_ctx->type_info()->SetInvocationTypeInfo(
+          invocation, callee_tab.parametric_env, *instantiation_ti);
+      return callee_tab;
+    }
+  }
+
   // We need to deduce fn body, so we're going to call Deduce, which means we'll
   // need a new stack entry w/the new symbolic bindings.
   TypeInfo* original_ti = parent_ctx->type_info();
@@ -1008,8 +1030,13 @@ absl::StatusOr<TypeAndParametricEnv> CheckInvocation(
 
   original_ti->SetInvocationTypeInfo(invocation, callee_tab.parametric_env,
                                      ctx->type_info());
+  TypeInfo* instantiation_ti = ctx->type_info();
 
   XLS_RETURN_IF_ERROR(ctx->PopDerivedTypeInfo());
+  if (shareable_instantiation) {
+    ctx->type_info()->NoteInstantiationTypeInfo(
+        callee_fn, callee_tab.parametric_env, instantiation_ti);
+  }
   ctx->PopFnStackEntry();
 
   // Implementation note: though we could have all functions have
@@ -23,15 +23,22 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "benchmark/benchmark.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/error_printer.h"
 #include "xls/dslx/error_test_utils.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/pos.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/type_system/typecheck_test_helpers.h"
 
 namespace xls::dslx {
@@ -2144,5 +2151,68 @@ TEST(TypecheckTest, ConcatNilArrayOfOneU8) {
                                    "array/non-array values together")));
 }
 
+// Collects the invocations under "node" whose callee is named "callee".
+void CollectInvocations(const AstNode* node, std::string_view callee,
+                        std::vector<const Invocation*>& invocations) {
+  if (auto* invocation = dynamic_cast<const Invocation*>(node);
+      invocation != nullptr && invocation->callee()->ToString() == callee) {
+    invocations.push_back(invocation);
+  }
+  for (const AstNode* child : node->GetChildren(/*want_types=*/false)) {
+    CollectInvocations(child, callee, invocations);
+  }
+}
+
+TEST(TypecheckTest, IdenticalParametricInstantiationsShareTypeInfo) {
+  constexpr std::string_view kProgram = R"(
+fn p<N: u32>(x: uN[N]) -> uN[N] { x + uN[N]:1 }
+fn main() -> u32 { p(u32:1) + p(u32:2) + (p(u8:3) as u32) }
+fn other() -> u32 { p(u32:4) }
+)";
+  ImportData import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "fake.x", "fake", &import_data));
+  std::vector<const Invocation*> invocations;
+  CollectInvocations(tm.module, "p", invocations);
+  ASSERT_EQ(invocations.size(), 4);
+
+  auto env_for_width = [](int64_t width) {
+    return ParametricEnv(absl::flat_hash_map<std::string, InterpValue>{
+        {"N", InterpValue::MakeU32(width)}});
+  };
+  std::vector<TypeInfo*> instantiation_tis;
+  for (const Invocation* invocation : invocations) {
+    std::optional<TypeInfo*> ti = tm.type_info->GetInvocationTypeInfo(
+        invocation, env_for_width(invocation == invocations[2] ? 8 : 32));
+    ASSERT_TRUE(ti.has_value()) << invocation->ToString();
+    instantiation_tis.push_back(*ti);
+  }
+  EXPECT_EQ(instantiation_tis[0], instantiation_tis[1]);
+  EXPECT_EQ(instantiation_tis[0], instantiation_tis[3]);
+  EXPECT_NE(instantiation_tis[0], instantiation_tis[2]);
+}
+
+// Typechecks a module that instantiates the apfloat parametrics many times
+// over, as floating point libraries do.
+void BM_TypecheckApfloatInstantiations(benchmark::State& state) {
+  std::string program = "import apfloat;\n";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    absl::StrAppendFormat(&program, R"(
+fn f%d(x: apfloat::APFloat<u32:8, u32:23>, y: apfloat::APFloat<u32:8, u32:23>)
+    -> apfloat::APFloat<u32:8, u32:23> {
+  apfloat::fma(apfloat::mul(x, y), apfloat::add(x, y), apfloat::sub(x, y))
+}
+)",
+                          i);
+  }
+  for (auto _ : state) {
+    ImportData import_data = CreateImportDataForTest();
+    XLS_ASSERT_OK(
+        ParseAndTypecheck(program, "fake.x", "fake", &import_data).status());
+  }
+}
+BENCHMARK(BM_TypecheckApfloatInstantiations)->Arg(1)->Arg(16)->Arg(64);
+
 }  // namespace
 }  // namespace xls::dslx
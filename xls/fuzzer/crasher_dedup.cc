@@ -0,0 +1,187 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/crasher_dedup.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "openssl/sha.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
+#include "re2/re2.h"
+
+namespace xls {
+namespace {
+
+// The number of innermost stack frames included in a signature. Frames further
+// out mostly describe how the fuzzer reached the failing code, not the bug.
+constexpr int64_t kMaxStackFrames = 3;
+
+// Returns the tool named in a SampleRunner error message about a failed or
+// timed-out subprocess, if any.
+std::optional<std::string> FailingTool(std::string_view message) {
+  static const LazyRE2 kNonZeroExitRe = {
+      R"(^(\S+) returned a? ?non-zero exit status)"};
+  static const LazyRE2 kSubprocessRe = {
+      R"(^Subprocess call (?:failed|timed out)[^:]*: (\S+))"};
+  std::string executable;
+  if (RE2::PartialMatch(message, *kNonZeroExitRe, &executable) ||
+      RE2::PartialMatch(message, *kSubprocessRe, &executable)) {
+    return std::filesystem::path(executable).filename().string();
+  }
+  return std::nullopt;
+}
+
+// Returns the first fatal (or failing that, error) log message in `stderr`.
+std::optional<std::string> FirstLoggedError(std::string_view stderr_text) {
+  static const LazyRE2 kLogLineRe = {R"(^([FE])\d{4} [^\]]*\] (.*)$)"};
+  std::optional<std::string> first_error;
+  for (std::string_view line : absl::StrSplit(stderr_text, '\n')) {
+    std::string severity;
+    std::string text;
+    if (!RE2::FullMatch(line, *kLogLineRe, &severity, &text)) {
+      continue;
+    }
+    if (severity == "F") {
+      return text;
+    }
+    if (!first_error.has_value()) {
+      first_error = text;
+    }
+  }
+  return first_error;
+}
+
+// Returns the symbols of the innermost frames of the first stack trace in
+// `stderr`, skipping unsymbolized frames and those of the logging library.
+std::vector<std::string> TopStackFrames(std::string_view stderr_text) {
+  static const LazyRE2 kFrameRe = {
+      R"(^\s*@\s+0x[0-9a-fA-F]+\s+(?:\d+\s+)?(.*\S)\s*$)"};
+  static const LazyRE2 kSkippedFrameRe = {
+      R"(^\(unknown\)$|logging_internal|LogMessage)"};
+  std::vector<std::string> frames;
+  for (std::string_view line : absl::StrSplit(stderr_text, '\n')) {
+    std::string symbol;
+    if (!RE2::FullMatch(line, *kFrameRe, &symbol) ||
+        RE2::PartialMatch(symbol, *kSkippedFrameRe)) {
+      continue;
+    }
+    frames.push_back(NormalizeFailureText(symbol));
+    if (frames.size() >= kMaxStackFrames) {
+      break;
+    }
+  }
+  return frames;
+}
+
+}  // namespace
+
+std::string FailureSignature::ToString() const {
+  std::string result = absl::StrCat("stage: ", stage, "\nmessage: ", message);
+  for (const std::string& frame : stack_frames) {
+    absl::StrAppend(&result, "\nframe: ", frame);
+  }
+  return result;
+}
+
+std::string FailureSignature::Digest() const {
+  std::string text = ToString();
+  std::array<uint8_t, SHA256_DIGEST_LENGTH> digest;
+  SHA256(reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+         digest.data());
+  return absl::BytesToHexString(absl::string_view(
+      reinterpret_cast<const char*>(digest.data()), /*length=*/8));
+}
+
+std::string NormalizeFailureText(std::string_view text) {
+  std::string result(text);
+  // Paths differ between run directories; keep only their final components.
+  static const LazyRE2 kDirectoryRe = {R"((?:[\w.+\-]*/)+)"};
+  static const LazyRE2 kHexRe = {R"(\b0x[0-9a-fA-F]+\b)"};
+  static const LazyRE2 kNumberRe = {R"(\d+)"};
+  static const LazyRE2 kSpaceRe = {R"(\s+)"};
+  RE2::GlobalReplace(&result, *kDirectoryRe, "");
+  RE2::GlobalReplace(&result, *kHexRe, "N");
+  RE2::GlobalReplace(&result, *kNumberRe, "N");
+  RE2::GlobalReplace(&result, *kSpaceRe, " ");
+  return std::string(absl::StripAsciiWhitespace(result));
+}
+
+FailureSignature ComputeFailureSignature(
+    const absl::Status& error, const std::filesystem::path& run_dir) {
+  FailureSignature signature;
+  std::string_view first_line =
+      std::string_view(error.message()).substr(0, error.message().find('\n'));
+  signature.message = NormalizeFailureText(
+      absl::StrCat(absl::StatusCodeToString(error.code()), ": ", first_line));
+
+  std::optional<std::string> tool = FailingTool(error.message());
+  signature.stage = tool.value_or("sample");
+  if (!tool.has_value()) {
+    return signature;
+  }
+  absl::StatusOr<std::string> stderr_text =
+      GetFileContents(run_dir / absl::StrCat(*tool, ".stderr"));
+  if (!stderr_text.ok()) {
+    return signature;
+  }
+  if (std::optional<std::string> logged_error = FirstLoggedError(*stderr_text);
+      logged_error.has_value()) {
+    signature.message = NormalizeFailureText(*logged_error);
+  }
+  signature.stack_frames = TopStackFrames(*stderr_text);
+  return signature;
+}
+
+absl::StatusOr<bool> ClaimFailureSignature(
+    const std::filesystem::path& crasher_dir,
+    const FailureSignature& signature, std::string_view sample_id) {
+  std::filesystem::path signatures_dir = crasher_dir / "signatures";
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(signatures_dir));
+
+  std::filesystem::path signature_dir = signatures_dir / signature.Digest();
+  std::error_code ec;
+  bool created = std::filesystem::create_directory(signature_dir, ec);
+  if (ec) {
+    return absl::InternalError(absl::StrCat("Failed to create directory ",
+                                            signature_dir.string(), ": ",
+                                            ec.message()));
+  }
+  if (!created) {
+    XLS_RETURN_IF_ERROR(AppendStringToFile(signature_dir / "duplicates.txt",
+                                           absl::StrCat(sample_id, "\n")));
+    return false;
+  }
+  XLS_RETURN_IF_ERROR(SetFileContents(signature_dir / "signature.txt",
+                                      signature.ToString() + "\n"));
+  XLS_RETURN_IF_ERROR(SetFileContents(signature_dir / "first.txt",
+                                      absl::StrCat(sample_id, "\n")));
+  return true;
+}
+
+}  // namespace xls
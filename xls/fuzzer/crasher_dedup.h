@@ -0,0 +1,73 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_CRASHER_DEDUP_H_
+#define XLS_FUZZER_CRASHER_DEDUP_H_
+
+#include <filesystem>  // NOLINT
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+namespace xls {
+
+// Identifies the bug behind a failing fuzz sample, so that samples which hit
+// the same bug can be recognized as duplicates. Every field is normalized (see
+// NormalizeFailureText) so that it does not depend on the sample's values,
+// node ids, or paths.
+struct FailureSignature {
+  // The tool which failed (e.g. "eval_ir_main"), or "sample" if the failure
+  // was found by the sample runner itself, e.g. a result miscompare.
+  std::string stage;
+  // The failure's status code and first line of its error message; for a tool
+  // which failed, the first fatal error line in its stderr.
+  std::string message;
+  // The innermost frames of the failing tool's stack trace, if it printed one.
+  std::vector<std::string> stack_frames;
+
+  // Returns a human-readable rendering of the signature.
+  std::string ToString() const;
+
+  // Returns a short hex digest of the signature, suitable as a file name.
+  std::string Digest() const;
+};
+
+// Replaces the parts of `text` which vary between samples hitting the same bug:
+// numbers (decimal or hex) become "N", paths lose their directories, and runs
+// of whitespace become single spaces.
+std::string NormalizeFailureText(std::string_view text);
+
+// Returns the signature of `error`, the failure of the sample run in
+// `run_dir`; the stderr of the failing tool is read from `run_dir`, if present.
+FailureSignature ComputeFailureSignature(const absl::Status& error,
+                                         const std::filesystem::path& run_dir);
+
+// Records that the sample identified by `sample_id` (e.g. the path it was
+// saved at) failed with `signature`, in the "signatures" subdirectory of
+// `crasher_dir`. Returns true if this is the first sample to fail with
+// `signature`, and false if it is a duplicate.
+//
+// Any number of processes may share `crasher_dir`: a signature is claimed by
+// creating its directory, which succeeds for exactly one of them, and
+// duplicates are only ever appended to a log, so no locking is needed.
+absl::StatusOr<bool> ClaimFailureSignature(
+    const std::filesystem::path& crasher_dir,
+    const FailureSignature& signature, std::string_view sample_id);
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_CRASHER_DEDUP_H_
@@ -0,0 +1,118 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/crasher_dedup.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr char kEvalIrStderr[] = R"(
+I1018 10:00:00.000000  42 main.cc:99] Running
+E1018 10:00:01.000000  42 main.cc:120] Something odd
+F1018 10:00:02.000000  42 add.cc:311] Check failed: w <= 64 (65 vs. 64)
+*** Check failure stack trace: ***
+    @     0x55d3a9c1e2a4  (unknown)
+    @     0x55d3a9c1e2a8  xls::logging_internal::LogMessageFatal::Fail()
+    @     0x55d3a9c1e2b8  xls::IrInterpreter::HandleAdd()
+    @     0x55d3a9c1e2c0  xls::Node::Accept()
+    @     0x55d3a9c1e2d0  xls::Function::Accept()
+    @     0x55d3a9c1e2e0  main
+)";
+
+TEST(CrasherDedupTest, NormalizeFailureText) {
+  EXPECT_EQ(NormalizeFailureText("  add.42: bits[17]  at 0xdeadBEEF  "),
+            "add.N: bits[N] at N");
+  EXPECT_EQ(NormalizeFailureText("failed: /tmp/abc123/sample.opt.ir:3:7"),
+            "failed: sample.opt.ir:N:N");
+}
+
+TEST(CrasherDedupTest, SampleFailureSignature) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory run_dir, TempDirectory::Create());
+  FailureSignature signature = ComputeFailureSignature(
+      absl::InvalidArgumentError(
+          "SampleError: Result miscompare for sample 3:\nargs: bits[8]:0x2a"),
+      run_dir.path());
+  EXPECT_EQ(signature.stage, "sample");
+  EXPECT_EQ(signature.message,
+            "INVALID_ARGUMENT: SampleError: Result miscompare for sample N:");
+  EXPECT_THAT(signature.stack_frames, IsEmpty());
+}
+
+TEST(CrasherDedupTest, ToolFailureSignature) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory run_dir, TempDirectory::Create());
+  XLS_ASSERT_OK(
+      SetFileContents(run_dir.path() / "eval_ir_main.stderr", kEvalIrStderr));
+  FailureSignature signature = ComputeFailureSignature(
+      absl::InternalError("/build/xls/tools/eval_ir_main returned non-zero "
+                          "exit status (134): /build/xls/tools/eval_ir_main "
+                          "--input_file=args.txt sample.ir"),
+      run_dir.path());
+  EXPECT_EQ(signature.stage, "eval_ir_main");
+  EXPECT_EQ(signature.message, "Check failed: w <= N (N vs. N)");
+  EXPECT_THAT(signature.stack_frames,
+              ElementsAre("xls::IrInterpreter::HandleAdd()",
+                          "xls::Node::Accept()", "xls::Function::Accept()"));
+}
+
+TEST(CrasherDedupTest, SignatureIgnoresSampleDetails) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory run_dir, TempDirectory::Create());
+  FailureSignature a = ComputeFailureSignature(
+      absl::InternalError("Node add.12 has width 33"), run_dir.path());
+  FailureSignature b = ComputeFailureSignature(
+      absl::InternalError("Node add.7 has width 9"), run_dir.path());
+  FailureSignature c = ComputeFailureSignature(
+      absl::InternalError("Node sub.7 has width 9"), run_dir.path());
+  EXPECT_EQ(a.Digest(), b.Digest());
+  EXPECT_NE(a.Digest(), c.Digest());
+}
+
+TEST(CrasherDedupTest, ClaimFailureSignature) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory crasher_dir, TempDirectory::Create());
+  FailureSignature signature = {.stage = "opt_main",
+                                .message = "Check failed: x"};
+  FailureSignature other = {.stage = "codegen_main",
+                            .message = "Check failed: x"};
+
+  EXPECT_THAT(ClaimFailureSignature(crasher_dir.path(), signature, "first"),
+              IsOkAndHolds(true));
+  EXPECT_THAT(ClaimFailureSignature(crasher_dir.path(), signature, "second"),
+              IsOkAndHolds(false));
+  EXPECT_THAT(ClaimFailureSignature(crasher_dir.path(), signature, "third"),
+              IsOkAndHolds(false));
+  EXPECT_THAT(ClaimFailureSignature(crasher_dir.path(), other, "fourth"),
+              IsOkAndHolds(true));
+
+  std::filesystem::path signature_dir =
+      crasher_dir.path() / "signatures" / signature.Digest();
+  EXPECT_THAT(GetFileContents(signature_dir / "first.txt"),
+              IsOkAndHolds("first\n"));
+  EXPECT_THAT(GetFileContents(signature_dir / "duplicates.txt"),
+              IsOkAndHolds("second\nthird\n"));
+}
+
+}  // namespace
+}  // namespace xls
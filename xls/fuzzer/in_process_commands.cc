@@ -0,0 +1,299 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/in_process_commands.h"
+
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/command_line_utils.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/ir_convert/convert_options.h"
+#include "xls/dslx/ir_convert/ir_converter.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/warning_kind.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/events.h"
+#include "xls/ir/format_preference.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/function_jit.h"
+#include "xls/tools/opt.h"
+
+namespace xls {
+namespace {
+
+// The command line of a tool invocation, split into flags and positional
+// arguments.
+struct ToolArgs {
+  absl::flat_hash_map<std::string, std::string> flags;
+  std::vector<std::string> positional;
+
+  std::optional<std::string> GetFlag(std::string_view name) const {
+    auto it = flags.find(name);
+    if (it == flags.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  absl::StatusOr<bool> GetBoolFlag(std::string_view name,
+                                   bool default_value) const {
+    std::optional<std::string> value = GetFlag(name);
+    if (!value.has_value()) {
+      return default_value;
+    }
+    bool result;
+    if (!absl::SimpleAtob(*value, &result)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid value for --", name, ": ", *value));
+    }
+    return result;
+  }
+};
+
+// Parses `args` in the form SampleRunner passes them to tools: `--name=value`,
+// `--name` or `--noname` for booleans, and positional arguments. Flags not in
+// `known_flags` are rejected.
+absl::StatusOr<ToolArgs> ParseToolArgs(
+    const std::vector<std::string>& args,
+    absl::Span<const std::string_view> known_flags) {
+  auto is_known = [&](std::string_view name) {
+    for (std::string_view known : known_flags) {
+      if (name == known) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  ToolArgs result;
+  for (std::string_view arg : args) {
+    if (!absl::ConsumePrefix(&arg, "--")) {
+      result.positional.push_back(std::string(arg));
+      continue;
+    }
+    std::vector<std::string_view> name_and_value =
+        absl::StrSplit(arg, absl::MaxSplits('=', 1));
+    std::string_view name = name_and_value[0];
+    std::string value = name_and_value.size() > 1
+                            ? std::string(name_and_value[1])
+                            : std::string("true");
+    if (name_and_value.size() == 1 && !is_known(name) &&
+        absl::ConsumePrefix(&name, "no")) {
+      value = "false";
+    }
+    if (!is_known(name)) {
+      return absl::UnimplementedError(
+          absl::StrCat("Flag not supported in-process: ", arg));
+    }
+    result.flags[std::string(name)] = std::move(value);
+  }
+  return result;
+}
+
+// Returns the single positional argument of `args` as a path, resolved against
+// `run_dir` as a tool invoked there would.
+absl::StatusOr<std::filesystem::path> GetInputPath(
+    const ToolArgs& args, const std::filesystem::path& run_dir) {
+  if (args.positional.size() != 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected exactly one input path; got ", args.positional.size()));
+  }
+  std::filesystem::path path = args.positional.front();
+  if (path.is_relative()) {
+    path = run_dir / path;
+  }
+  return path;
+}
+
+}  // namespace
+
+InProcessCommands::InProcessCommands()
+    : import_data_(dslx::CreateImportDataPtr(dslx::kDefaultDslxStdlibPath,
+                                             /*additional_search_paths=*/{},
+                                             dslx::kAllWarningsSet)) {}
+
+SampleRunner::Commands InProcessCommands::commands() {
+  SampleRunner::Commands commands;
+  commands.ir_converter_main = SampleRunner::Commands::Callable(
+      [this](const std::vector<std::string>& args,
+             const std::filesystem::path& run_dir,
+             const SampleOptions& options) {
+        return ConvertDslxToIr(args, run_dir, options);
+      });
+  commands.ir_opt_main = SampleRunner::Commands::Callable(
+      [this](const std::vector<std::string>& args,
+             const std::filesystem::path& run_dir,
+             const SampleOptions& options) {
+        return OptimizeIr(args, run_dir, options);
+      });
+  commands.eval_ir_main = SampleRunner::Commands::Callable(
+      [this](const std::vector<std::string>& args,
+             const std::filesystem::path& run_dir,
+             const SampleOptions& options) {
+        return EvaluateIr(args, run_dir, options);
+      });
+  return commands;
+}
+
+absl::StatusOr<std::string> InProcessCommands::ConvertDslxToIr(
+    const std::vector<std::string>& args, const std::filesystem::path& run_dir,
+    const SampleOptions& options) {
+  XLS_ASSIGN_OR_RETURN(ToolArgs tool_args,
+                       ParseToolArgs(args, {"top", "warnings_as_errors"}));
+  XLS_ASSIGN_OR_RETURN(std::filesystem::path input_path,
+                       GetInputPath(tool_args, run_dir));
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(input_path));
+  XLS_ASSIGN_OR_RETURN(std::string module_name,
+                       dslx::PathToName(input_path.string()));
+
+  dslx::ConvertOptions convert_options;
+  XLS_ASSIGN_OR_RETURN(
+      convert_options.warnings_as_errors,
+      tool_args.GetBoolFlag("warnings_as_errors", /*default_value=*/true));
+  convert_options.enabled_warnings = import_data_->enabled_warnings();
+
+  // The sample's module is dropped once converted so the next sample (which
+  // has the same module name) starts clean; the modules it imported stay
+  // cached. The cleanup is registered before typechecking so that it also
+  // runs when typechecking fails part way. (A module which fails to typecheck
+  // is never loaded; its type information is dropped by TypecheckModule.)
+  XLS_ASSIGN_OR_RETURN(dslx::ImportTokens subject,
+                       dslx::ImportTokens::FromString(module_name));
+  absl::Cleanup evict_sample = [&] {
+    if (import_data_->Contains(subject)) {
+      import_data_->Evict(subject).IgnoreError();
+    }
+  };
+  XLS_ASSIGN_OR_RETURN(
+      dslx::TypecheckedModule tm,
+      dslx::ParseAndTypecheck(text, input_path.string(), module_name,
+                              import_data_.get()));
+
+  if (convert_options.warnings_as_errors && !tm.warnings.warnings().empty()) {
+    return absl::InvalidArgumentError(
+        "Warnings encountered and warnings-as-errors set.");
+  }
+
+  Package package(module_name);
+  if (std::optional<std::string> top = tool_args.GetFlag("top");
+      top.has_value()) {
+    XLS_RETURN_IF_ERROR(dslx::ConvertOneFunctionIntoPackage(
+        tm.module, *top, import_data_.get(), /*parametric_env=*/nullptr,
+        convert_options, &package));
+  } else {
+    XLS_RETURN_IF_ERROR(dslx::ConvertModuleIntoPackage(
+        tm.module, import_data_.get(), convert_options, &package));
+  }
+  return package.DumpIr();
+}
+
+absl::StatusOr<std::string> InProcessCommands::OptimizeIr(
+    const std::vector<std::string>& args, const std::filesystem::path& run_dir,
+    const SampleOptions& options) {
+  XLS_ASSIGN_OR_RETURN(ToolArgs tool_args, ParseToolArgs(args, {"top"}));
+  XLS_ASSIGN_OR_RETURN(std::filesystem::path input_path,
+                       GetInputPath(tool_args, run_dir));
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(input_path));
+
+  std::string top = tool_args.GetFlag("top").value_or("");
+  tools::OptOptions opt_options;
+  opt_options.top = top;
+  opt_options.ir_path = input_path.string();
+  opt_options.inline_procs = false;
+  opt_options.use_context_narrowing_analysis = false;
+  return tools::OptimizeIrForTop(ir_text, opt_options);
+}
+
+absl::StatusOr<std::string> InProcessCommands::EvaluateIr(
+    const std::vector<std::string>& args, const std::filesystem::path& run_dir,
+    const SampleOptions& options) {
+  XLS_ASSIGN_OR_RETURN(
+      ToolArgs tool_args,
+      ParseToolArgs(args, {"top", "input_file", "use_llvm_jit"}));
+  XLS_ASSIGN_OR_RETURN(std::filesystem::path ir_path,
+                       GetInputPath(tool_args, run_dir));
+  XLS_ASSIGN_OR_RETURN(bool use_jit, tool_args.GetBoolFlag(
+                                         "use_llvm_jit",
+                                         /*default_value=*/true));
+  std::optional<std::string> input_file = tool_args.GetFlag("input_file");
+  XLS_RET_CHECK(input_file.has_value())
+      << "In-process IR evaluation requires --input_file";
+
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text, ir_path.string()));
+  if (std::optional<std::string> top = tool_args.GetFlag("top");
+      top.has_value()) {
+    XLS_RETURN_IF_ERROR(package->SetTopByName(*top));
+  }
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+
+  std::filesystem::path input_path = *input_file;
+  if (input_path.is_relative()) {
+    input_path = run_dir / input_path;
+  }
+  XLS_ASSIGN_OR_RETURN(std::string input_text, GetFileContents(input_path));
+  std::vector<std::vector<Value>> arg_sets;
+  for (std::string_view line :
+       absl::StrSplit(input_text, '\n', absl::SkipWhitespace())) {
+    std::vector<Value>& arg_set = arg_sets.emplace_back();
+    for (std::string_view value_text : absl::StrSplit(line, ';')) {
+      XLS_ASSIGN_OR_RETURN(Value value, Parser::ParseTypedValue(value_text));
+      arg_set.push_back(std::move(value));
+    }
+  }
+
+  std::unique_ptr<FunctionJit> jit;
+  if (use_jit) {
+    XLS_ASSIGN_OR_RETURN(jit, FunctionJit::Create(f));
+  }
+  std::string results;
+  for (const std::vector<Value>& arg_set : arg_sets) {
+    Value result;
+    if (use_jit) {
+      XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(jit->Run(arg_set)));
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          result, DropInterpreterEvents(InterpretFunction(f, arg_set)));
+    }
+    absl::StrAppend(&results, result.ToString(FormatPreference::kHex), "\n");
+  }
+  return results;
+}
+
+}  // namespace xls
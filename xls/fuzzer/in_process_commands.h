@@ -0,0 +1,79 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_IN_PROCESS_COMMANDS_H_
+#define XLS_FUZZER_IN_PROCESS_COMMANDS_H_
+
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "xls/dslx/import_data.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
+
+namespace xls {
+
+// Implementations of the SampleRunner stages that dominate the cost of a
+// function sample -- DSLX to IR conversion, IR optimization, and IR evaluation
+// -- which run inside the calling process rather than spawning a tool for each
+// invocation. The DSLX standard library stays parsed and typechecked in a
+// long-lived ImportData between samples, and the LLVM JIT is initialized once
+// per process.
+//
+// Each entry point accepts the same arguments SampleRunner passes to the
+// corresponding tool and returns what the tool would print to stdout. Flags
+// that are not understood yield an UnimplementedError rather than being
+// silently ignored.
+//
+// Running in-process gives up the isolation of a subprocess: a crash takes
+// down the caller, and SampleOptions::timeout_seconds() is not enforced.
+//
+// This class is not thread-safe; use one instance per thread.
+class InProcessCommands {
+ public:
+  InProcessCommands();
+
+  // Returns SampleRunner commands which dispatch to this object. Stages
+  // without an in-process implementation (codegen, proc evaluation, and Verilog
+  // simulation) are left unset, so SampleRunner runs their tools as usual.
+  //
+  // The returned commands refer to this object, which must outlive them.
+  SampleRunner::Commands commands();
+
+  // Equivalent to ir_converter_main; supports --top and --warnings_as_errors.
+  absl::StatusOr<std::string> ConvertDslxToIr(
+      const std::vector<std::string>& args,
+      const std::filesystem::path& run_dir, const SampleOptions& options);
+
+  // Equivalent to opt_main at the default optimization level; supports --top.
+  absl::StatusOr<std::string> OptimizeIr(const std::vector<std::string>& args,
+                                         const std::filesystem::path& run_dir,
+                                         const SampleOptions& options);
+
+  // Equivalent to eval_ir_main; supports --top, --input_file, and
+  // --[no]use_llvm_jit.
+  absl::StatusOr<std::string> EvaluateIr(const std::vector<std::string>& args,
+                                         const std::filesystem::path& run_dir,
+                                         const SampleOptions& options);
+
+ private:
+  std::unique_ptr<dslx::ImportData> import_data_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_IN_PROCESS_COMMANDS_H_
@@ -0,0 +1,136 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/in_process_commands.h"
+
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class InProcessCommandsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(temp_dir_, TempDirectory::Create());
+  }
+
+  std::filesystem::path GetTempPath() { return temp_dir_->path(); }
+
+  InProcessCommands commands_;
+
+ private:
+  std::optional<TempDirectory> temp_dir_;
+};
+
+TEST_F(InProcessCommandsTest, ConvertOptimizeAndEvaluate) {
+  SampleOptions options;
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.x",
+                                "fn main(x: u8, y: u8) -> u8 { x + y }"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string ir_text,
+      commands_.ConvertDslxToIr(
+          {"--top=main", "--warnings_as_errors=false", "sample.x"},
+          GetTempPath(), options));
+  EXPECT_THAT(ir_text, HasSubstr("top fn __sample__main"));
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.ir", ir_text));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string opt_ir_text,
+      commands_.OptimizeIr({"sample.ir"}, GetTempPath(), options));
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.opt.ir", opt_ir_text));
+
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "args.txt",
+                                "bits[8]:42; bits[8]:100\n"
+                                "bits[8]:222; bits[8]:240\n"));
+  for (const char* jit_flag : {"--use_llvm_jit", "--nouse_llvm_jit"}) {
+    EXPECT_THAT(commands_.EvaluateIr(
+                    {"--input_file=args.txt", jit_flag, "sample.opt.ir"},
+                    GetTempPath(), options),
+                IsOkAndHolds("bits[8]:0x8e\nbits[8]:0xce\n"));
+  }
+}
+
+TEST_F(InProcessCommandsTest, ConvertsSuccessiveSamples) {
+  SampleOptions options;
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.x",
+                                "fn main(x: u8) -> u8 { x + u8:1 }"));
+  EXPECT_THAT(
+      commands_.ConvertDslxToIr({"--top=main", "sample.x"}, GetTempPath(),
+                                options),
+      IsOkAndHolds(HasSubstr("add")));
+
+  // A sample which fails to typecheck leaves nothing behind.
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.x",
+                                "fn main(x: u8) -> u16 { x }"));
+  EXPECT_FALSE(
+      commands_
+          .ConvertDslxToIr({"--top=main", "sample.x"}, GetTempPath(), options)
+          .ok());
+
+  // Neither does a sample which converted successfully.
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.x",
+                                "fn main(x: u8) -> u8 { x - u8:1 }"));
+  EXPECT_THAT(
+      commands_.ConvertDslxToIr({"--top=main", "sample.x"}, GetTempPath(),
+                                options),
+      IsOkAndHolds(HasSubstr("sub")));
+}
+
+TEST_F(InProcessCommandsTest, UnsupportedFlag) {
+  SampleOptions options;
+  XLS_ASSERT_OK(SetFileContents(GetTempPath() / "sample.x",
+                                "fn main(x: u8) -> u8 { x }"));
+  EXPECT_THAT(commands_.ConvertDslxToIr({"--emit_positions=false", "sample.x"},
+                                        GetTempPath(), options),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("--emit_positions")));
+}
+
+TEST_F(InProcessCommandsTest, RunSampleInProcess) {
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_convert_to_ir(true);
+  options.set_ir_converter_args({"--top=main"});
+  options.set_optimize_ir(true);
+  options.set_use_jit(true);
+  std::vector<std::vector<dslx::InterpValue>> args_batch = {
+      {dslx::InterpValue::MakeUBits(8, 42),
+       dslx::InterpValue::MakeUBits(8, 100)}};
+
+  SampleRunner runner(GetTempPath(), commands_.commands());
+  XLS_ASSERT_OK(runner.Run(Sample("fn main(x: u8, y: u8) -> u8 { x + y }",
+                                  options, args_batch)));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.opt.ir.results"),
+              IsOkAndHolds("bits[8]:0x8e\n"));
+}
+
+}  // namespace
+}  // namespace xls
@@ -12,16 +12,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 #include "xls/common/exit_status.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
@@ -37,13 +43,21 @@ generated by the fuzzer including op types, widths, etc. This information gives
 an indication of what kind of IR operations are being covered by the
 fuzzer. Usage:
 
-  read_summary_main  [SUMMARY_FILE...]
+  read_summary_main  [SUMMARY_FILE_OR_DIR...]
+
+Directories are searched (recursively) for summary_*.binarypb files, so the
+summaries written by any number of fuzzer processes sharing a summary directory
+can be read together, even while the fuzzers are still running.
 
 Example invocations:
 
 Show summary of a set of files emitted by the fuzzer:
 
   read_summary_main /tmp/summaries/summary_*.binarypb
+
+Show summary of every file in a summary directory:
+
+  read_summary_main /tmp/summaries
 )";
 
 namespace xls {
@@ -244,18 +258,64 @@ void DumpSampleInfo(const SampleInfo& info) {
   }
 }
 
+// Aggregates each summary in `summary_data`, a serialized SampleSummariesProto
+// read from `path`, into 'info' one at a time, rather than parsing them all
+// into memory at once. A truncated final summary, as a fuzzer which is still
+// appending to the file may leave, is skipped.
+absl::Status AggregateSummaries(std::string_view summary_data,
+                                const std::filesystem::path& path,
+                                SummaryInfo* info) {
+  // Fuzzers append serialized SampleSummariesProtos, each holding one sample,
+  // so the file is a sequence of length-delimited `samples` fields.
+  constexpr uint32_t kSamplesTag = google::protobuf::internal::WireFormatLite::
+      MakeTag(fuzzer::SampleSummariesProto::kSamplesFieldNumber,
+              google::protobuf::internal::WireFormatLite::
+                  WIRETYPE_LENGTH_DELIMITED);
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(summary_data.data()),
+      summary_data.size());
+  std::string serialized_summary;
+  fuzzer::SampleSummaryProto summary;
+  while (uint32_t tag = input.ReadTag()) {
+    uint32_t length;
+    if (tag != kSamplesTag) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Failed to parse summary protobuf file %s.", path.string()));
+    }
+    if (!input.ReadVarint32(&length) ||
+        !input.ReadString(&serialized_summary, length)) {
+      XLS_LOG(WARNING) << "Skipping truncated summary at the end of "
+                       << path.string();
+      break;
+    }
+    if (!summary.ParseFromString(serialized_summary)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Failed to parse summary protobuf file %s.", path.string()));
+    }
+    AggregateSummary(summary, info);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(absl::Span<const std::string_view> input_paths) {
-  SummaryInfo summary_info;
+  std::vector<std::filesystem::path> summary_paths;
   for (const std::string_view input_path : input_paths) {
-    XLS_ASSIGN_OR_RETURN(std::string summary_data, GetFileContents(input_path));
-    fuzzer::SampleSummariesProto summaries;
-    if (!summaries.ParseFromString(summary_data)) {
-      return absl::InvalidArgumentError(
-          "Failed to parse summary protobuf file.");
-    }
-    for (const fuzzer::SampleSummaryProto& summary : summaries.samples()) {
-      AggregateSummary(summary, &summary_info);
+    if (!std::filesystem::is_directory(input_path)) {
+      summary_paths.push_back(input_path);
+      continue;
     }
+    XLS_ASSIGN_OR_RETURN(
+        std::vector<std::filesystem::path> dir_summary_paths,
+        FindFilesMatchingRegex(input_path, R"(.*/summary_[^/]*\.binarypb)"));
+    absl::c_move(dir_summary_paths, std::back_inserter(summary_paths));
+  }
+
+  SummaryInfo summary_info;
+  for (const std::filesystem::path& summary_path : summary_paths) {
+    XLS_ASSIGN_OR_RETURN(std::string summary_data,
+                         GetFileContents(summary_path));
+    XLS_RETURN_IF_ERROR(
+        AggregateSummaries(summary_data, summary_path, &summary_info));
   }
 
   std::cout << "Before optimizations:\n";
@@ -281,7 +341,7 @@ int main(int argc, char** argv) {
 
   if (positional_arguments.empty()) {
     XLS_LOG(QFATAL) << absl::StreamFormat(
-        "Expected invocation: %s [SUMMARY_FILE...]", argv[0]);
+        "Expected invocation: %s [SUMMARY_FILE_OR_DIR...]", argv[0]);
   }
 
   return xls::ExitStatus(xls::RealMain(positional_arguments));
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "absl/random/bit_gen_ref.h"
+#include "absl/random/distributions.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
@@ -44,7 +45,9 @@
 #include "xls/common/subprocess.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/cpp_run_fuzz.h"
+#include "xls/fuzzer/crasher_dedup.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_coverage.h"
 #include "xls/fuzzer/sample_generator.h"
 #include "xls/fuzzer/sample_runner.h"
 #include "xls/fuzzer/sample_summary.pb.h"
@@ -138,16 +141,21 @@ absl::Status WriteIrSummaries(const std::filesystem::path& run_dir,
   return absl::OkStatus();
 }
 
-// Save the sample into a new directory in the crasher directory.
-absl::StatusOr<std::filesystem::path> SaveCrasher(
-    const std::filesystem::path& run_dir, const Sample& smp,
-    const absl::Status& error, const std::filesystem::path& crasher_dir) {
+// Returns 8 hex digits identifying the sample's input text.
+std::string SampleDigest(const Sample& smp) {
   std::array<char, SHA256_DIGEST_LENGTH> digest;
   SHA256(reinterpret_cast<const uint8_t*>(smp.input_text().data()),
          smp.input_text().size(), reinterpret_cast<uint8_t*>(digest.data()));
   // Extract the first 4 bytes of the digest as 8 hex digits.
   static_assert(digest.size() >= 4);
-  std::string hex_digest = absl::BytesToHexString({digest.data(), 4});
+  return absl::BytesToHexString({digest.data(), 4});
+}
+
+// Save the sample into a new directory in the crasher directory.
+absl::StatusOr<std::filesystem::path> SaveCrasher(
+    const std::filesystem::path& run_dir, const Sample& smp,
+    const absl::Status& error, const std::filesystem::path& crasher_dir) {
+  std::string hex_digest = SampleDigest(smp);
 
   std::filesystem::path sample_crasher_dir = crasher_dir / hex_digest;
   XLS_LOG(INFO) << "Saving crasher to " << sample_crasher_dir;
@@ -168,11 +176,35 @@ absl::StatusOr<std::filesystem::path> SaveCrasher(
   return sample_crasher_dir;
 }
 
+// Returns a mutant of a sample from `coverage_corpus` with probability
+// kMutationProbability (if the corpus is given and not empty, and a mutant
+// typechecks); otherwise generates a new sample.
+absl::StatusOr<Sample> GenerateOrMutateSample(
+    absl::BitGenRef bit_gen,
+    const dslx::AstGeneratorOptions& ast_generator_options,
+    const SampleOptions& sample_options, CoverageCorpus* coverage_corpus) {
+  constexpr double kMutationProbability = 0.5;
+  if (coverage_corpus != nullptr &&
+      absl::Bernoulli(bit_gen, kMutationProbability)) {
+    if (std::optional<Sample> parent = coverage_corpus->ChooseSample(bit_gen);
+        parent.has_value()) {
+      absl::StatusOr<Sample> mutant = MutateSample(*parent, bit_gen);
+      if (mutant.ok()) {
+        XLS_VLOG(1) << "Running a mutant of a corpus sample";
+        return mutant;
+      }
+      XLS_VLOG(1) << "Failed to mutate corpus sample: " << mutant.status();
+    }
+  }
+  return GenerateSample(ast_generator_options, sample_options, bit_gen);
+}
+
 }  // namespace
 
 absl::Status RunSample(const Sample& smp, const std::filesystem::path& run_dir,
                        const std::optional<std::filesystem::path>& summary_file,
-                       std::optional<absl::Duration> generate_sample_elapsed) {
+                       std::optional<absl::Duration> generate_sample_elapsed,
+                       const SampleRunner::Commands* in_process_commands) {
   XLS_ASSIGN_OR_RETURN(std::filesystem::path sample_runner_main_path,
                        GetXlsRunfilePath(kSampleRunnerMainPath));
 
@@ -222,12 +254,26 @@ absl::Status RunSample(const Sample& smp, const std::filesystem::path& run_dir,
 
   XLS_VLOG(1) << "Starting to run sample";
   XLS_VLOG(2) << smp.input_text();
-  SampleRunner runner(run_dir);
-  XLS_RETURN_IF_ERROR(runner.RunFromFiles(sample_file_name, options_file_name,
-                                          args_file_name,
-                                          ir_channel_names_file_name));
-
-  fuzzer::SampleTimingProto timing = runner.timing();
+  fuzzer::SampleTimingProto timing;
+  absl::Status in_process_status = absl::OkStatus();
+  if (in_process_commands != nullptr) {
+    SampleRunner runner(run_dir, *in_process_commands);
+    in_process_status = runner.RunFromFiles(sample_file_name, options_file_name,
+                                            args_file_name,
+                                            ir_channel_names_file_name);
+    timing = runner.timing();
+    if (!in_process_status.ok()) {
+      XLS_LOG(INFO) << "Sample failed in-process (" << in_process_status
+                    << "); re-running in subprocesses";
+    }
+  }
+  if (in_process_commands == nullptr || !in_process_status.ok()) {
+    SampleRunner runner(run_dir);
+    XLS_RETURN_IF_ERROR(runner.RunFromFiles(sample_file_name, options_file_name,
+                                            args_file_name,
+                                            ir_channel_names_file_name));
+    timing = runner.timing();
+  }
 
   absl::Duration total_elapsed = stopwatch.GetElapsedTime();
   if (generate_sample_elapsed.has_value()) {
@@ -254,43 +300,75 @@ absl::StatusOr<Sample> GenerateSampleAndRun(
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_file,
-    bool force_failure) {
+    bool force_failure, const SampleRunner::Commands* in_process_commands,
+    CoverageCorpus* coverage_corpus, bool deduplicate_crashers) {
   Stopwatch stopwatch;
-  XLS_ASSIGN_OR_RETURN(Sample smp, GenerateSample(ast_generator_options,
-                                                  sample_options, bit_gen));
+  XLS_ASSIGN_OR_RETURN(
+      Sample smp, GenerateOrMutateSample(bit_gen, ast_generator_options,
+                                         sample_options, coverage_corpus));
   absl::Duration generate_sample_elapsed = stopwatch.GetElapsedTime();
 
   absl::Status status =
-      RunSample(smp, run_dir, summary_file, generate_sample_elapsed);
+      RunSample(smp, run_dir, summary_file, generate_sample_elapsed,
+                in_process_commands);
   if (force_failure) {
     status = absl::InternalError("Forced sample failure.");
   }
   if (status.ok()) {
+    if (coverage_corpus != nullptr) {
+      absl::StatusOr<CoverageFeatures> features =
+          CollectSampleCoverage(run_dir);
+      if (features.ok()) {
+        int64_t new_features = coverage_corpus->AddSample(smp, *features);
+        XLS_VLOG_IF(1, new_features > 0)
+            << "Sample reached " << new_features << " new coverage features";
+      } else {
+        XLS_LOG(ERROR) << "Failed to collect sample coverage: "
+                       << features.status();
+      }
+    }
     return smp;
   }
 
   XLS_LOG(ERROR) << "Sample failed: " << status;
-  if (crasher_dir.has_value()) {
-    XLS_ASSIGN_OR_RETURN(std::filesystem::path sample_crasher_dir,
-                         SaveCrasher(run_dir, smp, status, *crasher_dir));
-    if (!absl::IsDeadlineExceeded(status)) {
-      XLS_LOG(INFO) << "Attempting to minimize IR...";
-      std::optional<absl::Duration> timeout =
-          sample_options.timeout_seconds().has_value()
-              ? std::optional<absl::Duration>(
-                    absl::Seconds(*sample_options.timeout_seconds()))
-              : std::nullopt;
-      XLS_ASSIGN_OR_RETURN(
-          std::optional<std::filesystem::path> minimized_path,
-          MinimizeIr(smp, run_dir, /*inject_jit_result=*/std::nullopt,
-                     timeout));
-      if (minimized_path.has_value()) {
-        XLS_LOG(INFO) << "...minimization successful; output at "
-                      << *minimized_path;
-        std::filesystem::copy(*minimized_path, sample_crasher_dir);
-      } else {
-        XLS_LOG(INFO) << "...minimization failed.";
-      }
+  if (!crasher_dir.has_value()) {
+    return status;
+  }
+  std::optional<FailureSignature> signature;
+  if (deduplicate_crashers) {
+    signature = ComputeFailureSignature(status, run_dir);
+    XLS_ASSIGN_OR_RETURN(
+        bool first_failure,
+        ClaimFailureSignature(*crasher_dir, *signature, SampleDigest(smp)));
+    if (!first_failure) {
+      XLS_LOG(INFO) << "Not saving crasher; its failure signature "
+                    << signature->Digest() << " was already seen:\n"
+                    << signature->ToString();
+      return status;
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(std::filesystem::path sample_crasher_dir,
+                       SaveCrasher(run_dir, smp, status, *crasher_dir));
+  if (signature.has_value()) {
+    XLS_RETURN_IF_ERROR(SetFileContents(sample_crasher_dir / "signature.txt",
+                                        signature->ToString()));
+  }
+  if (!absl::IsDeadlineExceeded(status)) {
+    XLS_LOG(INFO) << "Attempting to minimize IR...";
+    std::optional<absl::Duration> timeout =
+        sample_options.timeout_seconds().has_value()
+            ? std::optional<absl::Duration>(
+                  absl::Seconds(*sample_options.timeout_seconds()))
+            : std::nullopt;
+    XLS_ASSIGN_OR_RETURN(
+        std::optional<std::filesystem::path> minimized_path,
+        MinimizeIr(smp, run_dir, /*inject_jit_result=*/std::nullopt, timeout));
+    if (minimized_path.has_value()) {
+      XLS_LOG(INFO) << "...minimization successful; output at "
+                    << *minimized_path;
+      std::filesystem::copy(*minimized_path, sample_crasher_dir);
+    } else {
+      XLS_LOG(INFO) << "...minimization failed.";
     }
   }
   return status;
@@ -24,6 +24,8 @@
 #include "absl/time/time.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_coverage.h"
+#include "xls/fuzzer/sample_runner.h"
 
 namespace xls {
 
@@ -31,19 +33,38 @@ namespace xls {
 // summary will be appended to this file; if `generate_sample_elapsed` is also
 // given, it will be recorded in the timings in the sample summary.
 //
+// If `in_process_commands` is given, the sample is first run with those
+// commands (see InProcessCommands); if that run fails, the sample is run again
+// with every stage in a subprocess, so that the failure is reproduced in
+// isolation and the tools' outputs are recorded in `run_dir`.
+//
 // `run_dir` must be an empty directory.
 absl::Status RunSample(
     const Sample& smp, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt);
+    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt,
+    const SampleRunner::Commands* in_process_commands = nullptr);
 
+// Generates a sample and runs it in `run_dir`. Failing samples are saved to
+// `crasher_dir`, if given, along with a minimized version of their IR.
+//
+// If `coverage_corpus` is given, the sample is instead, some of the time, a
+// mutant of a sample from the corpus (see MutateSample); passing samples which
+// reach new coverage are added to the corpus.
+//
+// If `deduplicate_crashers` is true, a failing sample is only saved (and
+// minimized) if no earlier sample saved to `crasher_dir`, by this or any other
+// process, failed with the same FailureSignature.
 absl::StatusOr<Sample> GenerateSampleAndRun(
     absl::BitGenRef bit_gen,
     const dslx::AstGeneratorOptions& ast_generator_options,
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false,
+    const SampleRunner::Commands* in_process_commands = nullptr,
+    CoverageCorpus* coverage_corpus = nullptr,
+    bool deduplicate_crashers = false);
 
 }  // namespace xls
 
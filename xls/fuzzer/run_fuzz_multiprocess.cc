@@ -21,6 +21,7 @@
 #include <random>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -36,8 +37,11 @@
 #include "xls/common/stopwatch.h"
 #include "xls/common/thread.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/in_process_commands.h"
 #include "xls/fuzzer/run_fuzz.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_coverage.h"
+#include "xls/fuzzer/sample_runner.h"
 
 namespace xls {
 namespace {
@@ -54,11 +58,22 @@ absl::Status GenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count,
-    const std::optional<absl::Duration>& duration, bool force_failure) {
+    const std::optional<absl::Duration>& duration, bool force_failure,
+    bool in_process, CoverageCorpus* coverage_corpus,
+    bool deduplicate_crashers) {
   int64_t crashers = 0;
   XLS_LOG(INFO) << "--- Started worker " << worker_number;
   Stopwatch stopwatch;
 
+  // Each worker keeps its own in-process tools, so their state stays warm
+  // across the worker's samples.
+  std::optional<InProcessCommands> in_process_tools;
+  std::optional<SampleRunner::Commands> in_process_commands;
+  if (in_process) {
+    in_process_tools.emplace();
+    in_process_commands = in_process_tools->commands();
+  }
+
   std::optional<std::filesystem::path> summary_file;
   if (summary_dir.has_value()) {
     summary_file =
@@ -95,7 +110,11 @@ absl::Status GenerateAndRunSamples(
 
     absl::Status sample_status =
         GenerateSampleAndRun(rng, ast_generator_options, sample_options,
-                             run_dir, crasher_dir, summary_file, force_failure)
+                             run_dir, crasher_dir, summary_file, force_failure,
+                             in_process_commands.has_value()
+                                 ? &*in_process_commands
+                                 : nullptr,
+                             coverage_corpus, deduplicate_crashers)
             .status();
     if (!sample_status.ok()) {
       XLS_LOG(INFO)
@@ -110,7 +129,7 @@ absl::Status GenerateAndRunSamples(
     absl::Duration elapsed = stopwatch.GetElapsedTime();
     if (sample > 0 && sample % 16 == 0) {
       std::vector<std::string> metrics;
-      metrics.reserve(3);
+      metrics.reserve(4);
       if (sample_count.has_value()) {
         metrics.push_back(
             absl::StrFormat("%d/%d samples", sample, *sample_count));
@@ -128,6 +147,11 @@ absl::Status GenerateAndRunSamples(
         metrics.push_back(
             absl::StrFormat("running for %s", absl::FormatDuration(elapsed)));
       }
+      if (coverage_corpus != nullptr) {
+        metrics.push_back(absl::StrFormat(
+            "corpus of %d samples covering %d features",
+            coverage_corpus->size(), coverage_corpus->feature_count()));
+      }
       XLS_LOG(INFO) << absl::StreamFormat("--- Worker #%d: %s", worker_number,
                                           absl::StrJoin(metrics, ", "));
     }
@@ -156,6 +180,28 @@ absl::Status GenerateAndRunSamples(
   return absl::OkStatus();
 }
 
+// Claims the lowest worker number not yet claimed by any process fuzzing in
+// `shard_dir`. A number is claimed by creating its directory, which succeeds
+// for exactly one claimant.
+absl::StatusOr<int64_t> ClaimWorkerNumber(
+    const std::filesystem::path& shard_dir) {
+  std::filesystem::path workers_dir = shard_dir / "workers";
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(workers_dir));
+  for (int64_t worker_number = 0;; ++worker_number) {
+    std::filesystem::path worker_dir =
+        workers_dir / absl::StrCat(worker_number);
+    std::error_code ec;
+    if (std::filesystem::create_directory(worker_dir, ec)) {
+      return worker_number;
+    }
+    if (ec) {
+      return absl::InternalError(absl::StrCat("Failed to create directory ",
+                                              worker_dir.string(), ": ",
+                                              ec.message()));
+    }
+  }
+}
+
 }  // namespace
 
 absl::Status ParallelGenerateAndRunSamples(
@@ -166,7 +212,26 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count, std::optional<absl::Duration> duration,
-    bool force_failure) {
+    bool force_failure, bool in_process, bool coverage_feedback,
+    const std::optional<std::filesystem::path>& shard_dir,
+    bool deduplicate_crashers) {
+  std::optional<CoverageCorpus> coverage_corpus;
+  if (coverage_feedback) {
+    coverage_corpus.emplace();
+  }
+  std::vector<int64_t> worker_numbers(worker_count);
+  for (int64_t i = 0; i < worker_count; ++i) {
+    if (shard_dir.has_value()) {
+      XLS_ASSIGN_OR_RETURN(worker_numbers[i], ClaimWorkerNumber(*shard_dir));
+    } else {
+      worker_numbers[i] = i;
+    }
+  }
+  if (shard_dir.has_value()) {
+    XLS_LOG(INFO) << "-- Claimed worker numbers "
+                  << absl::StrJoin(worker_numbers, ", ") << " in "
+                  << *shard_dir;
+  }
   std::vector<std::unique_ptr<Thread>> workers;
   workers.resize(worker_count);
   std::vector<absl::Status> worker_status;
@@ -177,12 +242,15 @@ absl::Status ParallelGenerateAndRunSamples(
         sample_count.has_value()
             ? std::make_optional((*sample_count + i) / worker_count)
             : std::nullopt;
-    workers[i] = std::make_unique<Thread>([&, i, worker_sample_count,
+    workers[i] = std::make_unique<Thread>([&, worker_sample_count,
+                                           worker_number = worker_numbers[i],
                                            status = &worker_status[i]] {
-      *status =
-          GenerateAndRunSamples(i, ast_generator_options, sample_options, seed,
-                                top_run_dir, crasher_dir, summary_dir,
-                                worker_sample_count, duration, force_failure);
+      *status = GenerateAndRunSamples(
+          worker_number, ast_generator_options, sample_options, seed,
+          top_run_dir, crasher_dir, summary_dir, worker_sample_count, duration,
+          force_failure, in_process,
+          coverage_corpus.has_value() ? &*coverage_corpus : nullptr,
+          deduplicate_crashers);
     });
   }
   for (int64_t i = 0; i < workers.size(); ++i) {
@@ -37,6 +37,24 @@ namespace xls {
 //
 // If `force_failure` is true, every sample run will be considered a failure.
 // This is useful for testing failure paths.
+//
+// If `in_process` is true, each worker runs the DSLX conversion, optimization,
+// and IR evaluation stages of its samples in-process (see InProcessCommands),
+// falling back to subprocesses only to re-run samples which fail.
+//
+// If `coverage_feedback` is true, the workers share a corpus of samples which
+// reached new coverage, and spend part of their time running mutants of them
+// (see GenerateSampleAndRun).
+//
+// If `shard_dir` is given, this is one of several processes (shards) fuzzing
+// together; each worker claims a worker number which is unique across all of
+// them in `shard_dir`, and uses it to choose its seed, run directories and
+// summary file, so the shards can share `seed`, `top_run_dir`, `crasher_dir`
+// and `summary_dir`. Worker numbers are claimed by creating directories, so no
+// locking is needed.
+//
+// If `deduplicate_crashers` is true, failing samples whose FailureSignature
+// matches that of a crasher already in `crasher_dir` are not saved.
 absl::Status ParallelGenerateAndRunSamples(
     int64_t worker_count,
     const dslx::AstGeneratorOptions& ast_generator_options,
@@ -47,7 +65,10 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& summary_dir = std::nullopt,
     std::optional<int64_t> sample_count = std::nullopt,
     std::optional<absl::Duration> duration = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false, bool in_process = false,
+    bool coverage_feedback = false,
+    const std::optional<std::filesystem::path>& shard_dir = std::nullopt,
+    bool deduplicate_crashers = false);
 
 }  // namespace xls
 
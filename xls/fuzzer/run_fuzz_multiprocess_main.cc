@@ -41,11 +41,22 @@ ABSL_FLAG(int64_t, calls_per_sample, 128, "Arguments to generate per sample.");
 ABSL_FLAG(std::optional<std::string>, crash_path, std::nullopt,
           "Path at which to place crash data.");
 ABSL_FLAG(bool, codegen, false, "Run code generation.");
+ABSL_FLAG(bool, coverage_feedback, false,
+          "Keep a corpus of samples which reached new IR and codegen coverage, "
+          "and run mutants of them alongside newly generated samples.");
+ABSL_FLAG(bool, deduplicate_crashers, false,
+          "Only save a failing sample if no crasher already in --crash_path "
+          "failed the same way (same failing tool, normalized error message, "
+          "and innermost stack frames).");
 ABSL_FLAG(bool, emit_loops, true, "Emit loops in generator.");
 ABSL_FLAG(
     bool, force_failure, false,
     "Forces the samples to fail. Can be used to test failure code paths.");
 ABSL_FLAG(bool, generate_proc, false, "Generate a proc sample.");
+ABSL_FLAG(bool, in_process, false,
+          "Run DSLX conversion, IR optimization, and IR evaluation inside the "
+          "worker processes rather than as subprocesses. Failing samples are "
+          "re-run with subprocesses.");
 ABSL_FLAG(int64_t, max_width_aggregate_types, 1024,
           "The maximum width of aggregate types (tuples and arrays) in the "
           "generated samples.");
@@ -62,6 +73,11 @@ ABSL_FLAG(std::optional<std::string>, save_temps_path, std::nullopt,
 ABSL_FLAG(std::optional<int64_t>, seed, std::nullopt,
           "Seed value for generation. By default, a nondetermistic seed is "
           "used; if a seed is provided, it is used for determinism");
+ABSL_FLAG(std::optional<std::string>, shard_dir, std::nullopt,
+          "Work directory shared by several run_fuzz_multiprocess processes "
+          "fuzzing together. Each worker claims a number there which is unique "
+          "across the processes, so they can share --seed, --crash_path, "
+          "--save_temps_path and --summary_path.");
 ABSL_FLAG(bool, simulate, false, "Run Verilog simulation.");
 ABSL_FLAG(std::optional<std::string>, simulator, std::nullopt,
           "Verilog simulator to use.");
@@ -91,15 +107,19 @@ struct Options {
   int64_t calls_per_sample;
   std::optional<std::filesystem::path> crash_path;
   bool codegen;
+  bool coverage_feedback;
+  bool deduplicate_crashers;
   bool emit_loops;
   bool force_failure;
   bool generate_proc;
+  bool in_process;
   int64_t max_width_aggregate_types;
   int64_t max_width_bits_types;
   int64_t proc_ticks;
   std::optional<int64_t> sample_count;
   std::optional<std::filesystem::path> save_temps_path;
   std::optional<int64_t> seed;
+  std::optional<std::filesystem::path> shard_dir;
   bool simulate;
   std::optional<std::string> simulator;
   std::optional<std::filesystem::path> summary_path;
@@ -172,7 +192,9 @@ absl::Status RealMain(const Options& options) {
       worker_count, ast_generator_options, sample_options, options.seed,
       /*top_run_dir=*/options.save_temps_path,
       /*crasher_dir=*/options.crash_path, /*summary_dir=*/options.summary_path,
-      options.sample_count, options.duration, options.force_failure);
+      options.sample_count, options.duration, options.force_failure,
+      options.in_process, options.coverage_feedback, options.shard_dir,
+      options.deduplicate_crashers);
 }
 
 }  // namespace
@@ -189,6 +211,11 @@ int main(int argc, char** argv) {
     XLS_LOG(QFATAL) << "Unexpected positional arguments: "
                     << absl::StrJoin(positional_arguments, ", ");
   }
+  if (absl::GetFlag(FLAGS_deduplicate_crashers) &&
+      !absl::GetFlag(FLAGS_crash_path).has_value()) {
+    XLS_LOG(QFATAL)
+        << "Must specify --crash_path when --deduplicate_crashers is given.";
+  }
   if (absl::GetFlag(FLAGS_simulate) && !absl::GetFlag(FLAGS_codegen)) {
     XLS_LOG(QFATAL) << "Must specify --codegen when --simulate is given.";
   }
@@ -198,9 +225,12 @@ int main(int argc, char** argv) {
       .calls_per_sample = absl::GetFlag(FLAGS_calls_per_sample),
       .crash_path = absl::GetFlag(FLAGS_crash_path),
       .codegen = absl::GetFlag(FLAGS_codegen),
+      .coverage_feedback = absl::GetFlag(FLAGS_coverage_feedback),
+      .deduplicate_crashers = absl::GetFlag(FLAGS_deduplicate_crashers),
       .emit_loops = absl::GetFlag(FLAGS_emit_loops),
       .force_failure = absl::GetFlag(FLAGS_force_failure),
       .generate_proc = absl::GetFlag(FLAGS_generate_proc),
+      .in_process = absl::GetFlag(FLAGS_in_process),
       .max_width_aggregate_types =
           absl::GetFlag(FLAGS_max_width_aggregate_types),
       .max_width_bits_types = absl::GetFlag(FLAGS_max_width_bits_types),
@@ -208,6 +238,7 @@ int main(int argc, char** argv) {
       .sample_count = absl::GetFlag(FLAGS_sample_count),
       .save_temps_path = absl::GetFlag(FLAGS_save_temps_path),
       .seed = absl::GetFlag(FLAGS_seed),
+      .shard_dir = absl::GetFlag(FLAGS_shard_dir),
       .simulate = absl::GetFlag(FLAGS_simulate),
       .simulator = absl::GetFlag(FLAGS_simulator),
       .summary_path = absl::GetFlag(FLAGS_summary_path),
@@ -100,6 +100,48 @@ class RunFuzzMultiprocessTest(test_base.TestCase):
     # Crasher directory should have 5 samples in it plus the `test` file.
     self.assertEqual(len(os.listdir(crasher_path)), 6)
 
+  def test_deduplicate_crashers(self):
+    crasher_path = self.create_tempdir().full_path
+
+    subprocess.check_call([
+        RUN_FUZZ_MULTIPROCESS_PATH, '--seed=42', '--crash_path=' + crasher_path,
+        '--sample_count=5', '--calls_per_sample=3', '--worker_count=3',
+        '--force_failure', '--deduplicate_crashers'
+    ])
+
+    # Every sample fails the same way, so only the first is saved; the crasher
+    # directory also holds the `test` file and the signature records.
+    self.assertLen(os.listdir(crasher_path), 3)
+    signatures_path = os.path.join(crasher_path, 'signatures')
+    self.assertLen(os.listdir(signatures_path), 1)
+    signature_path = os.path.join(signatures_path,
+                                  os.listdir(signatures_path)[0])
+    with open(os.path.join(signature_path, 'duplicates.txt')) as f:
+      self.assertLen(f.read().splitlines(), 4)
+
+  def test_shards(self):
+    shard_path = self.create_tempdir().full_path
+    samples_path = self.create_tempdir().full_path
+
+    shards = [
+        subprocess.Popen([
+            RUN_FUZZ_MULTIPROCESS_PATH, '--seed=42',
+            '--shard_dir=' + shard_path, '--save_temps_path=' + samples_path,
+            '--sample_count=2', '--calls_per_sample=3', '--worker_count=2'
+        ]) for _ in range(2)
+    ]
+    for shard in shards:
+      self.assertEqual(shard.wait(), 0)
+
+    # The shards' workers each claimed a distinct worker number.
+    self.assertSequenceEqual(
+        sorted(os.listdir(os.path.join(shard_path, 'workers'))),
+        ('0', '1', '2', '3'))
+    self.assertSequenceEqual(
+        sorted(os.listdir(samples_path)),
+        ('worker0-sample0', 'worker1-sample0', 'worker2-sample0',
+         'worker3-sample0'))
+
   def test_duration(self):
     samples_path = self.create_tempdir().full_path
     crasher_path = self.create_tempdir().full_path
@@ -0,0 +1,172 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_coverage.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/random/distributions.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+namespace {
+
+// Describes a node's op, type kind, and flat bit count rounded up to a power
+// of two, e.g. "add:bits:w8". Exact widths would make nearly every sample
+// "new".
+std::string NodeFeature(const Node* node) {
+  int64_t width = node->GetType()->GetFlatBitCount();
+  int64_t bucket = width == 0 ? 0 : int64_t{1} << CeilOfLog2(width);
+  return absl::StrCat(OpToString(node->op()), ":",
+                      TypeKindToString(node->GetType()->kind()), ":w", bucket);
+}
+
+absl::flat_hash_map<Op, int64_t> OpCounts(const Package& package) {
+  absl::flat_hash_map<Op, int64_t> counts;
+  for (FunctionBase* fb : package.GetFunctionBases()) {
+    for (Node* node : fb->nodes()) {
+      ++counts[node->op()];
+    }
+  }
+  return counts;
+}
+
+absl::StatusOr<std::optional<std::unique_ptr<Package>>> ParseIfPresent(
+    const std::filesystem::path& path) {
+  if (!FileExists(path).ok()) {
+    return std::nullopt;
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text, path.string()));
+  return package;
+}
+
+}  // namespace
+
+void AddIrCoverage(std::string_view stage, const Package& package,
+                   CoverageFeatures& features) {
+  for (FunctionBase* fb : package.GetFunctionBases()) {
+    for (Node* node : fb->nodes()) {
+      features.insert(absl::StrCat(stage, ":", NodeFeature(node)));
+      for (Node* operand : node->operands()) {
+        features.insert(absl::StrCat(stage, ":", OpToString(operand->op()),
+                                     "->", OpToString(node->op())));
+      }
+    }
+  }
+}
+
+void AddOptimizationCoverage(const Package& unoptimized,
+                             const Package& optimized,
+                             CoverageFeatures& features) {
+  absl::flat_hash_map<Op, int64_t> before = OpCounts(unoptimized);
+  absl::flat_hash_map<Op, int64_t> after = OpCounts(optimized);
+  for (const auto& [op, count] : before) {
+    auto it = after.find(op);
+    int64_t count_after = it == after.end() ? 0 : it->second;
+    if (count_after < count) {
+      features.insert(absl::StrCat("opt-removed:", OpToString(op)));
+    }
+  }
+  for (const auto& [op, count] : after) {
+    auto it = before.find(op);
+    int64_t count_before = it == before.end() ? 0 : it->second;
+    if (count_before < count) {
+      features.insert(absl::StrCat("opt-added:", OpToString(op)));
+    }
+  }
+}
+
+absl::StatusOr<CoverageFeatures> CollectSampleCoverage(
+    const std::filesystem::path& run_dir) {
+  CoverageFeatures features;
+  XLS_ASSIGN_OR_RETURN(std::optional<std::unique_ptr<Package>> unoptimized,
+                       ParseIfPresent(run_dir / "sample.ir"));
+  XLS_ASSIGN_OR_RETURN(std::optional<std::unique_ptr<Package>> optimized,
+                       ParseIfPresent(run_dir / "sample.opt.ir"));
+  XLS_ASSIGN_OR_RETURN(std::optional<std::unique_ptr<Package>> block,
+                       ParseIfPresent(run_dir / "sample.block.ir"));
+  if (unoptimized.has_value()) {
+    AddIrCoverage("ir", **unoptimized, features);
+  }
+  if (optimized.has_value()) {
+    AddIrCoverage("opt", **optimized, features);
+  }
+  if (unoptimized.has_value() && optimized.has_value()) {
+    AddOptimizationCoverage(**unoptimized, **optimized, features);
+  }
+  if (block.has_value()) {
+    AddIrCoverage("block", **block, features);
+  }
+  return features;
+}
+
+int64_t CoverageCorpus::AddSample(const Sample& sample,
+                                  const CoverageFeatures& features) {
+  absl::MutexLock lock(&mutex_);
+  int64_t new_features = 0;
+  for (const std::string& feature : features) {
+    if (covered_.insert(feature).second) {
+      ++new_features;
+    }
+  }
+  if (new_features > 0) {
+    samples_.push_back(sample);
+    if (samples_.size() > max_size_) {
+      samples_.pop_front();
+    }
+  }
+  return new_features;
+}
+
+std::optional<Sample> CoverageCorpus::ChooseSample(
+    absl::BitGenRef bit_gen) const {
+  absl::MutexLock lock(&mutex_);
+  if (samples_.empty()) {
+    return std::nullopt;
+  }
+  return samples_[absl::Uniform<size_t>(bit_gen, 0, samples_.size())];
+}
+
+int64_t CoverageCorpus::size() const {
+  absl::MutexLock lock(&mutex_);
+  return samples_.size();
+}
+
+int64_t CoverageCorpus::feature_count() const {
+  absl::MutexLock lock(&mutex_);
+  return covered_.size();
+}
+
+}  // namespace xls
@@ -0,0 +1,88 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_SAMPLE_COVERAGE_H_
+#define XLS_FUZZER_SAMPLE_COVERAGE_H_
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// The coverage a fuzz sample achieved, as a set of opaque feature strings. The
+// features describe which ops (with their types and bucketed widths) and
+// which producer/consumer op pairs each stage of the compiler saw, and which
+// ops the optimizer removed or introduced; the latter stands in for which
+// optimization passes changed the IR.
+using CoverageFeatures = absl::flat_hash_set<std::string>;
+
+// Adds the features of `package` to `features`, each prefixed by `stage`.
+void AddIrCoverage(std::string_view stage, const Package& package,
+                   CoverageFeatures& features);
+
+// Adds features describing how optimization changed `unoptimized` into
+// `optimized` to `features`.
+void AddOptimizationCoverage(const Package& unoptimized,
+                             const Package& optimized,
+                             CoverageFeatures& features);
+
+// Returns the coverage of the sample SampleRunner ran in `run_dir`, using the
+// unoptimized, optimized, and block IR it left there. Stages which did not run
+// contribute no features.
+absl::StatusOr<CoverageFeatures> CollectSampleCoverage(
+    const std::filesystem::path& run_dir);
+
+// A corpus of samples which each reached coverage no earlier sample did,
+// shared between fuzzing threads. Once `max_size` samples are held, the oldest
+// is dropped for each new one.
+//
+// This class is thread-safe.
+class CoverageCorpus {
+ public:
+  explicit CoverageCorpus(int64_t max_size = 1024) : max_size_(max_size) {}
+
+  // Records `features` as covered. If any of them was not covered before,
+  // `sample` is added to the corpus. Returns the number of new features.
+  int64_t AddSample(const Sample& sample, const CoverageFeatures& features);
+
+  // Returns a sample chosen uniformly at random from the corpus, or
+  // std::nullopt if the corpus is empty.
+  std::optional<Sample> ChooseSample(absl::BitGenRef bit_gen) const;
+
+  int64_t size() const;
+  int64_t feature_count() const;
+
+ private:
+  const int64_t max_size_;
+
+  mutable absl::Mutex mutex_;
+  CoverageFeatures covered_ ABSL_GUARDED_BY(mutex_);
+  std::deque<Sample> samples_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_SAMPLE_COVERAGE_H_
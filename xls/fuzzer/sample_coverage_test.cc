@@ -0,0 +1,116 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/sample_coverage.h"
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+using ::testing::Contains;
+using ::testing::IsEmpty;
+using ::testing::Not;
+using ::testing::UnorderedElementsAre;
+
+constexpr char kUnoptimizedIr[] = R"(package sample
+
+top fn main(x: bits[8], y: bits[8]) -> bits[8] {
+  zero: bits[8] = literal(value=0)
+  sum: bits[8] = add(x, zero)
+  ret result: bits[8] = add(sum, y)
+}
+)";
+
+constexpr char kOptimizedIr[] = R"(package sample
+
+top fn main(x: bits[8], y: bits[8]) -> bits[8] {
+  ret result: bits[8] = add(x, y)
+}
+)";
+
+TEST(SampleCoverageTest, IrCoverage) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kOptimizedIr));
+  CoverageFeatures features;
+  AddIrCoverage("opt", *package, features);
+  EXPECT_THAT(features, UnorderedElementsAre("opt:param:bits:w8",
+                                             "opt:add:bits:w8",
+                                             "opt:param->add"));
+}
+
+TEST(SampleCoverageTest, OptimizationCoverage) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> unoptimized,
+                           Parser::ParsePackage(kUnoptimizedIr));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> optimized,
+                           Parser::ParsePackage(kOptimizedIr));
+  CoverageFeatures features;
+  AddOptimizationCoverage(*unoptimized, *optimized, features);
+  EXPECT_THAT(features,
+              UnorderedElementsAre("opt-removed:literal", "opt-removed:add"));
+}
+
+TEST(SampleCoverageTest, CollectFromRunDirectory) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(CoverageFeatures features,
+                           CollectSampleCoverage(temp_dir.path()));
+  EXPECT_THAT(features, IsEmpty());
+
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "sample.ir", kUnoptimizedIr));
+  XLS_ASSERT_OK(
+      SetFileContents(temp_dir.path() / "sample.opt.ir", kOptimizedIr));
+  XLS_ASSERT_OK_AND_ASSIGN(features, CollectSampleCoverage(temp_dir.path()));
+  EXPECT_THAT(features, Contains("ir:literal:bits:w8"));
+  EXPECT_THAT(features, Contains("opt:param->add"));
+  EXPECT_THAT(features, Contains("opt-removed:literal"));
+  EXPECT_THAT(features, Not(Contains("opt:literal:bits:w8")));
+}
+
+TEST(SampleCoverageTest, CorpusKeepsSamplesWithNewCoverage) {
+  std::mt19937_64 rng;
+  CoverageCorpus corpus(/*max_size=*/2);
+  EXPECT_EQ(corpus.ChooseSample(rng), std::nullopt);
+
+  Sample a("fn main() -> u8 { u8:1 }", SampleOptions(), {});
+  Sample b("fn main() -> u8 { u8:2 }", SampleOptions(), {});
+  Sample c("fn main() -> u8 { u8:3 }", SampleOptions(), {});
+  EXPECT_EQ(corpus.AddSample(a, {"x", "y"}), 2);
+  EXPECT_EQ(corpus.AddSample(b, {"x"}), 0);
+  EXPECT_EQ(corpus.size(), 1);
+  EXPECT_EQ(corpus.ChooseSample(rng), a);
+
+  EXPECT_EQ(corpus.AddSample(b, {"x", "z"}), 1);
+  EXPECT_EQ(corpus.AddSample(c, {"w"}), 1);
+  EXPECT_EQ(corpus.size(), 2);
+  EXPECT_EQ(corpus.feature_count(), 4);
+  for (int64_t i = 0; i < 16; ++i) {
+    // The oldest sample was dropped to make room.
+    EXPECT_NE(corpus.ChooseSample(rng), a);
+  }
+}
+
+}  // namespace
+}  // namespace xls
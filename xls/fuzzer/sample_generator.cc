@@ -31,6 +31,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -48,6 +49,7 @@
 #include "xls/dslx/type_system/unwrap_meta_type.h"
 #include "xls/dslx/warning_kind.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/dslx_mutator.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample.pb.h"
 #include "xls/fuzzer/value_generator.h"
@@ -334,10 +336,46 @@ static absl::StatusOr<Sample> GenerateProcSample(
                 std::move(ir_channel_names));
 }
 
+// Parses and typechecks `dslx_text` and returns a sample of it with freshly
+// generated arguments for its top entity, which must be a proc or a function
+// named "main". The sample type of `sample_options` is set to match the top.
+static absl::StatusOr<Sample> GenerateSampleForDslx(
+    const std::string& dslx_text, SampleOptions sample_options,
+    absl::BitGenRef bit_gen) {
+  constexpr std::string_view top_name = "main";
+  ImportData import_data(
+      dslx::CreateImportData(/*stdlib_path=*/"",
+                             /*additional_search_paths=*/{},
+                             /*enabled_warnings=*/dslx::kAllWarningsSet));
+  XLS_ASSIGN_OR_RETURN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(dslx_text, "sample.x", "sample", &import_data));
+  std::optional<ModuleMember*> module_member =
+      tm.module->FindMemberWithName(top_name);
+  if (!module_member.has_value()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Sample has no member named ", top_name));
+  }
+  ModuleMember* member = module_member.value();
+
+  if (std::holds_alternative<dslx::Proc*>(*member)) {
+    sample_options.set_sample_type(fuzzer::SAMPLE_TYPE_PROC);
+    return GenerateProcSample(std::get<dslx::Proc*>(*member), tm,
+                              sample_options, bit_gen, dslx_text);
+  }
+  if (std::holds_alternative<dslx::Function*>(*member)) {
+    sample_options.set_sample_type(fuzzer::SAMPLE_TYPE_FUNCTION);
+    return GenerateFunctionSample(std::get<dslx::Function*>(*member), tm,
+                                  sample_options, bit_gen, dslx_text);
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Sample member ", top_name,
+                   " is neither a function nor a proc"));
+}
+
 absl::StatusOr<Sample> GenerateSample(
     const AstGeneratorOptions& generator_options,
     const SampleOptions& sample_options, absl::BitGenRef bit_gen) {
-  constexpr std::string_view top_name = "main";
   if (generator_options.generate_proc) {
     XLS_CHECK_EQ(sample_options.calls_per_sample(), 0)
         << "calls per sample must be zero when generating a proc sample.";
@@ -380,30 +418,37 @@ absl::StatusOr<Sample> GenerateSample(
                             min_stages, has_nb_recv, bit_gen));
   }
 
-  // Parse and type check the DSLX input to retrieve the top entity. The top
-  // member must be a proc or a function.
-  ImportData import_data(
-      dslx::CreateImportData(/*stdlib_path=*/"",
-                             /*additional_search_paths=*/{},
-                             /*enabled_warnings=*/dslx::kAllWarningsSet));
-  XLS_ASSIGN_OR_RETURN(
-      TypecheckedModule tm,
-      ParseAndTypecheck(dslx_text, "sample.x", "sample", &import_data));
-  std::optional<ModuleMember*> module_member =
-      tm.module->FindMemberWithName(top_name);
-  XLS_CHECK(module_member.has_value());
-  ModuleMember* member = module_member.value();
+  return GenerateSampleForDslx(dslx_text, sample_options_copy, bit_gen);
+}
 
-  if (generator_options.generate_proc) {
-    XLS_CHECK(std::holds_alternative<dslx::Proc*>(*member));
-    sample_options_copy.set_sample_type(fuzzer::SAMPLE_TYPE_PROC);
-    return GenerateProcSample(std::get<dslx::Proc*>(*member), tm,
-                              sample_options_copy, bit_gen, dslx_text);
+absl::StatusOr<Sample> MutateSample(const Sample& sample,
+                                    absl::BitGenRef bit_gen,
+                                    int64_t max_attempts) {
+  XLS_RET_CHECK(sample.options().input_is_dslx());
+  absl::Status last_error = absl::NotFoundError("No mutation attempted");
+  for (int64_t attempt = 0; attempt < max_attempts; ++attempt) {
+    std::string dslx_text = sample.input_text();
+    int64_t removals =
+        absl::Uniform<int64_t>(absl::IntervalClosed, bit_gen, 1, 3);
+    for (int64_t i = 0; i < removals; ++i) {
+      XLS_ASSIGN_OR_RETURN(dslx_text,
+                           dslx::RemoveDslxToken(dslx_text, bit_gen));
+    }
+    if (dslx_text == sample.input_text()) {
+      continue;
+    }
+    // Most removals break the program; only ones which still typecheck are
+    // worth running.
+    absl::StatusOr<Sample> mutant =
+        GenerateSampleForDslx(dslx_text, sample.options(), bit_gen);
+    if (mutant.ok()) {
+      return mutant;
+    }
+    last_error = mutant.status();
   }
-  XLS_CHECK(std::holds_alternative<dslx::Function*>(*member));
-  sample_options_copy.set_sample_type(fuzzer::SAMPLE_TYPE_FUNCTION);
-  return GenerateFunctionSample(std::get<dslx::Function*>(*member), tm,
-                                sample_options_copy, bit_gen, dslx_text);
+  return absl::NotFoundError(
+      absl::StrFormat("No valid mutation found in %d attempts; last error: %s",
+                      max_attempts, last_error.ToString()));
 }
 
 }  // namespace xls
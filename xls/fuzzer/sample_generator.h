@@ -15,6 +15,8 @@
 #ifndef XLS_FUZZER_SAMPLE_GENERATOR_H_
 #define XLS_FUZZER_SAMPLE_GENERATOR_H_
 
+#include <cstdint>
+
 #include "absl/random/bit_gen_ref.h"
 #include "absl/status/statusor.h"
 #include "xls/fuzzer/ast_generator.h"
@@ -27,6 +29,15 @@ absl::StatusOr<Sample> GenerateSample(
     const dslx::AstGeneratorOptions& generator_options,
     const SampleOptions& sample_options, absl::BitGenRef bit_gen);
 
+// Returns a mutant of `sample`, a DSLX sample: a few tokens are removed from
+// its program, and arguments are generated afresh for the result. The sample's
+// options (including any codegen arguments) are kept. Mutants which fail to
+// typecheck are discarded; returns NotFoundError if none of `max_attempts`
+// mutants typechecks.
+absl::StatusOr<Sample> MutateSample(const Sample& sample,
+                                    absl::BitGenRef bit_gen,
+                                    int64_t max_attempts = 16);
+
 }  // namespace xls
 
 #endif  // XLS_FUZZER_SAMPLE_GENERATOR_H_
@@ -111,5 +111,19 @@ TEST(SampleGeneratorTest, GenerateBasicProcSample) {
   EXPECT_THAT(sample.input_text(), HasSubstr("proc main"));
 }
 
+TEST(SampleGeneratorTest, MutateSample) {
+  std::mt19937_64 rng;
+  SampleOptions sample_options;
+  sample_options.set_calls_per_sample(3);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Sample sample,
+      GenerateSample(dslx::AstGeneratorOptions{}, sample_options, rng));
+  XLS_ASSERT_OK_AND_ASSIGN(Sample mutant,
+                           MutateSample(sample, rng, /*max_attempts=*/1000));
+  EXPECT_NE(mutant.input_text(), sample.input_text());
+  EXPECT_EQ(mutant.options(), sample.options());
+  EXPECT_EQ(mutant.args_batch().size(), 3);
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,207 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_NETLIST_BIT_PARALLEL_SIMULATOR_H_
+#define XLS_NETLIST_BIT_PARALLEL_SIMULATOR_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/parallel_for.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/netlist/compiled_interpreter.h"
+#include "xls/netlist/netlist.h"
+
+namespace xls {
+namespace netlist {
+
+// A netlist value type holding one bit for each of kLanes independent
+// simulations ("patterns"). The logical operators apply lane-wise, so
+// evaluating a netlist over PatternBlocks evaluates it for every pattern at
+// once. With kWords > 1 the word loops are short and fixed-length, which the
+// compiler turns into SIMD instructions where available.
+template <int64_t kWords>
+class PatternBlock {
+ public:
+  static constexpr int64_t kLanes = 64 * kWords;
+
+  // Broadcasts "value" to every lane.
+  explicit PatternBlock(bool value) {
+    words_.fill(value ? ~uint64_t{0} : 0);
+  }
+
+  static PatternBlock Zeros() { return PatternBlock(false); }
+  static PatternBlock Ones() { return PatternBlock(true); }
+
+  bool Get(int64_t lane) const {
+    return (words_[lane / 64] >> (lane % 64)) & 1;
+  }
+  void Set(int64_t lane, bool value) {
+    uint64_t mask = uint64_t{1} << (lane % 64);
+    if (value) {
+      words_[lane / 64] |= mask;
+    } else {
+      words_[lane / 64] &= ~mask;
+    }
+  }
+
+  uint64_t word(int64_t i) const { return words_[i]; }
+
+  PatternBlock operator&(const PatternBlock& rhs) const {
+    PatternBlock result = *this;
+    for (int64_t i = 0; i < kWords; ++i) {
+      result.words_[i] &= rhs.words_[i];
+    }
+    return result;
+  }
+  PatternBlock operator|(const PatternBlock& rhs) const {
+    PatternBlock result = *this;
+    for (int64_t i = 0; i < kWords; ++i) {
+      result.words_[i] |= rhs.words_[i];
+    }
+    return result;
+  }
+  PatternBlock operator^(const PatternBlock& rhs) const {
+    PatternBlock result = *this;
+    for (int64_t i = 0; i < kWords; ++i) {
+      result.words_[i] ^= rhs.words_[i];
+    }
+    return result;
+  }
+  // Lane-wise inversion; cell functions spell "not" as operator!.
+  PatternBlock operator!() const {
+    PatternBlock result = *this;
+    for (int64_t i = 0; i < kWords; ++i) {
+      result.words_[i] = ~result.words_[i];
+    }
+    return result;
+  }
+
+  bool operator==(const PatternBlock& rhs) const {
+    return words_ == rhs.words_;
+  }
+  bool operator!=(const PatternBlock& rhs) const { return !(*this == rhs); }
+
+ private:
+  std::array<uint64_t, kWords> words_;
+};
+
+// 64 patterns per value, one machine word.
+using PatternWord = PatternBlock<1>;
+
+// Evaluates a netlist module on many input patterns at a time by running the
+// compiled interpreter over PatternBlocks. The netlist must have been parsed
+// with PatternBlock<kWords> as its value type (see
+// AbstractCellLibrary::FromProto() and rtl::AbstractParser::ParseNetlist()).
+//
+// Cells described by state tables are not supported; cells described by
+// functions or custom evaluation functions are.
+template <int64_t kWords = 1>
+class BitParallelSimulator {
+ public:
+  using Block = PatternBlock<kWords>;
+  static constexpr int64_t kPatternsPerBlock = Block::kLanes;
+
+  // Blocks of patterns are evaluated concurrently on up to "num_threads"
+  // threads.
+  static absl::StatusOr<std::unique_ptr<BitParallelSimulator>> Create(
+      const rtl::AbstractNetlist<Block>* netlist,
+      const rtl::AbstractModule<Block>* module, int64_t num_threads = 0) {
+    XLS_ASSIGN_OR_RETURN(
+        std::unique_ptr<AbstractCompiledInterpreter<Block>> interpreter,
+        AbstractCompiledInterpreter<Block>::Create(
+            netlist, module, Block::Zeros(), Block::Ones(),
+            /*num_threads=*/0));
+    return absl::WrapUnique(
+        new BitParallelSimulator(std::move(interpreter), num_threads));
+  }
+
+  // Evaluates a single block of patterns. "inputs" holds one block per module
+  // input, in the order of module->inputs(); the result holds one block per
+  // module output.
+  absl::StatusOr<std::vector<Block>> RunBlock(
+      const std::vector<Block>& inputs) const {
+    return interpreter_->Run(inputs);
+  }
+
+  // Evaluates the module once for each of "patterns". Bit i of a pattern is
+  // the value of module input i; bit i of the corresponding result is the
+  // value of module output i.
+  absl::StatusOr<std::vector<Bits>> Run(absl::Span<const Bits> patterns) const;
+
+ private:
+  BitParallelSimulator(
+      std::unique_ptr<AbstractCompiledInterpreter<Block>> interpreter,
+      int64_t num_threads)
+      : interpreter_(std::move(interpreter)), num_threads_(num_threads) {}
+
+  std::unique_ptr<AbstractCompiledInterpreter<Block>> interpreter_;
+  int64_t num_threads_;
+};
+
+template <int64_t kWords>
+absl::StatusOr<std::vector<Bits>> BitParallelSimulator<kWords>::Run(
+    absl::Span<const Bits> patterns) const {
+  const int64_t input_count = interpreter_->module()->inputs().size();
+  const int64_t output_count = interpreter_->module()->outputs().size();
+  for (const Bits& pattern : patterns) {
+    XLS_RET_CHECK_EQ(pattern.bit_count(), input_count);
+  }
+
+  std::vector<Bits> results(patterns.size());
+  int64_t block_count =
+      (patterns.size() + kPatternsPerBlock - 1) / kPatternsPerBlock;
+  auto run_block = [&](int64_t block) -> absl::Status {
+    int64_t begin = block * kPatternsPerBlock;
+    int64_t end =
+        std::min<int64_t>(patterns.size(), begin + kPatternsPerBlock);
+
+    // Transpose the patterns so each input's values share a block.
+    std::vector<Block> inputs(input_count, Block::Zeros());
+    for (int64_t p = begin; p < end; ++p) {
+      for (int64_t i = 0; i < input_count; ++i) {
+        if (patterns[p].Get(i)) {
+          inputs[i].Set(p - begin, true);
+        }
+      }
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<Block> outputs, RunBlock(inputs));
+
+    absl::InlinedVector<bool, 64> result_bits(output_count);
+    for (int64_t p = begin; p < end; ++p) {
+      for (int64_t o = 0; o < output_count; ++o) {
+        result_bits[o] = outputs[o].Get(p - begin);
+      }
+      results[p] = Bits(result_bits);
+    }
+    return absl::OkStatus();
+  };
+  XLS_RETURN_IF_ERROR(ParallelFor(block_count, num_threads_, run_block));
+  return results;
+}
+
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_BIT_PARALLEL_SIMULATOR_H_
@@ -0,0 +1,321 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/netlist/bit_parallel_simulator.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/function_extractor.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/lib_parser.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace {
+
+constexpr std::string_view kLibertySrc = R"lib(
+library(simple) {
+  cell(and2) {
+    pin(A) {
+      direction : input;
+    }
+    pin(B) {
+      direction : input;
+    }
+    pin(Y) {
+      direction: output;
+      function : "(A * B)";
+    }
+  }
+  cell(or2) {
+    pin(A) {
+      direction : input;
+    }
+    pin(B) {
+      direction : input;
+    }
+    pin(Y) {
+      direction: output;
+      function : "(A + B)";
+    }
+  }
+  cell(xor2) {
+    pin(A) {
+      direction : input;
+    }
+    pin(B) {
+      direction : input;
+    }
+    pin(Y) {
+      direction: output;
+      function : "(A ^ B)";
+    }
+  }
+  cell(not1) {
+    pin(A) {
+      direction : input;
+    }
+    pin(Y) {
+      direction : output;
+      function : "A'";
+    }
+  }
+}
+)lib";
+
+constexpr int64_t kInputCount = 8;
+constexpr int64_t kOutputCount = 4;
+
+absl::StatusOr<CellLibraryProto> GetLibraryProto() {
+  XLS_ASSIGN_OR_RETURN(
+      auto stream, cell_lib::CharStream::FromText(std::string(kLibertySrc)));
+  return function::ExtractFunctions(&stream);
+}
+
+// Returns the text of a module "main" with inputs x0..x7 and outputs o0..o3
+// built from "cell_count" randomly chosen and randomly connected cells.
+std::string MakeRandomNetlist(int64_t cell_count, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::string text = "module main (";
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    absl::StrAppendFormat(&text, "x%d, ", i);
+  }
+  text += "o0, o1, o2, o3);\n";
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    absl::StrAppendFormat(&text, "  input x%d;\n", i);
+  }
+  for (int64_t i = 0; i < kOutputCount; ++i) {
+    absl::StrAppendFormat(&text, "  output o%d;\n", i);
+  }
+  std::vector<std::string> nets;
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    nets.push_back(absl::StrFormat("x%d", i));
+  }
+  for (int64_t i = 0; i < cell_count; ++i) {
+    std::string out;
+    if (i + kOutputCount >= cell_count) {
+      out = absl::StrFormat("o%d", i + kOutputCount - cell_count);
+    } else {
+      out = absl::StrFormat("w%d", i);
+      absl::StrAppendFormat(&text, "  wire %s;\n", out);
+    }
+    // Prefer recent nets so the netlist is deep as well as wide.
+    auto pick = [&]() -> const std::string& {
+      int64_t window = std::min<int64_t>(nets.size(), 32);
+      return nets[nets.size() - 1 - rng() % window];
+    };
+    switch (rng() % 4) {
+      case 0:
+        absl::StrAppendFormat(&text, "  not1 c%d ( .A(%s), .Y(%s) );\n", i,
+                              pick(), out);
+        break;
+      default: {
+        constexpr const char* kCells[] = {"and2", "or2", "xor2"};
+        absl::StrAppendFormat(&text, "  %s c%d ( .A(%s), .B(%s), .Y(%s) );\n",
+                              kCells[rng() % 3], i, pick(), pick(), out);
+        break;
+      }
+    }
+    nets.push_back(out);
+  }
+  text += "endmodule\n";
+  return text;
+}
+
+std::vector<Bits> MakeRandomPatterns(int64_t count, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<Bits> patterns;
+  for (int64_t i = 0; i < count; ++i) {
+    patterns.push_back(UBits(rng() % (1 << kInputCount), kInputCount));
+  }
+  return patterns;
+}
+
+template <int64_t kWords>
+void ExpectMatchesInterpreter(int64_t cell_count, int64_t pattern_count,
+                              int64_t num_threads) {
+  using Block = PatternBlock<kWords>;
+  std::string netlist_text = MakeRandomNetlist(cell_count, /*seed=*/cell_count);
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, GetLibraryProto());
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary bool_library,
+                           CellLibrary::FromProto(proto));
+  rtl::Scanner bool_scanner(netlist_text);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto bool_netlist,
+      rtl::Parser::ParseNetlist(&bool_library, &bool_scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* bool_module,
+                           bool_netlist->GetModule("main"));
+  Interpreter interpreter(bool_netlist.get());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractCellLibrary<Block> block_library,
+      AbstractCellLibrary<Block>::FromProto(proto, Block::Zeros(),
+                                            Block::Ones()));
+  rtl::Scanner block_scanner(netlist_text);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto block_netlist,
+      rtl::AbstractParser<Block>::ParseNetlist(&block_library, &block_scanner,
+                                               Block::Zeros(), Block::Ones()));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::AbstractModule<Block>* block_module,
+                           block_netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto simulator, BitParallelSimulator<kWords>::Create(
+                          block_netlist.get(), block_module, num_threads));
+
+  std::vector<Bits> patterns = MakeRandomPatterns(pattern_count, /*seed=*/1);
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bits> results,
+                           simulator->Run(patterns));
+  ASSERT_EQ(results.size(), patterns.size());
+  for (int64_t p = 0; p < patterns.size(); ++p) {
+    NetRef2Value inputs;
+    for (int64_t i = 0; i < kInputCount; ++i) {
+      inputs[bool_module->inputs()[i]] = patterns[p].Get(i);
+    }
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value outputs,
+                             interpreter.InterpretModule(bool_module, inputs));
+    ASSERT_EQ(results[p].bit_count(), kOutputCount);
+    for (int64_t o = 0; o < kOutputCount; ++o) {
+      EXPECT_EQ(results[p].Get(o), outputs.at(bool_module->outputs()[o]))
+          << "pattern " << p << ", output " << o;
+    }
+  }
+}
+
+TEST(PatternBlockTest, LaneWiseOperations) {
+  PatternBlock<2> a = PatternBlock<2>::Zeros();
+  PatternBlock<2> b = PatternBlock<2>::Zeros();
+  a.Set(3, true);
+  a.Set(100, true);
+  b.Set(100, true);
+  b.Set(127, true);
+
+  EXPECT_TRUE((a & b).Get(100));
+  EXPECT_FALSE((a & b).Get(3));
+  EXPECT_TRUE((a | b).Get(3));
+  EXPECT_TRUE((a | b).Get(127));
+  EXPECT_FALSE((a ^ b).Get(100));
+  EXPECT_TRUE((a ^ b).Get(127));
+  EXPECT_FALSE((!a).Get(3));
+  EXPECT_TRUE((!a).Get(4));
+  EXPECT_EQ(!PatternBlock<2>::Zeros(), PatternBlock<2>::Ones());
+  EXPECT_EQ(a.word(0), uint64_t{1} << 3);
+}
+
+TEST(BitParallelSimulatorTest, MatchesInterpreter) {
+  // Not a multiple of the block size, so the last block is partial.
+  ExpectMatchesInterpreter<1>(/*cell_count=*/200, /*pattern_count=*/1000,
+                              /*num_threads=*/0);
+}
+
+TEST(BitParallelSimulatorTest, WideBlocksWithThreads) {
+  ExpectMatchesInterpreter<4>(/*cell_count=*/500, /*pattern_count=*/3000,
+                              /*num_threads=*/4);
+}
+
+TEST(BitParallelSimulatorTest, RejectsMismatchedPatternWidth) {
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, GetLibraryProto());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractCellLibrary<PatternWord> library,
+      AbstractCellLibrary<PatternWord>::FromProto(proto, PatternWord::Zeros(),
+                                                  PatternWord::Ones()));
+  rtl::Scanner scanner(MakeRandomNetlist(/*cell_count=*/16, /*seed=*/0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::AbstractParser<PatternWord>::ParseNetlist(
+                               &library, &scanner, PatternWord::Zeros(),
+                               PatternWord::Ones()));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::AbstractModule<PatternWord>* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto simulator,
+      BitParallelSimulator<>::Create(netlist.get(), module));
+  std::vector<Bits> patterns = {UBits(0, kInputCount + 1)};
+  EXPECT_FALSE(simulator->Run(patterns).ok());
+}
+
+// Evaluates a random netlist of state.range(0) cells on 4096 patterns, either
+// one pattern at a time with the event-driven interpreter or in blocks.
+void BM_Interpreter(benchmark::State& state) {
+  std::string netlist_text =
+      MakeRandomNetlist(state.range(0), /*seed=*/state.range(0));
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, GetLibraryProto());
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary library, CellLibrary::FromProto(proto));
+  rtl::Scanner scanner(netlist_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  Interpreter interpreter(netlist.get());
+  std::vector<Bits> patterns = MakeRandomPatterns(4096, /*seed=*/1);
+  for (auto _ : state) {
+    for (const Bits& pattern : patterns) {
+      NetRef2Value inputs;
+      for (int64_t i = 0; i < kInputCount; ++i) {
+        inputs[module->inputs()[i]] = pattern.Get(i);
+      }
+      XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value outputs,
+                               interpreter.InterpretModule(module, inputs));
+      benchmark::DoNotOptimize(outputs);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * patterns.size());
+}
+
+template <int64_t kWords>
+void BM_BitParallel(benchmark::State& state) {
+  using Block = PatternBlock<kWords>;
+  std::string netlist_text =
+      MakeRandomNetlist(state.range(0), /*seed=*/state.range(0));
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, GetLibraryProto());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractCellLibrary<Block> library,
+      AbstractCellLibrary<Block>::FromProto(proto, Block::Zeros(),
+                                            Block::Ones()));
+  rtl::Scanner scanner(netlist_text);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto netlist, rtl::AbstractParser<Block>::ParseNetlist(
+                        &library, &scanner, Block::Zeros(), Block::Ones()));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::AbstractModule<Block>* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto simulator,
+      BitParallelSimulator<kWords>::Create(netlist.get(), module));
+  std::vector<Bits> patterns = MakeRandomPatterns(4096, /*seed=*/1);
+  for (auto _ : state) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bits> results,
+                             simulator->Run(patterns));
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * patterns.size());
+}
+
+BENCHMARK(BM_Interpreter)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_BitParallel, 1)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_BitParallel, 4)->Range(64, 4096);
+
+}  // namespace
+}  // namespace netlist
+}  // namespace xls
@@ -0,0 +1,764 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_NETLIST_COMPILED_INTERPRETER_H_
+#define XLS_NETLIST_COMPILED_INTERPRETER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/thread.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/function_parser.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/netlist.h"
+
+namespace xls {
+namespace netlist {
+
+// Interprets a netlist module that has been compiled ahead of time, as an
+// alternative to the event-driven AbstractInterpreter for modules that are
+// evaluated many times.
+//
+// Compilation levelizes the module's cells (a cell's level is one more than
+// the highest level of the cells driving its inputs), gives every net a dense
+// value slot, and lowers each cell library pin function to a postfix program
+// over the cell's input pins, once per library entry. Evaluation is then a
+// sweep over the levels; cells within a level are independent, so large
+// levels are split into chunks and evaluated on a pool of worker threads which
+// lives as long as the interpreter.
+//
+// Cells instantiating other modules of the netlist are compiled recursively.
+// Unlike AbstractInterpreter, constant nets and `assign`ed wires may feed
+// cells, and outputs may be assigned from cell-driven wires. Combinational
+// loops are rejected at compile time.
+template <typename EvalT = bool>
+class AbstractCompiledInterpreter {
+ public:
+  // Compiles "module" (which must belong to "netlist"). If "num_threads" is
+  // greater than one and the module has levels wide enough to split, starts
+  // num_threads - 1 worker threads which, together with the thread calling
+  // Run(), evaluate those levels.
+  static absl::StatusOr<std::unique_ptr<AbstractCompiledInterpreter>> Create(
+      const rtl::AbstractNetlist<EvalT>* netlist,
+      const rtl::AbstractModule<EvalT>* module, EvalT zero, EvalT one,
+      int64_t num_threads = 0);
+
+  template <typename = std::is_constructible<EvalT, bool>>
+  static absl::StatusOr<std::unique_ptr<AbstractCompiledInterpreter>> Create(
+      const rtl::AbstractNetlist<EvalT>* netlist,
+      const rtl::AbstractModule<EvalT>* module) {
+    return Create(netlist, module, EvalT{false}, EvalT{true});
+  }
+
+  ~AbstractCompiledInterpreter();
+
+  const rtl::AbstractModule<EvalT>* module() const { return module_; }
+
+  // Number of levels the module's cells were sorted into.
+  int64_t level_count() const {
+    return static_cast<int64_t>(level_starts_.size()) - 1;
+  }
+
+  // Evaluates the module on "inputs", given in the order of
+  // module()->inputs(), returning values in the order of module()->outputs().
+  // Only one Run() at a time uses the worker threads; concurrent calls
+  // evaluate on their calling thread.
+  absl::StatusOr<std::vector<EvalT>> Run(
+      const std::vector<EvalT>& inputs) const;
+
+  // As above, but with the same interface as
+  // AbstractInterpreter::InterpretModule(). Every module input must have a
+  // value.
+  absl::StatusOr<AbstractNetRef2Value<EvalT>> InterpretModule(
+      const AbstractNetRef2Value<EvalT>& inputs) const;
+
+ private:
+  // One step of a lowered pin function. The steps form a postfix program over
+  // a small value stack.
+  struct FunctionOp {
+    enum class Kind : uint8_t {
+      kInput,  // Pushes the value of cell input pin `input`.
+      kZero,
+      kOne,
+      kAnd,
+      kOr,
+      kXor,
+      kNot,
+      kStateTable,  // Pushes internal pin `internal_pin` of the state table.
+    };
+    Kind kind;
+    int64_t input = 0;
+    std::string internal_pin;
+  };
+  using Function = std::vector<FunctionOp>;
+
+  struct CompiledOutput {
+    int64_t slot = 0;
+    // Exactly one of these is set, unless the cell is a submodule instance.
+    const Function* function = nullptr;
+    const rtl::CellOutputEvalFn<EvalT>* eval = nullptr;
+    // For submodule instances, the index of the submodule output.
+    int64_t submodule_output = -1;
+  };
+
+  struct CompiledCell {
+    const rtl::AbstractCell<EvalT>* cell;
+    // Value slots of the cell's inputs, in the order of cell->inputs().
+    std::vector<int64_t> input_slots;
+    std::vector<CompiledOutput> outputs;
+    // For submodule instances, the compiled submodule and, for each of its
+    // inputs, the index into input_slots feeding it.
+    const AbstractCompiledInterpreter* submodule = nullptr;
+    std::vector<int64_t> submodule_inputs;
+  };
+
+  // Cells per chunk when a level is evaluated in parallel.
+  static constexpr int64_t kCellsPerChunk = 1024;
+
+  // Holds a value; wraps EvalT so that slots are distinct objects even for
+  // bool (std::vector<bool> is not safe for concurrent writes).
+  struct Slot {
+    EvalT value;
+  };
+
+  // The level being evaluated on the worker threads.
+  struct LevelWork {
+    int64_t begin = 0;
+    int64_t end = 0;
+    int64_t chunk_count = 0;
+    std::vector<Slot>* values = nullptr;
+  };
+
+  AbstractCompiledInterpreter(const rtl::AbstractModule<EvalT>* module,
+                              EvalT zero, EvalT one)
+      : module_(module), zero_(std::move(zero)), one_(std::move(one)) {}
+
+  absl::Status Compile(const rtl::AbstractNetlist<EvalT>* netlist);
+
+  // Returns the lowered form of "function" for cells of "entry", parsing and
+  // lowering it on first use.
+  absl::StatusOr<const Function*> GetOrLowerFunction(
+      const AbstractCellLibraryEntry<EvalT>* entry,
+      const std::string& pin_name);
+  absl::Status LowerFunction(const AbstractCellLibraryEntry<EvalT>* entry,
+                             const function::Ast& ast, Function* function);
+
+  absl::Status EvalLevels(std::vector<Slot>& values, bool use_workers) const;
+  absl::Status EvalChunk(const LevelWork& level, int64_t chunk) const;
+
+  // Hands the chunks of "level" out to the worker threads, evaluates chunks
+  // itself until none are left and waits for the rest.
+  absl::Status EvalLevelOnWorkers(const LevelWork& level) const;
+  // Evaluates chunks of the current level until there are none left to take.
+  void EvalAvailableChunks() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_mutex_);
+  void WorkerBody() const;
+  bool HasWorkOrShouldExit() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_mutex_) {
+    return workers_should_exit_ || next_chunk_ < level_.chunk_count;
+  }
+  bool LevelDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_mutex_) {
+    return chunks_done_ == level_.chunk_count;
+  }
+
+  absl::Status EvalCell(const CompiledCell& cell,
+                        std::vector<Slot>& values) const;
+  absl::StatusOr<EvalT> EvalFunction(const CompiledCell& cell,
+                                     const Function& function,
+                                     const std::vector<Slot>& values) const;
+
+  const rtl::AbstractModule<EvalT>* module_;
+  EvalT zero_;
+  EvalT one_;
+
+  int64_t slot_count_ = 0;
+  int64_t zero_slot_ = 0;
+  int64_t one_slot_ = 0;
+  std::vector<int64_t> input_slots_;
+  std::vector<int64_t> output_slots_;
+
+  // Cells sorted by level; level i is [level_starts_[i], level_starts_[i+1]).
+  std::vector<CompiledCell> cells_;
+  std::vector<int64_t> level_starts_;
+
+  absl::flat_hash_map<std::pair<const AbstractCellLibraryEntry<EvalT>*,
+                                std::string>,
+                      std::unique_ptr<Function>>
+      functions_;
+  absl::flat_hash_map<const rtl::AbstractModule<EvalT>*,
+                      std::unique_ptr<AbstractCompiledInterpreter>>
+      submodules_;
+
+  // Worker pool; see Create(). run_mutex_ is held by the Run() using it.
+  std::vector<std::unique_ptr<xls::Thread>> workers_;
+  mutable absl::Mutex run_mutex_;
+  mutable absl::Mutex pool_mutex_;
+  mutable LevelWork level_ ABSL_GUARDED_BY(pool_mutex_);
+  mutable int64_t next_chunk_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  mutable int64_t chunks_done_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  // The lowest-indexed failing chunk of the level and its error, if any.
+  mutable int64_t failed_chunk_ ABSL_GUARDED_BY(pool_mutex_) = -1;
+  mutable absl::Status level_status_ ABSL_GUARDED_BY(pool_mutex_);
+  bool workers_should_exit_ ABSL_GUARDED_BY(pool_mutex_) = false;
+};
+
+using CompiledInterpreter = AbstractCompiledInterpreter<>;
+
+template <typename EvalT>
+/* static */ absl::StatusOr<std::unique_ptr<AbstractCompiledInterpreter<EvalT>>>
+AbstractCompiledInterpreter<EvalT>::Create(
+    const rtl::AbstractNetlist<EvalT>* netlist,
+    const rtl::AbstractModule<EvalT>* module, EvalT zero, EvalT one,
+    int64_t num_threads) {
+  auto interpreter =
+      absl::WrapUnique(new AbstractCompiledInterpreter<EvalT>(
+          module, std::move(zero), std::move(one)));
+  XLS_RETURN_IF_ERROR(interpreter->Compile(netlist));
+
+  bool has_wide_level = false;
+  for (int64_t l = 0; l + 1 < interpreter->level_starts_.size(); ++l) {
+    has_wide_level |= interpreter->level_starts_[l + 1] -
+                          interpreter->level_starts_[l] >
+                      kCellsPerChunk;
+  }
+  if (num_threads > 1 && has_wide_level) {
+    AbstractCompiledInterpreter<EvalT>* raw = interpreter.get();
+    for (int64_t i = 0; i + 1 < num_threads; ++i) {
+      interpreter->workers_.push_back(
+          std::make_unique<xls::Thread>([raw]() { raw->WorkerBody(); }));
+    }
+  }
+  return interpreter;
+}
+
+template <typename EvalT>
+AbstractCompiledInterpreter<EvalT>::~AbstractCompiledInterpreter() {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    workers_should_exit_ = true;
+  }
+  for (std::unique_ptr<xls::Thread>& worker : workers_) {
+    worker->Join();
+  }
+}
+
+template <typename EvalT>
+void AbstractCompiledInterpreter<EvalT>::WorkerBody() const {
+  absl::MutexLock lock(&pool_mutex_);
+  while (true) {
+    pool_mutex_.Await(absl::Condition(
+        this, &AbstractCompiledInterpreter<EvalT>::HasWorkOrShouldExit));
+    if (workers_should_exit_) {
+      return;
+    }
+    EvalAvailableChunks();
+  }
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::Compile(
+    const rtl::AbstractNetlist<EvalT>* netlist) {
+  using NetRef = rtl::AbstractNetRef<EvalT>;
+
+  absl::flat_hash_map<NetRef, int64_t> slots;
+  for (const auto& net : module_->nets()) {
+    slots[net.get()] = slot_count_++;
+  }
+  zero_slot_ = slots.at(module_->zero());
+  one_slot_ = slots.at(module_->one());
+
+  // Index of the cell driving each net.
+  absl::Span<const std::unique_ptr<rtl::AbstractCell<EvalT>>> cells =
+      module_->cells();
+  absl::flat_hash_map<NetRef, int64_t> drivers;
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    for (const auto& output : cells[i]->outputs()) {
+      if (output.netref != module_->GetDummyRef()) {
+        drivers[output.netref] = i;
+      }
+    }
+  }
+
+  // Resolves a net to the net whose value it carries: itself if it is driven
+  // by a cell, otherwise the end of its chain of assigns.
+  const auto& assigns = module_->assigns();
+  auto resolve = [&](NetRef net) -> absl::StatusOr<NetRef> {
+    for (int64_t i = 0; !drivers.contains(net) && assigns.contains(net); ++i) {
+      XLS_RET_CHECK_LE(i, assigns.size())
+          << "Cycle of assigns through net " << net->name();
+      net = assigns.at(net);
+    }
+    return net;
+  };
+  absl::flat_hash_set<NetRef> module_inputs(module_->inputs().begin(),
+                                            module_->inputs().end());
+  auto has_value = [&](NetRef net) {
+    return drivers.contains(net) || module_inputs.contains(net) ||
+           net == module_->zero() || net == module_->one();
+  };
+
+  for (NetRef input : module_->inputs()) {
+    input_slots_.push_back(slots.at(input));
+  }
+  for (NetRef output : module_->outputs()) {
+    XLS_ASSIGN_OR_RETURN(NetRef source, resolve(output));
+    // As in AbstractInterpreter, an output without a value is more likely a
+    // bug in the netlist than intentional.
+    XLS_RET_CHECK(has_value(source))
+        << "Output " << output->name() << " has no driver or assignment.";
+    output_slots_.push_back(slots.at(source));
+  }
+
+  // Levelize: a cell can be evaluated once every cell driving one of its
+  // inputs has been.
+  std::vector<std::vector<int64_t>> input_slots(cells.size());
+  std::vector<std::vector<int64_t>> fanouts(cells.size());
+  std::vector<int64_t> pending(cells.size(), 0);
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    for (const auto& input : cells[i]->inputs()) {
+      XLS_ASSIGN_OR_RETURN(NetRef source, resolve(input.netref));
+      if (!has_value(source)) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Netlist contains unconnected subgraphs and cannot be translated. "
+            "Example: cell %s",
+            cells[i]->name()));
+      }
+      input_slots[i].push_back(slots.at(source));
+      if (auto it = drivers.find(source); it != drivers.end()) {
+        fanouts[it->second].push_back(i);
+        ++pending[i];
+      }
+    }
+  }
+  std::vector<int64_t> level(cells.size(), 0);
+  std::deque<int64_t> ready;
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    if (pending[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  int64_t processed = 0;
+  int64_t max_level = 0;
+  while (!ready.empty()) {
+    int64_t i = ready.front();
+    ready.pop_front();
+    ++processed;
+    max_level = std::max(max_level, level[i]);
+    for (int64_t fanout : fanouts[i]) {
+      level[fanout] = std::max(level[fanout], level[i] + 1);
+      if (--pending[fanout] == 0) {
+        ready.push_back(fanout);
+      }
+    }
+  }
+  if (processed != cells.size()) {
+    for (int64_t i = 0; i < cells.size(); ++i) {
+      if (pending[i] > 0) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Netlist contains a combinational loop and cannot be compiled. "
+            "Example: cell %s",
+            cells[i]->name()));
+      }
+    }
+  }
+
+  std::vector<int64_t> order(cells.size());
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int64_t a, int64_t b) { return level[a] < level[b]; });
+  level_starts_.assign(cells.empty() ? 1 : max_level + 2, 0);
+  for (int64_t i = 0; i < cells.size(); ++i) {
+    ++level_starts_[level[i] + 1];
+  }
+  for (int64_t l = 1; l < level_starts_.size(); ++l) {
+    level_starts_[l] += level_starts_[l - 1];
+  }
+
+  cells_.reserve(cells.size());
+  for (int64_t i : order) {
+    const rtl::AbstractCell<EvalT>* cell = cells[i].get();
+    const AbstractCellLibraryEntry<EvalT>* entry = cell->cell_library_entry();
+    CompiledCell compiled;
+    compiled.cell = cell;
+    compiled.input_slots = std::move(input_slots[i]);
+
+    std::optional<const rtl::AbstractModule<EvalT>*> submodule =
+        netlist->MaybeGetModule(entry->name());
+    if (submodule.has_value()) {
+      auto [it, inserted] = submodules_.try_emplace(*submodule);
+      if (inserted) {
+        XLS_ASSIGN_OR_RETURN(
+            it->second, Create(netlist, *submodule, zero_, one_,
+                               /*num_threads=*/0));
+      }
+      compiled.submodule = it->second.get();
+      // Match pins by name, as AbstractInterpreter does.
+      for (const auto& submodule_input : (*submodule)->inputs()) {
+        auto pin = std::find_if(
+            cell->inputs().begin(), cell->inputs().end(),
+            [&](const auto& p) { return p.name == submodule_input->name(); });
+        XLS_RET_CHECK(pin != cell->inputs().end()) << absl::StrFormat(
+            "Could not find input pin \"%s\" of module \"%s\" in cell \"%s\"!",
+            submodule_input->name(), (*submodule)->name(), cell->name());
+        compiled.submodule_inputs.push_back(pin - cell->inputs().begin());
+      }
+      const auto& submodule_outputs = (*submodule)->outputs();
+      for (int64_t o = 0; o < submodule_outputs.size(); ++o) {
+        auto pin = std::find_if(
+            cell->outputs().begin(), cell->outputs().end(),
+            [&](const auto& p) {
+              return p.name == submodule_outputs[o]->name();
+            });
+        XLS_RET_CHECK(pin != cell->outputs().end()) << absl::StrFormat(
+            "Could not find cell output pin \"%s\" in cell \"%s\", referenced "
+            "in child module \"%s\"!",
+            submodule_outputs[o]->name(), cell->name(), (*submodule)->name());
+        if (pin->netref != module_->GetDummyRef()) {
+          CompiledOutput compiled_output;
+          compiled_output.slot = slots.at(pin->netref);
+          compiled_output.submodule_output = o;
+          compiled.outputs.push_back(compiled_output);
+        }
+      }
+    } else {
+      for (const auto& output : cell->outputs()) {
+        // Unused outputs are not computed.
+        if (output.netref == module_->GetDummyRef()) {
+          continue;
+        }
+        CompiledOutput compiled_output;
+        compiled_output.slot = slots.at(output.netref);
+        if (output.eval != nullptr) {
+          compiled_output.eval = &output.eval;
+        } else {
+          XLS_ASSIGN_OR_RETURN(compiled_output.function,
+                               GetOrLowerFunction(entry, output.name));
+        }
+        compiled.outputs.push_back(compiled_output);
+      }
+    }
+    cells_.push_back(std::move(compiled));
+  }
+  return absl::OkStatus();
+}
+
+template <typename EvalT>
+absl::StatusOr<const typename AbstractCompiledInterpreter<EvalT>::Function*>
+AbstractCompiledInterpreter<EvalT>::GetOrLowerFunction(
+    const AbstractCellLibraryEntry<EvalT>* entry, const std::string& pin_name) {
+  std::unique_ptr<Function>& function = functions_[{entry, pin_name}];
+  if (function == nullptr) {
+    XLS_ASSIGN_OR_RETURN(function::Ast ast,
+                         function::Parser::ParseFunction(
+                             entry->output_pin_to_function().at(pin_name)));
+    auto lowered = std::make_unique<Function>();
+    XLS_RETURN_IF_ERROR(LowerFunction(entry, ast, lowered.get()));
+    function = std::move(lowered);
+  }
+  return function.get();
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::LowerFunction(
+    const AbstractCellLibraryEntry<EvalT>* entry, const function::Ast& ast,
+    Function* function) {
+  using Kind = typename FunctionOp::Kind;
+  for (const function::Ast& child : ast.children()) {
+    XLS_RETURN_IF_ERROR(LowerFunction(entry, child, function));
+  }
+  switch (ast.kind()) {
+    case function::Ast::Kind::kIdentifier: {
+      absl::Span<const std::string> input_names = entry->input_names();
+      auto it = std::find(input_names.begin(), input_names.end(), ast.name());
+      if (it != input_names.end()) {
+        function->push_back(
+            FunctionOp{Kind::kInput, it - input_names.begin(), ""});
+        return absl::OkStatus();
+      }
+      if (entry->state_table().has_value() &&
+          entry->state_table()->internal_signals().contains(ast.name())) {
+        // AbstractStateTable can only match rows against values convertible
+        // to a single bit.
+        if constexpr (!std::is_convertible<EvalT, int>()) {
+          return absl::UnimplementedError(absl::StrFormat(
+              "Cell %s is described by a state table, which is only supported "
+              "for boolean values.",
+              entry->name()));
+        }
+        function->push_back(FunctionOp{Kind::kStateTable, 0, ast.name()});
+        return absl::OkStatus();
+      }
+      return absl::NotFoundError(
+          absl::StrFormat("Identifier \"%s\" not found in cell %s's inputs "
+                          "or internal signals.",
+                          ast.name(), entry->name()));
+    }
+    case function::Ast::Kind::kLiteralZero:
+      function->push_back(FunctionOp{Kind::kZero});
+      return absl::OkStatus();
+    case function::Ast::Kind::kLiteralOne:
+      function->push_back(FunctionOp{Kind::kOne});
+      return absl::OkStatus();
+    case function::Ast::Kind::kAnd:
+      function->push_back(FunctionOp{Kind::kAnd});
+      return absl::OkStatus();
+    case function::Ast::Kind::kOr:
+      function->push_back(FunctionOp{Kind::kOr});
+      return absl::OkStatus();
+    case function::Ast::Kind::kXor:
+      function->push_back(FunctionOp{Kind::kXor});
+      return absl::OkStatus();
+    case function::Ast::Kind::kNot:
+      function->push_back(FunctionOp{Kind::kNot});
+      return absl::OkStatus();
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown AST element type: ", ast.kind()));
+}
+
+template <typename EvalT>
+absl::StatusOr<EvalT> AbstractCompiledInterpreter<EvalT>::EvalFunction(
+    const CompiledCell& cell, const Function& function,
+    const std::vector<Slot>& values) const {
+  using Kind = typename FunctionOp::Kind;
+  absl::InlinedVector<EvalT, 8> stack;
+  auto pop = [&stack]() {
+    EvalT value = std::move(stack.back());
+    stack.pop_back();
+    return value;
+  };
+  for (const FunctionOp& op : function) {
+    switch (op.kind) {
+      case Kind::kInput:
+        stack.push_back(values[cell.input_slots[op.input]].value);
+        break;
+      case Kind::kZero:
+        stack.push_back(zero_);
+        break;
+      case Kind::kOne:
+        stack.push_back(one_);
+        break;
+      case Kind::kAnd: {
+        EvalT rhs = pop();
+        EvalT lhs = pop();
+        stack.push_back(lhs & rhs);
+        break;
+      }
+      case Kind::kOr: {
+        EvalT rhs = pop();
+        EvalT lhs = pop();
+        stack.push_back(lhs | rhs);
+        break;
+      }
+      case Kind::kXor: {
+        EvalT rhs = pop();
+        EvalT lhs = pop();
+        stack.push_back(lhs ^ rhs);
+        break;
+      }
+      case Kind::kNot: {
+        EvalT value = pop();
+        stack.push_back(!value);
+        break;
+      }
+      case Kind::kStateTable: {
+        typename AbstractStateTable<EvalT>::InputStimulus stimulus;
+        absl::Span<const typename rtl::AbstractCell<EvalT>::Pin> inputs =
+            cell.cell->inputs();
+        for (int64_t i = 0; i < inputs.size(); ++i) {
+          stimulus.emplace(inputs[i].name, values[cell.input_slots[i]].value);
+        }
+        XLS_ASSIGN_OR_RETURN(
+            EvalT value,
+            cell.cell->cell_library_entry()->state_table()->GetSignalValue(
+                stimulus, op.internal_pin));
+        stack.push_back(std::move(value));
+        break;
+      }
+    }
+  }
+  XLS_RET_CHECK_EQ(stack.size(), 1);
+  return pop();
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::EvalCell(
+    const CompiledCell& cell, std::vector<Slot>& values) const {
+  if (cell.submodule != nullptr) {
+    std::vector<EvalT> submodule_inputs;
+    submodule_inputs.reserve(cell.submodule_inputs.size());
+    for (int64_t input : cell.submodule_inputs) {
+      submodule_inputs.push_back(values[cell.input_slots[input]].value);
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<EvalT> submodule_outputs,
+                         cell.submodule->Run(submodule_inputs));
+    for (const CompiledOutput& output : cell.outputs) {
+      values[output.slot].value = submodule_outputs[output.submodule_output];
+    }
+    return absl::OkStatus();
+  }
+
+  for (const CompiledOutput& output : cell.outputs) {
+    if (output.eval != nullptr) {
+      std::vector<EvalT> args;
+      args.reserve(cell.input_slots.size());
+      for (int64_t slot : cell.input_slots) {
+        args.push_back(values[slot].value);
+      }
+      XLS_ASSIGN_OR_RETURN(values[output.slot].value, (*output.eval)(args));
+    } else {
+      XLS_ASSIGN_OR_RETURN(values[output.slot].value,
+                           EvalFunction(cell, *output.function, values));
+    }
+  }
+  return absl::OkStatus();
+}
+
+template <typename EvalT>
+absl::StatusOr<std::vector<EvalT>> AbstractCompiledInterpreter<EvalT>::Run(
+    const std::vector<EvalT>& inputs) const {
+  XLS_RET_CHECK_EQ(inputs.size(), input_slots_.size());
+  std::vector<Slot> values(slot_count_, Slot{zero_});
+  values[one_slot_].value = one_;
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    values[input_slots_[i]].value = inputs[i];
+  }
+
+  bool use_workers = !workers_.empty() && run_mutex_.TryLock();
+  absl::Status status = EvalLevels(values, use_workers);
+  if (use_workers) {
+    run_mutex_.Unlock();
+  }
+  XLS_RETURN_IF_ERROR(status);
+
+  std::vector<EvalT> outputs;
+  outputs.reserve(output_slots_.size());
+  for (int64_t slot : output_slots_) {
+    outputs.push_back(values[slot].value);
+  }
+  return outputs;
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::EvalLevels(
+    std::vector<Slot>& values, bool use_workers) const {
+  for (int64_t l = 0; l + 1 < level_starts_.size(); ++l) {
+    LevelWork level{.begin = level_starts_[l],
+                    .end = level_starts_[l + 1],
+                    .values = &values};
+    level.chunk_count =
+        (level.end - level.begin + kCellsPerChunk - 1) / kCellsPerChunk;
+    if (use_workers && level.chunk_count > 1) {
+      XLS_RETURN_IF_ERROR(EvalLevelOnWorkers(level));
+    } else {
+      for (int64_t i = level.begin; i < level.end; ++i) {
+        XLS_RETURN_IF_ERROR(EvalCell(cells_[i], values));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::EvalChunk(
+    const LevelWork& level, int64_t chunk) const {
+  int64_t chunk_begin = level.begin + chunk * kCellsPerChunk;
+  int64_t chunk_end = std::min(level.end, chunk_begin + kCellsPerChunk);
+  for (int64_t i = chunk_begin; i < chunk_end; ++i) {
+    XLS_RETURN_IF_ERROR(EvalCell(cells_[i], *level.values));
+  }
+  return absl::OkStatus();
+}
+
+template <typename EvalT>
+absl::Status AbstractCompiledInterpreter<EvalT>::EvalLevelOnWorkers(
+    const LevelWork& level) const {
+  absl::MutexLock lock(&pool_mutex_);
+  level_ = level;
+  next_chunk_ = 0;
+  chunks_done_ = 0;
+  failed_chunk_ = -1;
+  level_status_ = absl::OkStatus();
+  EvalAvailableChunks();
+  pool_mutex_.Await(
+      absl::Condition(this, &AbstractCompiledInterpreter<EvalT>::LevelDone));
+  level_ = LevelWork();
+  next_chunk_ = 0;
+  return level_status_;
+}
+
+template <typename EvalT>
+void AbstractCompiledInterpreter<EvalT>::EvalAvailableChunks() const {
+  while (next_chunk_ < level_.chunk_count) {
+    int64_t chunk = next_chunk_++;
+    LevelWork level = level_;
+    pool_mutex_.Unlock();
+    absl::Status status = EvalChunk(level, chunk);
+    pool_mutex_.Lock();
+    if (!status.ok() && (failed_chunk_ < 0 || chunk < failed_chunk_)) {
+      failed_chunk_ = chunk;
+      level_status_ = status;
+    }
+    ++chunks_done_;
+  }
+}
+
+template <typename EvalT>
+absl::StatusOr<AbstractNetRef2Value<EvalT>>
+AbstractCompiledInterpreter<EvalT>::InterpretModule(
+    const AbstractNetRef2Value<EvalT>& inputs) const {
+  std::vector<EvalT> input_values;
+  input_values.reserve(module_->inputs().size());
+  for (const rtl::AbstractNetRef<EvalT> input : module_->inputs()) {
+    auto it = inputs.find(input);
+    if (it == inputs.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("No value given for input %s.", input->name()));
+    }
+    input_values.push_back(it->second);
+  }
+  XLS_ASSIGN_OR_RETURN(std::vector<EvalT> output_values, Run(input_values));
+
+  AbstractNetRef2Value<EvalT> outputs;
+  outputs.reserve(output_values.size());
+  for (int64_t i = 0; i < output_values.size(); ++i) {
+    outputs.insert({module_->outputs()[i], std::move(output_values[i])});
+  }
+  return outputs;
+}
+
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_COMPILED_INTERPRETER_H_
@@ -0,0 +1,354 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/netlist/compiled_interpreter.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/fake_cell_library.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+// Checks that the compiled interpreter agrees with the event-driven
+// interpreter on every input combination of "module".
+void ExpectMatchesInterpreter(rtl::Netlist* netlist,
+                              const rtl::Module* module,
+                              int64_t num_threads = 0) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto compiled,
+      CompiledInterpreter::Create(netlist, module, /*zero=*/false,
+                                  /*one=*/true, num_threads));
+  Interpreter interpreter(netlist);
+  int64_t input_count = module->inputs().size();
+  ASSERT_LE(input_count, 10);
+  for (int64_t value = 0; value < (int64_t{1} << input_count); ++value) {
+    NetRef2Value inputs;
+    for (int64_t i = 0; i < input_count; ++i) {
+      inputs[module->inputs()[i]] = (value >> i) & 1;
+    }
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value expected,
+                             interpreter.InterpretModule(module, inputs));
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value actual,
+                             compiled->InterpretModule(inputs));
+    EXPECT_EQ(actual, expected) << "inputs: " << value;
+  }
+}
+
+TEST(CompiledInterpreterTest, Tree) {
+  std::string module_text = R"(
+module main (i0, i1, i2, i3, o0);
+  input i0, i1, i2, i3;
+  output o0;
+  wire and_o, or_o;
+
+  AND and0 ( .A(i0), .B(i1), .Z(and_o) );
+  OR or0 ( .A(i2), .B(i3), .Z(or_o) );
+  XOR xor0 ( .A(and_o), .B(or_o), .Z(o0) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto compiled,
+                           CompiledInterpreter::Create(netlist.get(), module));
+  EXPECT_EQ(compiled->level_count(), 2);
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<bool> outputs,
+                           compiled->Run({true, false, true, false}));
+  EXPECT_THAT(outputs, ElementsAre(true));
+  ExpectMatchesInterpreter(netlist.get(), module);
+}
+
+TEST(CompiledInterpreterTest, Submodules) {
+  std::string module_text = R"(
+module submodule_0 (i2_0, i2_1, o2_0);
+  input i2_0, i2_1;
+  output o2_0;
+
+  AND and0( .A(i2_0), .B(i2_1), .Z(o2_0) );
+endmodule
+
+module submodule_1 (i2_2, i2_3, o2_1);
+  input i2_2, i2_3;
+  output o2_1;
+
+  OR or0( .A(i2_2), .B(i2_3), .Z(o2_1) );
+endmodule
+
+module submodule_2 (i1_0, i1_1, i1_2, i1_3, o1_0);
+  input i1_0, i1_1, i1_2, i1_3;
+  output o1_0;
+  wire res0, res1;
+
+  submodule_0 and0 ( .i2_0(i1_0), .i2_1(i1_1), .o2_0(res0) );
+  submodule_1 or0 ( .i2_2(i1_2), .i2_3(i1_3), .o2_1(res1) );
+  XOR xor0 ( .A(res0), .B(res1), .Z(o1_0) );
+endmodule
+
+module main (i0, i1, i2, i3, o0);
+  input i0, i1, i2, i3;
+  output o0;
+
+  submodule_2 bleh( .i1_0(i0), .i1_1(i1), .i1_2(i2), .i1_3(i3), .o1_0(o0) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  ExpectMatchesInterpreter(netlist.get(), module);
+}
+
+TEST(CompiledInterpreterTest, StateTables) {
+  std::string module_text = R"(
+module main(i0, i1, i2, i3, o0);
+  input i0, i1, i2, i3;
+  output o0;
+  wire and0_out, and1_out;
+
+  AND and0 ( .A(i0), .B(i1), .Z(and0_out) );
+  STATETABLE_AND and1 (.A(i2), .B(i3), .Z(and1_out) );
+  AND and2 ( .A(and0_out), .B(and1_out), .Z(o0) );
+endmodule
+  )";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  ExpectMatchesInterpreter(netlist.get(), module);
+}
+
+TEST(CompiledInterpreterTest, ComplexMixedInputAndWireAssigns) {
+  std::string module_text = R"(
+module main (A, B, out);
+  input A;
+  input B;
+  wire [1:0] i0;
+  wire [2:0] i1;
+  wire [3:0] i2;
+  wire [4:0] i3;
+  output [15:0] out;
+  wire [15:0] out;
+
+  assign i0 = { A, B };
+  assign i1 = { 1'b1, i0 };
+  assign { i2, i3 }  = { i1, i1, i1, i1 };
+  assign out = { i3, i2, 7'h4a };
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  ExpectMatchesInterpreter(netlist.get(), module);
+}
+
+// Cells may be fed by assigned wires and constants, and outputs may be
+// assigned from cell-driven wires.
+TEST(CompiledInterpreterTest, CellsThroughAssigns) {
+  std::string module_text = R"(
+module main (A, B, o0, o1);
+  input A, B;
+  output o0, o1;
+  wire a_alias, and_o, inv_o;
+
+  assign a_alias = A;
+  AND and0 ( .A(a_alias), .B(B), .Z(and_o) );
+  INV inv0 ( .A(1'b0), .ZN(inv_o) );
+  assign o0 = and_o;
+  XOR xor0 ( .A(and_o), .B(inv_o), .Z(o1) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto compiled,
+                           CompiledInterpreter::Create(netlist.get(), module));
+  for (bool a : {false, true}) {
+    for (bool b : {false, true}) {
+      XLS_ASSERT_OK_AND_ASSIGN(std::vector<bool> outputs,
+                               compiled->Run({a, b}));
+      EXPECT_THAT(outputs, ElementsAre(a && b, !(a && b)));
+    }
+  }
+}
+
+// A module whose levels are wide enough to be split across threads.
+TEST(CompiledInterpreterTest, WideLevelsWithThreads) {
+  constexpr int64_t kWidth = 3000;
+  std::string module_text =
+      "module main (i0, i1, i2, i3, i4, i5, o0);\n"
+      "  input i0, i1, i2, i3, i4, i5;\n"
+      "  output o0;\n";
+  for (int64_t i = 0; i < kWidth; ++i) {
+    absl::StrAppendFormat(&module_text, "  wire x%d, y%d;\n", i, i);
+  }
+  absl::StrAppend(&module_text, "  wire [", kWidth, ":0] acc;\n");
+  for (int64_t i = 0; i < kWidth; ++i) {
+    absl::StrAppendFormat(&module_text,
+                          "  XOR xor%d ( .A(i%d), .B(i%d), .Z(x%d) );\n", i,
+                          i % 6, (i / 6) % 6, i);
+    absl::StrAppendFormat(&module_text,
+                          "  NAND nand%d ( .A(x%d), .B(i%d), .ZN(y%d) );\n", i,
+                          i, (i + 1) % 6, i);
+  }
+  // Fold the second level into a single output.
+  absl::StrAppend(&module_text, "  assign acc[0] = 1'b0;\n");
+  for (int64_t i = 0; i < kWidth; ++i) {
+    absl::StrAppendFormat(
+        &module_text, "  XOR fold%d ( .A(acc[%d]), .B(y%d), .Z(acc[%d]) );\n",
+        i, i, i, i + 1);
+  }
+  absl::StrAppendFormat(&module_text, "  assign o0 = acc[%d];\nendmodule\n",
+                        kWidth);
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto serial, CompiledInterpreter::Create(netlist.get(), module, false,
+                                               true, /*num_threads=*/0));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto parallel, CompiledInterpreter::Create(netlist.get(), module, false,
+                                                 true, /*num_threads=*/4));
+  for (int64_t value = 0; value < 64; ++value) {
+    std::vector<bool> inputs;
+    for (int64_t i = 0; i < 6; ++i) {
+      inputs.push_back((value >> i) & 1);
+    }
+    std::vector<bool> expected = {false};
+    for (int64_t i = 0; i < kWidth; ++i) {
+      bool x = inputs[i % 6] ^ inputs[(i / 6) % 6];
+      bool y = !(x && inputs[(i + 1) % 6]);
+      expected[0] = expected[0] ^ y;
+    }
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<bool> serial_outputs,
+                             serial->Run(inputs));
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<bool> parallel_outputs,
+                             parallel->Run(inputs));
+    EXPECT_EQ(serial_outputs, expected);
+    EXPECT_EQ(parallel_outputs, expected);
+  }
+
+  // Concurrent runs of the same interpreter, only one of which at a time gets
+  // the worker threads, agree with the serial interpreter.
+  std::vector<std::vector<bool>> inputs(8);
+  std::vector<absl::StatusOr<std::vector<bool>>> outputs(inputs.size());
+  std::vector<std::unique_ptr<xls::Thread>> threads;
+  for (int64_t t = 0; t < inputs.size(); ++t) {
+    for (int64_t i = 0; i < 6; ++i) {
+      inputs[t].push_back((t >> (i % 3)) & 1);
+    }
+    threads.push_back(std::make_unique<xls::Thread>(
+        [&, t]() { outputs[t] = parallel->Run(inputs[t]); }));
+  }
+  for (int64_t t = 0; t < inputs.size(); ++t) {
+    threads[t]->Join();
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<bool> expected,
+                             serial->Run(inputs[t]));
+    EXPECT_THAT(outputs[t], IsOkAndHolds(expected));
+  }
+}
+
+TEST(CompiledInterpreterTest, RejectsCombinationalLoops) {
+  std::string module_text = R"(
+module main (i0, o0);
+  input i0;
+  output o0;
+  wire x, y;
+
+  AND and0 ( .A(i0), .B(y), .Z(x) );
+  AND and1 ( .A(x), .B(i0), .Z(y) );
+  assign o0 = x;
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  EXPECT_THAT(CompiledInterpreter::Create(netlist.get(), module).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("combinational loop")));
+}
+
+TEST(CompiledInterpreterTest, MissingInput) {
+  std::string module_text = R"(
+module main (i0, i1, o0);
+  input i0, i1;
+  output o0;
+
+  AND and0 ( .A(i0), .B(i1), .Z(o0) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto compiled,
+                           CompiledInterpreter::Create(netlist.get(), module));
+  NetRef2Value inputs;
+  inputs[module->inputs()[0]] = true;
+  EXPECT_THAT(compiled->InterpretModule(inputs).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("No value given for input i1")));
+}
+
+}  // namespace
+}  // namespace netlist
+}  // namespace xls
@@ -18,6 +18,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -277,10 +278,12 @@ absl::Status ExtractFromCell(const cell_lib::Block& cell,
 absl::StatusOr<CellLibraryProto> ExtractFunctions(
     cell_lib::CharStream* stream) {
   cell_lib::Scanner scanner(stream);
+  // Only these block kinds are read below; everything else (timing and power
+  // tables, which make up most of a real library) is skipped unbuilt.
   absl::flat_hash_set<std::string> kind_allowlist(
       {"library", "cell", "pin", "direction", "function", "ff", "next_state",
        "statetable"});
-  cell_lib::Parser parser(&scanner);
+  cell_lib::Parser parser(&scanner, std::move(kind_allowlist));
 
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<cell_lib::Block> block,
                        parser.ParseLibrary());
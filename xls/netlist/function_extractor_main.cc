@@ -41,11 +41,9 @@ namespace xls::netlist::function {
 static absl::Status RealMain(const std::string& cell_library_path,
                              const std::string& output_path,
                              bool output_textproto) {
-  XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
-                       GetFileContents(cell_library_path));
   XLS_ASSIGN_OR_RETURN(
       auto char_stream,
-      netlist::cell_lib::CharStream::FromText(cell_library_text));
+      netlist::cell_lib::CharStream::FromPath(cell_library_path));
   XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
                        netlist::function::ExtractFunctions(&char_stream));
 
@@ -14,7 +14,7 @@
 
 #include "xls/netlist/lib_parser.h"
 
-#include <fstream>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,6 +24,7 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/logging/logging.h"
 
 namespace xls {
@@ -32,16 +33,16 @@ namespace cell_lib {
 
 /* static */ absl::StatusOr<CharStream> CharStream::FromPath(
     std::string_view path) {
-  std::ifstream file_stream{std::string(path)};
-  if (file_stream.is_open()) {
-    return CharStream(std::move(file_stream));
+  absl::StatusOr<MappedFile> file = MappedFile::Open(path);
+  if (!file.ok()) {
+    return absl::NotFoundError(absl::StrCat(
+        "Could not open file at path: ", path, ": ", file.status().message()));
   }
-  return absl::NotFoundError(
-      absl::StrCat("Could not open file at path: ", path));
+  return CharStream(std::make_unique<MappedFile>(*std::move(file)));
 }
 
 /* static */ absl::StatusOr<CharStream> CharStream::FromText(std::string text) {
-  return CharStream(std::move(text));
+  return CharStream(std::make_unique<std::string>(std::move(text)));
 }
 
 std::string TokenKindToString(TokenKind kind) {
@@ -72,53 +73,48 @@ std::string TokenKindToString(TokenKind kind) {
 
 absl::StatusOr<Token> Scanner::ScanIdentifier() {
   const Pos start_pos = cs_->GetPos();
+  const int64_t start_offset = cs_->offset();
   XLS_CHECK(IsIdentifierStart(cs_->PeekCharOrDie()));
-  absl::InlinedVector<char, 16> chars;
   while (!cs_->AtEof() && IsIdentifierRest(cs_->PeekCharOrDie())) {
-    chars.push_back(cs_->PopCharOrDie());
+    cs_->DropCharOrDie();
   }
-  return Token::Identifier(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  return Token::Identifier(start_pos, cs_->TextFrom(start_offset));
 }
 
 // Scans a number token.
 absl::StatusOr<Token> Scanner::ScanNumber() {
   const Pos start_pos = cs_->GetPos();
+  const int64_t start_offset = cs_->offset();
   XLS_CHECK(std::isdigit(cs_->PeekCharOrDie()) != 0);
-  absl::InlinedVector<char, 16> chars;
   while (!cs_->AtEof()) {
     if (IsNumberRest(cs_->PeekCharOrDie())) {
-      chars.push_back(cs_->PopCharOrDie());
-    } else if (cs_->TryDropChars('e', '-')) {
-      chars.push_back('e');
-      chars.push_back('-');
-    } else {
+      cs_->DropCharOrDie();
+    } else if (!cs_->TryDropChars('e', '-')) {
       break;
     }
   }
-  return Token::Number(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  return Token::Number(start_pos, cs_->TextFrom(start_offset));
 }
 
 // Scans a string token.
 absl::StatusOr<Token> Scanner::ScanQuotedString() {
   const Pos start_pos = cs_->GetPos();
   XLS_CHECK(cs_->TryDropChar('"'));
-  absl::InlinedVector<char, 16> chars;
+  const int64_t start_offset = cs_->offset();
   while (true) {
     if (cs_->AtEof()) {
       return absl::InvalidArgumentError(
           "Unexpected end-of-file in string token starting @ " +
           start_pos.ToHumanString());
     }
-    char c = cs_->PopCharOrDie();
-    if (c == '"') {
+    if (cs_->PeekCharOrDie() == '"') {
       break;
     }
-    chars.push_back(c);
+    cs_->DropCharOrDie();
   }
-  return Token::QuotedString(
-      start_pos, std::string(std::string_view(chars.data(), chars.size())));
+  std::string_view contents = cs_->TextFrom(start_offset);
+  cs_->DropCharOrDie();
+  return Token::QuotedString(start_pos, contents);
 }
 
 absl::Status Scanner::PeekInternal() {
@@ -382,14 +378,35 @@ absl::StatusOr<std::unique_ptr<Block>> Parser::ParseBlock(
     }
   }
 
-  XLS_ASSIGN_OR_RETURN(block->entries, ParseEntries());
   if (!kind_allowed) {
-    // Save memory on disallowed blocks by clearing out its entries.
-    block->entries.clear();
+    // Disallowed blocks (e.g. timing tables) can make up most of a library, so
+    // don't build their entries at all.
+    XLS_RETURN_IF_ERROR(SkipEntries());
+    return block;
   }
+  XLS_ASSIGN_OR_RETURN(block->entries, ParseEntries());
   return block;
 }
 
+absl::Status Parser::SkipEntries() {
+  XLS_RETURN_IF_ERROR(DropTokenOrError(TokenKind::kOpenCurl));
+  int64_t depth = 1;
+  while (depth > 0) {
+    if (scanner_->AtEof()) {
+      return absl::InvalidArgumentError(
+          "Unexpected end-of-file in block ending @ " +
+          scanner_->GetPos().ToHumanString());
+    }
+    XLS_ASSIGN_OR_RETURN(Token t, scanner_->Pop());
+    if (t.kind() == TokenKind::kOpenCurl) {
+      ++depth;
+    } else if (t.kind() == TokenKind::kCloseCurl) {
+      --depth;
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace cell_lib
 }  // namespace netlist
 }  // namespace xls
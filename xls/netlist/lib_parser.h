@@ -15,13 +15,15 @@
 // Infrastructure for parsing ".lib" files (cell libraries).
 //
 // Note that these files can be quite large (on the order of gigabytes) so we
-// performance optimize this a bit.
+// performance optimize this a bit: files are memory-mapped, tokens are views
+// into the file text, and the parser can skip block kinds it is not asked for
+// without building them.
 
 #ifndef XLS_NETLIST_LIB_PARSER_H_
 #define XLS_NETLIST_LIB_PARSER_H_
 
 #include <cctype>
-#include <fstream>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -31,9 +33,11 @@
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 
@@ -53,31 +57,19 @@ struct Pos {
 
 // Wraps a file as a character stream with a 1- or 2-character lookahead
 // interface.
+//
+// The whole text is always addressable, so tokens can refer to it without
+// copying; files are memory-mapped rather than read into memory.
 class CharStream {
  public:
   static absl::StatusOr<CharStream> FromPath(std::string_view path);
   static absl::StatusOr<CharStream> FromText(std::string text);
 
-  ~CharStream() {
-    if (if_.has_value()) {
-      if_->close();
-    }
-  }
-
   CharStream(CharStream&& other) = default;
 
   Pos GetPos() const { return pos_; }
-  bool AtEof() const {
-    if (if_.has_value()) {
-      return if_->eof();
-    }
-    return cursor_ >= text_.size();
-  }
+  bool AtEof() const { return cursor_ >= text_.size(); }
   char PeekCharOrDie() {
-    if (if_.has_value()) {
-      XLS_DCHECK(!if_->eof());
-      return if_->peek();
-    }
     XLS_DCHECK_LT(cursor_, text_.size());
     return text_[cursor_];
   }
@@ -114,10 +106,20 @@ class CharStream {
     return false;
   }
 
+  // Offset of the next character in the text.
+  int64_t offset() const { return cursor_; }
+
+  // Returns the text from "start_offset" up to (but not including) the next
+  // character. The view is valid for the lifetime of the stream.
+  std::string_view TextFrom(int64_t start_offset) const {
+    return text_.substr(start_offset, cursor_ - start_offset);
+  }
+
  private:
-  explicit CharStream(std::ifstream file_stream)
-      : if_(std::move(file_stream)) {}
-  explicit CharStream(std::string text) : text_(std::move(text)) {}
+  explicit CharStream(std::unique_ptr<MappedFile> file)
+      : file_(std::move(file)), text_(file_->contents()) {}
+  explicit CharStream(std::unique_ptr<std::string> text)
+      : owned_text_(std::move(text)), text_(*owned_text_) {}
 
   void Unget(char c) {
     cursor_--;
@@ -127,9 +129,6 @@ class CharStream {
     } else {
       pos_.colno--;
     }
-    if (if_.has_value()) {
-      if_->unget();
-    }
   }
 
   void BumpPos(char c) {
@@ -145,13 +144,12 @@ class CharStream {
 
   Pos pos_ = {0, 0};
 
-  // We have both ifstream mode and text mode data, we store both inline.
+  // Exactly one of these owns the text; they are heap-allocated so that text_
+  // stays valid when the stream is moved.
+  std::unique_ptr<MappedFile> file_;
+  std::unique_ptr<std::string> owned_text_;
 
-  // ifstream mode
-  std::optional<std::ifstream> if_;
-
-  // text mode
-  std::string text_;
+  std::string_view text_;
   int64_t cursor_ = 0;
   int64_t last_colno_ = 0;
 };
@@ -172,32 +170,35 @@ enum class TokenKind {
 std::string TokenKindToString(TokenKind kind);
 
 // Represents a token in the file's token stream.
+//
+// Payloads refer into the CharStream's text, so tokens must not outlive the
+// stream they were scanned from.
 class Token {
  public:
-  static Token Identifier(Pos pos, std::string s) {
+  static Token Identifier(Pos pos, std::string_view s) {
     return Token(TokenKind::kIdentifier, pos, s);
   }
-  static Token QuotedString(Pos pos, std::string s) {
+  static Token QuotedString(Pos pos, std::string_view s) {
     return Token(TokenKind::kQuotedString, pos, s);
   }
-  static Token Number(Pos pos, std::string s) {
+  static Token Number(Pos pos, std::string_view s) {
     return Token(TokenKind::kNumber, pos, s);
   }
   static Token Simple(Pos pos, TokenKind kind) { return Token(kind, pos); }
 
   Token(TokenKind kind, Pos pos,
-        std::optional<std::string> payload = std::nullopt)
+        std::optional<std::string_view> payload = std::nullopt)
       : kind_(kind), pos_(pos), payload_(payload) {}
 
   TokenKind kind() const { return kind_; }
   const Pos& pos() const { return pos_; }
   std::string_view payload() const { return payload_.value(); }
-  std::string PopPayload() { return std::move(payload_.value()); }
+  std::string PopPayload() { return std::string(payload_.value()); }
 
  private:
   TokenKind kind_;
   Pos pos_;
-  std::optional<std::string> payload_;
+  std::optional<std::string_view> payload_;
 };
 
 // Converts a stream of characters to a stream of tokens.
@@ -388,6 +389,10 @@ class Parser {
   absl::StatusOr<absl::InlinedVector<std::string, 4>> ParseValues(
       Pos* end_pos = nullptr);
 
+  // Skips over a curly-brace-delimited block body without building any of its
+  // entries.
+  absl::Status SkipEntries();
+
   // Parses a block per the grammar above.
   //
   // If the identifier is provided by the caller it is not scanned out of the
@@ -397,9 +402,9 @@ class Parser {
   Scanner* scanner_;
 
   // Optional allowlist of keys (including block kinds) that we're interested in
-  // keeping in the result data structure. "Denied" (non-allowed) block kinds
-  // are still parsed properly, but then may have incomplete data (or not be
-  // present at all) in the resulting data structure.
+  // keeping in the result data structure. "Denied" (non-allowed) blocks are
+  // present in the result with their kind and arguments, but their bodies are
+  // only checked for balanced braces and are never built.
   //
   // This is very useful for minimizing memory usage when we're interested in
   // just a subset of particular fields, e.g. as part of a query.
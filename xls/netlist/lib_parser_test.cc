@@ -14,14 +14,21 @@
 
 #include "xls/netlist/lib_parser.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/temp_file.h"
 #include "xls/common/status/matchers.h"
 
 namespace xls {
@@ -29,6 +36,9 @@ namespace netlist {
 namespace cell_lib {
 namespace {
 
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
 TEST(LibParserTest, ScanSimple) {
   std::string text = "{}()";
   XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromText(text));
@@ -162,6 +172,122 @@ library (foo) {
             "))");
 }
 
+// Disallowed blocks are skipped without being built, including anything
+// nested in them.
+TEST(LibParserTest, AllowlistSkipsNestedBlocks) {
+  std::string text = R"(
+library (foo) {
+  cell (and2) {
+    pin (Z) {
+      function : "A*B";
+      timing () {
+        related_pin : "A";
+        cell_rise (delay_template) {
+          index_1 ("0.1, 0.2");
+          values ("1.0, 2.0", \
+                  "{3.0}, 4.0");
+        }
+      }
+    }
+  }
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Block> library,
+      Parse(text, absl::flat_hash_set<std::string>{"library", "cell", "pin"}));
+  EXPECT_EQ(library->ToString(),
+            "(block library (foo) ("
+            "(block cell (and2) ("
+            "(block pin (Z) ((function \"A*B\") (block timing () ())))"
+            ")))");
+}
+
+TEST(LibParserTest, AllowlistSkipReportsUnterminatedBlock) {
+  std::string text = R"(
+library (foo) {
+  cell (and2) {
+    timing () {
+      related_pin : "A";
+)";
+  EXPECT_THAT(
+      Parse(text, absl::flat_hash_set<std::string>{"library", "cell"}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Unexpected end-of-file")));
+}
+
+TEST(LibParserTest, FromPath) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TempFile file,
+      TempFile::CreateWithContent("library (foo) { key: value; }", ".lib"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromPath(file.path().string()));
+  Scanner scanner(&cs);
+  Parser parser(&scanner);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Block> library,
+                           parser.ParseLibrary());
+  EXPECT_EQ(library->ToString(),
+            "(block library (foo) ((key \"value\")))");
+
+  EXPECT_THAT(CharStream::FromPath("/does/not/exist.lib").status(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+// Returns a library of "cell_count" cells shaped like those in real PDKs:
+// a few pins with functions, and timing tables that dominate the text.
+std::string MakeLibraryText(int64_t cell_count) {
+  std::string text = "library (bench) {\n";
+  for (int64_t i = 0; i < cell_count; ++i) {
+    absl::StrAppendFormat(&text, "  cell (cell_%d) {\n", i);
+    absl::StrAppend(&text, "    area : 1.5;\n");
+    absl::StrAppend(&text, "    pin (A) { direction : input; }\n");
+    absl::StrAppend(&text, "    pin (B) { direction : input; }\n");
+    absl::StrAppend(&text, "    pin (Z) {\n      direction : output;\n");
+    absl::StrAppend(&text, "      function : \"(A * B)\";\n");
+    for (const char* related_pin : {"A", "B"}) {
+      absl::StrAppendFormat(&text,
+                            "      timing () {\n"
+                            "        related_pin : \"%s\";\n",
+                            related_pin);
+      for (const char* table : {"cell_rise", "cell_fall", "rise_transition",
+                                "fall_transition"}) {
+        absl::StrAppendFormat(&text, "        %s (delay_template_7x7) {\n",
+                              table);
+        absl::StrAppend(&text,
+                        "          index_1 (\"0.01, 0.02, 0.04, 0.08, 0.16, "
+                        "0.32, 0.64\");\n");
+        absl::StrAppend(&text, "          values ( \\\n");
+        for (int64_t row = 0; row < 7; ++row) {
+          absl::StrAppend(&text,
+                          "            \"0.011, 0.022, 0.033, 0.044, 0.055, "
+                          "0.066, 0.077\"",
+                          row + 1 < 7 ? ", \\\n" : ");\n");
+        }
+        absl::StrAppend(&text, "        }\n");
+      }
+      absl::StrAppend(&text, "      }\n");
+    }
+    absl::StrAppend(&text, "    }\n  }\n");
+  }
+  absl::StrAppend(&text, "}\n");
+  return text;
+}
+
+void BM_ParseLibrary(benchmark::State& state) {
+  std::string text = MakeLibraryText(state.range(0));
+  std::optional<absl::flat_hash_set<std::string>> allowlist;
+  if (state.range(1) != 0) {
+    allowlist = absl::flat_hash_set<std::string>{"library", "cell", "pin"};
+  }
+  for (auto _ : state) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Block> library,
+                             Parse(text, allowlist));
+    benchmark::DoNotOptimize(library);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+// Second argument: whether to skip everything but cells and pins.
+BENCHMARK(BM_ParseLibrary)->ArgsProduct({{16, 256}, {0, 1}});
+
 }  // namespace
 }  // namespace cell_lib
 }  // namespace netlist
@@ -75,10 +75,12 @@ struct Pos {
 };
 
 // Represents a scanned token (that comes from scanning a character stream).
+//
+// The value refers into the scanned text, so tokens must not outlive it.
 struct Token {
   TokenKind kind;
   Pos pos;
-  std::string value;
+  std::string_view value;
 
   std::string ToString() const;
 };
@@ -298,7 +300,7 @@ template <typename EvalT>
 absl::StatusOr<std::string> AbstractParser<EvalT>::PopNameOrError() {
   XLS_ASSIGN_OR_RETURN(Token token, scanner_->Pop());
   if (token.kind == TokenKind::kName) {
-    return token.value;
+    return std::string(token.value);
   }
   return absl::InvalidArgumentError("Expected name token; got: " +
                                     token.ToString());
@@ -346,8 +348,8 @@ absl::StatusOr<int64_t> AbstractParser<EvalT>::PopNumberOrError(size_t& width) {
     int64_t result;
     if (!absl::SimpleAtoi(token.value, &result)) {
       return absl::InternalError(
-          "Number token's value cannot be parsed as an int64_t: " +
-          token.value);
+          absl::StrCat("Number token's value cannot be parsed as an int64_t: ",
+                       token.value));
     }
     // Size field defaults to 32 when not explicitly specified.
     width = 32;
@@ -369,7 +371,7 @@ AbstractParser<EvalT>::PopNameOrNumberOrError(size_t& width) {
   TokenKind kind = scanner_->Peek()->kind;
   if (kind == TokenKind::kName) {
     XLS_ASSIGN_OR_RETURN(Token token, scanner_->Pop());
-    return token.value;
+    return std::string(token.value);
   } else if (kind == TokenKind::kNumber) {
     return PopNumberOrError(width);
   }
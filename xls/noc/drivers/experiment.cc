@@ -19,9 +19,12 @@
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/types/variant.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/global_routing_table.h"
 #include "xls/noc/simulation/network_graph.h"
@@ -132,6 +135,82 @@ absl::Status ExperimentMetrics::DebugDump() const {
   return absl::OkStatus();
 }
 
+ExperimentSweepMetrics ExperimentSweepMetrics::FromSteps(
+    absl::Span<const ExperimentData> steps) {
+  ExperimentSweepMetrics table(steps.size());
+  for (int64_t step = 0; step < steps.size(); ++step) {
+    table.SetStepMetrics(step, steps[step].metrics);
+  }
+  return table;
+}
+
+void ExperimentSweepMetrics::SetStepMetrics(int64_t step,
+                                            const ExperimentMetrics& metrics) {
+  XLS_CHECK(step >= 0 && step < step_count_);
+  for (const auto& [name, value] : metrics.GetIntegerMetrics()) {
+    std::vector<std::optional<int64_t>>& column = integer_columns_[name];
+    column.resize(step_count_);
+    column[step] = value;
+  }
+  for (const auto& [name, value] : metrics.GetFloatMetrics()) {
+    std::vector<std::optional<double>>& column = float_columns_[name];
+    column.resize(step_count_);
+    column[step] = value;
+  }
+}
+
+absl::StatusOr<absl::Span<const std::optional<int64_t>>>
+ExperimentSweepMetrics::GetIntegerColumn(std::string_view metric) const {
+  XLS_RET_CHECK(integer_columns_.contains(metric));
+  return absl::MakeConstSpan(integer_columns_.at(metric));
+}
+
+absl::StatusOr<absl::Span<const std::optional<double>>>
+ExperimentSweepMetrics::GetFloatColumn(std::string_view metric) const {
+  XLS_RET_CHECK(float_columns_.contains(metric));
+  return absl::MakeConstSpan(float_columns_.at(metric));
+}
+
+std::string ExperimentSweepMetrics::ToCsv() const {
+  std::vector<std::string> header = {"step"};
+  for (const auto& [name, column] : integer_columns_) {
+    header.push_back(name);
+  }
+  for (const auto& [name, column] : float_columns_) {
+    header.push_back(name);
+  }
+  std::string csv = absl::StrCat(absl::StrJoin(header, ","), "\n");
+
+  for (int64_t step = 0; step < step_count_; ++step) {
+    std::vector<std::string> row = {absl::StrCat(step)};
+    for (const auto& [name, column] : integer_columns_) {
+      row.push_back(column[step].has_value() ? absl::StrCat(*column[step])
+                                             : "");
+    }
+    for (const auto& [name, column] : float_columns_) {
+      row.push_back(column[step].has_value() ? absl::StrCat(*column[step])
+                                             : "");
+    }
+    absl::StrAppend(&csv, absl::StrJoin(row, ","), "\n");
+  }
+  return csv;
+}
+
+absl::StatusOr<ExperimentSweepData> Experiment::RunSweep(
+    int64_t num_threads) const {
+  ExperimentSweepData sweep_data;
+  sweep_data.steps.resize(GetStepCount());
+  auto run_step = [&](int64_t step) -> absl::Status {
+    XLS_ASSIGN_OR_RETURN(sweep_data.steps[step], RunStep(step),
+                         _ << "Experiment step " << step);
+    return absl::OkStatus();
+  };
+  XLS_RETURN_IF_ERROR(ParallelFor(GetStepCount(), num_threads, run_step));
+
+  sweep_data.metrics = ExperimentSweepMetrics::FromSteps(sweep_data.steps);
+  return sweep_data;
+}
+
 absl::StatusOr<ExperimentData> ExperimentRunner::RunExperiment(
     const ExperimentConfig& experiment_config,
     DistributedRoutingTableBuilderBase&& distributed_routing_table_builder)
@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <limits>
+#include <optional>
 #include <queue>
 #include <string>
 #include <string_view>
@@ -26,6 +27,7 @@
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -141,6 +143,14 @@ class ExperimentMetrics {
     return integer_integer_map_metrics_.at(metric);
   }
 
+  // Returns all integer/floating point metrics, ordered by name.
+  const absl::btree_map<std::string, int64_t>& GetIntegerMetrics() const {
+    return integer_metrics_;
+  }
+  const absl::btree_map<std::string, double>& GetFloatMetrics() const {
+    return float_metrics_;
+  }
+
   // Prints out the metrics and values stored.
   absl::Status DebugDump() const;
 
@@ -213,6 +223,63 @@ struct ExperimentData {
   ExperimentInfo info;
 };
 
+// The integer and floating point metrics of every step of a sweep, stored by
+// column: each metric name maps to a vector indexed by step, holding
+// std::nullopt for the steps that did not record said metric.
+//
+// Integer-integer map metrics are not tabulated; they remain available from
+// the per-step ExperimentMetrics.
+class ExperimentSweepMetrics {
+ public:
+  explicit ExperimentSweepMetrics(int64_t step_count = 0)
+      : step_count_(step_count) {}
+
+  // Builds the table from the data of each step, in step order.
+  static ExperimentSweepMetrics FromSteps(
+      absl::Span<const ExperimentData> steps);
+
+  // Records the metrics of the given step, adding columns as needed.
+  void SetStepMetrics(int64_t step, const ExperimentMetrics& metrics);
+
+  int64_t GetStepCount() const { return step_count_; }
+
+  // Retrieve the column of said metric.
+  absl::StatusOr<absl::Span<const std::optional<int64_t>>> GetIntegerColumn(
+      std::string_view metric) const;
+  absl::StatusOr<absl::Span<const std::optional<double>>> GetFloatColumn(
+      std::string_view metric) const;
+
+  const absl::btree_map<std::string, std::vector<std::optional<int64_t>>>&
+  GetIntegerColumns() const {
+    return integer_columns_;
+  }
+  const absl::btree_map<std::string, std::vector<std::optional<double>>>&
+  GetFloatColumns() const {
+    return float_columns_;
+  }
+
+  // Returns the table as CSV: a header row ("step" followed by the integer
+  // then the floating point metric names) and one row per step. Missing
+  // values are left empty.
+  std::string ToCsv() const;
+
+ private:
+  int64_t step_count_;
+  absl::btree_map<std::string, std::vector<std::optional<int64_t>>>
+      integer_columns_;
+  absl::btree_map<std::string, std::vector<std::optional<double>>>
+      float_columns_;
+};
+
+// The results of running all steps of an experiment.
+struct ExperimentSweepData {
+  // Data of each step, indexed by step.
+  std::vector<ExperimentData> steps;
+
+  // The metrics of all steps, merged by column.
+  ExperimentSweepMetrics metrics;
+};
+
 // Class to setup and run a single step of the experiment,
 // including the setup and initialization of the traffic model.
 class ExperimentRunner {
@@ -291,6 +358,15 @@ class Experiment {
                                 std::move(distributed_routing_table_builder));
   }
 
+  // Run every step of the experiment, with up to num_threads steps
+  // simulated concurrently.
+  //
+  // Steps are independent: each builds its own network, routing tables,
+  // simulator and random number generator (seeded as in RunStep), so the
+  // results are identical to calling RunStep for each step in turn. If any
+  // step fails, the error of the lowest failing step is returned.
+  absl::StatusOr<ExperimentSweepData> RunSweep(int64_t num_threads) const;
+
   // Get the configuration for step N.
   absl::StatusOr<ExperimentConfig> GetConfigForStep(int64_t step) const {
     XLS_RET_CHECK(step >= 0 && step < GetStepCount());
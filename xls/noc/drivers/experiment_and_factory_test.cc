@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
 #include "xls/noc/config/network_config.pb.h"
@@ -212,6 +214,36 @@ TEST(ExperimentsTest, ExperimentMetrics) {
   XLS_EXPECT_OK(metrics.DebugDump());
 }
 
+TEST(ExperimentsTest, ExperimentSweepMetrics) {
+  std::vector<ExperimentData> steps(3);
+  steps[0].metrics.SetIntegerMetric("count", 10);
+  steps[0].metrics.SetFloatMetric("rate", 1.5);
+  steps[1].metrics.SetIntegerMetric("count", 20);
+  steps[2].metrics.SetIntegerMetric("count", 30);
+  steps[2].metrics.SetFloatMetric("rate", 2.5);
+  steps[2].metrics.SetIntegerIntegerMapMetric("histogram", {{1, 1}});
+
+  ExperimentSweepMetrics table = ExperimentSweepMetrics::FromSteps(steps);
+  EXPECT_EQ(table.GetStepCount(), 3);
+  EXPECT_EQ(table.GetIntegerColumns().size(), 1);
+  EXPECT_EQ(table.GetFloatColumns().size(), 1);
+
+  XLS_ASSERT_OK_AND_ASSIGN(absl::Span<const std::optional<int64_t>> count,
+                           table.GetIntegerColumn("count"));
+  EXPECT_THAT(count, ::testing::ElementsAre(10, 20, 30));
+
+  XLS_ASSERT_OK_AND_ASSIGN(absl::Span<const std::optional<double>> rate,
+                           table.GetFloatColumn("rate"));
+  EXPECT_THAT(rate, ::testing::ElementsAre(1.5, std::nullopt, 2.5));
+
+  EXPECT_THAT(table.GetIntegerColumn("rate"),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(table.GetFloatColumn("histogram"),
+              StatusIs(absl::StatusCode::kInternal));
+
+  EXPECT_EQ(table.ToCsv(), "step,count,rate\n0,10,1.5\n1,20,\n2,30,2.5\n");
+}
+
 TEST(ExperimentsTest, ExperimentInfo) {
   ExperimentInfo experiment_info;
   std::vector<TimedRouteInfo> timed_route_info_a_expected;
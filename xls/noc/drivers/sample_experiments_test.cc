@@ -14,14 +14,17 @@
 
 #include "xls/noc/drivers/sample_experiments.h"
 
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
+#include "xls/noc/drivers/experiment.h"
 #include "xls/noc/drivers/experiment_factory.h"
 
 namespace xls::noc {
@@ -215,5 +218,37 @@ TEST(SampleExperimentsTest, AggregateTreeTest) {
   }
 }
 
+TEST(SampleExperimentsTest, SimpleVCExperimentParallelSweep) {
+  ExperimentFactory experiment_factory;
+  XLS_ASSERT_OK(RegisterSampleExperiments(experiment_factory));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Experiment experiment,
+      experiment_factory.BuildExperiment("SimpleVCExperiment"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(ExperimentSweepData sweep_data,
+                           experiment.RunSweep(/*num_threads=*/4));
+  ASSERT_EQ(sweep_data.steps.size(), experiment.GetStepCount());
+  EXPECT_EQ(sweep_data.metrics.GetStepCount(), experiment.GetStepCount());
+
+  // Each step gets its own simulator and random number generator so running
+  // concurrently gives the same results as running serially.
+  for (int64_t i = 0; i < experiment.GetStepCount(); ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(ExperimentData step_data, experiment.RunStep(i));
+    EXPECT_EQ(sweep_data.steps.at(i).metrics.GetFloatMetrics(),
+              step_data.metrics.GetFloatMetrics());
+    EXPECT_EQ(sweep_data.steps.at(i).metrics.GetIntegerMetrics(),
+              step_data.metrics.GetIntegerMetrics());
+
+    XLS_ASSERT_OK_AND_ASSIGN(double traffic_rate,
+                             step_data.metrics.GetFloatMetric(
+                                 "Flow:flow_0:TrafficRateInMiBps"));
+    XLS_ASSERT_OK_AND_ASSIGN(
+        absl::Span<const std::optional<double>> column,
+        sweep_data.metrics.GetFloatColumn("Flow:flow_0:TrafficRateInMiBps"));
+    ASSERT_TRUE(column.at(i).has_value());
+    EXPECT_EQ(*column.at(i), traffic_rate);
+  }
+}
+
 }  // namespace
 }  // namespace xls::noc
@@ -29,7 +29,8 @@ namespace xls {
 namespace sched {
 
 std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
-    FunctionBase* f, absl::Span<Node* const> partitionable_nodes) {
+    FunctionBase* f, absl::Span<Node* const> partitionable_nodes,
+    min_cut::MinCutSolver* solver) {
   if (XLS_VLOG_IS_ON(4)) {
     XLS_VLOG(4) << "Computing min-cut of function " << f->name()
                 << ", partitionable nodes:";
@@ -163,8 +164,13 @@ std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
     }
   }
 
-  min_cut::GraphCut graph_cut =
-      min_cut::MinCutBetweenNodes(graph, source, sink);
+  min_cut::GraphCut graph_cut;
+  if (solver == nullptr) {
+    graph_cut = min_cut::MinCutBetweenNodes(graph, source, sink);
+  } else {
+    solver->SetGraph(graph);
+    graph_cut = solver->Solve(source, sink);
+  }
 
   // Map the mincut graph partition back to the XLS graph.
   std::pair<std::vector<Node*>, std::vector<Node*>> partitions;
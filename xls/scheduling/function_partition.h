@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/types/span.h"
+#include "xls/data_structures/min_cut.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
 
@@ -53,8 +54,12 @@ namespace sched {
 //
 // Returns the two partitions as a std::pair. The first element is the
 // predecessor partition of the dicut (partition A in the example above).
+//
+// If `solver` is given it is used to compute the min cut, reusing the storage
+// it allocated for previous partitions.
 std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
-    FunctionBase* f, absl::Span<Node* const> partitionable_nodes);
+    FunctionBase* f, absl::Span<Node* const> partitionable_nodes,
+    min_cut::MinCutSolver* solver = nullptr);
 
 }  // namespace sched
 }  // namespace xls
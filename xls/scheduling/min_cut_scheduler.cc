@@ -33,6 +33,7 @@
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/data_structures/min_cut.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
 #include "xls/ir/nodes.h"
@@ -50,6 +51,7 @@ namespace {
 // 'cycle + 1'.
 absl::Status SplitAfterCycle(FunctionBase* f, int64_t cycle,
                              const DelayEstimator& delay_estimator,
+                             min_cut::MinCutSolver* solver,
                              sched::ScheduleBounds* bounds) {
   XLS_VLOG(3) << "Splitting after cycle " << cycle;
 
@@ -63,7 +65,7 @@ absl::Status SplitAfterCycle(FunctionBase* f, int64_t cycle,
   }
 
   std::pair<std::vector<Node*>, std::vector<Node*>> partitions =
-      sched::MinCostFunctionPartition(f, partitionable_nodes);
+      sched::MinCostFunctionPartition(f, partitionable_nodes, solver);
 
   // Tighten bounds based on the cut.
   for (Node* node : partitions.first) {
@@ -198,6 +200,8 @@ absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
   // is performed and keep the best one.
   int64_t best_register_count = std::numeric_limits<int64_t>::max();
   std::optional<sched::ScheduleBounds> best_bounds;
+  // Shared by every cut so the min-cut graph storage is only allocated once.
+  min_cut::MinCutSolver solver;
   for (const std::vector<int64_t>& cut_order :
        GetMinCutCycleOrders(pipeline_stages - 1)) {
     XLS_VLOG(3) << absl::StreamFormat("Trying cycle order: {%s}",
@@ -209,7 +213,7 @@ absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
     // node will have a range of exactly one cycle.
     for (int64_t cycle : cut_order) {
       XLS_RETURN_IF_ERROR(
-          SplitAfterCycle(f, cycle, delay_estimator, &trial_bounds));
+          SplitAfterCycle(f, cycle, delay_estimator, &solver, &trial_bounds));
       XLS_RETURN_IF_ERROR(trial_bounds.PropagateLowerBounds());
       XLS_RETURN_IF_ERROR(trial_bounds.PropagateUpperBounds());
     }
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -34,6 +35,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
@@ -92,12 +94,98 @@ bool HasIntersection(const absl::flat_hash_set<T>& lhs,
                      [&bigger](T element) { return bigger.contains(element); });
 }
 
-Z3_lbool RunSolver(Z3_context c, Z3_ast asserted) {
-  Z3_solver solver = solvers::z3::CreateSolver(c, 1);
-  Z3_solver_assert(c, solver, asserted);
-  Z3_lbool satisfiable = Z3_solver_check(c, solver);
-  Z3_solver_dec_ref(c, solver);
-  return satisfiable;
+// A single incremental Z3 solver shared by all of the satisfiability queries
+// made about one function. Each query is guarded by a fresh indicator literal
+// and checked under the assumption that the indicator holds, so the solver
+// keeps whatever it learned about the (shared) translated IR between queries
+// instead of starting from scratch every time.
+class IncrementalSolver {
+ public:
+  // If `deadline` is given, queries made after it has passed return
+  // Z3_L_UNDEF without consulting the solver, and queries made before it are
+  // cut off when it is reached. The per-query resource limit is the global
+  // "rlimit" parameter.
+  IncrementalSolver(Z3_context ctx, std::optional<absl::Time> deadline)
+      : ctx_(ctx),
+        solver_(solvers::z3::CreateSolver(ctx, 1)),
+        deadline_(deadline) {}
+  ~IncrementalSolver() { Z3_solver_dec_ref(ctx_, solver_); }
+
+  IncrementalSolver(const IncrementalSolver&) = delete;
+  IncrementalSolver& operator=(const IncrementalSolver&) = delete;
+
+  // Returns whether `asserted` is satisfiable, or Z3_L_UNDEF if the solver ran
+  // out of resources or time.
+  Z3_lbool Check(Z3_ast asserted) {
+    if (deadline_.has_value()) {
+      absl::Duration remaining = *deadline_ - absl::Now();
+      if (remaining <= absl::ZeroDuration()) {
+        return Z3_L_UNDEF;
+      }
+      SetTimeout(remaining);
+    }
+    Z3_ast indicator =
+        Z3_mk_fresh_const(ctx_, "query", Z3_mk_bool_sort(ctx_));
+    Z3_solver_assert(ctx_, solver_, Z3_mk_implies(ctx_, indicator, asserted));
+    Z3_lbool satisfiable =
+        Z3_solver_check_assumptions(ctx_, solver_, 1, &indicator);
+    // Retire the indicator so that its implication is trivially satisfied in
+    // all later queries.
+    Z3_solver_assert(ctx_, solver_, Z3_mk_not(ctx_, indicator));
+    return satisfiable;
+  }
+
+ private:
+  void SetTimeout(absl::Duration timeout) {
+    Z3_params params = Z3_mk_params(ctx_);
+    Z3_params_inc_ref(ctx_, params);
+    Z3_params_set_uint(
+        ctx_, params, Z3_mk_string_symbol(ctx_, "timeout"),
+        static_cast<unsigned>(std::clamp<int64_t>(
+            absl::ToInt64Milliseconds(timeout), 1,
+            std::numeric_limits<unsigned>::max())));
+    Z3_solver_set_params(ctx_, solver_, params);
+    Z3_params_dec_ref(ctx_, params);
+  }
+
+  Z3_context ctx_;
+  Z3_solver solver_;
+  std::optional<absl::Time> deadline_;
+};
+
+// Assigns every node a representative node that computes the same value
+// structurally: same op, same node-specific data, and operands with the same
+// representatives. Side-effecting nodes (including params and receives) are
+// their own representatives. Structurally identical predicates have identical
+// Z3 translations, so solver results can be shared between them.
+absl::flat_hash_map<Node*, Node*> StructuralRepresentatives(FunctionBase* f) {
+  absl::flat_hash_map<Node*, Node*> representative;
+  representative.reserve(f->node_count());
+  absl::flat_hash_map<std::vector<int64_t>, std::vector<Node*>> buckets;
+  for (Node* node : TopoSort(f)) {
+    if (OpIsSideEffecting(node->op())) {
+      representative[node] = node;
+      continue;
+    }
+    std::vector<int64_t> key = {static_cast<int64_t>(node->op())};
+    for (Node* operand : node->operands()) {
+      key.push_back(representative.at(operand)->id());
+    }
+    std::vector<Node*>& bucket = buckets[key];
+    Node* found = nullptr;
+    for (Node* candidate : bucket) {
+      if (node->IsDefinitelyEqualTo(candidate)) {
+        found = candidate;
+        break;
+      }
+    }
+    if (found == nullptr) {
+      bucket.push_back(node);
+      found = node;
+    }
+    representative[node] = found;
+  }
+  return representative;
 }
 
 // Returns a list of all predicates in a deterministic order, paired with their
@@ -829,11 +917,17 @@ absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f) {
   return absl::OkStatus();
 }
 
-absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
+absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
+                                    std::optional<absl::Duration> time_budget) {
   if (f->IsBlock()) {
     return absl::OkStatus();
   }
 
+  std::optional<absl::Time> deadline;
+  if (time_budget.has_value()) {
+    deadline = absl::Now() + *time_budget;
+  }
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<solvers::z3::IrTranslator> translator,
                        solvers::z3::IrTranslator::CreateAndTranslate(f, true));
 
@@ -841,16 +935,33 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
 
   solvers::z3::ScopedErrorHandler seh(ctx);
 
+  IncrementalSolver solver(ctx, deadline);
+
   std::vector<std::pair<Node*, int64_t>> predicate_nodes = PredicateNodes(p, f);
 
+  // Solver results, keyed by the structural representatives of the predicates
+  // involved so that duplicated predicate logic is only queried once.
+  absl::flat_hash_map<Node*, Node*> representative =
+      StructuralRepresentatives(f);
+  absl::flat_hash_map<Node*, Z3_lbool> always_false_cache;
+  absl::flat_hash_map<std::pair<Node*, Node*>, Z3_lbool> pair_cache;
+  int64_t cache_hits = 0;
+
   // Determine for each predicate whether it is always false using Z3.
   // Dead nodes are mutually exclusive with all other nodes, so this can reduce
   // the runtime  by doing only a linear amount of Z3 calls to remove
   // quadratically many Z3 calls.
   for (const auto& [node, index] : predicate_nodes) {
-    Z3_ast translated = translator->GetTranslation(node);
-    if (RunSolver(ctx, solvers::z3::BitVectorToBoolean(ctx, translated)) ==
-        Z3_L_FALSE) {
+    Node* rep = representative.at(node);
+    auto [it, inserted] = always_false_cache.try_emplace(rep, Z3_L_UNDEF);
+    if (inserted) {
+      Z3_ast translated = translator->GetTranslation(rep);
+      it->second =
+          solver.Check(solvers::z3::BitVectorToBoolean(ctx, translated));
+    } else {
+      ++cache_hits;
+    }
+    if (it->second == Z3_L_FALSE) {
       XLS_VLOG(3) << "Proved that " << node << " is always false";
       // A constant false node is mutually exclusive with all other nodes.
       for (const auto& [other, other_index] : predicate_nodes) {
@@ -905,15 +1016,27 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
         continue;
       }
 
-      Z3_ast z3_a = translator->GetTranslation(node_a);
-      Z3_ast z3_b = translator->GetTranslation(node_b);
-
-      // We try to find out if `a ∧ b` is satisfiable, which is true iff
-      // `a NAND b` is not valid.
-      Z3_ast a_and_b =
-          solvers::z3::BitVectorToBoolean(ctx, Z3_mk_bvand(ctx, z3_a, z3_b));
-
-      Z3_lbool satisfiable = RunSolver(ctx, a_and_b);
+      Node* rep_a = representative.at(node_a);
+      Node* rep_b = representative.at(node_b);
+      if (rep_a->id() > rep_b->id()) {
+        std::swap(rep_a, rep_b);
+      }
+      auto [it, inserted] =
+          pair_cache.try_emplace(std::make_pair(rep_a, rep_b), Z3_L_UNDEF);
+      if (inserted) {
+        Z3_ast z3_a = translator->GetTranslation(rep_a);
+        Z3_ast z3_b = translator->GetTranslation(rep_b);
+
+        // We try to find out if `a ∧ b` is satisfiable, which is true iff
+        // `a NAND b` is not valid.
+        Z3_ast a_and_b =
+            solvers::z3::BitVectorToBoolean(ctx, Z3_mk_bvand(ctx, z3_a, z3_b));
+
+        it->second = solver.Check(a_and_b);
+      } else {
+        ++cache_hits;
+      }
+      Z3_lbool satisfiable = it->second;
 
       if (satisfiable == Z3_L_FALSE) {
         known_true += 1;
@@ -932,6 +1055,7 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
   XLS_VLOG(3) << "known_false = " << known_false;
   XLS_VLOG(3) << "known_true  = " << known_true;
   XLS_VLOG(3) << "unknown     = " << unknown;
+  XLS_VLOG(3) << "cache hits  = " << cache_hits;
 
   XLS_RETURN_IF_ERROR(seh.status());
 
@@ -955,7 +1079,8 @@ absl::StatusOr<bool> MutualExclusionPass::RunOnFunctionBaseInternal(
     }
   }
 
-  // Sets limit on z3 "solver resources", so that the pass doesn't take too long
+  // Sets limit on z3 "solver resources" for each query, so that the pass
+  // doesn't take too long
   const int64_t z3_rlimit =
       options.scheduling_options.mutual_exclusion_z3_rlimit().has_value()
           ? options.scheduling_options.mutual_exclusion_z3_rlimit().value()
@@ -967,7 +1092,8 @@ absl::StatusOr<bool> MutualExclusionPass::RunOnFunctionBaseInternal(
 
   Predicates p;
   XLS_RETURN_IF_ERROR(AddSendReceivePredicates(&p, f));
-  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(&p, f));
+  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(
+      &p, f, options.scheduling_options.mutual_exclusion_time_budget()));
   XLS_ASSIGN_OR_RETURN(std::vector<absl::flat_hash_set<Node*>> merge_classes,
                        ComputeMergeClasses(&p, f, scm));
 
@@ -18,6 +18,7 @@
 #include <optional>
 
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "xls/ir/function.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/scheduling/scheduling_pass.h"
@@ -99,8 +100,13 @@ absl::StatusOr<Node*> AddPredicate(Predicates* p, Node* node, Node* pred);
 absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f);
 
 // Use an SMT solver to populate the given `Predicates*` with information about
-// whether nodes are used in a mutually exclusive way.
-absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f);
+// whether nodes are used in a mutually exclusive way. All queries share one
+// incremental solver, and each is bounded by the global Z3 "rlimit". If
+// `time_budget` is given, pairs not yet decided when it runs out are left
+// unknown (i.e.: not mutually exclusive).
+absl::Status ComputeMutualExclusion(
+    Predicates* p, FunctionBase* f,
+    std::optional<absl::Duration> time_budget = std::nullopt);
 
 // Pass which merges together nodes that are determined to be mutually exclusive
 // via SMT solver analysis.
@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
@@ -25,6 +26,7 @@
 #include "xls/passes/cse_pass.h"
 #include "xls/passes/dce_pass.h"
 #include "xls/passes/optimization_pass.h"
+#include "xls/scheduling/scheduling_options.h"
 
 namespace xls {
 namespace {
@@ -45,18 +47,22 @@ class MutualExclusionPassTest : public IrTestBase {
  protected:
   MutualExclusionPassTest() = default;
 
-  absl::StatusOr<bool> Run(FunctionBase* f) {
+  absl::StatusOr<bool> Run(
+      FunctionBase* f,
+      const SchedulingOptions& scheduling_options = SchedulingOptions()) {
     PassResults results;
     bool changed = false;
     bool subpass_changed;
     {
       SchedulingUnit<FunctionBase*> unit;
       unit.ir = f;
+      SchedulingPassOptions options;
+      options.scheduling_options = scheduling_options;
       SchedulingPassResults scheduling_results;
       XLS_ASSIGN_OR_RETURN(
           subpass_changed,
-          MutualExclusionPass().RunOnFunctionBase(
-              &unit, SchedulingPassOptions(), &scheduling_results));
+          MutualExclusionPass().RunOnFunctionBase(&unit, options,
+                                                  &scheduling_results));
       changed = changed || subpass_changed;
     }
     XLS_ASSIGN_OR_RETURN(
@@ -116,6 +122,61 @@ TEST_F(MutualExclusionPassTest, TwoParallelSends) {
   XLS_EXPECT_OK(VerifyProc(proc, true));
 }
 
+TEST_F(MutualExclusionPassTest, DuplicatedPredicates) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> p, ParsePackage(R"(
+     package test_module
+
+     chan test_channel(
+       bits[32], id=0, kind=streaming, ops=send_only,
+       flow_control=ready_valid, metadata="""""")
+
+     top proc main(__token: token, __state: bits[1], init={0}) {
+       not.1: bits[1] = not(__state)
+       not.2: bits[1] = not(__state)
+       literal.3: bits[32] = literal(value=50)
+       literal.4: bits[32] = literal(value=60)
+       literal.5: bits[32] = literal(value=70)
+       send.6: token = send(__token, literal.3, predicate=__state, channel=test_channel)
+       send.7: token = send(__token, literal.4, predicate=not.1, channel=test_channel)
+       send.8: token = send(__token, literal.5, predicate=not.2, channel=test_channel)
+       after_all.9: token = after_all(send.6, send.7, send.8)
+       next (after_all.9, not.1)
+     }
+  )"));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetTopAsProc());
+  // not.1 and not.2 share solver results; they are not mutually exclusive
+  // with each other, but both are with __state.
+  EXPECT_THAT(Run(proc), IsOkAndHolds(true));
+  EXPECT_EQ(NumberOfOp(proc, Op::kSend), 2);
+  XLS_EXPECT_OK(VerifyProc(proc, true));
+}
+
+TEST_F(MutualExclusionPassTest, ExhaustedTimeBudget) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> p, ParsePackage(R"(
+     package test_module
+
+     chan test_channel(
+       bits[32], id=0, kind=streaming, ops=send_only,
+       flow_control=ready_valid, metadata="""""")
+
+     top proc main(__token: token, __state: bits[1], init={0}) {
+       not.1: bits[1] = not(__state)
+       literal.2: bits[32] = literal(value=50)
+       literal.3: bits[32] = literal(value=60)
+       send.4: token = send(__token, literal.2, predicate=__state, channel=test_channel)
+       send.5: token = send(__token, literal.3, predicate=not.1, channel=test_channel)
+       after_all.6: token = after_all(send.4, send.5)
+       next (after_all.6, not.1)
+     }
+  )"));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetTopAsProc());
+  // With no time to run the solver nothing is proven mutually exclusive.
+  EXPECT_THAT(Run(proc, SchedulingOptions().mutual_exclusion_time_budget(
+                            absl::ZeroDuration())),
+              IsOkAndHolds(false));
+  EXPECT_EQ(NumberOfOp(proc, Op::kSend), 2);
+}
+
 TEST_F(MutualExclusionPassTest, ThreeParallelSends) {
   XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> p, ParsePackage(R"(
      package test_module
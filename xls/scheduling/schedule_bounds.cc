@@ -15,11 +15,18 @@
 #include "xls/scheduling/schedule_bounds.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <numeric>
+#include <queue>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/logging.h"
@@ -35,7 +42,7 @@ ScheduleBounds::ScheduleBounds(FunctionBase* f, int64_t clock_period_ps,
     : clock_period_ps_(clock_period_ps), delay_estimator_(&delay_estimator) {
   auto topo_sort_it = TopoSort(f);
   topo_sort_ = std::vector<Node*>(topo_sort_it.begin(), topo_sort_it.end());
-  Reset();
+  Initialize();
 }
 
 ScheduleBounds::ScheduleBounds(FunctionBase* f, std::vector<Node*> topo_sort,
@@ -44,64 +51,118 @@ ScheduleBounds::ScheduleBounds(FunctionBase* f, std::vector<Node*> topo_sort,
     : topo_sort_(std::move(topo_sort)),
       clock_period_ps_(clock_period_ps),
       delay_estimator_(&delay_estimator) {
+  Initialize();
+}
+
+void ScheduleBounds::Initialize() {
+  topo_index_.reserve(topo_sort_.size());
+  for (int64_t i = 0; i < topo_sort_.size(); ++i) {
+    topo_index_[topo_sort_[i]] = i;
+  }
+  delays_.resize(topo_sort_.size());
   Reset();
 }
 
 void ScheduleBounds::Reset() {
+  int64_t node_count = topo_sort_.size();
+  bounds_.assign(node_count, {0, std::numeric_limits<int64_t>::max()});
+  lb_in_cycle_delay_.assign(node_count, 0);
+  ub_in_cycle_delay_.assign(node_count, 0);
+  lb_dirty_.assign(node_count, true);
+  ub_dirty_.assign(node_count, true);
+  lb_dirty_nodes_.resize(node_count);
+  std::iota(lb_dirty_nodes_.begin(), lb_dirty_nodes_.end(), 0);
+  ub_dirty_nodes_ = lb_dirty_nodes_;
   max_lower_bound_ = 0;
-  min_upper_bound_ = 0;
-  for (Node* node : topo_sort_) {
-    bounds_[node] = {0, std::numeric_limits<int64_t>::max()};
-    max_lower_bound_ = 0;
-    min_upper_bound_ = std::numeric_limits<int64_t>::max();
-  }
+  min_upper_bound_ =
+      node_count == 0 ? 0 : std::numeric_limits<int64_t>::max();
 }
 
 std::string ScheduleBounds::ToString() const {
   std::string out = "Bounds:\n";
-  if (!bounds_.empty()) {
-    for (Node* node : TopoSort(bounds_.begin()->first->function_base())) {
-      if (bounds_.contains(node)) {
-        absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", node->GetName(),
-                              lb(node), ub(node));
-      }
-    }
+  for (int64_t i = 0; i < topo_sort_.size(); ++i) {
+    absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", topo_sort_[i]->GetName(),
+                          bounds_[i].first, bounds_[i].second);
   }
   return out;
 }
 
+absl::StatusOr<int64_t> ScheduleBounds::NodeDelay(int64_t index) {
+  if (!delays_[index].has_value()) {
+    XLS_ASSIGN_OR_RETURN(
+        delays_[index],
+        delay_estimator_->GetOperationDelayInPs(topo_sort_[index]));
+  }
+  return *delays_[index];
+}
+
+namespace {
+
+// A worklist of topological indices which pops the smallest (or, if
+// `kReverse`, the largest) index first and ignores duplicate insertions.
+template <bool kReverse>
+class TopoWorklist {
+ public:
+  void Push(int64_t index) {
+    if (queued_.insert(index).second) {
+      heap_.push(index);
+    }
+  }
+  bool empty() const { return heap_.empty(); }
+  int64_t Pop() {
+    int64_t index = heap_.top();
+    heap_.pop();
+    queued_.erase(index);
+    return index;
+  }
+
+ private:
+  using Compare =
+      std::conditional_t<kReverse, std::less<int64_t>, std::greater<int64_t>>;
+  std::priority_queue<int64_t, std::vector<int64_t>, Compare> heap_;
+  absl::flat_hash_set<int64_t> queued_;
+};
+
+}  // namespace
+
 absl::Status ScheduleBounds::PropagateLowerBounds() {
   XLS_VLOG(4) << "PropagateLowerBounds()";
-  // The delay in picoseconds from the beginning of a cycle to the start of the
-  // node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
-
-  // Compute the lower bound of each node based on the lower bounds of the
-  // operands of the node.
-  for (Node* node : topo_sort_) {
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+  TopoWorklist</*kReverse=*/false> worklist;
+  for (int64_t index : lb_dirty_nodes_) {
+    worklist.Push(index);
+  }
+  lb_dirty_nodes_.clear();
+
+  // Compute the lower bound of each visited node based on the lower bounds of
+  // the operands of the node.
+  while (!worklist.empty()) {
+    int64_t index = worklist.Pop();
+    Node* node = topo_sort_[index];
+    // The delay in picoseconds from the beginning of a cycle to the start of
+    // the node.
+    int64_t node_in_cycle_delay = 0;
     XLS_VLOG(4) << absl::StreamFormat("  %s : original lb=%d", node->GetName(),
                                       lb(node));
     for (Node* operand : node->operands()) {
-      int64_t operand_lb = lb(operand);
-      if (operand_lb < lb(node)) {
+      int64_t operand_index = topo_index_.at(operand);
+      int64_t operand_lb = bounds_[operand_index].first;
+      if (operand_lb < bounds_[index].first) {
         continue;
       }
-      XLS_ASSIGN_OR_RETURN(int64_t operand_delay,
-                           delay_estimator_->GetOperationDelayInPs(operand));
-      if (operand_lb > lb(node)) {
+      XLS_ASSIGN_OR_RETURN(int64_t operand_delay, NodeDelay(operand_index));
+      if (operand_lb > bounds_[index].first) {
         XLS_VLOG(4) << absl::StreamFormat(
             "    tightened lb to %d because of operand %s", operand_lb,
             operand->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeLb(node, operand_lb));
-        node_in_cycle_delay = in_cycle_delay.at(operand) + operand_delay;
+        node_in_cycle_delay = lb_in_cycle_delay_[operand_index] + operand_delay;
         continue;
       }
-      node_in_cycle_delay = std::max(
-          node_in_cycle_delay, in_cycle_delay.at(operand) + operand_delay);
+      node_in_cycle_delay =
+          std::max(node_in_cycle_delay,
+                   lb_in_cycle_delay_[operand_index] + operand_delay);
     }
-    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
-                         delay_estimator_->GetOperationDelayInPs(node));
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay, NodeDelay(index));
     if (node_delay > clock_period_ps_) {
       return absl::ResourceExhaustedError(absl::StrFormat(
           "Node %s has a greater delay (%dps) than the clock period (%dps)",
@@ -114,43 +175,60 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
       XLS_RETURN_IF_ERROR(TightenNodeLb(node, lb(node) + 1));
       node_in_cycle_delay = 0;
     }
+
+    // The users only need to be revisited if the state they depend on changed.
+    bool changed = lb_dirty_[index] ||
+                   node_in_cycle_delay != lb_in_cycle_delay_[index];
+    lb_in_cycle_delay_[index] = node_in_cycle_delay;
+    lb_dirty_[index] = false;
+    if (changed) {
+      for (Node* user : node->users()) {
+        worklist.Push(topo_index_.at(user));
+      }
+    }
   }
+  // Every node tightened during propagation has been visited.
+  lb_dirty_nodes_.clear();
   return absl::OkStatus();
 }
 
 absl::Status ScheduleBounds::PropagateUpperBounds() {
   XLS_VLOG(4) << "PropagateUpperBounds()";
-  // The delay in picoseconds from the end of a cycle to the end of the node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
-
-  // Compute the upper bound of each node based on the upper bounds of the
-  // users of the node.
-  for (auto it = topo_sort_.rbegin(); it != topo_sort_.rend(); ++it) {
-    Node* node = *it;
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+  TopoWorklist</*kReverse=*/true> worklist;
+  for (int64_t index : ub_dirty_nodes_) {
+    worklist.Push(index);
+  }
+  ub_dirty_nodes_.clear();
+
+  // Compute the upper bound of each visited node based on the upper bounds of
+  // the users of the node.
+  while (!worklist.empty()) {
+    int64_t index = worklist.Pop();
+    Node* node = topo_sort_[index];
+    // The delay in picoseconds from the end of a cycle to the end of the node.
+    int64_t node_in_cycle_delay = 0;
     XLS_VLOG(4) << absl::StreamFormat("  %s : original ub=%d", node->GetName(),
                                       ub(node));
     for (Node* user : node->users()) {
-      int64_t user_ub = ub(user);
+      int64_t user_index = topo_index_.at(user);
+      int64_t user_ub = bounds_[user_index].second;
       if (user_ub == std::numeric_limits<int64_t>::max() ||
-          user_ub > ub(node)) {
+          user_ub > bounds_[index].second) {
         continue;
       }
-      XLS_ASSIGN_OR_RETURN(int64_t user_delay,
-                           delay_estimator_->GetOperationDelayInPs(user));
-      if (user_ub < ub(node)) {
+      XLS_ASSIGN_OR_RETURN(int64_t user_delay, NodeDelay(user_index));
+      if (user_ub < bounds_[index].second) {
         XLS_VLOG(4) << absl::StreamFormat(
             "    tightened ub to %d because of user %s", user_ub,
             user->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeUb(node, user_ub));
-        node_in_cycle_delay = in_cycle_delay.at(user) + user_delay;
+        node_in_cycle_delay = ub_in_cycle_delay_[user_index] + user_delay;
         continue;
       }
-      node_in_cycle_delay =
-          std::max(node_in_cycle_delay, in_cycle_delay.at(user) + user_delay);
+      node_in_cycle_delay = std::max(
+          node_in_cycle_delay, ub_in_cycle_delay_[user_index] + user_delay);
     }
-    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
-                         delay_estimator_->GetOperationDelayInPs(node));
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay, NodeDelay(index));
     if (node_delay > clock_period_ps_) {
       return absl::ResourceExhaustedError(absl::StrFormat(
           "Node %s has a greater delay (%dps) than the clock period (%dps)",
@@ -163,7 +241,21 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
       XLS_RETURN_IF_ERROR(TightenNodeUb(node, ub(node) - 1));
       node_in_cycle_delay = 0;
     }
+
+    // The operands only need to be revisited if the state they depend on
+    // changed.
+    bool changed = ub_dirty_[index] ||
+                   node_in_cycle_delay != ub_in_cycle_delay_[index];
+    ub_in_cycle_delay_[index] = node_in_cycle_delay;
+    ub_dirty_[index] = false;
+    if (changed) {
+      for (Node* operand : node->operands()) {
+        worklist.Push(topo_index_.at(operand));
+      }
+    }
   }
+  // Every node tightened during propagation has been visited.
+  ub_dirty_nodes_.clear();
   return absl::OkStatus();
 }
 
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -69,24 +71,28 @@ class ScheduleBounds {
   void Reset();
 
   // Return the lower/upper bound of the given node.
-  int64_t lb(Node* node) const { return bounds_.at(node).first; }
-  int64_t ub(Node* node) const { return bounds_.at(node).second; }
+  int64_t lb(Node* node) const { return bounds(node).first; }
+  int64_t ub(Node* node) const { return bounds(node).second; }
 
   // Return the lower and upper bound as a pair (lower bound is first element).
   const std::pair<int64_t, int64_t>& bounds(Node* node) const {
-    return bounds_.at(node);
+    return bounds_[topo_index_.at(node)];
   }
 
   // Sets the lower bound of the given node to the maximum of its existing value
   // and the given value. Raises a ResourceExhaustedError if the new value
   // results in infeasible bounds (lower bound is greater than upper bound).
   absl::Status TightenNodeLb(Node* node, int64_t value) {
-    if (value > ub(node)) {
+    int64_t index = topo_index_.at(node);
+    if (value > bounds_[index].second) {
       return absl::ResourceExhaustedError(
           absl::StrFormat("Unable to tighten the lower bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).first = std::max(bounds_.at(node).first, value);
+    if (value > bounds_[index].first) {
+      bounds_[index].first = value;
+      MarkDirty(index, lb_dirty_, lb_dirty_nodes_);
+    }
     max_lower_bound_ = std::max(max_lower_bound_, value);
     return absl::OkStatus();
   }
@@ -95,12 +101,16 @@ class ScheduleBounds {
   // and the given value. Raises a ResourceExhaustedError if the new value
   // results in infeasible bounds (lower bound is greater than upper bound).
   absl::Status TightenNodeUb(Node* node, int64_t value) {
-    if (value < lb(node)) {
+    int64_t index = topo_index_.at(node);
+    if (value < bounds_[index].first) {
       return absl::ResourceExhaustedError(
           absl::StrFormat("Unable to tighten the upper bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).second = std::min(bounds_.at(node).second, value);
+    if (value < bounds_[index].second) {
+      bounds_[index].second = value;
+      MarkDirty(index, ub_dirty_, ub_dirty_nodes_);
+    }
     min_upper_bound_ = std::min(min_upper_bound_, value);
     return absl::OkStatus();
   }
@@ -117,18 +127,61 @@ class ScheduleBounds {
   // throughout the graph. This method only tightens bounds (increases lower
   // bounds and decreases upper bounds). Returns an error if propagation results
   // in infeasible bounds (lower bound is greater than upper bound for a node).
+  //
+  // Propagation is incremental: only the nodes whose bounds were tightened
+  // since the previous propagation in the same direction, and the nodes
+  // downstream (upstream) of them whose bounds or in-cycle delays actually
+  // change, are visited. Nodes are visited from a worklist ordered by
+  // topological index so each node is processed at most once per call. The
+  // first propagation after construction or Reset() visits every node.
   absl::Status PropagateLowerBounds();
   absl::Status PropagateUpperBounds();
 
  private:
+  // Builds the topological index and resets all bounds. Called from the
+  // constructors.
+  void Initialize();
+
+  static void MarkDirty(int64_t index, std::vector<bool>& dirty,
+                        std::vector<int64_t>& dirty_nodes) {
+    if (!dirty[index]) {
+      dirty[index] = true;
+      dirty_nodes.push_back(index);
+    }
+  }
+
+  // Returns the delay of the node at the given topological index. Delays are
+  // computed once and memoized.
+  absl::StatusOr<int64_t> NodeDelay(int64_t index);
+
   // A topological sort of the nodes in the function.
   std::vector<Node*> topo_sort_;
 
+  // The index of each node in `topo_sort_`. All of the per-node state below is
+  // indexed by this value.
+  absl::flat_hash_map<Node*, int64_t> topo_index_;
+
   int64_t clock_period_ps_;
   const DelayEstimator* delay_estimator_;
 
   // The bounds of each node stored as a {lower, upper} pair.
-  absl::flat_hash_map<Node*, std::pair<int64_t, int64_t>> bounds_;
+  std::vector<std::pair<int64_t, int64_t>> bounds_;
+
+  // The delay of each node, if it has been computed.
+  std::vector<std::optional<int64_t>> delays_;
+
+  // The delay in picoseconds from the beginning of the node's lower-bound
+  // cycle to the start of the node, and from the end of the node to the end of
+  // the node's upper-bound cycle, as of the last propagation.
+  std::vector<int64_t> lb_in_cycle_delay_;
+  std::vector<int64_t> ub_in_cycle_delay_;
+
+  // Nodes whose lower (upper) bound has been tightened since they were last
+  // visited by PropagateLowerBounds (PropagateUpperBounds).
+  std::vector<bool> lb_dirty_;
+  std::vector<int64_t> lb_dirty_nodes_;
+  std::vector<bool> ub_dirty_;
+  std::vector<int64_t> ub_dirty_nodes_;
 
   int64_t max_lower_bound_;
   int64_t min_upper_bound_;
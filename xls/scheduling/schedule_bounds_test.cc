@@ -14,7 +14,10 @@
 
 #include "xls/scheduling/schedule_bounds.h"
 
+#include <cstdint>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -164,6 +167,79 @@ TEST_F(ScheduleBoundsTest, SimpleExpressionTightenBounds) {
   EXPECT_EQ(bounds.lb(result.node()), 23);
 }
 
+TEST_F(ScheduleBoundsTest, IncrementalPropagationMatchesFullPropagation) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  // Build a lattice of adds so tightening a node affects some but not all of
+  // the other nodes.
+  std::vector<BValue> layer = {fb.Param("x", p->GetBitsType(32)),
+                               fb.Param("y", p->GetBitsType(32)),
+                               fb.Param("z", p->GetBitsType(32))};
+  for (int64_t i = 0; i < 6; ++i) {
+    std::vector<BValue> next;
+    for (int64_t j = 0; j < layer.size(); ++j) {
+      next.push_back(fb.Add(layer[j], layer[(j + 1) % layer.size()]));
+    }
+    layer = std::move(next);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  std::vector<Node*> nodes(f->nodes().begin(), f->nodes().end());
+
+  // Tighten bounds one node at a time, propagating after each, and check the
+  // result against a single full propagation of all the tightenings.
+  ScheduleBounds incremental(f, /*clock_period_ps=*/2, delay_estimator_);
+  XLS_ASSERT_OK(incremental.PropagateLowerBounds());
+  std::vector<std::pair<Node*, int64_t>> lb_tightenings;
+  for (int64_t i = 0; i < nodes.size(); i += 5) {
+    lb_tightenings.push_back({nodes[i], i / 3});
+    XLS_ASSERT_OK(incremental.TightenNodeLb(nodes[i], i / 3));
+    XLS_ASSERT_OK(incremental.PropagateLowerBounds());
+  }
+  std::vector<std::pair<Node*, int64_t>> ub_tightenings;
+  for (int64_t i = nodes.size() - 1; i >= 0; i -= 7) {
+    int64_t value = incremental.lb(nodes[i]) + 20;
+    ub_tightenings.push_back({nodes[i], value});
+    XLS_ASSERT_OK(incremental.TightenNodeUb(nodes[i], value));
+    XLS_ASSERT_OK(incremental.PropagateUpperBounds());
+  }
+
+  ScheduleBounds full(f, /*clock_period_ps=*/2, delay_estimator_);
+  for (const auto& [node, value] : lb_tightenings) {
+    XLS_ASSERT_OK(full.TightenNodeLb(node, value));
+  }
+  XLS_ASSERT_OK(full.PropagateLowerBounds());
+  for (const auto& [node, value] : ub_tightenings) {
+    XLS_ASSERT_OK(full.TightenNodeUb(node, value));
+  }
+  XLS_ASSERT_OK(full.PropagateUpperBounds());
+
+  for (Node* node : nodes) {
+    EXPECT_EQ(incremental.bounds(node), full.bounds(node)) << node->GetName();
+  }
+  EXPECT_EQ(incremental.max_lower_bound(), full.max_lower_bound());
+  EXPECT_EQ(incremental.min_upper_bound(), full.min_upper_bound());
+}
+
+TEST_F(ScheduleBoundsTest, ResetRepropagatesEverything) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto not_x = fb.Not(x);
+  auto not_not_x = fb.Not(not_x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  ScheduleBounds bounds(f, /*clock_period_ps=*/1, delay_estimator_);
+  XLS_ASSERT_OK(bounds.TightenNodeLb(not_x.node(), 5));
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 6);
+
+  bounds.Reset();
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 0);
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+  EXPECT_EQ(bounds.lb(not_x.node()), 0);
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 1);
+}
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
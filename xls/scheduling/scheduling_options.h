@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/ir/node.h"
@@ -359,6 +360,17 @@ class SchedulingOptions {
     return mutual_exclusion_z3_rlimit_;
   }
 
+  // The total time allowed for the solver queries of mutual exclusion analysis
+  // on one function; pairs left undecided are treated as not mutually
+  // exclusive.
+  SchedulingOptions& mutual_exclusion_time_budget(absl::Duration value) {
+    mutual_exclusion_time_budget_ = value;
+    return *this;
+  }
+  std::optional<absl::Duration> mutual_exclusion_time_budget() const {
+    return mutual_exclusion_time_budget_;
+  }
+
   // Struct that configures what should be done when scheduling fails. The
   // scheduling problem can be reformulated to give actionable feedback on how
   // to get a feasible schedule.
@@ -475,6 +487,7 @@ class SchedulingOptions {
   std::vector<SchedulingConstraint> constraints_;
   std::optional<int32_t> seed_;
   std::optional<int64_t> mutual_exclusion_z3_rlimit_;
+  std::optional<absl::Duration> mutual_exclusion_time_budget_;
   SchedulingFailureBehavior failure_behavior_;
   bool use_fdo_;
   int64_t fdo_iteration_number_;
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -25,6 +26,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -40,6 +42,8 @@
 #include "xls/ir/value.h"
 #include "xls/simulation/module_testbench.h"
 #include "xls/simulation/module_testbench_thread.h"
+#include "xls/simulation/testbench_signal_capture.h"
+#include "xls/simulation/testbench_stream.h"
 #include "xls/tools/eval_helpers.h"
 
 namespace xls {
@@ -487,6 +491,184 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
   return outputs;
 }
 
+absl::StatusOr<std::vector<ModuleSimulator::BitsMap>>
+ModuleSimulator::RunBatchedStreaming(absl::Span<const BitsMap> inputs) const {
+  XLS_VLOG(1) << "Running Verilog module with streaming IO with signature:\n"
+              << signature_.ToString();
+  XLS_VLOG(2) << "Verilog:\n" << verilog_text_;
+
+  if (inputs.empty()) {
+    return std::vector<BitsMap>();
+  }
+
+  for (auto& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+  }
+
+  if (!signature_.proto().has_clock_name() &&
+      !signature_.proto().has_combinational()) {
+    return absl::InvalidArgumentError("Expected clock in signature");
+  }
+
+  // The number of cycles spent on each input, and the number of cycles after
+  // an input is driven before its outputs are captured by a separate capture
+  // thread (pipelined interfaces only).
+  int64_t cycles_per_input;
+  int64_t capture_delay = 0;
+  if (signature_.proto().has_fixed_latency()) {
+    cycles_per_input = signature_.proto().fixed_latency().latency() + 1;
+  } else if (signature_.proto().has_pipeline()) {
+    cycles_per_input = 1;
+    capture_delay = signature_.proto().pipeline().latency();
+  } else if (signature_.proto().has_combinational()) {
+    cycles_per_input = 1;
+  } else {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported interface: ", signature_.proto().interface_oneof_case()));
+  }
+
+  const int64_t input_count = inputs.size();
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<ModuleTestbench> tb,
+      ModuleTestbench::CreateFromVerilogText(
+          verilog_text_, file_type_, signature_, simulator_,
+          /*reset_dut=*/true, includes_,
+          /*simulation_cycle_limit=*/input_count * cycles_per_input +
+              capture_delay + kDefaultSimulationCycleLimit));
+
+  // One stream per data port.
+  absl::flat_hash_map<std::string, const TestbenchStream*> input_streams;
+  for (const PortProto& input : signature_.data_inputs()) {
+    XLS_ASSIGN_OR_RETURN(
+        input_streams[input.name()],
+        tb->CreateInputStream(absl::StrCat("in_", input.name()),
+                              input.width()));
+  }
+  absl::flat_hash_map<std::string, const TestbenchStream*> output_streams;
+  for (const PortProto& output : signature_.data_outputs()) {
+    XLS_ASSIGN_OR_RETURN(
+        output_streams[output.name()],
+        tb->CreateOutputStream(absl::StrCat("out_", output.name()),
+                               output.width()));
+  }
+  auto drive_data = [&](SequentialBlock& block) {
+    for (const PortProto& input : signature_.data_inputs()) {
+      block.ReadFromStreamAndSet(input.name(), input_streams.at(input.name()));
+    }
+  };
+  auto capture_outputs = [&](EndOfCycleEvent& event) {
+    for (const PortProto& output : signature_.data_outputs()) {
+      event.CaptureAndWriteToStream(output.name(),
+                                    output_streams.at(output.name()));
+    }
+  };
+
+  // Drive any control signals to an unasserted state so the all control inputs
+  // are non-X when the device comes out of reset.
+  std::vector<DutInput> dut_inputs = DeassertControlSignals();
+  for (const PortProto& input : signature_.data_inputs()) {
+    dut_inputs.push_back(DutInput{input.name(), IsX()});
+  }
+  XLS_ASSIGN_OR_RETURN(ModuleTestbenchThread * tbt,
+                       tb->CreateThread("input driver", dut_inputs));
+  SequentialBlock& seq_block = tbt->MainBlock();
+
+  if (signature_.proto().has_fixed_latency()) {
+    SequentialBlock& loop = seq_block.Repeat(input_count);
+    drive_data(loop);
+    loop.AdvanceNCycles(signature_.proto().fixed_latency().latency());
+    capture_outputs(loop.AtEndOfCycle());
+    // The input data cannot be changed in the same cycle that the output is
+    // being read so hold for one more cycle while output is read.
+    loop.NextCycle();
+  } else if (signature_.proto().has_pipeline()) {
+    std::optional<PipelineControl> pipeline_control;
+    if (signature_.proto().pipeline().has_pipeline_control()) {
+      pipeline_control = signature_.proto().pipeline().pipeline_control();
+    }
+    if (pipeline_control.has_value() && pipeline_control->has_manual()) {
+      // Drive the pipeline register load-enable signals high.
+      seq_block.Set(pipeline_control->manual().input_name(),
+                    Bits::AllOnes(capture_delay));
+    }
+    if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+      seq_block.Set(pipeline_control->valid().input_name(), 1);
+    }
+    SequentialBlock& loop = seq_block.Repeat(input_count);
+    drive_data(loop);
+    loop.NextCycle();
+    for (const PortProto& input : signature_.data_inputs()) {
+      seq_block.SetX(input.name());
+    }
+    if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+      seq_block.Set(pipeline_control->valid().input_name(), 0);
+    }
+
+    // Outputs emerge `capture_delay` cycles after their inputs are driven, so
+    // they are captured by a thread which starts that much later.
+    XLS_ASSIGN_OR_RETURN(ModuleTestbenchThread * capture_tbt,
+                         tb->CreateThread("output capture",
+                                          /*dut_inputs=*/{}));
+    SequentialBlock& capture_block = capture_tbt->MainBlock();
+    if (capture_delay > 0) {
+      capture_block.AdvanceNCycles(capture_delay);
+    }
+    capture_outputs(capture_block.Repeat(input_count).AtEndOfCycle());
+  } else {
+    SequentialBlock& loop = seq_block.Repeat(input_count);
+    drive_data(loop);
+    capture_outputs(loop.AtEndOfCycle());
+  }
+
+  // Each stream is fed (or drained) by its own thread, indexing `inputs`
+  // (`outputs`) with its own counter.
+  std::vector<BitsMap> outputs(input_count);
+  std::vector<std::function<std::optional<Bits>()>> producer_fns;
+  producer_fns.reserve(signature_.data_inputs().size());
+  absl::flat_hash_map<std::string, TestbenchStreamThread::Producer> producers;
+  for (const PortProto& input : signature_.data_inputs()) {
+    producer_fns.push_back(
+        [&inputs, name = input.name(), next = int64_t{0}]() mutable
+        -> std::optional<Bits> {
+          if (next >= inputs.size()) {
+            return std::nullopt;
+          }
+          return inputs[next++].at(name);
+        });
+    producers.emplace(input_streams.at(input.name())->name,
+                      producer_fns.back());
+  }
+  std::vector<int64_t> output_counts(signature_.data_outputs().size(), 0);
+  std::vector<std::function<absl::Status(const Bits&)>> consumer_fns;
+  consumer_fns.reserve(signature_.data_outputs().size());
+  absl::flat_hash_map<std::string, TestbenchStreamThread::Consumer> consumers;
+  for (int64_t i = 0; i < signature_.data_outputs().size(); ++i) {
+    const PortProto& output = signature_.data_outputs()[i];
+    consumer_fns.push_back([&outputs, name = output.name(),
+                            count = &output_counts[i]](const Bits& value) {
+      if (*count >= outputs.size()) {
+        return absl::InternalError(absl::StrFormat(
+            "Simulation produced more than %d values of output `%s`",
+            outputs.size(), name));
+      }
+      outputs[(*count)++][name] = value;
+      return absl::OkStatus();
+    });
+    consumers.emplace(output_streams.at(output.name())->name,
+                      consumer_fns.back());
+  }
+
+  XLS_RETURN_IF_ERROR(tb->RunWithStreamingIo(producers, consumers));
+  for (int64_t i = 0; i < signature_.data_outputs().size(); ++i) {
+    if (output_counts[i] != input_count) {
+      return absl::InternalError(absl::StrFormat(
+          "Simulation produced %d values of output `%s`, expected %d",
+          output_counts[i], signature_.data_outputs()[i].name(), input_count));
+    }
+  }
+  return outputs;
+}
+
 absl::StatusOr<Value> ModuleSimulator::RunFunction(
     const absl::flat_hash_map<std::string, Value>& inputs) const {
   absl::flat_hash_map<std::string, Value> input_map(inputs.begin(),
@@ -498,13 +680,30 @@ absl::StatusOr<Value> ModuleSimulator::RunFunction(
 
 absl::StatusOr<std::vector<Value>> ModuleSimulator::RunBatched(
     absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) const {
+  return RunBatchedValues(inputs, [&](absl::Span<const BitsMap> bits_inputs) {
+    return RunBatched(bits_inputs);
+  });
+}
+
+absl::StatusOr<std::vector<Value>> ModuleSimulator::RunBatchedStreaming(
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) const {
+  return RunBatchedValues(inputs, [&](absl::Span<const BitsMap> bits_inputs) {
+    return RunBatchedStreaming(bits_inputs);
+  });
+}
+
+absl::StatusOr<std::vector<Value>> ModuleSimulator::RunBatchedValues(
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs,
+    absl::FunctionRef<absl::StatusOr<std::vector<BitsMap>>(
+        absl::Span<const BitsMap>)>
+        run_batched) const {
   std::vector<BitsMap> bits_inputs;
   for (const auto& input : inputs) {
     XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
     bits_inputs.push_back(ValueMapToBitsMap(input));
   }
   XLS_ASSIGN_OR_RETURN(std::vector<BitsMap> bits_outputs,
-                       RunBatched(bits_inputs));
+                       run_batched(bits_inputs));
   XLS_CHECK_EQ(signature_.data_outputs().size(), 1);
   std::vector<Value> outputs;
   for (const BitsMap& bits_output : bits_outputs) {
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/vast.h"
@@ -105,11 +106,22 @@ class ModuleSimulator {
   absl::StatusOr<std::vector<BitsMap>> RunBatched(
       absl::Span<const BitsMap> inputs) const;
 
+  // As RunBatched, but the testbench is a loop which reads each argument from
+  // a stream (a named pipe fed as the simulation runs) and writes each output
+  // to a stream, rather than a straight-line sequence with every value spelled
+  // out and outputs $display'ed for parsing. The testbench is therefore the
+  // same size however many inputs there are, which makes this much faster for
+  // large batches. Output-valid signals of pipelined modules are not checked.
+  absl::StatusOr<std::vector<BitsMap>> RunBatchedStreaming(
+      absl::Span<const BitsMap> inputs) const;
+
   // Overloads which accept Values rather than Bits.
   absl::StatusOr<Value> RunFunction(
       const absl::flat_hash_map<std::string, Value>& inputs) const;
   absl::StatusOr<std::vector<Value>> RunBatched(
       absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) const;
+  absl::StatusOr<std::vector<Value>> RunBatchedStreaming(
+      absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) const;
 
   // Runs the given channel inputs and expects a number of values at an output
   // channel on the a design under test (DUT) derived from a proc.
@@ -137,6 +149,14 @@ class ModuleSimulator {
       std::optional<ReadyValidHoldoffs> holdoffs = std::nullopt) const;
 
  private:
+  // Converts `inputs` to Bits, runs them with `run_batched`, and converts the
+  // (single) output of each back to a Value.
+  absl::StatusOr<std::vector<Value>> RunBatchedValues(
+      absl::Span<const absl::flat_hash_map<std::string, Value>> inputs,
+      absl::FunctionRef<absl::StatusOr<std::vector<BitsMap>>(
+          absl::Span<const BitsMap>)>
+          run_batched) const;
+
   // Returns the control input ports and their deasserted values.
   std::vector<DutInput> DeassertControlSignals() const;
 
@@ -353,6 +353,90 @@ TEST_P(ModuleSimulatorTest, CombinationalBatched) {
   EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(100, 8))));
 }
 
+TEST_P(ModuleSimulatorTest, FixedLatencyBatchedStreaming) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeFixedLatencyModule());
+  ModuleSimulator simulator =
+      NewModuleSimulator(verilog_signature.first, verilog_signature.second);
+
+  using BitsMap = ModuleSimulator::BitsMap;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      simulator.RunBatchedStreaming({BitsMap{{"x", UBits(44, 8)}},
+                                     BitsMap{{"x", UBits(123, 8)}},
+                                     BitsMap{{"x", UBits(7, 8)}}}));
+
+  EXPECT_EQ(outputs.size(), 3);
+  EXPECT_THAT(outputs[0], ElementsAre(Pair("out", UBits(88, 8))));
+  EXPECT_THAT(outputs[1], ElementsAre(Pair("out", UBits(246, 8))));
+  EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(14, 8))));
+}
+
+TEST_P(ModuleSimulatorTest, CombinationalBatchedStreaming) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeCombinationalModule());
+  ModuleSimulator simulator =
+      NewModuleSimulator(verilog_signature.first, verilog_signature.second);
+
+  // Enough inputs that the non-streaming testbench would be very large.
+  using BitsMap = ModuleSimulator::BitsMap;
+  constexpr int64_t kInputCount = 10000;
+  std::vector<BitsMap> inputs;
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    inputs.push_back(
+        BitsMap{{"x", UBits(i % 256, 8)}, {"y", UBits((3 * i) % 256, 8)}});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<BitsMap> outputs,
+                           simulator.RunBatchedStreaming(inputs));
+
+  ASSERT_EQ(outputs.size(), kInputCount);
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    int64_t difference = (i % 256) - ((3 * i) % 256);
+    EXPECT_THAT(outputs[i],
+                ElementsAre(Pair("out", UBits((difference + 256) % 256, 8))));
+  }
+}
+
+TEST_P(ModuleSimulatorTest, PipelinedBatchedStreaming) {
+  const std::string text = R"(
+module pipelined_add(
+  input wire clk,
+  input wire [7:0] x,
+  input wire [7:0] y,
+  output wire [7:0] out
+);
+  reg [7:0] p0;
+  reg [7:0] p1;
+  always @ (posedge clk) begin
+    p0 <= x + y;
+    p1 <= p0;
+  end
+  assign out = p1;
+endmodule
+)";
+
+  ModuleSignatureBuilder b("pipelined_add");
+  b.WithClock("clk").WithPipelineInterface(/*latency=*/2,
+                                           /*initiation_interval=*/1);
+  b.AddDataInputAsBits("x", 8);
+  b.AddDataInputAsBits("y", 8);
+  b.AddDataOutputAsBits("out", 8);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, b.Build());
+  ModuleSimulator simulator = NewModuleSimulator(text, signature);
+
+  using BitsMap = ModuleSimulator::BitsMap;
+  std::vector<BitsMap> inputs = {
+      BitsMap{{"x", UBits(1, 8)}, {"y", UBits(2, 8)}},
+      BitsMap{{"x", UBits(10, 8)}, {"y", UBits(20, 8)}},
+      BitsMap{{"x", UBits(200, 8)}, {"y", UBits(100, 8)}},
+      BitsMap{{"x", UBits(7, 8)}, {"y", UBits(0, 8)}}};
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<BitsMap> outputs,
+                           simulator.RunBatchedStreaming(inputs));
+  EXPECT_THAT(outputs, ElementsAre(ElementsAre(Pair("out", UBits(3, 8))),
+                                   ElementsAre(Pair("out", UBits(30, 8))),
+                                   ElementsAre(Pair("out", UBits(44, 8))),
+                                   ElementsAre(Pair("out", UBits(7, 8)))));
+  EXPECT_THAT(simulator.RunBatched(inputs), IsOkAndHolds(outputs));
+}
+
 TEST_P(ModuleSimulatorTest, MultipleOutputs) {
   const std::string text = R"(
 module delay_3(
@@ -14,20 +14,30 @@
 
 #include "xls/solvers/z3_ir_equivalence.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <random>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/interpreter/ir_interpreter.h"
+#include "xls/interpreter/random_value.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
@@ -38,6 +48,8 @@
 #include "xls/ir/source_location.h"
 #include "xls/ir/value.h"
 #include "xls/solvers/z3_ir_translator.h"
+#include "xls/solvers/z3_utils.h"
+#include "../z3/src/api/z3_api.h"
 
 namespace xls::solvers::z3 {
 namespace {
@@ -89,15 +101,28 @@ absl::StatusOr<Node*> FlattenToBits(Function* function, Node* original) {
       SourceInfo(), values,
       absl::StrFormat("split_concat_%s", original->GetName()), function));
 }
-}  // namespace
 
-absl::StatusOr<bool> TryProveEquivalence(Function* a, Function* b,
-                                         absl::Duration timeout) {
-  std::unique_ptr<Package> to_test = std::make_unique<Package>(
+// A single function computing the results of both "a" and "b" on shared
+// parameters, so that the two can be compared within one Z3 context.
+struct Miter {
+  std::unique_ptr<Package> package;
+  Function* function;
+  // The nodes of the copy of "a", and those of the copy of "b" excluding its
+  // (shared) parameters.
+  std::vector<Node*> a_nodes;
+  std::vector<Node*> b_nodes;
+  // The results of "a" and "b", flattened to bits.
+  Node* a_result;
+  Node* b_result;
+};
+
+absl::StatusOr<Miter> BuildMiter(Function* a, Function* b) {
+  Miter miter;
+  miter.package = std::make_unique<Package>(
       absl::StrFormat("%s_tester", a->package()->name()));
   XLS_ASSIGN_OR_RETURN(
-      Function * to_test_func,
-      a->Clone(absl::StrFormat("%s_test", a->name()), to_test.get()));
+      miter.function,
+      a->Clone(absl::StrFormat("%s_test", a->name()), miter.package.get()));
 
   XLS_RET_CHECK(
       a->return_value()->GetType()->IsEqualTo(b->return_value()->GetType()));
@@ -106,16 +131,19 @@ absl::StatusOr<bool> TryProveEquivalence(Function* a, Function* b,
     XLS_RET_CHECK(
         a->params()[i]->GetType()->IsEqualTo(b->params()[i]->GetType()));
   }
+  for (Node* n : TopoSort(miter.function)) {
+    miter.a_nodes.push_back(n);
+  }
 
-  // Patch b into to_test. Wire up parameters to those at the same index in the
-  // to_test_function.  We do this so we can test whether the two functions are
-  // semantically equivalent by making a single Z3-AST function and checking a
-  // single eq node's value.
+  // Patch b into the miter. Wire up parameters to those at the same index in
+  // the miter function.  We do this so we can test whether the two functions
+  // are semantically equivalent by making a single Z3-AST function and
+  // checking a single eq node's value.
   absl::flat_hash_map<Node*, Node*> node_map;
   for (Node* n : TopoSort(b)) {
     if (n->Is<Param>()) {
       XLS_ASSIGN_OR_RETURN(int64_t index, b->GetParamIndex(n->As<Param>()));
-      node_map[n] = to_test_func->param(index);
+      node_map[n] = miter.function->param(index);
       continue;
     }
     std::vector<Node*> new_ops;
@@ -124,23 +152,229 @@ absl::StatusOr<bool> TryProveEquivalence(Function* a, Function* b,
       new_ops.push_back(node_map[op]);
     }
     XLS_ASSIGN_OR_RETURN(node_map[n],
-                         n->CloneInNewFunction(new_ops, to_test_func));
+                         n->CloneInNewFunction(new_ops, miter.function));
+    miter.b_nodes.push_back(node_map[n]);
   }
 
-  // Add check, coerce any tuples/arays into bit-arrays since z3 ir-translator
-  // doesn't support eq of tuples/arrays yet.
+  // Coerce any tuples/arays into bit-arrays since z3 ir-translator doesn't
+  // support eq of tuples/arrays yet.
   XLS_ASSIGN_OR_RETURN(
-      Node * original_result,
-      FlattenToBits(to_test_func, to_test_func->return_value()));
+      miter.a_result,
+      FlattenToBits(miter.function, miter.function->return_value()));
   XLS_ASSIGN_OR_RETURN(
-      Node * transformed_result,
-      FlattenToBits(to_test_func, node_map[b->return_value()]));
-  Node* new_ret = to_test_func->AddNode(std::make_unique<CompareOp>(
-      SourceInfo(), original_result, transformed_result, Op::kEq, "TestCheck",
-      to_test_func));
-  XLS_RETURN_IF_ERROR(to_test_func->set_return_value(new_ret));
+      miter.b_result,
+      FlattenToBits(miter.function, node_map[b->return_value()]));
+  return miter;
+}
+
+// Evaluates every node of "f" on "samples" random inputs and returns, for each
+// bits-typed node, a hash of the values it took.
+absl::StatusOr<absl::flat_hash_map<Node*, uint64_t>> SimulationSignatures(
+    Function* f, int64_t samples, int64_t seed) {
+  absl::flat_hash_map<Node*, uint64_t> signatures;
+  std::mt19937_64 rng(seed);
+  absl::flat_hash_map<Node*, Value> values;
+  for (int64_t sample = 0; sample < samples; ++sample) {
+    std::vector<Value> args = RandomFunctionArguments(f, rng);
+    values.clear();
+    for (Node* node : TopoSort(f)) {
+      if (node->Is<Param>()) {
+        XLS_ASSIGN_OR_RETURN(int64_t index,
+                             f->GetParamIndex(node->As<Param>()));
+        values[node] = args[index];
+      } else {
+        std::vector<Value> operand_values;
+        operand_values.reserve(node->operand_count());
+        for (Node* operand : node->operands()) {
+          operand_values.push_back(values.at(operand));
+        }
+        XLS_ASSIGN_OR_RETURN(values[node],
+                             InterpretNode(node, operand_values));
+      }
+      if (node->GetType()->IsBits()) {
+        signatures[node] =
+            absl::HashOf(signatures[node], values.at(node).bits());
+      }
+    }
+  }
+  return signatures;
+}
+
+// Checks whether each of the given pairs of equally-typed bits nodes of "f"
+// are equal for all inputs. Each worker thread translates "f" (as it is at the
+// time of the call) into its own Z3 context and then takes pairs from a shared
+// queue. Returns, for each
+// pair, Z3_L_FALSE if the nodes are equal (i.e.: their inequality is
+// unsatisfiable), Z3_L_TRUE if they differ, and Z3_L_UNDEF on timeout.
+absl::StatusOr<std::vector<Z3_lbool>> CheckEqualities(
+    Function* f, absl::Span<const std::pair<Node*, Node*>> pairs,
+    absl::Duration timeout, int64_t num_threads) {
+  std::vector<Z3_lbool> results(pairs.size(), Z3_L_UNDEF);
+  if (pairs.empty()) {
+    return results;
+  }
+  int64_t worker_count =
+      std::clamp<int64_t>(num_threads, 1, static_cast<int64_t>(pairs.size()));
+  std::atomic<int64_t> next_pair = 0;
+  auto worker = [&](int64_t) -> absl::Status {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator,
+                         IrTranslator::CreateAndTranslate(f));
+    translator->SetTimeout(timeout);
+    Z3_context ctx = translator->ctx();
+    Z3_solver solver = CreateSolver(ctx, /*num_threads=*/1);
+    auto cleanup = absl::Cleanup([&] { Z3_solver_dec_ref(ctx, solver); });
+    for (int64_t i = next_pair++; i < static_cast<int64_t>(pairs.size());
+         i = next_pair++) {
+      Z3_ast lhs = translator->GetTranslation(pairs[i].first);
+      Z3_ast rhs = translator->GetTranslation(pairs[i].second);
+      XLS_RET_CHECK(lhs != nullptr && rhs != nullptr);
+      Z3_solver_push(ctx, solver);
+      Z3_solver_assert(ctx, solver, Z3_mk_not(ctx, Z3_mk_eq(ctx, lhs, rhs)));
+      results[i] = Z3_solver_check(ctx, solver);
+      Z3_solver_pop(ctx, solver, 1);
+    }
+    return absl::OkStatus();
+  };
+  XLS_RETURN_IF_ERROR(ParallelFor(worker_count, worker_count, worker));
+  return results;
+}
+
+}  // namespace
+
+absl::StatusOr<bool> TryProveEquivalence(Function* a, Function* b,
+                                         absl::Duration timeout) {
+  XLS_ASSIGN_OR_RETURN(Miter miter, BuildMiter(a, b));
+  Node* new_ret = miter.function->AddNode(std::make_unique<CompareOp>(
+      SourceInfo(), miter.a_result, miter.b_result, Op::kEq, "TestCheck",
+      miter.function));
+  XLS_RETURN_IF_ERROR(miter.function->set_return_value(new_ret));
   // Run prover
-  return TryProve(to_test_func, new_ret, Predicate::NotEqualToZero(), timeout);
+  return TryProve(miter.function, new_ret, Predicate::NotEqualToZero(),
+                  timeout);
+}
+
+absl::StatusOr<bool> TryProveEquivalence(
+    Function* a, Function* b, const PartitionedEquivalenceOptions& options) {
+  XLS_RET_CHECK_GT(options.partition_width, 0);
+  XLS_ASSIGN_OR_RETURN(Miter miter, BuildMiter(a, b));
+  Function* f = miter.function;
+
+  // Look for a cheap counterexample first.
+  absl::flat_hash_map<Node*, uint64_t> signatures;
+  if (options.simulation_samples > 0) {
+    XLS_ASSIGN_OR_RETURN(
+        signatures,
+        SimulationSignatures(f, options.simulation_samples, options.seed));
+    if (signatures.at(miter.a_result) != signatures.at(miter.b_result)) {
+      XLS_VLOG(1) << "Random simulation found a counterexample.";
+      return false;
+    }
+  }
+
+  // Sweep: prove nodes of "b" equal to nodes of "a" with the same simulated
+  // values, and replace the uses of each proven node of "b" with its
+  // counterpart in "a". Candidates are checked a level (distance from the
+  // parameters) at a time, and the pairs proven at one level are merged before
+  // the queries of the next are built. A deeper query thus only contains the
+  // logic of "b" not yet known to match "a", and is often trivial once its
+  // operands have been merged.
+  Node* b_result = miter.b_result;
+  if (options.sweep && !signatures.empty()) {
+    absl::flat_hash_map<std::pair<int64_t, uint64_t>, Node*> a_by_signature;
+    for (Node* node : miter.a_nodes) {
+      if (node->GetType()->IsBits()) {
+        a_by_signature.try_emplace(
+            std::make_pair(node->BitCountOrDie(), signatures.at(node)), node);
+      }
+    }
+    absl::flat_hash_map<Node*, int64_t> levels;
+    for (Node* node : TopoSort(f)) {
+      int64_t level = 0;
+      for (Node* operand : node->operands()) {
+        level = std::max(level, levels.at(operand) + 1);
+      }
+      levels[node] = level;
+    }
+    std::vector<std::vector<std::pair<Node*, Node*>>> candidates_by_level;
+    for (Node* node : miter.b_nodes) {
+      if (!node->GetType()->IsBits()) {
+        continue;
+      }
+      auto it = a_by_signature.find(
+          std::make_pair(node->BitCountOrDie(), signatures.at(node)));
+      if (it == a_by_signature.end()) {
+        continue;
+      }
+      int64_t level = levels.at(node);
+      if (candidates_by_level.size() <= level) {
+        candidates_by_level.resize(level + 1);
+      }
+      candidates_by_level[level].push_back({it->second, node});
+    }
+    int64_t candidate_count = 0;
+    int64_t merged = 0;
+    for (absl::Span<const std::pair<Node*, Node*>> candidates :
+         candidates_by_level) {
+      if (candidates.empty()) {
+        continue;
+      }
+      candidate_count += candidates.size();
+      XLS_ASSIGN_OR_RETURN(std::vector<Z3_lbool> proven,
+                           CheckEqualities(f, candidates, options.sweep_timeout,
+                                           options.num_threads));
+      for (int64_t i = 0; i < candidates.size(); ++i) {
+        if (proven[i] != Z3_L_FALSE) {
+          continue;
+        }
+        auto [a_node, b_node] = candidates[i];
+        XLS_RETURN_IF_ERROR(b_node->ReplaceUsesWith(a_node));
+        if (b_node == b_result) {
+          b_result = a_node;
+        }
+        ++merged;
+      }
+    }
+    XLS_VLOG(1) << absl::StreamFormat("Sweeping merged %d of %d candidates.",
+                                      merged, candidate_count);
+  }
+
+  // Check each slice of the outputs separately.
+  const int64_t width = miter.a_result->BitCountOrDie();
+  std::vector<std::pair<Node*, Node*>> slices;
+  if (miter.a_result != b_result) {
+    for (int64_t start = 0; start < width;
+         start += options.partition_width) {
+      int64_t slice_width = std::min(options.partition_width, width - start);
+      XLS_ASSIGN_OR_RETURN(
+          Node * a_slice,
+          f->MakeNode<BitSlice>(SourceInfo(), miter.a_result, start,
+                                slice_width));
+      XLS_ASSIGN_OR_RETURN(
+          Node * b_slice,
+          f->MakeNode<BitSlice>(SourceInfo(), b_result, start, slice_width));
+      slices.push_back({a_slice, b_slice});
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<Z3_lbool> results,
+      CheckEqualities(f, slices, options.timeout, options.num_threads));
+  bool undecided = false;
+  for (int64_t i = 0; i < results.size(); ++i) {
+    if (results[i] == Z3_L_TRUE) {
+      XLS_VLOG(1) << absl::StreamFormat(
+          "Found a counterexample for output bits [%d, %d).",
+          i * options.partition_width,
+          std::min((i + 1) * options.partition_width, width));
+      return false;
+    }
+    undecided = undecided || results[i] == Z3_L_UNDEF;
+  }
+  if (undecided) {
+    return absl::DeadlineExceededError(
+        "Could not decide equivalence of every output slice within the "
+        "timeout.");
+  }
+  return true;
 }
 
 absl::StatusOr<bool> TryProveEquivalence(
@@ -15,6 +15,7 @@
 #ifndef XLS_SOLVERS_Z3_IR_EQUIVALENCE_H_
 #define XLS_SOLVERS_Z3_IR_EQUIVALENCE_H_
 
+#include <cstdint>
 #include <functional>
 
 #include "absl/status/status.h"
@@ -49,6 +50,48 @@ absl::StatusOr<bool> TryProveEquivalence(
     Function* a, Function* b,
     absl::Duration timeout = absl::InfiniteDuration());
 
+// Options for the partitioned form of TryProveEquivalence().
+struct PartitionedEquivalenceOptions {
+  // Time limit for each individual solver query.
+  absl::Duration timeout = absl::InfiniteDuration();
+
+  // Number of threads, each with its own Z3 context, to dispatch solver
+  // queries to.
+  int64_t num_threads = 1;
+
+  // Number of random input vectors to simulate before invoking the solver.
+  // A mismatch in simulation is a counterexample; the simulated values are
+  // also used to pick candidate internal node pairs for sweeping.
+  int64_t simulation_samples = 64;
+  int64_t seed = 0;
+
+  // Width, in bits, of each slice of the (flattened) outputs that is checked
+  // as its own solver query.
+  int64_t partition_width = 1;
+
+  // Whether to first prove internal nodes of `b` equal to nodes of `a` with
+  // the same simulated values (SAT sweeping). Candidates are proven in
+  // topological order, one level at a time, and the pairs proven at each level
+  // are merged before the next level's queries (and the output queries) are
+  // built.
+  bool sweep = true;
+  // Time limit for each sweeping query.
+  absl::Duration sweep_timeout = absl::Seconds(1);
+};
+
+// Verify that both functions have the same behaviors by checking each
+// `partition_width`-bit slice of the outputs separately, in parallel, after
+// random simulation and sweeping. Both functions must have exactly the same
+// types.
+//
+// This call does not alter either function.
+//
+// Returns 'true' if every slice is proven equal and 'false' if a
+// counterexample is found; returns a DeadlineExceeded error if some slice
+// could be neither proven nor refuted within the timeout.
+absl::StatusOr<bool> TryProveEquivalence(
+    Function* a, Function* b, const PartitionedEquivalenceOptions& options);
+
 }  // namespace xls::solvers::z3
 
 #endif  // XLS_SOLVERS_Z3_IR_EQUIVALENCE_H_
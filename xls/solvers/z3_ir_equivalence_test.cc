@@ -22,6 +22,7 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/bits.h"
@@ -38,6 +39,7 @@ namespace {
 
 using status_testing::IsOk;
 using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
 
 using ::testing::Not;
 
@@ -347,5 +349,112 @@ TEST_F(EquivalenceTest, MultiFunctionDetectsDifference) {
   EXPECT_THAT(TryProveEquivalence(f1, f2), IsOkAndHolds(false));
 }
 
+TEST_F(EquivalenceTest, PartitionedDetectsSame) {
+  std::unique_ptr<Package> p1 = CreatePackage();
+  FunctionBuilder fb1(TestName(), p1.get());
+  BValue x1 = fb1.Param("x", p1->GetBitsType(16));
+  BValue y1 = fb1.Param("y", p1->GetBitsType(16));
+  fb1.Tuple({fb1.Add(x1, y1), fb1.UMul(fb1.Add(x1, y1), x1)});
+
+  std::unique_ptr<Package> p2 = CreatePackage();
+  FunctionBuilder fb2(TestName(), p2.get());
+  BValue x2 = fb2.Param("x", p2->GetBitsType(16));
+  BValue y2 = fb2.Param("y", p2->GetBitsType(16));
+  fb2.Tuple({fb2.Add(y2, x2), fb2.UMul(x2, fb2.Add(y2, x2))});
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f1, fb1.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f2, fb2.Build());
+
+  PartitionedEquivalenceOptions options;
+  options.num_threads = 4;
+  options.partition_width = 4;
+  EXPECT_THAT(TryProveEquivalence(f1, f2, options), IsOkAndHolds(true));
+  options.sweep = false;
+  EXPECT_THAT(TryProveEquivalence(f1, f2, options), IsOkAndHolds(true));
+}
+
+TEST_F(EquivalenceTest, PartitionedDetectsDifferenceBySimulation) {
+  std::unique_ptr<Package> p1 = CreatePackage();
+  FunctionBuilder fb1(TestName(), p1.get());
+  fb1.Add(fb1.Param("x", p1->GetBitsType(32)),
+          fb1.Param("y", p1->GetBitsType(32)));
+
+  std::unique_ptr<Package> p2 = CreatePackage();
+  FunctionBuilder fb2(TestName(), p2.get());
+  fb2.Add(
+      fb2.Add(fb2.Literal(UBits(1, 32)), fb2.Param("x", p2->GetBitsType(32))),
+      fb2.Param("y", p2->GetBitsType(32)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f1, fb1.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f2, fb2.Build());
+
+  EXPECT_THAT(TryProveEquivalence(f1, f2, PartitionedEquivalenceOptions()),
+              IsOkAndHolds(false));
+}
+
+TEST_F(EquivalenceTest, PartitionedDetectsRareDifference) {
+  // The functions differ only when x is a particular value, which random
+  // simulation is unlikely to hit; the solver has to find it.
+  std::unique_ptr<Package> p1 = CreatePackage();
+  FunctionBuilder fb1(TestName(), p1.get());
+  BValue x1 = fb1.Param("x", p1->GetBitsType(32));
+  fb1.Concat({fb1.Not(x1), x1});
+
+  std::unique_ptr<Package> p2 = CreatePackage();
+  FunctionBuilder fb2(TestName(), p2.get());
+  BValue x2 = fb2.Param("x", p2->GetBitsType(32));
+  fb2.Concat(
+      {fb2.Not(x2),
+       fb2.Select(fb2.Eq(x2, fb2.Literal(UBits(0x12345678, 32))),
+                  {x2, fb2.Literal(UBits(0, 32))})});
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f1, fb1.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f2, fb2.Build());
+
+  PartitionedEquivalenceOptions options;
+  options.num_threads = 2;
+  options.partition_width = 8;
+  EXPECT_THAT(TryProveEquivalence(f1, f2, options), IsOkAndHolds(false));
+}
+
+TEST_F(EquivalenceTest, PartitionedSweepProvesWhatTheFullQueryCannot) {
+  // `b` computes each addition of `a` in carry-save form. The squares make the
+  // output query too hard for the solver unless the sums feeding them have
+  // already been merged, which only works when they're merged in order.
+  std::unique_ptr<Package> p = CreatePackage();
+  FunctionBuilder fb1(absl::StrCat(TestName(), "1"), p.get());
+  BValue x1 = fb1.Param("x", p->GetBitsType(16));
+  BValue y1 = fb1.Param("y", p->GetBitsType(16));
+  BValue z1 = fb1.Param("z", p->GetBitsType(16));
+  BValue s1 = fb1.Add(x1, y1);
+  BValue u1 = fb1.Add(fb1.UMul(s1, s1), z1);
+  fb1.UMul(u1, u1);
+
+  FunctionBuilder fb2(absl::StrCat(TestName(), "2"), p.get());
+  auto carry_save_add = [&](BValue a, BValue b) {
+    return fb2.Add(fb2.Xor(a, b),
+                   fb2.Shll(fb2.And(a, b), fb2.Literal(UBits(1, 16))));
+  };
+  BValue x2 = fb2.Param("x", p->GetBitsType(16));
+  BValue y2 = fb2.Param("y", p->GetBitsType(16));
+  BValue z2 = fb2.Param("z", p->GetBitsType(16));
+  BValue s2 = carry_save_add(x2, y2);
+  BValue u2 = carry_save_add(fb2.UMul(s2, s2), z2);
+  fb2.UMul(u2, u2);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f1, fb1.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f2, fb2.Build());
+
+  PartitionedEquivalenceOptions options;
+  options.num_threads = 2;
+  options.partition_width = 16;
+  options.timeout = absl::Seconds(1);
+  EXPECT_THAT(TryProveEquivalence(f1, f2, options), IsOkAndHolds(true));
+
+  options.sweep = false;
+  EXPECT_THAT(TryProveEquivalence(f1, f2, options),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+}
+
 }  // namespace
 }  // namespace xls::solvers::z3
@@ -797,7 +797,10 @@ absl::Status RealMain(std::string_view path,
     XLS_ASSIGN_OR_RETURN(pdelay_estimator,
                          GetDelayEstimator(absl::GetFlag(FLAGS_delay_model)));
   }
-  const auto& delay_estimator = *pdelay_estimator;
+  // Critical path analysis, delay totals and scheduling all query the same
+  // delays, so share a structural cache across them.
+  const StructuralCachingDelayEstimator delay_estimator(
+      absl::StrCat("cached_", pdelay_estimator->name()), *pdelay_estimator);
   XLS_RETURN_IF_ERROR(PrintCriticalPath(f, query_engine, delay_estimator,
                                         effective_clock_period_ps));
   XLS_RETURN_IF_ERROR(PrintTotalDelay(f, delay_estimator));
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -40,6 +41,7 @@
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
 #include "xls/passes/unroll_pass.h"
+#include "xls/solvers/z3_ir_equivalence.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "xls/solvers/z3_utils.h"
 #include "../z3/src/api/z3.h"
@@ -65,6 +67,17 @@ ABSL_FLAG(std::string, top, "",
           "Functions are supported.");
 ABSL_FLAG(absl::Duration, timeout, absl::InfiniteDuration(),
           "How long to wait for any proof to complete.");
+ABSL_FLAG(int64_t, partition_width, 0,
+          "If nonzero, check each slice of this many output bits as a "
+          "separate query (after random simulation and sweeping of internal "
+          "nodes) instead of checking the whole function as one query. "
+          "--timeout then applies to each query.");
+ABSL_FLAG(int64_t, num_threads, 0,
+          "Number of threads, each with its own solver, to run partitioned "
+          "queries on. If zero, uses the number of hardware threads.");
+ABSL_FLAG(int64_t, simulation_samples, 64,
+          "Number of random inputs to simulate before solving, in "
+          "partitioned mode.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
 
 namespace xls {
@@ -87,7 +100,8 @@ static absl::StatusOr<Z3_ast> CreateComparisonFunction(
 }
 
 static absl::Status RealMain(const std::vector<std::string_view>& ir_paths,
-                             const std::string& entry, absl::Duration timeout) {
+                             const std::string& entry, absl::Duration timeout,
+                             int64_t partition_width) {
   std::vector<std::unique_ptr<Package>> packages;
   for (const auto ir_path : ir_paths) {
     XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
@@ -127,6 +141,29 @@ static absl::Status RealMain(const std::vector<std::string_view>& ir_paths,
     functions.push_back(func);
   }
 
+  if (partition_width > 0) {
+    solvers::z3::PartitionedEquivalenceOptions options;
+    options.timeout = timeout;
+    options.partition_width = partition_width;
+    options.num_threads = absl::GetFlag(FLAGS_num_threads) > 0
+                              ? absl::GetFlag(FLAGS_num_threads)
+                              : std::thread::hardware_concurrency();
+    options.simulation_samples = absl::GetFlag(FLAGS_simulation_samples);
+    absl::StatusOr<bool> proven =
+        solvers::z3::TryProveEquivalence(functions[0], functions[1], options);
+    if (absl::IsDeadlineExceeded(proven.status())) {
+      std::cout << "[UNDETERMINED] " << proven.status().message()
+                << std::endl;
+      return absl::OkStatus();
+    }
+    XLS_RETURN_IF_ERROR(proven.status());
+    std::cout << (*proven ? "[UNSAT] Functions are equivalent."
+                          : "[SAT] Functions are not equivalent; run with "
+                            "-v=1 for details.")
+              << std::endl;
+    return absl::OkStatus();
+  }
+
   std::vector<std::unique_ptr<IrTranslator>> translators;
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator,
                        IrTranslator::CreateAndTranslate(functions[0]));
@@ -176,5 +213,6 @@ int main(int argc, char** argv) {
       xls::InitXls(kUsage, argc, argv);
   XLS_QCHECK_EQ(positional_args.size(), 2) << "Two IR files must be specified!";
   return xls::ExitStatus(xls::RealMain(
-      positional_args, absl::GetFlag(FLAGS_top), absl::GetFlag(FLAGS_timeout)));
+      positional_args, absl::GetFlag(FLAGS_top), absl::GetFlag(FLAGS_timeout),
+      absl::GetFlag(FLAGS_partition_width)));
 }
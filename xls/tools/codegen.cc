@@ -14,6 +14,8 @@
 
 #include "xls/tools/codegen.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -23,6 +25,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/combinational_generator.h"
@@ -30,6 +33,7 @@
 #include "xls/codegen/op_override_impls.h"
 #include "xls/codegen/pipeline_generator.h"
 #include "xls/codegen/ram_configuration.h"
+#include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -38,8 +42,10 @@
 #include "xls/fdo/synthesizer.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/op.h"
+#include "xls/ir/proc.h"
 #include "xls/ir/verifier.h"
 #include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/run_pipeline_schedule.h"
 #include "xls/scheduling/scheduling_options.h"
 #include "xls/scheduling/scheduling_pass.h"
 #include "xls/scheduling/scheduling_pass_pipeline.h"
@@ -183,6 +189,61 @@ absl::StatusOr<PipelineSchedule> RunSchedulingPipeline(
   return scheduling_unit.schedule.value();
 }
 
+// Generates a pipelined module for every proc in `p`, given the schedule of the
+// top proc from the scheduling pipeline. The scheduling pipeline optimizes
+// every proc in the package but schedules only the top, so the other procs are
+// scheduled here with the same options. The modules are generated on up to
+// `worker_count` threads and returned as one result: their Verilog in package
+// order (with the line map adjusted to match) and the signature of the top
+// proc's module.
+absl::StatusOr<verilog::ModuleGeneratorResult> GenerateProcModules(
+    Package* p, const PipelineSchedule& top_schedule,
+    const SchedulingOptions& scheduling_options,
+    const DelayEstimator& delay_estimator,
+    const synthesis::Synthesizer* synthesizer,
+    const verilog::CodegenOptions& codegen_options, int64_t worker_count) {
+  std::vector<PipelineSchedule> schedules;
+  std::optional<int64_t> top_index;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    if (proc.get() == top_schedule.function_base()) {
+      top_index = schedules.size();
+      schedules.push_back(top_schedule);
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(PipelineSchedule schedule,
+                         RunPipelineSchedule(proc.get(), delay_estimator,
+                                             scheduling_options, synthesizer));
+    schedules.push_back(std::move(schedule));
+  }
+  XLS_RET_CHECK(top_index.has_value());
+
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<verilog::ModuleGeneratorResult> results,
+      verilog::ToPipelineModuleTexts(schedules, worker_count, codegen_options,
+                                     &delay_estimator));
+  verilog::ModuleGeneratorResult combined{
+      .signature = results[top_index.value()].signature};
+  for (const verilog::ModuleGeneratorResult& result : results) {
+    if (!combined.verilog_text.empty()) {
+      combined.verilog_text.append("\n");
+    }
+    const int64_t line_offset = std::count(combined.verilog_text.begin(),
+                                           combined.verilog_text.end(), '\n');
+    for (const verilog::VerilogLineMapping& mapping :
+         result.verilog_line_map.mapping()) {
+      verilog::VerilogLineMapping* moved =
+          combined.verilog_line_map.add_mapping();
+      *moved = mapping;
+      moved->mutable_verilog_span()->set_line_start(
+          mapping.verilog_span().line_start() + line_offset);
+      moved->mutable_verilog_span()->set_line_end(
+          mapping.verilog_span().line_end() + line_offset);
+    }
+    absl::StrAppend(&combined.verilog_text, result.verilog_text);
+  }
+  return combined;
+}
+
 }  // namespace
 
 absl::StatusOr<CodegenResult> ScheduleAndCodegen(
@@ -198,6 +259,12 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
   XLS_RET_CHECK(p->GetTop().has_value())
       << "Package " << p->name() << " needs a top function/proc.";
   auto main = [&p]() -> FunctionBase* { return p->GetTop().value(); };
+  if (codegen_flags_proto.multi_proc() &&
+      (codegen_flags_proto.generator() != GENERATOR_KIND_PIPELINE ||
+       !main()->IsProc())) {
+    return absl::InvalidArgumentError(
+        "--multi_proc requires the pipeline generator and a top proc.");
+  }
 
   XLS_ASSIGN_OR_RETURN(
       SchedulingOptions scheduling_options,
@@ -221,8 +288,13 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
     const FfiDelayEstimator ffi_estimator(
         scheduling_options.ffi_fallback_delay_ps());
 
-    FirstMatchDelayEstimator delay_estimator("combined_estimator",
-                                             {base_estimator, &ffi_estimator});
+    // The registered delay models only depend on the structure of each node,
+    // so identical operations across the package share one estimate.
+    const StructuralCachingDelayEstimator cached_base_estimator(
+        absl::StrCat("cached_", base_estimator->name()), *base_estimator);
+
+    FirstMatchDelayEstimator delay_estimator(
+        "combined_estimator", {&cached_base_estimator, &ffi_estimator});
 
     synthesis::Synthesizer* synthesizer = nullptr;
     if (scheduling_options.use_fdo() &&
@@ -237,6 +309,18 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
 
     XLS_RETURN_IF_ERROR(VerifyPackage(p, /*codegen=*/true));
 
+    if (codegen_flags_proto.multi_proc()) {
+      XLS_ASSIGN_OR_RETURN(
+          verilog::ModuleGeneratorResult result,
+          GenerateProcModules(p, schedule, scheduling_options, delay_estimator,
+                              synthesizer, codegen_options,
+                              codegen_flags_proto.codegen_worker_count()));
+      return CodegenResult{
+          .module_generator_result = result,
+          .pipeline_schedule_proto = schedule.ToProto(delay_estimator),
+      };
+    }
+
     XLS_ASSIGN_OR_RETURN(
         verilog::ModuleGeneratorResult result,
         verilog::ToPipelineModuleText(schedule, main(), codegen_options,
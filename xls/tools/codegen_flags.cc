@@ -14,6 +14,7 @@
 
 #include "xls/tools/codegen_flags.h"
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -47,6 +48,14 @@ ABSL_FLAG(std::string, output_verilog_line_map_path, "",
           "Verilog line map is not generated.");
 ABSL_FLAG(std::string, top, "",
           "Top entity of the package to generate the (System)Verilog code.");
+ABSL_FLAG(bool, multi_proc, false,
+          "If true, generate a pipelined module for every proc in the package "
+          "rather than only the top. The modules are written to the Verilog "
+          "output in package order; the signature and schedule outputs "
+          "describe the module of the top proc.");
+ABSL_FLAG(int64_t, codegen_worker_count, 1,
+          "Number of threads on which the modules of --multi_proc are "
+          "converted to blocks and emitted as Verilog.");
 ABSL_FLAG(std::string, generator, "pipeline",
           "The generator to use when emitting the device function. Valid "
           "values: pipeline, combinational.");
@@ -176,6 +185,8 @@ static absl::StatusOr<bool> SetOptionsFromFlags(CodegenFlagsProto &proto) {
   }
   bool any_flags_set = false;
   POPULATE_FLAG(top);
+  POPULATE_FLAG(multi_proc);
+  POPULATE_FLAG(codegen_worker_count);
 
   // Generator is somewhat special, in that we need to parse it to its enum
   // form.
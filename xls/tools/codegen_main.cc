@@ -53,6 +53,13 @@ Emit a feed-forward pipelined module:
        --clock_period_ps=500 \
        --pipeline_stages=7 \
        IR_FILE
+
+Emit a pipelined module for each proc of a multi-proc design, on 8 threads:
+   codegen_main --generator=pipeline \
+       --pipeline_stages=3 \
+       --multi_proc \
+       --codegen_worker_count=8 \
+       IR_FILE
 )";
 
 namespace xls {
@@ -68,6 +75,11 @@ absl::Status RealMain(std::string_view ir_path) {
 
   XLS_ASSIGN_OR_RETURN(CodegenFlagsProto codegen_flags_proto,
                        GetCodegenFlags());
+  if (codegen_flags_proto.multi_proc() &&
+      !absl::GetFlag(FLAGS_output_block_ir_path).empty()) {
+    return absl::InvalidArgumentError(
+        "--output_block_ir_path is not supported with --multi_proc.");
+  }
   if (!codegen_flags_proto.top().empty()) {
     XLS_RETURN_IF_ERROR(p->SetTopByName(codegen_flags_proto.top()));
   }
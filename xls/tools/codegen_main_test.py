@@ -62,6 +62,34 @@ proc neg_proc(my_token: token, my_state: (), init={()}) {
 }
 """
 
+MULTI_PROC_IR = """package test
+
+chan in(bits[32], id=0, kind=streaming, ops=receive_only,
+        flow_control=ready_valid, metadata="")
+chan internal(bits[32], id=1, kind=streaming, ops=send_receive,
+        flow_control=ready_valid, metadata="")
+chan out(bits[32], id=2, kind=streaming, ops=send_only,
+        flow_control=ready_valid, metadata="")
+
+proc neg_proc(my_token: token, my_state: (), init={()}) {
+  rcv: (token, bits[32]) = receive(my_token, channel=in)
+  data: bits[32] = tuple_index(rcv, index=1)
+  negate: bits[32] = neg(data)
+  rcv_token: token = tuple_index(rcv, index=0)
+  send: token = send(rcv_token, negate, channel=internal)
+  next (send, my_state)
+}
+
+proc not_proc(my_token: token, my_state: (), init={()}) {
+  rcv: (token, bits[32]) = receive(my_token, channel=internal)
+  data: bits[32] = tuple_index(rcv, index=1)
+  invert: bits[32] = not(data)
+  rcv_token: token = tuple_index(rcv, index=0)
+  send: token = send(rcv_token, invert, channel=out)
+  next (send, my_state)
+}
+"""
+
 ASSERT_IR = """package assert_example
 
 fn invert_with_assert(x: bits[1]) -> bits[1] {
@@ -320,6 +348,29 @@ class CodeGenMainTest(parameterized.TestCase):
     ]).decode('utf-8')
     self._compare_to_golden(verilog)
 
+  def test_multi_proc(self):
+    ir_file = self.create_tempfile(content=MULTI_PROC_IR)
+    signature_path = test_base.create_named_output_text_file(
+        'multi_proc_sig.textproto')
+    verilog = subprocess.check_output([
+        CODEGEN_MAIN_PATH, '--generator=pipeline', '--pipeline_stages=2',
+        '--reset=rst', '--delay_model=unit', '--alsologtostderr',
+        '--top=not_proc', '--multi_proc', '--codegen_worker_count=2',
+        '--output_signature_path=' + signature_path, ir_file.full_path
+    ]).decode('utf-8')
+    # Both modules are emitted, in package order.
+    self.assertIn('module neg_proc(', verilog)
+    self.assertIn('module not_proc(', verilog)
+    self.assertLess(
+        verilog.index('module neg_proc('), verilog.index('module not_proc(')
+    )
+
+    # The signature describes the module of the top proc.
+    with open(signature_path, 'r') as f:
+      sig_proto = text_format.Parse(f.read(),
+                                    module_signature_pb2.ModuleSignatureProto())
+      self.assertEqual(sig_proto.module_name, 'not_proc')
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -42,6 +42,7 @@
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/subprocess.h"
@@ -171,6 +172,13 @@ ABSL_FLAG(int64_t, simplifications_between_tests, 1,
 ABSL_FLAG(int64_t, failed_attempts_between_tests_limit, 16,
           "Failed simplification attempts between tests before we conclude we "
           "need to check our changes so far.");
+ABSL_FLAG(int64_t, parallelism, 1,
+          "Number of simplifications to test concurrently. If greater than "
+          "one, each round makes that many independent simplifications of the "
+          "last failing IR, tests them on as many threads, and keeps the first "
+          "(in the order they were made) which still fails, so the result does "
+          "not depend on thread timing. Cannot be combined with "
+          "--simplifications_between_tests.");
 ABSL_FLAG(
     bool, verify_ir, true,
     "Verify IR whenever parsing. In most cases, this is a good check that the "
@@ -213,6 +221,10 @@ absl::StatusOr<std::unique_ptr<Package>> ParsePackage(
 
 // Checks whether we still fail when attempting to run function "f". Optional
 // 'inputs' is required if --test_llvm_jit is used.
+//
+// Thread-safe (see --parallelism): every call works on its own temporary file
+// and subprocess, or parses its own package and builds its own JIT (with its
+// own LLVM context) and interpreter for it.
 absl::StatusOr<bool> StillFailsHelper(
     std::string_view ir_text, std::optional<std::vector<Value>> inputs) {
   if (!absl::GetFlag(FLAGS_test_executable).empty()) {
@@ -280,11 +292,14 @@ absl::StatusOr<bool> StillFailsHelper(
   return jit_result.value != interpreter_result.value;
 }
 
+// Memoized test results, keyed by the tested IR text.
+using TestCache = absl::flat_hash_map<std::string, bool>;
+
 // Wrapper around StillFails which memoizes the result. Optional test_cache is
 // used to memoize the results of testing the given IR.
-absl::StatusOr<bool> StillFails(
-    std::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+absl::StatusOr<bool> StillFails(std::string_view ir_text,
+                                std::optional<std::vector<Value>> inputs,
+                                TestCache* test_cache) {
   XLS_VLOG(1) << "=== Verifying contents still fails";
   XLS_VLOG_LINES(2, ir_text);
 
@@ -309,8 +324,7 @@ absl::StatusOr<bool> StillFails(
 // cache is used to memoize the results of testing the given IR.
 absl::Status VerifyStillFails(
     std::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    std::string_view description,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+    std::string_view description, TestCache* test_cache) {
   XLS_ASSIGN_OR_RETURN(bool still_fails,
                        StillFails(ir_text, inputs, test_cache));
 
@@ -894,14 +908,156 @@ absl::Status CleanUp(FunctionBase* f, bool can_remove_params) {
   return absl::OkStatus();
 }
 
+// Prints the minimized IR and checks (without the cache) that it still fails.
+absl::Status OutputMinimized(std::string_view knownf_ir_text,
+                             const std::optional<std::vector<Value>>& inputs) {
+  std::cout << knownf_ir_text;
+
+  // Run the last test verification without the cache.
+  XLS_RETURN_IF_ERROR(VerifyStillFails(knownf_ir_text, inputs,
+                                       "Minimized function does not fail!",
+                                       /*test_cache=*/nullptr));
+
+  return absl::OkStatus();
+}
+
+// Picks the function base to simplify: the top if --simplify_top_only is
+// set, otherwise one chosen at random, weighted by node count.
+FunctionBase* ChooseFunctionBase(Package* package, std::mt19937& rng) {
+  if (absl::GetFlag(FLAGS_simplify_top_only)) {
+    return package->GetTop().value();
+  }
+  std::vector<FunctionBase*> bases = package->GetFunctionBases();
+  std::vector<int64_t> node_counts;
+  node_counts.reserve(bases.size());
+  absl::c_transform(bases, std::back_inserter(node_counts),
+                    [](FunctionBase* f) { return f->node_count(); });
+  std::discrete_distribution<int64_t> distribution(node_counts.cbegin(),
+                                                   node_counts.cend());
+  return bases[distribution(rng)];
+}
+
+// Minimizes `knownf_ir_text` (which is known to fail) by rounds of
+// `parallelism` independent simplifications, tested concurrently; see
+// --parallelism. Returns the minimized IR text.
+absl::StatusOr<std::string> MinimizeInParallel(
+    std::string knownf_ir_text, const std::optional<std::vector<Value>>& inputs,
+    int64_t parallelism, int64_t failed_attempt_limit,
+    int64_t total_attempt_limit, TestCache& test_cache, std::mt19937& rng) {
+  struct Candidate {
+    std::string which_transform;
+    std::string ir_text;
+  };
+  const bool can_remove_params = absl::GetFlag(FLAGS_can_remove_params);
+  int64_t failed_simplification_attempts = 0;
+  int64_t total_attempts = 0;
+  bool cannot_change = false;
+  while (!cannot_change) {
+    if (failed_simplification_attempts >= failed_attempt_limit) {
+      XLS_LOG(INFO) << "Hit failed-simplification-attempt-limit: "
+                    << failed_simplification_attempts;
+      break;
+    }
+    if (total_attempts >= total_attempt_limit) {
+      XLS_LOG(INFO) << "Hit total-attempt-limit: " << total_attempts;
+      break;
+    }
+
+    // Each candidate is a single simplification of the last known failure.
+    // Attempts which change nothing (or duplicate an earlier candidate) count
+    // as failures; the number of them per round is bounded so a round always
+    // ends.
+    std::vector<Candidate> candidates;
+    auto is_new_candidate = [&](std::string_view ir_text) {
+      return ir_text != knownf_ir_text &&
+             absl::c_none_of(candidates, [&](const Candidate& c) {
+               return c.ir_text == ir_text;
+             });
+    };
+    for (int64_t attempt = 0; attempt < 2 * parallelism &&
+                              candidates.size() < parallelism &&
+                              total_attempts < total_attempt_limit;
+         ++attempt) {
+      ++total_attempts;
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                           ParsePackage(knownf_ir_text));
+      FunctionBase* candidate = ChooseFunctionBase(package.get(), rng);
+      std::string candidate_name = candidate->name();
+      std::string which_transform;
+      XLS_ASSIGN_OR_RETURN(SimplificationResult simplification,
+                           Simplify(candidate, inputs, rng, &which_transform));
+      if (simplification == SimplificationResult::kCannotChange) {
+        cannot_change = true;
+        break;
+      }
+      if (simplification == SimplificationResult::kDidChange) {
+        XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
+        std::string ir_text = package->DumpIr();
+        if (is_new_candidate(ir_text)) {
+          candidates.push_back(
+              {absl::StrCat(which_transform, " on ", candidate_name),
+               std::move(ir_text)});
+          continue;
+        }
+      }
+      ++failed_simplification_attempts;
+    }
+
+    std::vector<std::optional<bool>> still_fails(candidates.size());
+    for (int64_t i = 0; i < candidates.size(); ++i) {
+      auto it = test_cache.find(candidates[i].ir_text);
+      if (it != test_cache.end()) {
+        still_fails[i] = it->second;
+      }
+    }
+    XLS_LOG(INFO) << absl::StreamFormat(
+        "Testing %d candidates (%d attempts so far)", candidates.size(),
+        total_attempts);
+    auto test_candidate = [&](int64_t i) -> absl::Status {
+      if (still_fails[i].has_value()) {
+        return absl::OkStatus();
+      }
+      XLS_ASSIGN_OR_RETURN(still_fails[i],
+                           StillFailsHelper(candidates[i].ir_text, inputs));
+      return absl::OkStatus();
+    };
+    XLS_RETURN_IF_ERROR(
+        ParallelFor(candidates.size(), parallelism, test_candidate));
+
+    std::optional<int64_t> accepted;
+    for (int64_t i = 0; i < candidates.size(); ++i) {
+      test_cache[candidates[i].ir_text] = *still_fails[i];
+      if (*still_fails[i] && !accepted.has_value()) {
+        accepted = i;
+      }
+    }
+    if (!accepted.has_value()) {
+      failed_simplification_attempts += candidates.size();
+      XLS_LOG(INFO) << "No candidate still fails; failed simplification "
+                       "attempts now: "
+                    << failed_simplification_attempts;
+      continue;
+    }
+    knownf_ir_text = std::move(candidates[*accepted].ir_text);
+    failed_simplification_attempts = 0;
+    std::cerr << "---\ntransforms: " << candidates[*accepted].which_transform
+              << "\n";
+  }
+  if (cannot_change) {
+    XLS_LOG(INFO) << "Cannot simplify any further, done!";
+  }
+  return knownf_ir_text;
+}
+
 absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
                       const int64_t total_attempt_limit,
                       const int64_t simplifications_between_tests,
-                      const int64_t failed_attempts_between_tests_limit) {
+                      const int64_t failed_attempts_between_tests_limit,
+                      const int64_t parallelism) {
   XLS_ASSIGN_OR_RETURN(std::string knownf_ir_text, GetFileContents(path));
   // Cache of test results to avoid duplicate invocations of the
   // test_executable.
-  absl::flat_hash_map<std::string, bool> test_cache;
+  TestCache test_cache;
 
   // Parse inputs, if specified.
   std::optional<std::vector<xls::Value>> inputs;
@@ -943,6 +1099,15 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
   // If so, we start simplifying via this seeded RNG.
   std::mt19937 rng;  // Default constructor uses deterministic seed.
 
+  if (parallelism > 1) {
+    XLS_ASSIGN_OR_RETURN(
+        knownf_ir_text,
+        MinimizeInParallel(std::move(knownf_ir_text), inputs, parallelism,
+                           failed_attempt_limit, total_attempt_limit,
+                           test_cache, rng));
+    return OutputMinimized(knownf_ir_text, inputs);
+  }
+
   int64_t failed_simplification_attempts = 0;
   int64_t total_attempts = 0;
   int64_t simplification_iterations = 0;
@@ -979,19 +1144,7 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
 
     XLS_VLOG(1) << "=== Simplification attempt " << total_attempts;
 
-    FunctionBase* candidate;
-    if (absl::GetFlag(FLAGS_simplify_top_only)) {
-      candidate = package->GetTop().value();
-    } else {
-      std::vector<FunctionBase*> bases = package->GetFunctionBases();
-      std::vector<int64_t> node_counts;
-      node_counts.reserve(bases.size());
-      absl::c_transform(bases, std::back_inserter(node_counts),
-                        [](FunctionBase* f) { return f->node_count(); });
-      std::discrete_distribution<int64_t> distribution(node_counts.cbegin(),
-                                                       node_counts.cend());
-      candidate = bases[distribution(rng)];
-    }
+    FunctionBase* candidate = ChooseFunctionBase(package.get(), rng);
     std::string candidate_name = candidate->name();
     XLS_VLOG_LINES(2,
                    "=== Candidate for simplification:\n" + candidate->DumpIr());
@@ -1123,14 +1276,7 @@ absl::Status RealMain(std::string_view path, const int64_t failed_attempt_limit,
     candidate_changes.clear();
   }
 
-  std::cout << knownf_ir_text;
-
-  // Run the last test verification without the cache.
-  XLS_RETURN_IF_ERROR(VerifyStillFails(knownf_ir_text, inputs,
-                                       "Minimized function does not fail!",
-                                       /*test_cache=*/nullptr));
-
-  return absl::OkStatus();
+  return OutputMinimized(knownf_ir_text, inputs);
 }
 
 }  // namespace
@@ -1148,10 +1294,15 @@ int main(int argc, char** argv) {
   XLS_QCHECK(!absl::GetFlag(FLAGS_test_executable).empty() ^
              absl::GetFlag(FLAGS_test_llvm_jit))
       << "Must specify either --test_executable or --test_llvm_jit";
+  XLS_QCHECK(absl::GetFlag(FLAGS_parallelism) <= 1 ||
+             absl::GetFlag(FLAGS_simplifications_between_tests) == 1)
+      << "Cannot specify both --parallelism and "
+         "--simplifications_between_tests";
 
   return xls::ExitStatus(xls::RealMain(
       positional_arguments[0], absl::GetFlag(FLAGS_failed_attempt_limit),
       absl::GetFlag(FLAGS_total_attempt_limit),
       absl::GetFlag(FLAGS_simplifications_between_tests),
-      absl::GetFlag(FLAGS_failed_attempts_between_tests_limit)));
+      absl::GetFlag(FLAGS_failed_attempts_between_tests_limit),
+      absl::GetFlag(FLAGS_parallelism)));
 }
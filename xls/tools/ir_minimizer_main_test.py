@@ -153,6 +153,24 @@ top fn foo(x: bits[32], y: bits[32]) -> bits[32] {
 """,
     )
 
+  def test_minimize_add_in_parallel(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    test_sh_file = self.create_tempfile()
+    self._write_sh_script(test_sh_file.full_path, ['/usr/bin/env grep add $1'])
+    args = [
+        IR_MINIMIZER_MAIN_PATH,
+        '--test_executable=' + test_sh_file.full_path,
+        '--can_remove_params=false',
+        '--parallelism=4',
+        ir_file.full_path,
+    ]
+    minimized_ir = subprocess.check_output(args).decode('utf-8')
+    self._maybe_record_property('output', minimized_ir)
+    self.assertIn('add(', minimized_ir)
+    self.assertNotIn('not(', minimized_ir)
+    # The result must not depend on thread timing.
+    self.assertEqual(minimized_ir, subprocess.check_output(args).decode('utf-8'))
+
   def test_minimize_add_remove_params(self):
     ir_file = self.create_tempfile(content=ADD_IR)
     test_sh_file = self.create_tempfile()
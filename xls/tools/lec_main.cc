@@ -109,9 +109,8 @@ absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     XLS_RET_CHECK(cell_proto.ParseFromString(cell_proto_text));
     return netlist::CellLibrary::FromProto(cell_proto);
   }
-  XLS_ASSIGN_OR_RETURN(std::string lib_text, GetFileContents(cell_lib_path));
   XLS_ASSIGN_OR_RETURN(auto stream,
-                       netlist::cell_lib::CharStream::FromText(lib_text));
+                       netlist::cell_lib::CharStream::FromPath(cell_lib_path));
   XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto proto,
                        netlist::function::ExtractFunctions(&stream));
   return netlist::CellLibrary::FromProto(proto);
@@ -15,6 +15,7 @@
 // Driver for NetlistInterpreter: loads a netlist from disk, feeds Value input
 // (taken from the command line) into it, and prints the result.
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "xls/codegen/flattening.h"
 #include "xls/common/exit_status.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/file/mapped_file.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -33,6 +35,7 @@
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/value.h"
 #include "xls/netlist/cell_library.h"
+#include "xls/netlist/compiled_interpreter.h"
 #include "xls/netlist/function_extractor.h"
 #include "xls/netlist/interpreter.h"
 #include "xls/netlist/lib_parser.h"
@@ -43,6 +46,10 @@ ABSL_FLAG(std::string, cell_library, "",
           "Cell library to use for interpretation.");
 ABSL_FLAG(std::string, cell_library_proto, "",
           "Preprocessed cell library proto to use for interpretation.");
+ABSL_FLAG(bool, compiled, false,
+          "If true, levelize and compile the module before evaluating it "
+          "instead of using the event-driven interpreter. Not compatible "
+          "with --dump_cells.");
 // TODO(rspringer): Eliminate the need for this flag.
 // This one is a hidden temporary flag until we can properly handle cells
 // with state_function attributes (e.g., some latches).
@@ -58,6 +65,8 @@ ABSL_FLAG(std::string, output_type, "",
           "output will be printed as flat uninterpreted bits.");
 ABSL_FLAG(std::string, module_name, "", "Module in the netlist to interpret.");
 ABSL_FLAG(std::string, netlist, "", "Path to the netlist to interpret.");
+ABSL_FLAG(int64_t, num_threads, 0,
+          "Number of worker threads to use for interpretation.");
 
 namespace xls {
 
@@ -71,11 +80,9 @@ static absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     XLS_RET_CHECK(lib_proto.ParseFromString(proto_text));
     return netlist::CellLibrary::FromProto(lib_proto);
   }
-  XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
-                       GetFileContents(cell_library_path));
   XLS_ASSIGN_OR_RETURN(
       auto char_stream,
-      netlist::cell_lib::CharStream::FromText(cell_library_text));
+      netlist::cell_lib::CharStream::FromPath(cell_library_path));
   XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
                        netlist::function::ExtractFunctions(&char_stream));
   return netlist::CellLibrary::FromProto(lib_proto);
@@ -87,13 +94,14 @@ static absl::Status RealMain(const std::string& netlist_path,
                              const std::string& module_name,
                              absl::Span<const std::string> inputs,
                              const std::string& output_type_string,
-                             absl::Span<const std::string> dump_cells) {
+                             absl::Span<const std::string> dump_cells,
+                             bool compiled, int64_t num_threads) {
   XLS_ASSIGN_OR_RETURN(
       netlist::CellLibrary cell_library,
       GetCellLibrary(cell_library_path, cell_library_proto_path));
 
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
+  XLS_ASSIGN_OR_RETURN(MappedFile netlist_file, MappedFile::Open(netlist_path));
+  netlist::rtl::Scanner scanner(netlist_file.contents());
   XLS_ASSIGN_OR_RETURN(auto netlist, netlist::rtl::Parser::ParseNetlist(
                                          &cell_library, &scanner));
   XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
@@ -128,9 +136,20 @@ static absl::Status RealMain(const std::string& netlist_path,
     input_nets[in] = input_bits.Get(module->GetInputPortOffset(in->name()));
   }
 
-  netlist::Interpreter interpreter(netlist.get());
-  XLS_ASSIGN_OR_RETURN(auto output_nets, interpreter.InterpretModule(
-                                             module, input_nets, dump_cells));
+  netlist::NetRef2Value output_nets;
+  if (compiled) {
+    XLS_ASSIGN_OR_RETURN(
+        auto interpreter,
+        netlist::CompiledInterpreter::Create(netlist.get(), module,
+                                             /*zero=*/false, /*one=*/true,
+                                             num_threads));
+    XLS_ASSIGN_OR_RETURN(output_nets, interpreter->InterpretModule(input_nets));
+  } else {
+    netlist::Interpreter interpreter(netlist.get(), /*zero=*/false,
+                                     /*one=*/true, num_threads);
+    XLS_ASSIGN_OR_RETURN(output_nets, interpreter.InterpretModule(
+                                          module, input_nets, dump_cells));
+  }
 
   BitsRope rope(output_nets.size());
   for (const netlist::rtl::NetRef ref : module->outputs()) {
@@ -178,9 +197,15 @@ int main(int argc, char* argv[]) {
   std::string dump_cells_str = absl::GetFlag(FLAGS_dump_cells);
   std::vector<std::string> dump_cells = absl::StrSplit(dump_cells_str, ',');
 
+  bool compiled = absl::GetFlag(FLAGS_compiled);
+  XLS_QCHECK(!compiled || dump_cells_str.empty())
+      << "--dump_cells is not supported with --compiled.";
+  int64_t num_threads = absl::GetFlag(FLAGS_num_threads);
+
   std::string output_type = absl::GetFlag(FLAGS_output_type);
 
   return xls::ExitStatus(xls::RealMain(netlist_path, cell_library_path,
                                        cell_library_proto_path, module_name,
-                                       inputs, output_type, dump_cells));
+                                       inputs, output_type, dump_cells,
+                                       compiled, num_threads));
 }
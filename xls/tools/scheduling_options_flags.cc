@@ -27,6 +27,7 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
+#include "absl/time/time.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
@@ -87,7 +88,12 @@ ABSL_FLAG(bool, receives_first_sends_last, false,
           "If true, this forces receives into the first cycle and sends into "
           "the last cycle.");
 ABSL_FLAG(int64_t, mutual_exclusion_z3_rlimit, -1,
-          "Resource limit for solver in mutual exclusion pass");
+          "Resource limit for each solver query in mutual exclusion pass");
+ABSL_FLAG(int64_t, mutual_exclusion_time_budget_ms, -1,
+          "Total time in milliseconds the mutual exclusion pass may spend in "
+          "the solver per function; values <= 0 mean unlimited. Pairs of "
+          "predicates not decided within the budget are treated as not "
+          "mutually exclusive.");
 ABSL_FLAG(std::string, scheduling_options_proto, "",
           "Path to a protobuf containing all scheduling options args.");
 ABSL_FLAG(bool, explain_infeasibility, true,
@@ -167,6 +173,7 @@ static absl::StatusOr<bool> SetOptionsFromFlags(
   POPULATE_REPEATED_FLAG(io_constraints);
   POPULATE_FLAG(receives_first_sends_last);
   POPULATE_FLAG(mutual_exclusion_z3_rlimit);
+  POPULATE_FLAG(mutual_exclusion_time_budget_ms);
   POPULATE_FLAG(use_fdo);
   POPULATE_FLAG(fdo_iteration_number);
   POPULATE_FLAG(fdo_delay_driven_path_number);
@@ -298,6 +305,13 @@ static absl::StatusOr<SchedulingOptions> OptionsFromFlagProto(
     scheduling_options.mutual_exclusion_z3_rlimit(
         proto.mutual_exclusion_z3_rlimit());
   }
+  // The field is unset in protos written without it; a non-positive budget
+  // (including the flag default of -1) means unlimited.
+  if (proto.has_mutual_exclusion_time_budget_ms() &&
+      proto.mutual_exclusion_time_budget_ms() > 0) {
+    scheduling_options.mutual_exclusion_time_budget(
+        absl::Milliseconds(proto.mutual_exclusion_time_budget_ms()));
+  }
 
   if (p != nullptr) {
     for (const SchedulingConstraint& c : scheduling_options.constraints()) {
@@ -0,0 +1,73 @@
+// Copyright 2023 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/scheduling_options_flags.h"
+
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "google/protobuf/text_format.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/scheduling/scheduling_options.h"
+#include "xls/tools/scheduling_options_flags.pb.h"
+
+namespace xls {
+namespace {
+
+// Round-trips `proto` through its text format, as --scheduling_options_proto
+// does, and sets up scheduling options from the result.
+absl::StatusOr<SchedulingOptions> SetUpFromTextProto(
+    const SchedulingOptionsFlagsProto& proto) {
+  std::string text;
+  XLS_RET_CHECK(google::protobuf::TextFormat::PrintToString(proto, &text));
+  SchedulingOptionsFlagsProto parsed;
+  XLS_RET_CHECK(google::protobuf::TextFormat::ParseFromString(text, &parsed));
+  return SetUpSchedulingOptions(parsed, /*p=*/nullptr);
+}
+
+TEST(SchedulingOptionsFlagsTest, MutualExclusionTimeBudgetUnset) {
+  SchedulingOptionsFlagsProto proto;
+  proto.set_clock_period_ps(1000);
+  XLS_ASSERT_OK_AND_ASSIGN(SchedulingOptions options,
+                           SetUpFromTextProto(proto));
+  EXPECT_EQ(options.mutual_exclusion_time_budget(), std::nullopt);
+}
+
+TEST(SchedulingOptionsFlagsTest, MutualExclusionTimeBudgetNonPositive) {
+  SchedulingOptionsFlagsProto proto;
+  proto.set_mutual_exclusion_time_budget_ms(0);
+  XLS_ASSERT_OK_AND_ASSIGN(SchedulingOptions options,
+                           SetUpFromTextProto(proto));
+  EXPECT_EQ(options.mutual_exclusion_time_budget(), std::nullopt);
+
+  proto.set_mutual_exclusion_time_budget_ms(-1);
+  XLS_ASSERT_OK_AND_ASSIGN(options, SetUpFromTextProto(proto));
+  EXPECT_EQ(options.mutual_exclusion_time_budget(), std::nullopt);
+}
+
+TEST(SchedulingOptionsFlagsTest, MutualExclusionTimeBudgetSet) {
+  SchedulingOptionsFlagsProto proto;
+  proto.set_mutual_exclusion_time_budget_ms(250);
+  XLS_ASSERT_OK_AND_ASSIGN(SchedulingOptions options,
+                           SetUpFromTextProto(proto));
+  EXPECT_EQ(options.mutual_exclusion_time_budget(), absl::Milliseconds(250));
+}
+
+}  // namespace
+}  // namespace xls
@@ -86,6 +86,10 @@ ABSL_FLAG(std::vector<std::string>, output_channel_counts, {},
           "channel name, and 'count' is an integer representing the number of "
           "values expected from the given channel during simulation. Must be "
           "specified with 'channel_values_file'.");
+ABSL_FLAG(bool, streaming, false,
+          "Stream the argument sets from --args_file through the simulation "
+          "rather than writing each into the testbench. Much faster for large "
+          "batches.");
 ABSL_FLAG(std::string, verilog_simulator, "",
           "The Verilog simulator to use. If not specified, the default "
           "simulator is used.");
@@ -136,7 +140,9 @@ absl::Status RunFunction(const verilog::ModuleSimulator& simulator,
   }
 
   XLS_ASSIGN_OR_RETURN(std::vector<Value> outputs,
-                       simulator.RunBatched(args_sets));
+                       absl::GetFlag(FLAGS_streaming)
+                           ? simulator.RunBatchedStreaming(args_sets)
+                           : simulator.RunBatched(args_sets));
 
   for (const Value& output : outputs) {
     std::cout << output.ToString(FormatPreference::kHex) << std::endl;